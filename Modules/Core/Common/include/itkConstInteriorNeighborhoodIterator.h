@@ -0,0 +1,216 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkConstInteriorNeighborhoodIterator_h
+#define __itkConstInteriorNeighborhoodIterator_h
+
+#include <vector>
+#include "itkImage.h"
+#include "itkNeighborhood.h"
+
+namespace itk
+{
+/** \class ConstInteriorNeighborhoodIterator
+ *
+ * \brief Lightweight neighborhood iterator for regions whose
+ * neighborhoods lie inside the buffer of the image.
+ *
+ * ConstInteriorNeighborhoodIterator walks a region like
+ * ConstNeighborhoodIterator, but keeps only a pointer to the center pixel
+ * and a constant table of the offsets of the neighbors from it in the
+ * buffer. Moving the iterator updates the center pointer alone, instead
+ * of one pointer per neighbor, and no boundary condition is ever checked.
+ *
+ * The neighborhoods of all the pixels of the region must therefore be
+ * inside the buffered region of the image, as they are in the first,
+ * non-boundary, region returned by
+ * NeighborhoodAlgorithm::ImageBoundaryFacesCalculator. The neighbors are
+ * numbered as in Neighborhood.
+ *
+ * \sa ConstNeighborhoodIterator
+ * \sa NeighborhoodAlgorithm::ImageBoundaryFacesCalculator
+ * \sa NeighborhoodAlgorithm::ImageInteriorTilesCalculator
+ *
+ * \ingroup ImageIterators
+ * \ingroup ITKCommon
+ */
+template< class TImage >
+class ITK_EXPORT ConstInteriorNeighborhoodIterator
+{
+public:
+  /** Standard class typedefs. */
+  typedef ConstInteriorNeighborhoodIterator Self;
+
+  /** Save the image dimension. */
+  itkStaticConstMacro(Dimension, unsigned int, TImage::ImageDimension);
+
+  /** Typedef support for common objects */
+  typedef TImage                                         ImageType;
+  typedef typename TImage::PixelType                     PixelType;
+  typedef typename TImage::InternalPixelType             InternalPixelType;
+  typedef typename TImage::RegionType                    RegionType;
+  typedef typename TImage::IndexType                     IndexType;
+  typedef typename TImage::SizeType                      SizeType;
+  typedef typename TImage::OffsetType                    OffsetType;
+  typedef SizeType                                       RadiusType;
+  typedef Neighborhood< PixelType, itkGetStaticConstMacro(Dimension) > NeighborhoodType;
+  typedef typename NeighborhoodType::NeighborIndexType   NeighborIndexType;
+
+  /** Typedef for the functor used to access neighborhoods of pixel
+   * pointers. This is obtained as a trait from the image and is
+   * different for Image and VectorImage. */
+  typedef typename ImageType::NeighborhoodAccessorFunctorType NeighborhoodAccessorFunctorType;
+
+  /** Default constructor */
+  ConstInteriorNeighborhoodIterator();
+
+  /** Constructor which establishes the region size, neighborhood, and image
+   * over which to walk. */
+  ConstInteriorNeighborhoodIterator(const RadiusType & radius, const ImageType *ptr, const RegionType & region);
+
+  /** Sets the radius, the image and the region over which to walk, and
+   * goes to the beginning of the region. Throws an exception if the
+   * neighborhoods of the region are not inside the buffered region of
+   * the image. */
+  void Initialize(const RadiusType & radius, const ImageType *ptr, const RegionType & region);
+
+  /** Returns true when the neighborhoods of all the pixels of the region
+   * are inside the buffered region of the image, so that the iterator
+   * can walk the region. */
+  static bool IsInteriorRegion(const RadiusType & radius, const ImageType *ptr, const RegionType & region);
+
+  /** Returns the number of pixels of the neighborhood. */
+  NeighborIndexType Size() const
+  {
+    return static_cast< NeighborIndexType >( m_Offsets.size() );
+  }
+
+  /** Returns the radius of the neighborhood. */
+  const RadiusType & GetRadius() const
+  {
+    return m_Radius;
+  }
+
+  /** Returns the index of the center pixel in the neighborhood. */
+  NeighborIndexType GetCenterNeighborhoodIndex() const
+  {
+    return static_cast< NeighborIndexType >( m_Offsets.size() / 2 );
+  }
+
+  /** Returns the offset of a neighbor from the center pixel. */
+  OffsetType GetOffset(NeighborIndexType n) const
+  {
+    OffsetType offset;
+    for ( unsigned int i = 0; i < Dimension; ++i )
+      {
+      const NeighborIndexType width = static_cast< NeighborIndexType >( 2 * m_Radius[i] + 1 );
+      offset[i] = static_cast< OffsetValueType >( n % width ) - static_cast< OffsetValueType >( m_Radius[i] );
+      n /= width;
+      }
+    return offset;
+  }
+
+  /** Returns the offset, in the image buffer, of a neighbor from the
+   * center pixel. */
+  OffsetValueType GetBufferOffset(NeighborIndexType n) const
+  {
+    return m_Offsets[n];
+  }
+
+  /** Returns the table of the offsets, in the image buffer, of the
+   * neighbors from the center pixel. */
+  const std::vector< OffsetValueType > & GetBufferOffsets() const
+  {
+    return m_Offsets;
+  }
+
+  /** Returns a pointer to the center pixel in the image buffer. */
+  const InternalPixelType * GetCenterPointer() const
+  {
+    return m_Center;
+  }
+
+  /** Returns the value of the center pixel. */
+  PixelType GetCenterPixel() const
+  {
+    return m_NeighborhoodAccessorFunctor.Get(m_Center);
+  }
+
+  /** Returns the value of neighbor n. */
+  PixelType GetPixel(NeighborIndexType n) const
+  {
+    return m_NeighborhoodAccessorFunctor.Get(m_Center + m_Offsets[n]);
+  }
+
+  /** Returns the index of the center pixel. */
+  const IndexType & GetIndex() const
+  {
+    return m_Index;
+  }
+
+  /** Returns the region over which the iterator walks. */
+  const RegionType & GetRegion() const
+  {
+    return m_Region;
+  }
+
+  /** Moves the iterator to the beginning of the region. */
+  void GoToBegin();
+
+  /** Returns true when the iterator has walked past the end of the
+   * region. */
+  bool IsAtEnd() const
+  {
+    return m_IsAtEnd;
+  }
+
+  /** Moves the center of the neighborhood to the next pixel of the
+   * region, along the first dimension first. */
+  Self & operator++()
+  {
+    ++m_Center;
+    if ( ++m_Index[0] == m_End[0] )
+      {
+      this->NextLine();
+      }
+    return *this;
+  }
+
+protected:
+  /** Moves the center of the neighborhood to the beginning of the next
+   * line of the region. */
+  void NextLine();
+
+private:
+  const ImageType *               m_ConstImage;
+  RadiusType                      m_Radius;
+  RegionType                      m_Region;
+  std::vector< OffsetValueType >  m_Offsets;
+  const InternalPixelType *       m_Center;
+  IndexType                       m_Index;
+  IndexType                       m_End;
+  OffsetValueType                 m_WrapOffsets[TImage::ImageDimension];
+  bool                            m_IsAtEnd;
+  NeighborhoodAccessorFunctorType m_NeighborhoodAccessorFunctor;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkConstInteriorNeighborhoodIterator.hxx"
+#endif
+
+#endif
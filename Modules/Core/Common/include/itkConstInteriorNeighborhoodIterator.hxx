@@ -0,0 +1,148 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkConstInteriorNeighborhoodIterator_hxx
+#define __itkConstInteriorNeighborhoodIterator_hxx
+
+#include "itkConstInteriorNeighborhoodIterator.h"
+
+namespace itk
+{
+template< class TImage >
+ConstInteriorNeighborhoodIterator< TImage >
+::ConstInteriorNeighborhoodIterator():
+  m_ConstImage(0),
+  m_Center(0),
+  m_IsAtEnd(true)
+{
+  m_Radius.Fill(0);
+  m_Index.Fill(0);
+  m_End.Fill(0);
+  for ( unsigned int i = 0; i < Dimension; ++i )
+    {
+    m_WrapOffsets[i] = 0;
+    }
+}
+
+template< class TImage >
+ConstInteriorNeighborhoodIterator< TImage >
+::ConstInteriorNeighborhoodIterator(const RadiusType & radius,
+                                    const ImageType *ptr,
+                                    const RegionType & region)
+{
+  this->Initialize(radius, ptr, region);
+}
+
+template< class TImage >
+void
+ConstInteriorNeighborhoodIterator< TImage >
+::Initialize(const RadiusType & radius, const ImageType *ptr, const RegionType & region)
+{
+  m_ConstImage = ptr;
+  m_Radius = radius;
+  m_Region = region;
+
+  if ( !IsInteriorRegion(radius, ptr, region) )
+    {
+    itkGenericExceptionMacro(<< "The neighborhoods of region " << region
+                             << " are not inside the buffered region "
+                             << ptr->GetBufferedRegion());
+    }
+
+  // Offsets of the neighbors in the buffer, in the order of Neighborhood
+  const OffsetValueType *offsetTable = ptr->GetOffsetTable();
+  NeighborhoodType       neighborhood;
+  neighborhood.SetRadius(radius);
+  m_Offsets.resize( neighborhood.Size() );
+  for ( NeighborIndexType n = 0; n < neighborhood.Size(); ++n )
+    {
+    const OffsetType offset = neighborhood.GetOffset(n);
+    m_Offsets[n] = 0;
+    for ( unsigned int i = 0; i < Dimension; ++i )
+      {
+      m_Offsets[n] += offset[i] * offsetTable[i];
+      }
+    }
+
+  // Offsets to add to the center pointer, once past the end of a line,
+  // to move to the beginning of the next line along every dimension
+  OffsetValueType lineOffset = 0;
+  for ( unsigned int i = 0; i < Dimension; ++i )
+    {
+    m_End[i] = region.GetIndex(i) + static_cast< IndexValueType >( region.GetSize(i) );
+    m_WrapOffsets[i] = offsetTable[i] - 1 - lineOffset;
+    if ( region.GetSize(i) > 0 )
+      {
+      lineOffset += static_cast< OffsetValueType >( region.GetSize(i) - 1 ) * offsetTable[i];
+      }
+    }
+
+  m_NeighborhoodAccessorFunctor = ptr->GetNeighborhoodAccessor();
+  m_NeighborhoodAccessorFunctor.SetBegin( ptr->GetBufferPointer() );
+
+  this->GoToBegin();
+}
+
+template< class TImage >
+bool
+ConstInteriorNeighborhoodIterator< TImage >
+::IsInteriorRegion(const RadiusType & radius, const ImageType *ptr, const RegionType & region)
+{
+  if ( region.GetNumberOfPixels() == 0 )
+    {
+    return true;
+    }
+  RegionType neighborhoodsRegion = region;
+  neighborhoodsRegion.PadByRadius(radius);
+  return ptr->GetBufferedRegion().IsInside(neighborhoodsRegion);
+}
+
+template< class TImage >
+void
+ConstInteriorNeighborhoodIterator< TImage >
+::GoToBegin()
+{
+  m_Index = m_Region.GetIndex();
+  m_IsAtEnd = ( m_Region.GetNumberOfPixels() == 0 );
+  m_Center = m_IsAtEnd ? 0 : m_ConstImage->GetBufferPointer() + m_ConstImage->ComputeOffset(m_Index);
+}
+
+template< class TImage >
+void
+ConstInteriorNeighborhoodIterator< TImage >
+::NextLine()
+{
+  // The center pointer is one past the end of the line; move it to the
+  // first pixel of the next line along the first dimension that is not
+  // at its end.
+  m_Index[0] = m_Region.GetIndex(0);
+  unsigned int i = 1;
+  while ( i < Dimension && ++m_Index[i] == m_End[i] )
+    {
+    m_Index[i] = m_Region.GetIndex(i);
+    ++i;
+    }
+  if ( i == Dimension )
+    {
+    m_IsAtEnd = true;
+    return;
+    }
+  m_Center += m_WrapOffsets[i];
+}
+} // end namespace itk
+
+#endif
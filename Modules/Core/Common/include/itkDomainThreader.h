@@ -100,7 +100,7 @@ public:
 
   /** Convenience methods to set/get the maximum number of threads to use.
    * \warning When setting the maximum number of threads, it will be clamped by
-   * itk::MultiThreader::GetGlobalMaximumNumberOfThreads() and ITK_MAX_THREADS.
+   * itk::MultiThreader::GetGlobalMaximumNumberOfThreads().
    * */
   ThreadIdType GetMaximumNumberOfThreads() const;
   void SetMaximumNumberOfThreads( const ThreadIdType threads );
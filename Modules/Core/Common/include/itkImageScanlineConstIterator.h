@@ -0,0 +1,254 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkImageScanlineConstIterator_h
+#define __itkImageScanlineConstIterator_h
+
+#include "itkImageIterator.h"
+
+namespace itk
+{
+/** \class ImageScanlineConstIterator
+ * \brief A multi-dimensional iterator templated over image type that walks a
+ * region of pixels, scanline by scanline or in the direction of the
+ * fastest axis.
+ *
+ * The itk::ImageScanlineConstIterator is optimized for iteration speed and
+ * is the first choice for pixel-wise operations, when the index of the
+ * pixel is not needed.  Unlike ImageRegionConstIterator, its increment
+ * operator does not check whether the end of the current line was
+ * reached: the iteration is written as two nested loops, the inner one
+ * walking a contiguous line of pixels of the fastest axis and the outer
+ * one moving to the next line of the region with NextLine().  The inner
+ * loop is then free of branches, which lets the compiler unroll and
+ * vectorize it.
+ *
+ * \code
+ *
+ *   it.GoToBegin();
+ *   while ( !it.IsAtEnd() )
+ *     {
+ *     while ( !it.IsAtEndOfLine() )
+ *       {
+ *       value = it.Get();
+ *       ++it;
+ *       }
+ *     it.NextLine();
+ *     }
+ *
+ * \endcode
+ *
+ * The begin and end of the current line are also available as offsets in
+ * the buffer, through GetLineBeginOffset() and GetLineEndOffset(), for
+ * code that processes the line with raw pointers.
+ *
+ * \par MORE INFORMATION
+ * For a complete description of the ITK Image Iterators and their API, please
+ * see the Iterators chapter in the ITK Software Guide.  The ITK Software Guide
+ * is available in print and as a free .pdf download from http://www.itk.org.
+ *
+ * \ingroup ImageIterators
+ *
+ * \sa ImageConstIterator \sa ImageRegionConstIterator
+ * \sa ImageScanlineIterator
+ * \ingroup ITKCommon
+ */
+template< typename TImage >
+class ITK_EXPORT ImageScanlineConstIterator:public ImageConstIterator< TImage >
+{
+public:
+  /** Standard class typedef. */
+  typedef ImageScanlineConstIterator   Self;
+  typedef ImageConstIterator< TImage > Superclass;
+
+  /** Dimension of the image that the iterator walks.  This constant is needed so
+   * functions that are templated over image iterator type (as opposed to
+   * being templated over pixel type and dimension) can have compile time
+   * access to the dimension of the image that the iterator walks. */
+  itkStaticConstMacro(ImageIteratorDimension, unsigned int,
+                      Superclass::ImageIteratorDimension);
+
+  /** Types inherited from the Superclass */
+  typedef typename Superclass::IndexType             IndexType;
+  typedef typename Superclass::SizeType              SizeType;
+  typedef typename Superclass::OffsetType            OffsetType;
+  typedef typename Superclass::RegionType            RegionType;
+  typedef typename Superclass::ImageType             ImageType;
+  typedef typename Superclass::PixelContainer        PixelContainer;
+  typedef typename Superclass::PixelContainerPointer PixelContainerPointer;
+  typedef typename Superclass::InternalPixelType     InternalPixelType;
+  typedef typename Superclass::PixelType             PixelType;
+  typedef typename Superclass::AccessorType          AccessorType;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ImageScanlineConstIterator, ImageConstIterator);
+
+  /** Default constructor. Needed since we provide a cast constructor. */
+  ImageScanlineConstIterator():ImageConstIterator< TImage >()
+  {
+    m_SpanBeginOffset = 0;
+    m_SpanEndOffset = 0;
+  }
+
+  /** Constructor establishes an iterator to walk a particular image and a
+   * particular region of that image. */
+  ImageScanlineConstIterator(const ImageType *ptr,
+                             const RegionType & region):
+    ImageConstIterator< TImage >(ptr, region)
+  {
+    m_SpanBeginOffset = this->m_BeginOffset;
+    m_SpanEndOffset   = this->m_BeginOffset + static_cast< OffsetValueType >( this->m_Region.GetSize()[0] );
+  }
+
+  /** Constructor that can be used to cast from an ImageIterator to an
+   * ImageScanlineConstIterator. */
+  ImageScanlineConstIterator(const ImageIterator< TImage > & it)
+  {
+    this->ImageConstIterator< TImage >::operator=(it);
+
+    IndexType ind = this->GetIndex();
+    m_SpanEndOffset = this->m_Offset + static_cast< OffsetValueType >( this->m_Region.GetSize()[0] )
+                      - ( ind[0] - this->m_Region.GetIndex()[0] );
+    m_SpanBeginOffset = m_SpanEndOffset
+                        - static_cast< OffsetValueType >( this->m_Region.GetSize()[0] );
+  }
+
+  /** Constructor that can be used to cast from an ImageConstIterator to an
+   * ImageScanlineConstIterator. */
+  ImageScanlineConstIterator(const ImageConstIterator< TImage > & it)
+  {
+    this->ImageConstIterator< TImage >::operator=(it);
+
+    IndexType ind = this->GetIndex();
+    m_SpanEndOffset = this->m_Offset + static_cast< OffsetValueType >( this->m_Region.GetSize()[0] )
+                      - ( ind[0] - this->m_Region.GetIndex()[0] );
+    m_SpanBeginOffset = m_SpanEndOffset
+                        - static_cast< OffsetValueType >( this->m_Region.GetSize()[0] );
+  }
+
+  /** Move an iterator to the beginning of the region. "Begin" is
+   * defined as the first pixel in the region. */
+  void GoToBegin()
+  {
+    Superclass::GoToBegin();
+
+    // reset the span offsets
+    m_SpanBeginOffset = this->m_BeginOffset;
+    m_SpanEndOffset   = this->m_BeginOffset + static_cast< OffsetValueType >( this->m_Region.GetSize()[0] );
+  }
+
+  /** Move an iterator to the end of the region. "End" is defined as
+   * one pixel past the last pixel of the region. */
+  void GoToEnd()
+  {
+    Superclass::GoToEnd();
+
+    // reset the span offsets
+    m_SpanEndOffset = this->m_EndOffset;
+    m_SpanBeginOffset = m_SpanEndOffset - static_cast< OffsetValueType >( this->m_Region.GetSize()[0] );
+  }
+
+  /** Go to the beginning pixel of the current line. */
+  void GoToBeginOfLine(void)
+  {
+    this->m_Offset = m_SpanBeginOffset;
+  }
+
+  /** Go to the past end pixel of the current line. */
+  void GoToEndOfLine(void)
+  {
+    this->m_Offset = m_SpanEndOffset;
+  }
+
+  /** Test if the index is at the end of line. */
+  inline bool IsAtEndOfLine(void) const
+  {
+    return this->m_Offset >= m_SpanEndOffset;
+  }
+
+  /** Offset in the buffer of the first pixel of the current line. */
+  OffsetValueType GetLineBeginOffset() const
+  {
+    return m_SpanBeginOffset;
+  }
+
+  /** Offset in the buffer of one pixel past the last pixel of the
+   * current line. */
+  OffsetValueType GetLineEndOffset() const
+  {
+    return m_SpanEndOffset;
+  }
+
+  /** Set the index. No bounds checking is performed. This is overridden
+   * from the parent because we have extra ivars.
+   * \sa GetIndex */
+  void SetIndex(const IndexType & ind)
+  {
+    Superclass::SetIndex(ind);
+    m_SpanEndOffset = this->m_Offset + static_cast< OffsetValueType >( this->m_Region.GetSize()[0] )
+                      - ( ind[0] - this->m_Region.GetIndex()[0] );
+    m_SpanBeginOffset = m_SpanEndOffset - static_cast< OffsetValueType >( this->m_Region.GetSize()[0] );
+  }
+
+  /** Go to the next line of the region, or past the end of the region
+   * when the current line is the last one.  The iterator is placed at
+   * the beginning of the new line.
+   * \sa operator++ \sa IsAtEndOfLine */
+  void NextLine(void)
+  {
+    this->Increment();
+  }
+
+  /** Increment (prefix) along the scanline.
+   *
+   * If the iterator is at the end of the scanline ( one past the last
+   * valid element in the row ), then the results are undefined. Which
+   * means it may assert in debug mode or result in an undefined
+   * iterator which may have unknown consequences if used. */
+  Self &
+  operator++()
+  {
+    itkAssertInDebugAndIgnoreInReleaseMacro( !this->IsAtEndOfLine() );
+    ++this->m_Offset;
+    return *this;
+  }
+
+  /** Decrement (prefix) along the scanline.
+   *
+   * The iterator must not be at the beginning of the scanline. */
+  Self & operator--()
+  {
+    itkAssertInDebugAndIgnoreInReleaseMacro( this->m_Offset > m_SpanBeginOffset );
+    --this->m_Offset;
+    return *this;
+  }
+
+protected:
+  OffsetValueType m_SpanBeginOffset; // offset to first pixel in the span
+                                     // (row)
+  OffsetValueType m_SpanEndOffset;   // one pixel past the end of the span (row)
+
+private:
+  void Increment(); // move to the beginning of the next line
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkImageScanlineConstIterator.hxx"
+#endif
+
+#endif
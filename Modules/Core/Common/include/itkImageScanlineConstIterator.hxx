@@ -0,0 +1,70 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkImageScanlineConstIterator_hxx
+#define __itkImageScanlineConstIterator_hxx
+
+#include "itkImageScanlineConstIterator.h"
+
+namespace itk
+{
+
+//----------------------------------------------------------------------------
+// Move to the beginning of the next line of the region. This method
+// should *ONLY* be invoked from the NextLine() method.
+template< class TImage >
+void
+ImageScanlineConstIterator< TImage >
+::Increment()
+{
+  // Get the index of the first pixel on the span (row)
+  typename ImageConstIterator< TImage >::IndexType
+  ind = this->m_Image->ComputeIndex( static_cast< OffsetValueType >( m_SpanBeginOffset ) );
+
+  const typename ImageConstIterator< TImage >::IndexType &
+  startIndex = this->m_Region.GetIndex();
+  const typename ImageConstIterator< TImage >::SizeType &
+  size = this->m_Region.GetSize();
+
+  // Increment the index of the slower dimensions, wrapping around the
+  // region as needed.
+  unsigned int dim = 1;
+  for (; dim < ImageIteratorDimension; ++dim )
+    {
+    if ( ++ind[dim] < startIndex[dim] + static_cast< IndexValueType >( size[dim] ) )
+      {
+      break;
+      }
+    ind[dim] = startIndex[dim];
+    }
+
+  if ( dim == ImageIteratorDimension )
+    {
+    // We were on the last line of the region.
+    this->m_Offset = this->m_EndOffset;
+    m_SpanEndOffset = this->m_Offset;
+    m_SpanBeginOffset = m_SpanEndOffset - static_cast< OffsetValueType >( size[0] );
+    return;
+    }
+
+  this->m_Offset = this->m_Image->ComputeOffset(ind);
+  m_SpanBeginOffset = this->m_Offset;
+  m_SpanEndOffset = this->m_Offset + static_cast< OffsetValueType >( size[0] );
+}
+} // end namespace itk
+
+#endif
@@ -31,6 +31,7 @@
 #include "itkProcessObject.h"
 #include "itkImage.h"
 #include "itkImageRegionSplitterBase.h"
+#include "itkSimpleFastMutexLock.h"
 
 namespace itk
 {
@@ -232,9 +233,32 @@ public:
   using Superclass::MakeOutput;
   virtual ProcessObject::DataObjectPointer MakeOutput(ProcessObject::DataObjectPointerArraySizeType idx);
 
+  /** Set/Get whether the output requested region is processed in
+   * dynamically scheduled pieces.  When off (the default), the region is
+   * split into one piece per thread.  When on, it is split into
+   * NumberOfPiecesPerThread pieces per thread, and each thread repeatedly
+   * takes the next unprocessed piece until none remain, which balances the
+   * load when the cost per pixel is not uniform (masks, pixels mapping
+   * outside of the input buffer, heterogeneous cores).
+   *
+   * ThreadedGenerateData() is then called several times per thread, each
+   * time with an ordinary region and the id of the calling thread.  A
+   * filter may only turn this on if its ThreadedGenerateData() accumulates
+   * its per thread results instead of overwriting them. */
+  itkSetMacro(DynamicMultiThreading, bool);
+  itkGetConstMacro(DynamicMultiThreading, bool);
+  itkBooleanMacro(DynamicMultiThreading);
+
+  /** Set/Get the number of pieces per thread the requested region is split
+   * into when DynamicMultiThreading is on. Defaults to 8. */
+  itkSetClampMacro( NumberOfPiecesPerThread, unsigned int, 1,
+                    NumericTraits< unsigned int >::max() );
+  itkGetConstMacro(NumberOfPiecesPerThread, unsigned int);
+
 protected:
   ImageSource();
   virtual ~ImageSource() {}
+  void PrintSelf(std::ostream & os, Indent indent) const;
 
   /** A version of GenerateData() specific for image processing
    * filters.  This implementation will split the processing across
@@ -257,7 +281,8 @@ protected:
    * algorithm, the filter will provide an implementation of
    * ThreadedGenerateData(). This superclass will automatically split
    * the output image into a number of pieces, spawn multiple threads,
-   * and call ThreadedGenerateData() in each thread. Prior to spawning
+   * and call ThreadedGenerateData() in each thread (once, or once per
+   * piece taken by the thread when DynamicMultiThreading is on). Prior to spawning
    * threads, the BeforeThreadedGenerateData() method is called. After
    * all the threads have completed, the AfterThreadedGenerateData()
    * method is called. If an image processing filter cannot support
@@ -310,6 +335,10 @@ protected:
    * a ThreadedGenerateData() method and NOT a GenerateData() method. */
   virtual void AfterThreadedGenerateData() {}
 
+  /** Report the size of the image outputs and of their requested regions
+   * in the PipelineTracer event of GenerateData(). */
+  virtual void AddOutputsToTraceEvent(PipelineTracer::EventType & event) const;
+
   /** \brief Returns the default image region splitter
    *
    * This is an adapter function from the private common base class to
@@ -358,11 +387,30 @@ protected:
     */
   struct ThreadStruct {
     Pointer Filter;
+
+    /** Number of pieces of the requested region and index of the next piece
+     * to process, when the pieces are scheduled dynamically. A number of
+     * pieces of zero selects one static piece per thread. */
+    unsigned int        NumberOfPieces;
+    unsigned int        NextPiece;
+    SimpleFastMutexLock PieceLock;
+
+    ThreadStruct():NumberOfPieces(0), NextPiece(0) {}
   };
 
 private:
+  /** Call ThreadedGenerateData(), recording a PipelineTracer event for
+   * the region when the tracer is enabled. */
+  void TraceThreadedGenerateData(const OutputImageRegionType & region, ThreadIdType threadId);
+
+  /** Number of bytes of a pixel of an output image. */
+  static SizeValueType GetOutputPixelSizeInBytes(const TOutputImage *image);
+
   ImageSource(const Self &);    //purposely not implemented
   void operator=(const Self &); //purposely not implemented
+
+  bool         m_DynamicMultiThreading;
+  unsigned int m_NumberOfPiecesPerThread;
 };
 } // end namespace itk
 
@@ -31,6 +31,7 @@
 
 #include "itkOutputDataObjectIterator.h"
 #include "itkImageRegionSplitterBase.h"
+#include "itkIsSame.h"
 
 #include "vnl/vnl_math.h"
 
@@ -54,6 +55,24 @@ ImageSource< TOutputImage >
   // output bulk data prior to GenerateData() in case that bulk data
   // can be reused (an thus avoid a costly deallocate/allocate cycle).
   this->ReleaseDataBeforeUpdateFlagOff();
+
+  m_DynamicMultiThreading = false;
+  m_NumberOfPiecesPerThread = 8;
+}
+
+/**
+ *
+ */
+template< class TOutputImage >
+void
+ImageSource< TOutputImage >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "DynamicMultiThreading: "
+     << ( m_DynamicMultiThreading ? "On" : "Off" ) << std::endl;
+  os << indent << "NumberOfPiecesPerThread: "
+     << m_NumberOfPiecesPerThread << std::endl;
 }
 
 /**
@@ -233,7 +252,18 @@ ImageSource< TOutputImage >
   // Get the output pointer
   const OutputImageType *outputPtr = this->GetOutput();
   const ImageRegionSplitterBase * splitter = this->GetImageRegionSplitter();
-  const unsigned int validThreads = splitter->GetNumberOfSplits( outputPtr->GetRequestedRegion(), this->GetNumberOfThreads() );
+  unsigned int validThreads;
+  if ( m_DynamicMultiThreading )
+    {
+    // Many more pieces than threads, handed out to the threads on demand
+    str.NumberOfPieces = splitter->GetNumberOfSplits( outputPtr->GetRequestedRegion(),
+                                                      this->GetNumberOfThreads() * m_NumberOfPiecesPerThread );
+    validThreads = std::min( static_cast< unsigned int >( this->GetNumberOfThreads() ), str.NumberOfPieces );
+    }
+  else
+    {
+    validThreads = splitter->GetNumberOfSplits( outputPtr->GetRequestedRegion(), this->GetNumberOfThreads() );
+    }
 
   this->GetMultiThreader()->SetNumberOfThreads( validThreads );
   this->GetMultiThreader()->SetSingleMethod(this->ThreaderCallback, &str);
@@ -287,12 +317,36 @@ ImageSource< TOutputImage >
   // execute the actual method with appropriate output region
   // first find out how many pieces extent can be split into.
   typename TOutputImage::RegionType splitRegion;
+
+  if ( str->NumberOfPieces > 0 )
+    {
+    // Dynamic scheduling: take the next unprocessed piece until none
+    // remain. The thread id is kept, so per thread results accumulate.
+    for (;; )
+      {
+      str->PieceLock.Lock();
+      const unsigned int piece = str->NextPiece++;
+      str->PieceLock.Unlock();
+      if ( piece >= str->NumberOfPieces )
+        {
+        break;
+        }
+      total = str->Filter->SplitRequestedRegion(piece, str->NumberOfPieces,
+                                                splitRegion);
+      if ( piece < total )
+        {
+        str->Filter->TraceThreadedGenerateData(splitRegion, threadId);
+        }
+      }
+    return ITK_THREAD_RETURN_VALUE;
+    }
+
   total = str->Filter->SplitRequestedRegion(threadId, threadCount,
                                             splitRegion);
 
   if ( threadId < total )
     {
-    str->Filter->ThreadedGenerateData(splitRegion, threadId);
+    str->Filter->TraceThreadedGenerateData(splitRegion, threadId);
     }
   // else
   //   {
@@ -303,6 +357,75 @@ ImageSource< TOutputImage >
 
   return ITK_THREAD_RETURN_VALUE;
 }
+
+template< class TOutputImage >
+void
+ImageSource< TOutputImage >
+::TraceThreadedGenerateData(const OutputImageRegionType & region,
+                            ThreadIdType threadId)
+{
+  if ( !PipelineTracer::GetEnabled() )
+    {
+    this->ThreadedGenerateData(region, threadId);
+    return;
+    }
+
+  PipelineTracer::EventType event;
+  event.Start = PipelineTracer::GetTimeStamp();
+  this->ThreadedGenerateData(region, threadId);
+  event.Duration = PipelineTracer::GetTimeStamp() - event.Start;
+
+  event.Name = this->GetNameOfClass();
+  event.Category = "ThreadedGenerateData";
+  event.Object = this;
+  event.ThreadId = threadId + 1;
+  event.RequestedRegionPixels = region.GetNumberOfPixels();
+  event.OutputBytes = event.RequestedRegionPixels
+                      * GetOutputPixelSizeInBytes( this->GetOutput() );
+  PipelineTracer::AddEvent(event);
+}
+
+template< class TOutputImage >
+void
+ImageSource< TOutputImage >
+::AddOutputsToTraceEvent(PipelineTracer::EventType & event) const
+{
+  for ( OutputDataObjectIterator it( const_cast< Self * >( this ) ); !it.IsAtEnd(); it++ )
+    {
+    const ImageBase< OutputImageDimension > *image =
+      dynamic_cast< const ImageBase< OutputImageDimension > * >( it.GetOutput() );
+    if ( image == 0 )
+      {
+      continue;
+      }
+    event.RequestedRegionPixels += image->GetRequestedRegion().GetNumberOfPixels();
+
+    // Only the outputs of the type of the primary output have a known
+    // pixel size.
+    const TOutputImage *output = dynamic_cast< const TOutputImage * >( image );
+    if ( output != 0 )
+      {
+      event.OutputBytes += output->GetBufferedRegion().GetNumberOfPixels()
+                           * GetOutputPixelSizeInBytes(output);
+      }
+    }
+}
+
+template< class TOutputImage >
+SizeValueType
+ImageSource< TOutputImage >
+::GetOutputPixelSizeInBytes(const TOutputImage *image)
+{
+  typedef typename TOutputImage::PixelType         PixelType;
+  typedef typename TOutputImage::InternalPixelType InternalPixelType;
+
+  // The pixels of a VectorImage are stored as several internal values.
+  if ( IsSame< PixelType, InternalPixelType >::Value || image == 0 )
+    {
+    return sizeof( PixelType );
+    }
+  return image->GetNumberOfComponentsPerPixel() * sizeof( InternalPixelType );
+}
 } // end namespace itk
 
 #endif
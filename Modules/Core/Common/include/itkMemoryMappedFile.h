@@ -0,0 +1,88 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkMemoryMappedFile_h
+#define __itkMemoryMappedFile_h
+
+#include "itkMacro.h"
+#include "itkIntTypes.h"
+
+#include <string>
+
+namespace itk
+{
+/** \class MemoryMappedFile
+ * \brief Maps a byte range of a file into memory.
+ *
+ * MemoryMappedFile maps a range of a file privately and copy-on-write:
+ * the pages are read from the file on first access and can be modified,
+ * but the modifications are never written back to the file.  The mapping
+ * is released by Unmap() or when the object is destroyed.
+ *
+ * MemoryMappedFile is not a subclass of Object and is designed to be
+ * a member of the class that owns the mapping.
+ *
+ * \sa MemoryMappedImageContainer
+ * \ingroup OSSystemObjects
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT MemoryMappedFile
+{
+public:
+  /** Standard class typedefs. */
+  typedef MemoryMappedFile Self;
+
+  MemoryMappedFile();
+  ~MemoryMappedFile();
+
+  /** Map "length" bytes of the file, starting "offset" bytes from its
+   * beginning.  The offset does not need to be aligned on a page.
+   * Return false, and leave the object unmapped, if the file cannot be
+   * opened or mapped or if it is shorter than offset + length. Any
+   * previous mapping is released first. */
+  bool Map(const std::string & fileName, SizeValueType offset, SizeValueType length);
+
+  /** Release the mapping. */
+  void Unmap();
+
+  /** Get the address of the first mapped byte of the requested range,
+   * or a null pointer if nothing is mapped. */
+  void * GetData() const { return m_Data; }
+
+  /** Get the length of the requested range. */
+  SizeValueType GetLength() const { return m_Length; }
+
+  /** Whether a range is currently mapped. */
+  bool IsMapped() const { return m_Data != 0; }
+
+private:
+  MemoryMappedFile(const Self &); //purposely not implemented
+  void operator=(const Self &);   //purposely not implemented
+
+  void *        m_Data;
+  SizeValueType m_Length;
+
+  /** The page aligned mapping that contains the requested range. */
+  void *        m_MappingAddress;
+  SizeValueType m_MappingLength;
+
+  /** The mapping object; only used on Windows. */
+  void *m_MappingHandle;
+};
+} // end namespace itk
+
+#endif
@@ -0,0 +1,103 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkMemoryMappedImageContainer_h
+#define __itkMemoryMappedImageContainer_h
+
+#include "itkImportImageContainer.h"
+#include "itkMemoryMappedFile.h"
+
+namespace itk
+{
+/** \class MemoryMappedImageContainer
+ *  \brief An ImportImageContainer whose elements are mapped from a file.
+ *
+ * MemoryMappedImageContainer exposes the elements stored uncompressed in
+ * a file as the buffer of an image, without reading them.  The pages of
+ * the file are loaded by the operating system on first access, so only
+ * the part of the image that is actually used is read, and clean pages
+ * can be dropped under memory pressure instead of being swapped.
+ *
+ * The mapping is private and copy-on-write: the buffer can be modified
+ * as usual by filters running in place, but the file is never changed.
+ * When the container is resized by Reserve() or released by Initialize(),
+ * the mapping is released and the container behaves as an
+ * ImportImageContainer managing its own memory.
+ *
+ * The elements must be stored in the file in the byte order of the host,
+ * at an offset that is a multiple of the size of their components.
+ *
+ * \sa ImageFileReader::SetUseMemoryMapping()
+ * \ingroup ImageObjects
+ * \ingroup IOFilters
+ * \ingroup ITKCommon
+ */
+template< typename TElementIdentifier, typename TElement >
+class MemoryMappedImageContainer:
+  public ImportImageContainer< TElementIdentifier, TElement >
+{
+public:
+  /** Standard class typedefs. */
+  typedef MemoryMappedImageContainer                         Self;
+  typedef ImportImageContainer< TElementIdentifier, TElement > Superclass;
+  typedef SmartPointer< Self >                               Pointer;
+  typedef SmartPointer< const Self >                         ConstPointer;
+
+  /** Save the template parameters. */
+  typedef TElementIdentifier ElementIdentifier;
+  typedef TElement           Element;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Standard part of every itk Object. */
+  itkTypeMacro(MemoryMappedImageContainer, ImportImageContainer);
+
+  /** Map "numberOfElements" elements stored in the file "fileName",
+   * starting "offset" bytes from its beginning, and use them as the
+   * buffer of the container.  The previous buffer is released.  Return
+   * false, and leave the container empty, if the file cannot be mapped. */
+  bool MapFile(const std::string & fileName, SizeValueType offset,
+               ElementIdentifier numberOfElements);
+
+  /** Whether the buffer of the container is currently mapped from a file. */
+  bool IsMapped() const
+  { return m_MappedFile.IsMapped(); }
+
+protected:
+  MemoryMappedImageContainer() {}
+  virtual ~MemoryMappedImageContainer() {}
+
+  void PrintSelf(std::ostream & os, Indent indent) const;
+
+  /** Release the mapping if there is one, otherwise the memory managed
+   * by the container. */
+  virtual void DeallocateManagedMemory();
+
+private:
+  MemoryMappedImageContainer(const Self &); //purposely not implemented
+  void operator=(const Self &);             //purposely not implemented
+
+  MemoryMappedFile m_MappedFile;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkMemoryMappedImageContainer.hxx"
+#endif
+
+#endif
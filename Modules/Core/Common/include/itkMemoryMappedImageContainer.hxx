@@ -0,0 +1,68 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkMemoryMappedImageContainer_hxx
+#define __itkMemoryMappedImageContainer_hxx
+
+#include "itkMemoryMappedImageContainer.h"
+
+namespace itk
+{
+template< typename TElementIdentifier, typename TElement >
+bool
+MemoryMappedImageContainer< TElementIdentifier, TElement >
+::MapFile(const std::string & fileName, SizeValueType offset,
+          ElementIdentifier numberOfElements)
+{
+  this->DeallocateManagedMemory();
+
+  if ( !m_MappedFile.Map( fileName, offset,
+                          static_cast< SizeValueType >( numberOfElements ) * sizeof( TElement ) ) )
+    {
+    return false;
+    }
+
+  // The container must not try to delete the mapped pages.
+  this->SetImportPointer( static_cast< TElement * >( m_MappedFile.GetData() ) );
+  this->SetContainerManageMemory(false);
+  this->SetCapacity(numberOfElements);
+  this->SetSize(numberOfElements);
+  this->Modified();
+  return true;
+}
+
+template< typename TElementIdentifier, typename TElement >
+void
+MemoryMappedImageContainer< TElementIdentifier, TElement >
+::DeallocateManagedMemory()
+{
+  m_MappedFile.Unmap();
+  Superclass::DeallocateManagedMemory();
+}
+
+template< typename TElementIdentifier, typename TElement >
+void
+MemoryMappedImageContainer< TElementIdentifier, TElement >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Mapped: " << ( m_MappedFile.IsMapped() ? "true" : "false" ) << std::endl;
+}
+} // end namespace itk
+
+#endif
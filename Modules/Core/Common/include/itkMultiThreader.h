@@ -29,9 +29,14 @@
 #define __itkMultiThreader_h
 
 #include "itkMutexLock.h"
+#include "itkSimpleFastMutexLock.h"
+#include "itkThreadArena.h"
 #include "itkThreadSupport.h"
 #include "itkIntTypes.h"
 
+#include <deque>
+#include <vector>
+
 namespace itk
 {
 /** \class MultiThreader
@@ -47,6 +52,16 @@ namespace itk
  * If ITK_USE_PTHREADS is defined, then
  * pthread_create() will be used to create multiple threads (on
  * a sun, for example).
+ *
+ * When UseThreadPool is on, the methods are executed on the persistent
+ * workers of the ThreadPool instead of on threads created for the call.
+ *
+ * SingleMethodExecute() takes its threads from a ThreadArena when one
+ * applies to the execution, so that nested and concurrent executions share
+ * a bounded number of threads instead of multiplying them.
+ *
+ * \sa ThreadPool
+ * \sa ThreadArena
  * \ingroup ITKCommon
  */
 
@@ -72,11 +87,14 @@ public:
 
   itkGetConstMacro(NumberOfThreads, ThreadIdType);
 
-  /** Set/Get the maximum number of threads to use when multithreading.  It
-   * will be clamped to the range [ 1, ITK_MAX_THREADS ] because several arrays
-   * are already statically allocated using the ITK_MAX_THREADS number.
-   * Therefore the caller of this method should check that the requested number
-   * of threads was accepted. */
+  /** Set/Get the maximum number of threads to use when multithreading.  The
+   * per thread storage is allocated at run time, so the maximum is not
+   * limited by ITK_MAX_THREADS: it will be clamped to the range
+   * [ 1, 16 * max( ITK_MAX_THREADS, number of processors ) ], and to
+   * exactly 1 when ITK is built without threads.  It is initialized to the
+   * larger of ITK_MAX_THREADS and the number of processors.
+   * Therefore the caller of this method should check that the requested
+   * number of threads was accepted. */
   static void SetGlobalMaximumNumberOfThreads(ThreadIdType val);
 
   static ThreadIdType  GetGlobalMaximumNumberOfThreads();
@@ -89,16 +107,64 @@ public:
 
   static ThreadIdType  GetGlobalDefaultNumberOfThreads();
 
+  /** Set/Get whether the threads are taken from the process-wide ThreadPool
+   * instead of being created and joined on every execution.  Using the pool
+   * removes the thread creation cost from each SingleMethodExecute() and
+   * MultipleMethodExecute() call, which is significant for short methods.
+   * Jobs of concurrent executions share the workers of the pool, so methods
+   * that synchronize all their threads (e.g. with a Barrier) must turn
+   * ExactNumberOfThreads on, which creates their threads. */
+  itkSetMacro(UseThreadPool, bool);
+  itkGetConstMacro(UseThreadPool, bool);
+  itkBooleanMacro(UseThreadPool);
+
+  /** Set/Get the value which is used to initialize UseThreadPool in the
+   * constructor.  Unless set explicitly, it is initialized from the
+   * ITK_USE_THREADPOOL environment variable, and is false otherwise. */
+  static void SetGlobalDefaultUseThreadPool(bool useThreadPool);
+
+  static bool GetGlobalDefaultUseThreadPool();
+
+  /** Set/Get the arena providing the threads of SingleMethodExecute().
+   * When it is NULL (the default), the arena of the calling thread is used
+   * if any, and otherwise the global default arena. */
+  itkSetObjectMacro(ThreadArena, ThreadArena);
+  itkGetObjectMacro(ThreadArena, ThreadArena);
+
+  /** Set/Get the arena used by the executions which have no other arena.
+   * It is NULL by default: each execution then creates all the threads it
+   * requests.  Setting an arena bounds the number of threads working for
+   * all the pipelines of the process, nested executions included. */
+  static void SetGlobalDefaultThreadArena(ThreadArena *arena);
+
+  static ThreadArena * GetGlobalDefaultThreadArena();
+
+  /** Set/Get whether SingleMethodExecute() must run exactly
+   * NumberOfThreads threads, at the same time.  The methods that
+   * synchronize all their threads, e.g. with a Barrier sized from the
+   * number of threads, need it.  An exact execution takes the threads its
+   * arena can grant and runs the other ones beyond the budget of the
+   * arena, and creates its threads instead of taking them from the
+   * ThreadPool.  Default is off. */
+  itkSetMacro(ExactNumberOfThreads, bool);
+  itkGetConstMacro(ExactNumberOfThreads, bool);
+  itkBooleanMacro(ExactNumberOfThreads);
+
   /** Execute the SingleMethod (as define by SetSingleMethod) using
    * m_NumberOfThreads threads. As a side effect the m_NumberOfThreads will be
    * checked against the current m_GlobalMaximumNumberOfThreads and clamped if
-   * necessary. */
+   * necessary.  When the execution runs in a ThreadArena, fewer threads may
+   * be used unless ExactNumberOfThreads is on: the SingleMethod must rely on
+   * the NumberOfThreads member of the ThreadInfoStruct it receives. */
   void SingleMethodExecute();
 
   /** Execute the MultipleMethods (as define by calling SetMultipleMethod for
    * each of the required m_NumberOfThreads methods) using m_NumberOfThreads
    * threads. As a side effect the m_NumberOfThreads will be checked against the
-   * current m_GlobalMaximumNumberOfThreads and clamped if necessary. */
+   * current m_GlobalMaximumNumberOfThreads and clamped if necessary. The
+   * methods run on threads of the ThreadPool when it is used, unless
+   * ExactNumberOfThreads is on; the exceptions they throw there are
+   * reported as an ExceptionObject. */
   void MultipleMethodExecute();
 
   /** Set the SingleMethod to f() and the UserData field of the
@@ -113,8 +179,8 @@ public:
   void SetMultipleMethod(ThreadIdType index, ThreadFunctionType, void *data);
 
   /** Create a new thread for the given function. Return a thread id
-     * which is a number between 0 and ITK_MAX_THREADS - 1. This
-   * id should be used to kill the thread at a later time. */
+   * which is a number between 0 and the number of threads spawned so far.
+   * This id should be used to kill the thread at a later time. */
   ThreadIdType SpawnThread(ThreadFunctionType, void *data);
 
   /** Terminate the thread that was created with a SpawnThreadExecute() */
@@ -130,7 +196,8 @@ public:
    * SingleMethodExecute or MultipleMethodExecute, and it is 1 for
    * threads created from SpawnThread.  The UserData is the (void
    * *)arg passed into the SetSingleMethod, SetMultipleMethod, or
-   * SpawnThread method. */
+   * SpawnThread method.  The Arena is the ThreadArena the thread works
+   * for, if any. */
 #ifdef ThreadInfoStruct
 #undef ThreadInfoStruct
 #endif
@@ -141,6 +208,7 @@ public:
     MutexLock::Pointer ActiveFlagLock;
     void *UserData;
     ThreadFunctionType ThreadFunction;
+    ThreadArena *Arena;
     enum { SUCCESS, ITK_EXCEPTION, ITK_PROCESS_ABORTED_EXCEPTION, STD_EXCEPTION, UNKNOWN } ThreadExitCode;
   };
 
@@ -154,28 +222,45 @@ private:
   void operator=(const Self &); //purposely not implemented
 
   /** An array of thread info containing a thread id
-   *  (0, 1, 2, .. ITK_MAX_THREADS-1), the thread count, and a pointer
-   *  to void so that user data can be passed to each thread. */
-  ThreadInfoStruct m_ThreadInfoArray[ITK_MAX_THREADS];
+   *  (0, 1, 2, .. m_NumberOfThreads-1), the thread count, and a pointer
+   *  to void so that user data can be passed to each thread.  It grows
+   *  with m_NumberOfThreads and is never resized during an execution. */
+  std::vector< ThreadInfoStruct > m_ThreadInfoArray;
 
   /** The methods to invoke. */
-  ThreadFunctionType m_SingleMethod;
-  ThreadFunctionType m_MultipleMethod[ITK_MAX_THREADS];
+  ThreadFunctionType                m_SingleMethod;
+  std::vector< ThreadFunctionType > m_MultipleMethod;
 
   /** Storage of MutexFunctions and ints used to control spawned
-   *  threads and the spawned thread ids. */
-  int                 m_SpawnedThreadActiveFlag[ITK_MAX_THREADS];
-  MutexLock::Pointer  m_SpawnedThreadActiveFlagLock[ITK_MAX_THREADS];
-  ThreadProcessIDType m_SpawnedThreadProcessID[ITK_MAX_THREADS];
-  ThreadInfoStruct    m_SpawnedThreadInfoArray[ITK_MAX_THREADS];
+   *  threads and the spawned thread ids.  The running threads keep
+   *  pointers to these elements, so they are stored in containers that
+   *  do not move their elements when growing. */
+  std::deque< int >                 m_SpawnedThreadActiveFlag;
+  std::deque< MutexLock::Pointer >  m_SpawnedThreadActiveFlagLock;
+  std::deque< ThreadProcessIDType > m_SpawnedThreadProcessID;
+  std::deque< ThreadInfoStruct >    m_SpawnedThreadInfoArray;
 
   /** Internal storage of the data. */
-  void *m_SingleData;
-  void *m_MultipleData[ITK_MAX_THREADS];
+  void *               m_SingleData;
+  std::vector< void * > m_MultipleData;
+
+  /** Grow the per thread storage to hold at least the given number of
+   * threads. */
+  void AllocateThreadStorage(ThreadIdType numberOfThreads);
+
+  /** Return the id of an unused spawned thread slot, marked as active,
+   * adding a slot if all of them are in use.  m_SpawnedThreadMutex must be
+   * held by the caller. */
+  ThreadIdType AcquireSpawnedThreadID();
+
+  /** Mark a spawned thread slot as unused again, when its thread could
+   * not be created. */
+  void ReleaseSpawnedThreadID(ThreadIdType id);
 
   /** Global variable defining the maximum number of threads that can be used.
-   *  The m_GlobalMaximumNumberOfThreads must always be less than or equal to
-   *  ITK_MAX_THREADS and greater than zero. */
+   *  The m_GlobalMaximumNumberOfThreads must always be greater than zero
+   *  once it has been initialized by GetGlobalMaximumNumberOfThreads(); it
+   *  is zero before. */
   static ThreadIdType m_GlobalMaximumNumberOfThreads;
 
   /*  Global variable defining the default number of threads to set at
@@ -189,6 +274,9 @@ private:
   /**  Platform specific number of threads */
   static ThreadIdType  GetGlobalDefaultNumberOfThreadsByPlatform();
 
+  /** Largest value accepted for m_GlobalMaximumNumberOfThreads. */
+  static ThreadIdType  GetThreadingLibraryMaximumNumberOfThreads();
+
   /** The number of threads to use.
    *  The m_NumberOfThreads must always be less than or equal to
    *  the m_GlobalMaximumNumberOfThreads before it is used during the execution
@@ -200,6 +288,29 @@ private:
    */
   ThreadIdType m_NumberOfThreads;
 
+  /** Whether the threads are taken from the ThreadPool. */
+  bool m_UseThreadPool;
+
+  /** Whether all the threads requested must run. */
+  bool m_ExactNumberOfThreads;
+
+  /** Global variables defining the default of m_UseThreadPool, and
+   *  whether that default was already initialized. */
+  static bool m_GlobalDefaultUseThreadPool;
+  static bool m_GlobalDefaultUseThreadPoolIsInitialized;
+
+  /** The arena of the executions of this instance, and the default arena
+   *  of all the executions. */
+  ThreadArena::Pointer        m_ThreadArena;
+  static ThreadArena::Pointer m_GlobalDefaultThreadArena;
+
+  /** Serializes the acquisition, growth and release of the spawned
+   *  thread slots. */
+  SimpleFastMutexLock m_SpawnedThreadMutex;
+
+  /** Run the MultipleMethods on the ThreadPool. */
+  void ThreadPoolMultipleMethodExecute();
+
   /** Static function used as a "proxy callback" by the MultiThreader.  The
    * threading library will call this routine for each thread, which
    * will delegate the control to the prescribed SingleMethod. This
@@ -71,6 +71,37 @@ struct ITK_EXPORT ImageBoundaryFacesCalculator {
   FaceListType operator()(const TImage *, RegionType, RadiusType);
 };
 
+/** \class ImageInteriorTilesCalculator
+ *  \brief Splits a region into tiles whose neighborhoods are kept in a
+ *          cache while the tiles are walked.
+ *
+ * A neighborhood iterator walking a region line after line reads the
+ * lines of the neighborhoods of the lines of a slice again for the next
+ * slices. When the neighborhoods of a whole slice do not fit in the
+ * cache, they are read from memory again and again. The tiles returned
+ * span the whole region along all dimensions but the second one, along
+ * which they are cut so that the neighborhoods of a slice of a tile fit
+ * in a cache of the given number of bytes. The region is returned whole
+ * when it already fits, or when the image has less than three
+ * dimensions.
+ *
+ * The tiles are usually those of the non-boundary region returned by
+ * ImageBoundaryFacesCalculator, walked with a
+ * ConstInteriorNeighborhoodIterator.
+ *
+ * \ingroup ITKCommon
+ */
+template< class TImage >
+struct ITK_EXPORT ImageInteriorTilesCalculator {
+  typedef typename NeighborhoodIterator< TImage >::RadiusType RadiusType;
+  typedef typename TImage::RegionType                         RegionType;
+  typedef std::list< RegionType >                             TileListType;
+  itkStaticConstMacro(ImageDimension, unsigned int, TImage::ImageDimension);
+
+  TileListType operator()(const RegionType & region, const RadiusType & radius,
+                          SizeValueType cacheSize = 262144) const;
+};
+
 /** \class CalculateOutputWrapOffsetModifiers
  *  \brief Sets up itkNeighborhoodIterator output buffers.
  *
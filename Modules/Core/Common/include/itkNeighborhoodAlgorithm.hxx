@@ -21,6 +21,7 @@
 #include "itkImageRegionIterator.h"
 #include "itkImageRegion.h"
 #include "itkConstSliceIterator.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -166,6 +167,46 @@ ImageBoundaryFacesCalculator< TImage >
   return faceList;
 }
 
+template< class TImage >
+typename ImageInteriorTilesCalculator< TImage >::TileListType
+ImageInteriorTilesCalculator< TImage >
+::operator()(const RegionType & region, const RadiusType & radius, SizeValueType cacheSize) const
+{
+  TileListType tiles;
+  if ( ImageDimension < 3 )
+    {
+    tiles.push_back(region);
+    return tiles;
+    }
+
+  // Number of lines of the neighborhoods of a slice of a tile, which
+  // are read again for the next slice when walking the tile
+  const unsigned int  lineDimension = 1;
+  const unsigned int  sliceDimension = ImageDimension > 2 ? 2 : 0;
+  const SizeValueType lineSize = region.GetSize(0) * sizeof( typename TImage::PixelType );
+  const SizeValueType lines =
+    cacheSize / std::max( lineSize * ( 2 * radius[sliceDimension] + 1 ), static_cast< SizeValueType >( 1 ) );
+  const SizeValueType tileSize =
+    std::max( lines, 2 * radius[lineDimension] + 1 ) - 2 * radius[lineDimension];
+  if ( tileSize >= region.GetSize(lineDimension) )
+    {
+    tiles.push_back(region);
+    return tiles;
+    }
+
+  const IndexValueType end = region.GetIndex(lineDimension)
+                           + static_cast< IndexValueType >( region.GetSize(lineDimension) );
+  RegionType           tile = region;
+  for ( IndexValueType start = region.GetIndex(lineDimension); start < end;
+        start += static_cast< IndexValueType >( tileSize ) )
+    {
+    tile.SetIndex(lineDimension, start);
+    tile.SetSize( lineDimension, std::min( tileSize, static_cast< SizeValueType >( end - start ) ) );
+    tiles.push_back(tile);
+    }
+  return tiles;
+}
+
 template< class TImage >
 typename CalculateOutputWrapOffsetModifiers< TImage >::OffsetType
 CalculateOutputWrapOffsetModifiers< TImage >
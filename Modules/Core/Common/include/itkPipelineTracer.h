@@ -0,0 +1,146 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkPipelineTracer_h
+#define __itkPipelineTracer_h
+
+#include "itkTimeProbesCollectorBase.h"
+#include "itkRealTimeClock.h"
+#include "itkSimpleFastMutexLock.h"
+#include "itkIntTypes.h"
+
+#include <string>
+#include <vector>
+
+namespace itk
+{
+/** \class PipelineTracer
+ * \brief Records the execution of the pipeline filters.
+ *
+ * When enabled, PipelineTracer records an event for every execution of
+ * ProcessObject::GenerateData(), with the wall time spent in the filter,
+ * the number of bytes of its image outputs and the size of their requested
+ * regions, and an event for every call of ImageSource::ThreadedGenerateData()
+ * with the time each thread was busy.  This tells which stage of a long
+ * pipeline is responsible for its execution time without attaching a
+ * profiler.
+ *
+ * The events can be exported as a Chrome trace (the JSON format read by
+ * chrome://tracing and compatible viewers) with WriteChromeTrace().  The
+ * wall time of the filters is also accumulated per filter instance in a
+ * TimeProbesCollectorBase, which is printed by Report().
+ *
+ * Tracing is switched at run time with SetEnabled(), possibly while
+ * pipelines are executing: the flag is read and written atomically.  When
+ * it is disabled, which is the default, the only cost in the pipeline is
+ * the test of that flag.
+ *
+ * \sa ProcessObject \sa TimeProbesCollectorBase
+ * \ingroup OSSystemObjects
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT PipelineTracer
+{
+public:
+  /** \class EventType
+   * \brief A timed section of the execution of a filter.
+   * \ingroup ITKCommon
+   */
+  struct EventType {
+    EventType():
+      Object(0), ThreadId(0), SystemThread(0), Start(0.0), Duration(0.0),
+      OutputBytes(0), RequestedRegionPixels(0)
+    {}
+
+    /** Class name of the filter. */
+    std::string Name;
+    /** "GenerateData" or "ThreadedGenerateData". */
+    std::string Category;
+    /** Address of the filter, to distinguish instances of a class. */
+    const void *Object;
+    /** Thread of the event, 0 for the thread updating the pipeline and
+     * 1 + the thread id for the threads of a multi-threaded execution. */
+    ThreadIdType ThreadId;
+    /** System thread the event was recorded on, numbered from 0 in the
+     * order the threads record their first event of the trace.  It tells
+     * apart the events of pipelines updated concurrently, and of threads
+     * of the ThreadPool working for several executions.  Set by
+     * AddEvent(). */
+    ThreadIdType SystemThread;
+    /** Start, relative to the enabling of the tracer, and duration in
+     * seconds. */
+    double Start;
+    double Duration;
+    /** Size of the image outputs, or of the region processed by a thread. */
+    SizeValueType OutputBytes;
+    SizeValueType RequestedRegionPixels;
+  };
+
+  typedef std::vector< EventType > EventContainerType;
+
+  /** Enable or disable the tracing.  Enabling the tracer clears the
+   * previously recorded events. */
+  static void SetEnabled(bool enabled);
+  static bool GetEnabled();
+  static void EnabledOn() { SetEnabled(true); }
+  static void EnabledOff() { SetEnabled(false); }
+
+  /** Time in seconds since the tracer was enabled. */
+  static double GetTimeStamp();
+
+  /** Record an event, on the thread that executed it.  This is thread
+   * safe. */
+  static void AddEvent(const EventType & event);
+
+  /** Start and stop the summary probe of a filter, identified by its
+   * address and named after its class.  They are called around
+   * ProcessObject::GenerateData(). */
+  static void StartFilter(const void *object, const char *name);
+  static void StopFilter(const void *object, const char *name);
+
+  /** Copy of the recorded events. */
+  static EventContainerType GetEvents();
+
+  /** Forget the recorded events and summary probes. */
+  static void Clear();
+
+  /** Write the recorded events in the Chrome trace event format. */
+  static void WriteChromeTrace(std::ostream & os);
+
+  /** Print the wall time of the filters, accumulated per instance, and the
+   * busy time of every thread. */
+  static void Report(std::ostream & os = std::cout);
+
+private:
+  PipelineTracer();                     //purposely not implemented
+  PipelineTracer(const PipelineTracer &); //purposely not implemented
+  void operator=(const PipelineTracer &); //purposely not implemented
+
+  typedef PipelineTracer Self;
+
+  /** Name of the summary probe of a filter. */
+  static std::string GetProbeName(const void *object, const char *name);
+
+  static SimpleFastMutexLock     m_Lock;
+  static EventContainerType      m_Events;
+  static TimeProbesCollectorBase m_FilterProbes;
+  static RealTimeClock::Pointer  m_Clock;
+  static double                  m_Origin;
+};
+} // end namespace itk
+
+#endif
@@ -32,6 +32,7 @@
 #include "itkDomainThreader.h"
 #include "itkMultiThreader.h"
 #include "itkObjectFactory.h"
+#include "itkPipelineTracer.h"
 #include <vector>
 #include <map>
 #include <set>
@@ -356,8 +357,9 @@ public:
   itkGetConstReferenceMacro(ReleaseDataBeforeUpdateFlag, bool);
   itkBooleanMacro(ReleaseDataBeforeUpdateFlag);
 
-  /** Get/Set the number of threads to create when executing. */
-  itkSetClampMacro(NumberOfThreads, ThreadIdType, 1, ITK_MAX_THREADS);
+  /** Get/Set the number of threads to create when executing.  It is
+   * clamped to the range [ 1, MultiThreader::GetGlobalMaximumNumberOfThreads() ]. */
+  virtual void SetNumberOfThreads(ThreadIdType numberOfThreads);
   itkGetConstReferenceMacro(NumberOfThreads, ThreadIdType);
 
   /** Return the multithreader used by this class. */
@@ -606,6 +608,13 @@ protected:
   /** This method causes the filter to generate its output. */
   virtual void GenerateData() {}
 
+  /** Complete the PipelineTracer event recorded for an execution of
+   * GenerateData() with the size of the outputs and of their requested
+   * regions.  It is only called when the tracer is enabled.  The default
+   * implementation leaves them at zero; ImageSource reports its image
+   * outputs. */
+  virtual void AddOutputsToTraceEvent(PipelineTracer::EventType & event) const;
+
   /** Called to allocate the input array.  Copies old inputs. */
   /** Propagate a call to ResetPipeline() up the pipeline. Called only from
    * DataObject. */
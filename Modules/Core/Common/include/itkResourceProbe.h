@@ -83,10 +83,24 @@ public:
    */
   MeanType    GetMean(void) const;
 
+  /** Returns the smallest and the largest value change measured between a
+   *  start and the following stop of the probe. Stop() has to be called at
+   *  least once, they return 0 otherwise. */
+  ValueType   GetMinimum(void) const;
+  ValueType   GetMaximum(void) const;
+
+  /** Returns the standard deviation of the value changes measured between
+   *  the starts and stops of the probe. Stop() has to be called at least
+   *  twice, returns 0 otherwise. */
+  MeanType    GetStandardDeviation(void) const;
+
 private:
 
   ValueType m_StartValue;
   ValueType m_TotalValue;
+  ValueType m_MinimumValue;
+  ValueType m_MaximumValue;
+  MeanType  m_SumOfSquares;
 
   CountType m_NumberOfStarts;
   CountType m_NumberOfStops;
@@ -30,6 +30,7 @@
 
 #include "itkResourceProbe.h"
 #include "itkNumericTraits.h"
+#include <cmath>
 
 namespace itk
 {
@@ -40,6 +41,9 @@ ResourceProbe< ValueType, MeanType >
   m_TypeString(type), m_UnitString(unit)
 {
   this->m_TotalValue      = NumericTraits< ValueType >::ZeroValue();
+  this->m_MinimumValue    = NumericTraits< ValueType >::ZeroValue();
+  this->m_MaximumValue    = NumericTraits< ValueType >::ZeroValue();
+  this->m_SumOfSquares    = NumericTraits< MeanType >::ZeroValue();
   this->m_StartValue      = NumericTraits< ValueType >::ZeroValue();
   this->m_NumberOfStarts  = NumericTraits< CountType >::ZeroValue();
   this->m_NumberOfStops   = NumericTraits< CountType >::ZeroValue();
@@ -89,7 +93,17 @@ ResourceProbe< ValueType, MeanType >
     {
     itkGenericExceptionMacro(<< "Can't stop a probe that has not been started.");
     }
-  this->m_TotalValue += this->GetInstantValue() - this->m_StartValue;
+  const ValueType change = this->GetInstantValue() - this->m_StartValue;
+  if ( this->m_NumberOfStops == 0 || change < this->m_MinimumValue )
+    {
+    this->m_MinimumValue = change;
+    }
+  if ( this->m_NumberOfStops == 0 || change > this->m_MaximumValue )
+    {
+    this->m_MaximumValue = change;
+    }
+  this->m_TotalValue += change;
+  this->m_SumOfSquares += static_cast< MeanType >( change ) * static_cast< MeanType >( change );
   this->m_NumberOfStops++;
 }
 
@@ -135,6 +149,47 @@ ResourceProbe< ValueType, MeanType >
 
   return meanValue;
 }
+
+/** Get Minimum */
+template< class ValueType, class MeanType >
+ValueType
+ResourceProbe< ValueType, MeanType >
+::GetMinimum(void) const
+{
+  return this->m_MinimumValue;
+}
+
+/** Get Maximum */
+template< class ValueType, class MeanType >
+ValueType
+ResourceProbe< ValueType, MeanType >
+::GetMaximum(void) const
+{
+  return this->m_MaximumValue;
+}
+
+/** Get Standard Deviation */
+template< class ValueType, class MeanType >
+MeanType
+ResourceProbe< ValueType, MeanType >
+::GetStandardDeviation(void) const
+{
+  MeanType stdValue = NumericTraits< MeanType >::ZeroValue();
+
+  if ( this->m_NumberOfStops > 1 )
+    {
+    const MeanType n = static_cast< MeanType >( this->m_NumberOfStops );
+    const MeanType mean = this->GetMean();
+    // Sample variance, computed from the running sums.
+    const MeanType variance = ( this->m_SumOfSquares - n * mean * mean ) / ( n - 1 );
+    if ( variance > NumericTraits< MeanType >::ZeroValue() )
+      {
+      stdValue = static_cast< MeanType >( std::sqrt( static_cast< double >( variance ) ) );
+      }
+    }
+
+  return stdValue;
+}
 } // end namespace itk
 
 #endif
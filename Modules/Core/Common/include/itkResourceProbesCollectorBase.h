@@ -54,6 +54,17 @@ public:
   /** Report the summary of results from the probes */
   virtual void Report(std::ostream & os = std::cout) const;
 
+  /** Report the summary of results from the probes as a JSON object, so
+   * that the measurements can be compared across builds or runs by
+   * external tools.  The object holds the type and unit of the probes and
+   * an array with, for each probe, its name, number of starts and stops,
+   * and the total, mean, minimum, maximum and standard deviation of the
+   * measured values. */
+  virtual void JSONReport(std::ostream & os = std::cout) const;
+
+  /** Write a string as a quoted and escaped JSON string. */
+  static void JSONWriteString(std::ostream & os, const std::string & str);
+
   /** Destroy the set of probes. New probes can be created after invoking this
     method. */
   virtual void Clear(void);
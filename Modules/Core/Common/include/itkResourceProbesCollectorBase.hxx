@@ -20,6 +20,7 @@
 
 #include "itkResourceProbesCollectorBase.h"
 #include <iostream>
+#include <limits>
 
 namespace itk
 {
@@ -93,6 +94,93 @@ ResourceProbesCollectorBase< TProbe >
     }
 }
 
+template< class TProbe >
+void
+ResourceProbesCollectorBase< TProbe >
+::JSONReport(std::ostream & os) const
+{
+  typename MapType::const_iterator probe = this->m_Probes.begin();
+  typename MapType::const_iterator end   = this->m_Probes.end();
+
+  // Keep enough digits for the values to round trip.
+  const std::streamsize precision = os.precision( std::numeric_limits< double >::digits10 + 2 );
+
+  os << "{" << std::endl;
+  if ( probe != end )
+    {
+    os << "  \"Type\": ";
+    this->JSONWriteString( os, probe->second.GetType() );
+    os << "," << std::endl;
+    os << "  \"Unit\": ";
+    this->JSONWriteString( os, probe->second.GetUnit() );
+    os << "," << std::endl;
+    }
+  os << "  \"Probes\": [";
+
+  bool first = true;
+  while ( probe != end )
+    {
+    os << ( first ? "" : "," ) << std::endl;
+    first = false;
+    os << "    {" << std::endl;
+    os << "      \"Name\": ";
+    this->JSONWriteString(os, probe->first);
+    os << "," << std::endl;
+    os << "      \"Starts\": " << probe->second.GetNumberOfStarts() << "," << std::endl;
+    os << "      \"Stops\": " << probe->second.GetNumberOfStops() << "," << std::endl;
+    os << "      \"Total\": " << probe->second.GetTotal() << "," << std::endl;
+    os << "      \"Mean\": " << probe->second.GetMean() << "," << std::endl;
+    os << "      \"Minimum\": " << probe->second.GetMinimum() << "," << std::endl;
+    os << "      \"Maximum\": " << probe->second.GetMaximum() << "," << std::endl;
+    os << "      \"StandardDeviation\": " << probe->second.GetStandardDeviation() << std::endl;
+    os << "    }";
+    probe++;
+    }
+  os << std::endl << "  ]" << std::endl;
+  os << "}" << std::endl;
+
+  os.precision(precision);
+}
+
+template< class TProbe >
+void
+ResourceProbesCollectorBase< TProbe >
+::JSONWriteString(std::ostream & os, const std::string & str)
+{
+  os << '"';
+  for ( std::string::const_iterator it = str.begin(); it != str.end(); ++it )
+    {
+    const unsigned char c = static_cast< unsigned char >( *it );
+    switch ( c )
+      {
+      case '"':
+        os << "\\\"";
+        break;
+      case '\\':
+        os << "\\\\";
+        break;
+      case '\n':
+        os << "\\n";
+        break;
+      case '\t':
+        os << "\\t";
+        break;
+      default:
+        if ( c < 0x20 )
+          {
+          // Other control characters are written as unicode escapes.
+          const char *hex = "0123456789abcdef";
+          os << "\\u00" << hex[c >> 4] << hex[c & 0xf];
+          }
+        else
+          {
+          os << *it;
+          }
+      }
+    }
+  os << '"';
+}
+
 template< class TProbe >
 void
 ResourceProbesCollectorBase< TProbe >
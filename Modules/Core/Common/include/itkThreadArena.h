@@ -0,0 +1,156 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkThreadArena_h
+#define __itkThreadArena_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkSimpleFastMutexLock.h"
+#include "itkIntTypes.h"
+
+namespace itk
+{
+/** \class ThreadArena
+ * \brief A budget of threads shared by nested and concurrent executions.
+ *
+ * Every MultiThreader::SingleMethodExecute() running in an arena asks the
+ * arena for the threads it wants to add to the calling thread, and only
+ * gets the threads that are still available in the budget.  When the
+ * budget is exhausted the execution proceeds with fewer threads, down to
+ * the calling thread alone.  This bounds the number of threads working
+ * on behalf of the arena, whatever the nesting of the executions (a
+ * threaded metric evaluated from a threaded optimizer, the filters of a
+ * mini-pipeline run from a threaded filter) or the number of pipelines
+ * updated at the same time.
+ *
+ * The threads of an execution belong to the arena of that execution, so
+ * that the executions nested in the threaded method share the same
+ * budget.  The arena of an execution is, in order of precedence, the one
+ * set with MultiThreader::SetThreadArena(), the arena of the calling
+ * thread (see Scope), and MultiThreader::GetGlobalDefaultThreadArena().
+ * Without arena, the threads requested by every execution are created.
+ *
+ * Several pipelines can be given separate shares of the machine by
+ * updating each of them in the Scope of its own arena:
+ *
+ * \code
+ * itk::ThreadArena::Pointer arena = itk::ThreadArena::New();
+ * arena->SetMaximumNumberOfThreads( 4 );
+ * {
+ *   itk::ThreadArena::Scope scope( arena );
+ *   filter->Update();
+ * }
+ * \endcode
+ *
+ * Because the number of threads of an execution can be lower than
+ * requested, a threaded method has to rely on
+ * ThreadInfoStruct::NumberOfThreads.  Methods that synchronize a fixed
+ * number of threads (e.g. with a Barrier) must be executed with
+ * MultiThreader::ExactNumberOfThreadsOn(): they then run all their
+ * threads, beyond the budget of the arena if needed.
+ *
+ * \sa MultiThreader
+ * \ingroup OSSystemObjects
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT ThreadArena:public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef ThreadArena                Self;
+  typedef Object                     Superclass;
+  typedef SmartPointer< Self >       Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ThreadArena, Object);
+
+  /** Set/Get the maximum number of threads working concurrently in the
+   * arena.  It is clamped to be at least 1, and defaults to
+   * MultiThreader::GetGlobalDefaultNumberOfThreads().  Threads entering
+   * the arena to execute a method are always admitted, so that the number
+   * of working threads can exceed the maximum by the number of threads
+   * entering the arena concurrently from the outside. */
+  void SetMaximumNumberOfThreads(ThreadIdType numberOfThreads);
+  ThreadIdType GetMaximumNumberOfThreads() const;
+
+  /** Number of threads currently working in the arena. */
+  ThreadIdType GetNumberOfActiveThreads() const;
+
+  /** Reserve up to the given number of additional threads, and return the
+   * number that was granted.  The granted threads must be returned with
+   * ReleaseThreads(). */
+  ThreadIdType AcquireThreads(ThreadIdType numberOfThreads);
+
+  /** Return threads obtained from AcquireThreads(). */
+  void ReleaseThreads(ThreadIdType numberOfThreads);
+
+  /** Count a thread entering the arena from the outside as working in
+   * the arena, even when the budget is exhausted, and uncount it when it
+   * leaves. */
+  void EnterThread();
+  void LeaveThread();
+
+  /** Return the arena of the calling thread, or NULL when the calling
+   * thread is not working for any arena. */
+  static ThreadArena * GetCurrentThreadArena();
+
+  /** Set the arena of the calling thread.  The arena is not registered:
+   * the caller must keep it alive while it is current, and should rather
+   * use a Scope. */
+  static void SetCurrentThreadArena(ThreadArena *arena);
+
+  /** \class Scope
+   * \brief Make an arena the arena of the calling thread.
+   *
+   * The calling thread enters the arena on construction, and leaves it,
+   * restoring its previous arena, on destruction.
+   * \ingroup ITKCommon
+   */
+  class ITKCommon_EXPORT Scope
+  {
+  public:
+    Scope(ThreadArena *arena);
+    ~Scope();
+
+  private:
+    Scope(const Scope &);          //purposely not implemented
+    void operator=(const Scope &); //purposely not implemented
+
+    ThreadArena::Pointer m_Arena;
+    ThreadArena *        m_PreviousArena;
+  };
+
+protected:
+  ThreadArena();
+  ~ThreadArena();
+  void PrintSelf(std::ostream & os, Indent indent) const;
+
+private:
+  ThreadArena(const Self &);    //purposely not implemented
+  void operator=(const Self &); //purposely not implemented
+
+  mutable SimpleFastMutexLock m_Mutex;
+  ThreadIdType                m_MaximumNumberOfThreads;
+  ThreadIdType                m_NumberOfActiveThreads;
+};
+}  // end namespace itk
+#endif
@@ -0,0 +1,214 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkThreadPool_h
+#define __itkThreadPool_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkConditionVariable.h"
+#include "itkSimpleFastMutexLock.h"
+#include "itkThreadSupport.h"
+#include "itkIntTypes.h"
+
+#include <deque>
+#include <vector>
+
+namespace itk
+{
+/** \class ThreadPool
+ * \brief A process-wide pool of persistent worker threads.
+ *
+ * ThreadPool keeps a set of worker threads alive for the lifetime of the
+ * process so that MultiThreader::SingleMethodExecute() and
+ * MultiThreader::MultipleMethodExecute() do not have to create and join
+ * operating system threads on every call.  This matters for pipelines
+ * made of many short filters running on small images, where thread
+ * creation otherwise represents a significant share of the execution time.
+ *
+ * Every worker owns a double ended job queue.  Submitted jobs are
+ * distributed over the queues in a round robin fashion; a worker takes
+ * jobs from the back of its own queue and, when that queue is empty,
+ * steals jobs from the front of the queues of the other workers.  Queue
+ * operations are short and serialized by a single lock, which keeps the
+ * implementation portable to every threading library supported by ITK.
+ *
+ * Jobs are submitted as part of a JobGroup.  The submitting thread waits
+ * for the completion of the group with WaitForJobs(), and executes queued
+ * jobs itself while the group is not finished.  Because of this, a job
+ * running on a worker may itself submit and wait for jobs (nested
+ * parallelism) without exhausting the pool.
+ *
+ * The number of workers grows on demand to satisfy the largest request
+ * issued through AddWorkThreads(), or can be set explicitly with
+ * SetNumberOfWorkThreads().  Growing the pool adds workers next to the
+ * running ones, so it is safe from within a job.  The pool only shrinks
+ * when no job is running; a smaller number of workers requested while
+ * jobs run is ignored.  Optionally the workers can be pinned to
+ * processor cores with SetThreadAffinity(), on platforms supporting it.
+ *
+ * ThreadPool is a singleton, accessed through GetInstance().
+ *
+ * \sa MultiThreader
+ * \ingroup OSSystemObjects
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT ThreadPool:public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef ThreadPool                 Self;
+  typedef Object                     Superclass;
+  typedef SmartPointer< Self >       Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ThreadPool, Object);
+
+  /** Return the singleton instance of the pool, creating it on first use. */
+  static Pointer GetInstance();
+
+  /** This is a singleton pattern New.  There will only be ONE reference to
+   * a ThreadPool object per process.  Clients that call this must call
+   * Delete on the object so that the reference counting will work. */
+  static Pointer New();
+
+  /** \class JobGroup
+   * \brief Set of jobs whose completion is waited for collectively.
+   *
+   * A JobGroup is typically allocated on the stack of the submitting
+   * thread, used with AddJob() and then passed to WaitForJobs().  It must
+   * outlive the jobs submitted with it.
+   * \ingroup ITKCommon
+   */
+  class ITKCommon_EXPORT JobGroup
+  {
+  public:
+    JobGroup();
+    ~JobGroup();
+
+    /** Number of jobs of the group that did not complete yet. */
+    SizeValueType GetNumberOfPendingJobs() const;
+
+  private:
+    JobGroup(const JobGroup &);     //purposely not implemented
+    void operator=(const JobGroup &); //purposely not implemented
+
+    friend class ThreadPool;
+
+    SizeValueType              m_PendingJobs;
+    mutable SimpleMutexLock    m_Mutex;
+    ConditionVariable::Pointer m_Condition;
+  };
+
+  /** Queue the execution of function( data ) on one of the workers, as
+   * part of the given group. */
+  void AddJob(ThreadFunctionType function, void *data, JobGroup & group);
+
+  /** Block until every job of the group completed.  The calling thread
+   * executes queued jobs while it waits. */
+  void WaitForJobs(JobGroup & group);
+
+  /** Make sure that at least the given number of workers are running. */
+  void AddWorkThreads(ThreadIdType count);
+
+  /** Set/Get the number of persistent workers.  A larger number adds
+   * workers.  A smaller number stops and restarts the workers when no job
+   * is running, and is ignored otherwise; queued jobs are preserved. */
+  void SetNumberOfWorkThreads(ThreadIdType count);
+  ThreadIdType GetNumberOfWorkThreads() const;
+
+  /** Set/Get whether each worker is pinned to a processor core.  It is
+   * ignored on platforms that do not support thread affinity.  The running
+   * workers are only restarted with the new placement when no job is
+   * running. */
+  void SetThreadAffinity(bool affinity);
+  itkGetConstMacro(ThreadAffinity, bool);
+  itkBooleanMacro(ThreadAffinity);
+
+  /** Number of jobs currently waiting in the queues. */
+  SizeValueType GetNumberOfQueuedJobs() const;
+
+protected:
+  ThreadPool();
+  ~ThreadPool();
+  void PrintSelf(std::ostream & os, Indent indent) const;
+
+private:
+  ThreadPool(const Self &);     //purposely not implemented
+  void operator=(const Self &); //purposely not implemented
+
+  struct JobType {
+    ThreadFunctionType Function;
+    void *             UserData;
+    JobGroup *         Group;
+  };
+
+  typedef std::deque< JobType > JobQueueType;
+
+  /** Per worker bookkeeping passed to the worker entry point. */
+  struct WorkerType {
+    ThreadPool *        Pool;
+    ThreadIdType        Index;
+    ThreadProcessIDType ProcessID;
+  };
+
+  /** Pop a job from the queue of the given worker, or steal one from
+   * another worker. */
+  bool PopJob(ThreadIdType preferredQueue, JobType & job, bool worker);
+
+  /** Run a job and signal its group on completion. */
+  void ExecuteJob(const JobType & job);
+
+  /** Entry point of the worker threads. */
+  static ITK_THREAD_RETURN_TYPE WorkerMain(void *arg);
+
+  /** Start the workers of index first to count - 1. */
+  void StartWorkers(ThreadIdType first, ThreadIdType count);
+
+  /** Stop and join every worker.  When onlyIfIdle is true, nothing is
+   * done while a job is running, and false is returned. */
+  bool StopWorkers(bool onlyIfIdle);
+
+  /** Platform specific thread management. */
+  static ThreadProcessIDType CreateWorkerThread(WorkerType *worker);
+  static void JoinWorkerThread(ThreadProcessIDType id);
+  static void SetWorkerThreadAffinity(ThreadProcessIDType id, ThreadIdType core);
+  static bool PlatformSupportsWorkThreads();
+
+  std::vector< JobQueueType > m_Queues;
+  std::vector< WorkerType * > m_Workers;
+
+  /** Protects the queues, the worker list, the counters and the wake up
+   * condition.  It is only held for the duration of queue operations. */
+  mutable SimpleMutexLock    m_Mutex;
+  ConditionVariable::Pointer m_WakeUp;
+
+  /** Serializes changes of the number of workers. */
+  SimpleMutexLock m_ResizeMutex;
+
+  long         m_NumberOfQueuedJobs;
+  long         m_NumberOfRunningJobs;
+  ThreadIdType m_NextQueue;
+  bool         m_StopWorkers;
+  bool         m_ThreadAffinity;
+
+  static Pointer             m_Instance;
+  static SimpleFastMutexLock m_InstanceLock;
+};
+}  // end namespace itk
+#endif
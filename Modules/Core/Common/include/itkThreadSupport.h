@@ -40,6 +40,11 @@
 namespace itk
 {
   /** Platform specific typedefs for simple types
+   *
+   * ITK_MAX_THREADS is not a hard limit: the per thread storage of
+   * MultiThreader is allocated at run time, and ITK_MAX_THREADS is only
+   * the lower bound of the initial value of
+   * MultiThreader::GetGlobalMaximumNumberOfThreads().
    */
 #if defined(ITK_USE_PTHREADS)
 #define ITK_MAX_THREADS              128
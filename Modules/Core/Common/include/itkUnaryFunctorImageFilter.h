@@ -20,6 +20,7 @@
 
 #include "itkInPlaceImageFilter.h"
 #include "itkImageRegionIteratorWithIndex.h"
+#include "itkIsSame.h"
 
 namespace itk
 {
@@ -35,6 +36,12 @@ namespace itk
  * UnaryFunctorImageFilter (like the CastImageFilter) can be used
  * to promote a 2D image to a 3D image, etc.
  *
+ * When the input and the output have the same dimension and their pixels
+ * are stored as is in their buffers (not for ImageAdaptor or VectorImage),
+ * the functor is applied in plain loops over the contiguous spans of the
+ * buffers, which compilers can vectorize.  Otherwise the pixels are
+ * visited with image iterators.
+ *
  * \sa BinaryFunctorImageFilter TernaryFunctorImageFilter
  *
  * \ingroup   IntensityImageFilters     MultiThreaded
@@ -126,6 +133,28 @@ private:
   UnaryFunctorImageFilter(const Self &); //purposely not implemented
   void operator=(const Self &);          //purposely not implemented
 
+  /** Whether the pixels of the images are the values stored in their
+   * buffers. */
+  typedef typename IsSame< typename InputImageType::AccessorType,
+                           DefaultPixelAccessor< InputImagePixelType > >::Type  InputBufferIsPixelsType;
+  typedef typename IsSame< typename OutputImageType::AccessorType,
+                           DefaultPixelAccessor< OutputImagePixelType > >::Type OutputBufferIsPixelsType;
+
+  /** Apply the functor over the contiguous spans of the buffers.  Return
+   * false, without processing any pixel, when the regions do not allow
+   * it. */
+  bool BufferThreadedGenerateData(const InputImageRegionType & inputRegionForThread,
+                                  const OutputImageRegionType & outputRegionForThread,
+                                  ThreadIdType threadId, TrueType, TrueType);
+
+  template< class TInputBufferIsPixels, class TOutputBufferIsPixels >
+  bool BufferThreadedGenerateData(const InputImageRegionType &,
+                                  const OutputImageRegionType &,
+                                  ThreadIdType, TInputBufferIsPixels, TOutputBufferIsPixels)
+  {
+    return false;
+  }
+
   FunctorType m_Functor;
 };
 } // end namespace itk
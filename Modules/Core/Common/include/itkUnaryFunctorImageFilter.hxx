@@ -20,6 +20,7 @@
 
 #include "itkUnaryFunctorImageFilter.h"
 #include "itkImageRegionIterator.h"
+#include "itkImageScanlineIterator.h"
 #include "itkProgressReporter.h"
 
 namespace itk
@@ -161,22 +162,133 @@ UnaryFunctorImageFilter< TInputImage, TOutputImage, TFunction >
 
   this->CallCopyOutputRegionToInputRegion(inputRegionForThread, outputRegionForThread);
 
+  if ( this->BufferThreadedGenerateData( inputRegionForThread, outputRegionForThread, threadId,
+                                         InputBufferIsPixelsType(), OutputBufferIsPixelsType() ) )
+    {
+    return;
+    }
+
+  const typename OutputImageRegionType::SizeType & regionSize = outputRegionForThread.GetSize();
+  if ( regionSize[0] == 0 )
+    {
+    return;
+    }
+  const SizeValueType numberOfLinesToProcess = outputRegionForThread.GetNumberOfPixels() / regionSize[0];
+
   // Define the iterators
-  ImageRegionConstIterator< TInputImage > inputIt(inputPtr, inputRegionForThread);
-  ImageRegionIterator< TOutputImage >     outputIt(outputPtr, outputRegionForThread);
+  ImageScanlineConstIterator< TInputImage > inputIt(inputPtr, inputRegionForThread);
+  ImageScanlineIterator< TOutputImage >     outputIt(outputPtr, outputRegionForThread);
 
-  ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
+  ProgressReporter progress( this, threadId, numberOfLinesToProcess );
 
   inputIt.GoToBegin();
   outputIt.GoToBegin();
 
   while ( !inputIt.IsAtEnd() )
     {
-    outputIt.Set( m_Functor( inputIt.Get() ) );
-    ++inputIt;
-    ++outputIt;
+    while ( !inputIt.IsAtEndOfLine() )
+      {
+      outputIt.Set( m_Functor( inputIt.Get() ) );
+      ++inputIt;
+      ++outputIt;
+      }
+    inputIt.NextLine();
+    outputIt.NextLine();
+    progress.CompletedPixel();  // potential exception thrown here
+    }
+}
+
+template< class TInputImage, class TOutputImage, class TFunction  >
+bool
+UnaryFunctorImageFilter< TInputImage, TOutputImage, TFunction >
+::BufferThreadedGenerateData(const InputImageRegionType & inputRegionForThread,
+                             const OutputImageRegionType & outputRegionForThread,
+                             ThreadIdType threadId, TrueType, TrueType)
+{
+  const unsigned int ImageDimension = OutputImageType::ImageDimension;
+
+  if ( static_cast< unsigned int >( InputImageType::ImageDimension ) != ImageDimension )
+    {
+    return false;
+    }
+
+  InputImagePointer  inputPtr = this->GetInput();
+  OutputImagePointer outputPtr = this->GetOutput(0);
+
+  const typename InputImageRegionType::SizeType &  inputSize = inputRegionForThread.GetSize();
+  const typename OutputImageRegionType::SizeType & size = outputRegionForThread.GetSize();
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    if ( inputSize[d] != size[d] )
+      {
+      return false;
+      }
+    }
+
+  const SizeValueType numberOfPixels = outputRegionForThread.GetNumberOfPixels();
+  if ( numberOfPixels == 0 )
+    {
+    return true;
+    }
+
+  // The span extends over the next dimension as long as the region covers
+  // the whole buffered region of both images in the previous ones.
+  const typename InputImageRegionType::SizeType &  inputBufferSize =
+    inputPtr->GetBufferedRegion().GetSize();
+  const typename OutputImageRegionType::SizeType & outputBufferSize =
+    outputPtr->GetBufferedRegion().GetSize();
+  SizeValueType spanLength = size[0];
+  unsigned int  firstOuterDimension = 1;
+  while ( firstOuterDimension < ImageDimension
+          && size[firstOuterDimension - 1] == inputBufferSize[firstOuterDimension - 1]
+          && size[firstOuterDimension - 1] == outputBufferSize[firstOuterDimension - 1] )
+    {
+    spanLength *= size[firstOuterDimension];
+    ++firstOuterDimension;
+    }
+  const SizeValueType numberOfSpans = numberOfPixels / spanLength;
+
+  ProgressReporter progress( this, threadId, numberOfSpans );
+
+  // A local copy of the functor lets the compiler keep its members in
+  // registers, as they cannot alias the output buffer.
+  FunctorType functor = m_Functor;
+
+  const typename InputImageRegionType::IndexType &  inputStart = inputRegionForThread.GetIndex();
+  const typename OutputImageRegionType::IndexType & outputStart = outputRegionForThread.GetIndex();
+  typename InputImageRegionType::IndexType  inputIndex = inputStart;
+  typename OutputImageRegionType::IndexType outputIndex = outputStart;
+
+  const InputImagePixelType *inputBuffer = inputPtr->GetBufferPointer();
+  OutputImagePixelType *     outputBuffer = outputPtr->GetBufferPointer();
+
+  for ( SizeValueType span = 0; span < numberOfSpans; ++span )
+    {
+    const InputImagePixelType *in = inputBuffer + inputPtr->ComputeOffset(inputIndex);
+    OutputImagePixelType *     out = outputBuffer + outputPtr->ComputeOffset(outputIndex);
+
+    for ( SizeValueType i = 0; i < spanLength; ++i )
+      {
+      out[i] = functor(in[i]);
+      }
+
+    // move to the start of the next span
+    for ( unsigned int d = firstOuterDimension; d < ImageDimension; ++d )
+      {
+      ++inputIndex[d];
+      ++outputIndex[d];
+      if ( static_cast< SizeValueType >( outputIndex[d] - outputStart[d] ) < size[d] )
+        {
+        break;
+        }
+      inputIndex[d] = inputStart[d];
+      outputIndex[d] = outputStart[d];
+      }
+
     progress.CompletedPixel();  // potential exception thrown here
     }
+
+  return true;
 }
 } // end namespace itk
 
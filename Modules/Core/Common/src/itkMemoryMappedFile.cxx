@@ -0,0 +1,187 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkMemoryMappedFile.h"
+
+#if defined( WIN32 ) || defined( _WIN32 )
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace itk
+{
+MemoryMappedFile::MemoryMappedFile():
+  m_Data(0),
+  m_Length(0),
+  m_MappingAddress(0),
+  m_MappingLength(0),
+  m_MappingHandle(0)
+{}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+  this->Unmap();
+}
+
+#if defined( WIN32 ) || defined( _WIN32 )
+
+bool
+MemoryMappedFile
+::Map(const std::string & fileName, SizeValueType offset, SizeValueType length)
+{
+  this->Unmap();
+
+  if ( length == 0 )
+    {
+    return false;
+    }
+
+  HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if ( file == INVALID_HANDLE_VALUE )
+    {
+    return false;
+    }
+
+  LARGE_INTEGER fileSize;
+  if ( !GetFileSizeEx(file, &fileSize)
+       || static_cast< ::itk::uint64_t >( fileSize.QuadPart ) < offset
+       || static_cast< ::itk::uint64_t >( fileSize.QuadPart ) - offset < length )
+    {
+    CloseHandle(file);
+    return false;
+    }
+
+  // The mapping object keeps its own reference to the file.
+  HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+  CloseHandle(file);
+  if ( mapping == NULL )
+    {
+    return false;
+    }
+
+  // Views must start on a multiple of the allocation granularity.
+  SYSTEM_INFO systemInfo;
+  GetSystemInfo(&systemInfo);
+  const SizeValueType shift = offset % systemInfo.dwAllocationGranularity;
+  const ::itk::uint64_t viewOffset = offset - shift;
+
+  void *address = MapViewOfFile( mapping, FILE_MAP_COPY,
+                                 static_cast< DWORD >( viewOffset >> 32 ),
+                                 static_cast< DWORD >( viewOffset & 0xFFFFFFFF ),
+                                 static_cast< SIZE_T >( length + shift ) );
+  if ( address == NULL )
+    {
+    CloseHandle(mapping);
+    return false;
+    }
+
+  m_MappingHandle = mapping;
+  m_MappingAddress = address;
+  m_MappingLength = length + shift;
+  m_Data = static_cast< char * >( address ) + shift;
+  m_Length = length;
+  return true;
+}
+
+void
+MemoryMappedFile
+::Unmap()
+{
+  if ( m_MappingAddress )
+    {
+    UnmapViewOfFile(m_MappingAddress);
+    CloseHandle( static_cast< HANDLE >( m_MappingHandle ) );
+    }
+  m_Data = 0;
+  m_Length = 0;
+  m_MappingAddress = 0;
+  m_MappingLength = 0;
+  m_MappingHandle = 0;
+}
+
+#else
+
+bool
+MemoryMappedFile
+::Map(const std::string & fileName, SizeValueType offset, SizeValueType length)
+{
+  this->Unmap();
+
+  if ( length == 0 )
+    {
+    return false;
+    }
+
+  const int file = open(fileName.c_str(), O_RDONLY);
+  if ( file < 0 )
+    {
+    return false;
+    }
+
+  // Touching a page past the end of the file raises SIGBUS, so a
+  // truncated file must be rejected here.
+  struct stat fileStatus;
+  if ( fstat(file, &fileStatus) != 0
+       || static_cast< ::itk::uint64_t >( fileStatus.st_size ) < offset
+       || static_cast< ::itk::uint64_t >( fileStatus.st_size ) - offset < length )
+    {
+    close(file);
+    return false;
+    }
+
+  // Mappings must start on a page boundary.
+  const SizeValueType pageSize = static_cast< SizeValueType >( sysconf(_SC_PAGESIZE) );
+  const SizeValueType shift = offset % pageSize;
+
+  void *address = mmap(0, length + shift, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                       file, static_cast< off_t >( offset - shift ) );
+  // The mapping keeps its own reference to the file.
+  close(file);
+  if ( address == MAP_FAILED )
+    {
+    return false;
+    }
+
+  m_MappingAddress = address;
+  m_MappingLength = length + shift;
+  m_Data = static_cast< char * >( address ) + shift;
+  m_Length = length;
+  return true;
+}
+
+void
+MemoryMappedFile
+::Unmap()
+{
+  if ( m_MappingAddress )
+    {
+    munmap(m_MappingAddress, m_MappingLength);
+    }
+  m_Data = 0;
+  m_Length = 0;
+  m_MappingAddress = 0;
+  m_MappingLength = 0;
+  m_MappingHandle = 0;
+}
+
+#endif
+} // end namespace itk
@@ -26,6 +26,7 @@
  *
  *=========================================================================*/
 #include "itkMultiThreader.h"
+#include "itkThreadPool.h"
 #include "itkNumericTraits.h"
 #include <iostream>
 
@@ -41,20 +42,127 @@
 
 namespace itk
 {
-// Initialize static member that controls global maximum number of threads.
-ThreadIdType MultiThreader:: m_GlobalMaximumNumberOfThreads = ITK_MAX_THREADS;
+namespace
+{
+// Reserves the threads of an execution in an arena for the duration of the
+// execution. The calling thread enters the arena if it is not already
+// working for it, so that the executions nested in the threaded method
+// find the arena as the arena of their calling thread.
+class ThreadArenaExecution
+{
+public:
+  ThreadArenaExecution(ThreadArena *arena, ThreadIdType numberOfThreads, bool exact):
+    m_Arena(arena),
+    m_PreviousArena( ThreadArena::GetCurrentThreadArena() ),
+    m_Entered(false),
+    m_GrantedThreads(0),
+    m_NumberOfThreads(numberOfThreads)
+  {
+    if ( m_Arena )
+      {
+      if ( m_PreviousArena != m_Arena )
+        {
+        m_Arena->EnterThread();
+        ThreadArena::SetCurrentThreadArena(m_Arena);
+        m_Entered = true;
+        }
+      m_GrantedThreads = m_Arena->AcquireThreads(numberOfThreads - 1);
+      // An exact execution runs all its threads, beyond the budget if
+      // needed.
+      if ( !exact )
+        {
+        m_NumberOfThreads = m_GrantedThreads + 1;
+        }
+      }
+  }
+
+  ~ThreadArenaExecution()
+  {
+    if ( m_Arena )
+      {
+      m_Arena->ReleaseThreads(m_GrantedThreads);
+      if ( m_Entered )
+        {
+        ThreadArena::SetCurrentThreadArena(m_PreviousArena);
+        m_Arena->LeaveThread();
+        }
+      }
+  }
+
+  ThreadIdType GetNumberOfThreads() const
+  {
+    return m_NumberOfThreads;
+  }
+
+private:
+  ThreadArena::Pointer m_Arena;
+  ThreadArena *        m_PreviousArena;
+  bool                 m_Entered;
+  ThreadIdType         m_GrantedThreads;
+  ThreadIdType         m_NumberOfThreads;
+};
+}
+
+// Initialize static member that controls global maximum number of threads : 0
+// => Not initialized.
+ThreadIdType MultiThreader:: m_GlobalMaximumNumberOfThreads = 0;
 
 // Initialize static member that controls global default number of threads : 0
 // => Not initialized.
 ThreadIdType MultiThreader:: m_GlobalDefaultNumberOfThreads = 0;
 
+// Initialize static members that control the global default use of the
+// thread pool.
+bool MultiThreader:: m_GlobalDefaultUseThreadPool = false;
+bool MultiThreader:: m_GlobalDefaultUseThreadPoolIsInitialized = false;
+
+// Initialize static member that controls the default arena : NULL
+// => the executions are not bounded.
+ThreadArena::Pointer MultiThreader:: m_GlobalDefaultThreadArena;
+
+void MultiThreader::SetGlobalDefaultThreadArena(ThreadArena *arena)
+{
+  m_GlobalDefaultThreadArena = arena;
+}
+
+ThreadArena * MultiThreader::GetGlobalDefaultThreadArena()
+{
+  return m_GlobalDefaultThreadArena.GetPointer();
+}
+
+void MultiThreader::SetGlobalDefaultUseThreadPool(bool useThreadPool)
+{
+  m_GlobalDefaultUseThreadPool = useThreadPool;
+  m_GlobalDefaultUseThreadPoolIsInitialized = true;
+}
+
+bool MultiThreader::GetGlobalDefaultUseThreadPool()
+{
+  if ( !m_GlobalDefaultUseThreadPoolIsInitialized )
+    {
+    // The ITK_USE_THREADPOOL environment variable allows to switch existing
+    // applications to the thread pool without recompiling them.
+    itksys_stl::string useThreadPoolEnv;
+    if ( itksys::SystemTools::GetEnv("ITK_USE_THREADPOOL", useThreadPoolEnv) )
+      {
+      useThreadPoolEnv = itksys::SystemTools::UpperCase(useThreadPoolEnv);
+      m_GlobalDefaultUseThreadPool = ( useThreadPoolEnv == "1"
+                                       || useThreadPoolEnv == "ON"
+                                       || useThreadPoolEnv == "YES"
+                                       || useThreadPoolEnv == "TRUE" );
+      }
+    m_GlobalDefaultUseThreadPoolIsInitialized = true;
+    }
+  return m_GlobalDefaultUseThreadPool;
+}
+
 void MultiThreader::SetGlobalMaximumNumberOfThreads(ThreadIdType val)
 {
   m_GlobalMaximumNumberOfThreads = val;
 
-  // clamp between 1 and ITK_MAX_THREADS
+  // clamp between 1 and the limit of the threading library
   m_GlobalMaximumNumberOfThreads = std::min( m_GlobalMaximumNumberOfThreads,
-                                             (ThreadIdType) ITK_MAX_THREADS );
+                                             GetThreadingLibraryMaximumNumberOfThreads() );
   m_GlobalMaximumNumberOfThreads = std::max( m_GlobalMaximumNumberOfThreads,
                                              NumericTraits<ThreadIdType>::One );
 
@@ -63,8 +171,34 @@ void MultiThreader::SetGlobalMaximumNumberOfThreads(ThreadIdType val)
                                               m_GlobalMaximumNumberOfThreads);
 }
 
+// The per thread storage is allocated at run time, so this bound only
+// protects against unreasonable requests (for instance a negative int
+// converted to ThreadIdType) that would exhaust the memory. It allows a
+// large oversubscription of the processors of the machine.
+ThreadIdType MultiThreader::GetThreadingLibraryMaximumNumberOfThreads()
+{
+#if defined(ITK_USE_PTHREADS) || defined(ITK_USE_WIN32_THREADS)
+  const ThreadIdType oversubscription = 16;
+  return oversubscription * std::max( static_cast< ThreadIdType >( ITK_MAX_THREADS ),
+                                      GetGlobalDefaultNumberOfThreadsByPlatform() );
+#else
+  return 1;
+#endif
+}
+
 ThreadIdType MultiThreader::GetGlobalMaximumNumberOfThreads()
 {
+  if ( m_GlobalMaximumNumberOfThreads == 0 )
+    {
+    // ITK_MAX_THREADS is kept as a lower bound of the default so that
+    // oversubscription remains possible on small machines, while larger
+    // machines can use all of their processors.
+    m_GlobalMaximumNumberOfThreads =
+      std::max( static_cast< ThreadIdType >( ITK_MAX_THREADS ),
+                GetGlobalDefaultNumberOfThreadsByPlatform() );
+    m_GlobalMaximumNumberOfThreads = std::min( m_GlobalMaximumNumberOfThreads,
+                                               GetThreadingLibraryMaximumNumberOfThreads() );
+    }
   return m_GlobalMaximumNumberOfThreads;
 }
 
@@ -74,7 +208,7 @@ void MultiThreader::SetGlobalDefaultNumberOfThreads(ThreadIdType val)
 
   // clamp between 1 and m_GlobalMaximumNumberOfThreads
   m_GlobalDefaultNumberOfThreads  = std::min( m_GlobalDefaultNumberOfThreads,
-                                              m_GlobalMaximumNumberOfThreads );
+                                              GetGlobalMaximumNumberOfThreads() );
   m_GlobalDefaultNumberOfThreads  = std::max( m_GlobalDefaultNumberOfThreads,
                                               NumericTraits<ThreadIdType>::One );
 
@@ -83,7 +217,7 @@ void MultiThreader::SetGlobalDefaultNumberOfThreads(ThreadIdType val)
 void MultiThreader::SetNumberOfThreads(ThreadIdType numberOfThreads)
 {
   if ( m_NumberOfThreads == numberOfThreads &&
-       numberOfThreads <= m_GlobalMaximumNumberOfThreads )
+       numberOfThreads <= GetGlobalMaximumNumberOfThreads() )
     {
     return;
     }
@@ -92,9 +226,11 @@ void MultiThreader::SetNumberOfThreads(ThreadIdType numberOfThreads)
 
   // clamp between 1 and m_GlobalMaximumNumberOfThreads
   m_NumberOfThreads  = std::min( m_NumberOfThreads,
-                                 m_GlobalMaximumNumberOfThreads );
+                                 GetGlobalMaximumNumberOfThreads() );
   m_NumberOfThreads  = std::max( m_NumberOfThreads, NumericTraits<ThreadIdType>::One );
 
+  this->AllocateThreadStorage(m_NumberOfThreads);
+
 }
 
 
@@ -169,7 +305,7 @@ ThreadIdType MultiThreader::GetGlobalDefaultNumberOfThreads()
 
   // limit the number of threads to m_GlobalMaximumNumberOfThreads
   m_GlobalDefaultNumberOfThreads  = std::min( m_GlobalDefaultNumberOfThreads,
-                                              m_GlobalMaximumNumberOfThreads );
+                                              GetGlobalMaximumNumberOfThreads() );
 
   // verify that the default number of threads is larger than zero
   m_GlobalDefaultNumberOfThreads  = std::max( m_GlobalDefaultNumberOfThreads,
@@ -179,32 +315,96 @@ ThreadIdType MultiThreader::GetGlobalDefaultNumberOfThreads()
 }
 
 
-// Constructor. Default all the methods to NULL. Since the
-// ThreadInfoArray is static, the ThreadIDs can be initialized here
-// and will not change.
+// Constructor. Default all the methods to NULL. The per thread storage
+// is allocated for the default number of threads, and grows when the
+// number of threads is increased.
 MultiThreader::MultiThreader()
 {
-  for ( ThreadIdType i = 0; i < ITK_MAX_THREADS; i++ )
+  m_SingleMethod = 0;
+  m_SingleData = 0;
+  m_NumberOfThreads = this->GetGlobalDefaultNumberOfThreads();
+  m_UseThreadPool = this->GetGlobalDefaultUseThreadPool();
+  m_ExactNumberOfThreads = false;
+
+  this->AllocateThreadStorage(m_NumberOfThreads);
+}
+
+MultiThreader::~MultiThreader()
+{}
+
+void MultiThreader::AllocateThreadStorage(ThreadIdType numberOfThreads)
+{
+  const ThreadIdType allocated = static_cast< ThreadIdType >( m_ThreadInfoArray.size() );
+
+  if ( numberOfThreads <= allocated )
+    {
+    return;
+    }
+
+  m_ThreadInfoArray.resize(numberOfThreads);
+  m_MultipleMethod.resize(numberOfThreads, 0);
+  m_MultipleData.resize(numberOfThreads, 0);
+
+  // The ThreadIDs of the new elements can be initialized here and will
+  // not change.
+  for ( ThreadIdType i = allocated; i < numberOfThreads; i++ )
     {
     m_ThreadInfoArray[i].ThreadID           = i;
     m_ThreadInfoArray[i].ActiveFlag         = 0;
     m_ThreadInfoArray[i].ActiveFlagLock     = 0;
+    m_ThreadInfoArray[i].Arena              = 0;
+    }
+}
 
-    m_MultipleMethod[i]                     = 0;
-    m_MultipleData[i]                       = 0;
+// Called with m_SpawnedThreadMutex held.
+ThreadIdType MultiThreader::AcquireSpawnedThreadID()
+{
+  ThreadIdType id = 0;
+  const ThreadIdType numberOfSlots = static_cast< ThreadIdType >( m_SpawnedThreadActiveFlag.size() );
 
-    m_SpawnedThreadActiveFlag[i]            = 0;
-    m_SpawnedThreadActiveFlagLock[i]        = 0;
-    m_SpawnedThreadInfoArray[i].ThreadID    = i;
+  while ( id < numberOfSlots )
+    {
+    if ( !m_SpawnedThreadActiveFlagLock[id]  )
+      {
+      m_SpawnedThreadActiveFlagLock[id] = MutexLock::New();
+      }
+    m_SpawnedThreadActiveFlagLock[id]->Lock();
+    if ( m_SpawnedThreadActiveFlag[id] == 0 )
+      {
+      // We've got a useable thread id, so grab it
+      m_SpawnedThreadActiveFlag[id] = 1;
+      m_SpawnedThreadActiveFlagLock[id]->Unlock();
+      return id;
+      }
+    m_SpawnedThreadActiveFlagLock[id]->Unlock();
+
+    id++;
     }
 
-  m_SingleMethod = 0;
-  m_SingleData = 0;
-  m_NumberOfThreads = this->GetGlobalDefaultNumberOfThreads();
+  // All the slots are in use, add one. Growing the deques keeps the
+  // elements used by the running threads in place.
+  ThreadInfoStruct info;
+  info.ThreadID = id;
+  info.ActiveFlag = 0;
+  info.ActiveFlagLock = 0;
+  info.Arena = 0;
+
+  m_SpawnedThreadActiveFlag.push_back(1);
+  m_SpawnedThreadActiveFlagLock.push_back( MutexLock::New() );
+  m_SpawnedThreadProcessID.push_back( ThreadProcessIDType() );
+  m_SpawnedThreadInfoArray.push_back(info);
+
+  return id;
 }
 
-MultiThreader::~MultiThreader()
-{}
+void MultiThreader::ReleaseSpawnedThreadID(ThreadIdType id)
+{
+  m_SpawnedThreadMutex.Lock();
+  m_SpawnedThreadActiveFlagLock[id]->Lock();
+  m_SpawnedThreadActiveFlag[id] = 0;
+  m_SpawnedThreadActiveFlagLock[id]->Unlock();
+  m_SpawnedThreadMutex.Unlock();
+}
 
 // Set the user defined method that will be run on NumberOfThreads threads
 // when SingleMethodExecute is called.
@@ -236,7 +436,6 @@ void MultiThreader::SetMultipleMethod(ThreadIdType index, ThreadFunctionType f,
 void MultiThreader::SingleMethodExecute()
 {
   ThreadIdType                 thread_loop = 0;
-  ThreadProcessIDType process_id[ITK_MAX_THREADS];
 
   if ( !m_SingleMethod )
     {
@@ -245,7 +444,22 @@ void MultiThreader::SingleMethodExecute()
     }
 
   // obey the global maximum number of threads limit
-  m_NumberOfThreads = std::min( m_GlobalMaximumNumberOfThreads, m_NumberOfThreads );
+  m_NumberOfThreads = std::min( GetGlobalMaximumNumberOfThreads(), m_NumberOfThreads );
+
+  // Share the threads with the other executions of the arena, if any.
+  ThreadArena *arena = m_ThreadArena.GetPointer();
+  if ( !arena )
+    {
+    arena = ThreadArena::GetCurrentThreadArena();
+    }
+  if ( !arena )
+    {
+    arena = m_GlobalDefaultThreadArena.GetPointer();
+    }
+  const ThreadArenaExecution arenaExecution(arena, m_NumberOfThreads, m_ExactNumberOfThreads);
+  const ThreadIdType         numberOfThreads = arenaExecution.GetNumberOfThreads();
+
+  std::vector< ThreadProcessIDType > process_id(numberOfThreads);
 
   // Spawn a set of threads through the SingleMethodProxy. Exceptions
   // thrown from a thread will be caught by the SingleMethodProxy. A
@@ -256,16 +470,38 @@ void MultiThreader::SingleMethodExecute()
   // exceptions thrown by threads.
   bool        exceptionOccurred = false;
   std::string exceptionDetails;
+
+  // When the thread pool is used, the threads are not created here: the
+  // work is queued as jobs of a group that is waited for below.
+  // The jobs of an exact execution could wait behind the jobs of other
+  // executions, so its threads are always created.
+  const bool           useThreadPool = m_UseThreadPool && !m_ExactNumberOfThreads;
+  ThreadPool::Pointer  threadPool;
+  ThreadPool::JobGroup threadPoolJobs;
+  if ( useThreadPool )
+    {
+    threadPool = ThreadPool::GetInstance();
+    threadPool->AddWorkThreads(numberOfThreads - 1);
+    }
+
   try
     {
-    for ( thread_loop = 1; thread_loop < m_NumberOfThreads; thread_loop++ )
+    for ( thread_loop = 1; thread_loop < numberOfThreads; thread_loop++ )
       {
       m_ThreadInfoArray[thread_loop].UserData    = m_SingleData;
-      m_ThreadInfoArray[thread_loop].NumberOfThreads = m_NumberOfThreads;
+      m_ThreadInfoArray[thread_loop].NumberOfThreads = numberOfThreads;
       m_ThreadInfoArray[thread_loop].ThreadFunction = m_SingleMethod;
+      m_ThreadInfoArray[thread_loop].Arena = arena;
 
-      process_id[thread_loop] =
-        this->DispatchSingleMethodThread(&m_ThreadInfoArray[thread_loop]);
+      if ( useThreadPool )
+        {
+        threadPool->AddJob( this->SingleMethodProxy, &m_ThreadInfoArray[thread_loop], threadPoolJobs );
+        }
+      else
+        {
+        process_id[thread_loop] =
+          this->DispatchSingleMethodThread(&m_ThreadInfoArray[thread_loop]);
+        }
       }
     }
   catch ( std::exception & e )
@@ -289,21 +525,28 @@ void MultiThreader::SingleMethodExecute()
   try
     {
     m_ThreadInfoArray[0].UserData = m_SingleData;
-    m_ThreadInfoArray[0].NumberOfThreads = m_NumberOfThreads;
+    m_ThreadInfoArray[0].NumberOfThreads = numberOfThreads;
     m_SingleMethod( (void *)( &m_ThreadInfoArray[0] ) );
     }
   catch ( ProcessAborted & excp )
     {
     // Need cleanup and rethrow ProcessAborted
     // close down other threads
-    for ( thread_loop = 1; thread_loop < m_NumberOfThreads; thread_loop++ )
+    if ( useThreadPool )
+      {
+      threadPool->WaitForJobs(threadPoolJobs);
+      }
+    else
       {
-      try
+      for ( thread_loop = 1; thread_loop < numberOfThreads; thread_loop++ )
         {
-        this->WaitForSingleMethodThread(process_id[thread_loop]);
+        try
+          {
+          this->WaitForSingleMethodThread(process_id[thread_loop]);
+          }
+        catch ( ... )
+                {}
         }
-      catch ( ... )
-              {}
       }
     // rethrow
     throw &excp;
@@ -325,11 +568,18 @@ void MultiThreader::SingleMethodExecute()
 
   // The parent thread has finished this->SingleMethod() - so now it
   // waits for each of the other processes to exit
-  for ( thread_loop = 1; thread_loop < m_NumberOfThreads; thread_loop++ )
+  if ( useThreadPool )
+    {
+    threadPool->WaitForJobs(threadPoolJobs);
+    }
+  for ( thread_loop = 1; thread_loop < numberOfThreads; thread_loop++ )
     {
     try
       {
-      this->WaitForSingleMethodThread(process_id[thread_loop]);
+      if ( !useThreadPool )
+        {
+        this->WaitForSingleMethodThread(process_id[thread_loop]);
+        }
       if ( m_ThreadInfoArray[thread_loop].ThreadExitCode
            != ThreadInfoStruct::SUCCESS )
         {
@@ -369,6 +619,11 @@ MultiThreader
   * threadInfoStruct =
     reinterpret_cast< MultiThreader::ThreadInfoStruct * >( arg );
 
+  // the thread works for the arena of the execution; a worker of the
+  // thread pool may be working for another arena between two jobs
+  ThreadArena *previousArena = ThreadArena::GetCurrentThreadArena();
+  ThreadArena::SetCurrentThreadArena(threadInfoStruct->Arena);
+
   // execute the user specified threader callback, catching any exceptions
   try
     {
@@ -395,8 +650,54 @@ MultiThreader
     threadInfoStruct->ThreadExitCode = MultiThreader::ThreadInfoStruct::UNKNOWN;
     }
 
+  ThreadArena::SetCurrentThreadArena(previousArena);
+
   return ITK_THREAD_RETURN_VALUE;
 }
+void MultiThreader::ThreadPoolMultipleMethodExecute()
+{
+  ThreadPool::Pointer  threadPool = ThreadPool::GetInstance();
+  ThreadPool::JobGroup threadPoolJobs;
+
+  threadPool->AddWorkThreads(m_NumberOfThreads - 1);
+
+  // The jobs run the methods through the SingleMethodProxy, which records
+  // the exceptions they throw: the workers of the pool cannot report them.
+  for ( ThreadIdType thread_loop = 1; thread_loop < m_NumberOfThreads; thread_loop++ )
+    {
+    m_ThreadInfoArray[thread_loop].UserData = m_MultipleData[thread_loop];
+    m_ThreadInfoArray[thread_loop].NumberOfThreads = m_NumberOfThreads;
+    m_ThreadInfoArray[thread_loop].ThreadFunction = m_MultipleMethod[thread_loop];
+    m_ThreadInfoArray[thread_loop].Arena = ThreadArena::GetCurrentThreadArena();
+    threadPool->AddJob( this->SingleMethodProxy, &m_ThreadInfoArray[thread_loop], threadPoolJobs );
+    }
+
+  // Now, the parent thread calls the first method itself
+  m_ThreadInfoArray[0].UserData = m_MultipleData[0];
+  m_ThreadInfoArray[0].NumberOfThreads = m_NumberOfThreads;
+  try
+    {
+    ( m_MultipleMethod[0] )( (void *)( &m_ThreadInfoArray[0] ) );
+    }
+  catch ( ... )
+    {
+    // The queued jobs reference m_ThreadInfoArray: they must complete
+    // before the exception leaves this method.
+    threadPool->WaitForJobs(threadPoolJobs);
+    throw;
+    }
+
+  threadPool->WaitForJobs(threadPoolJobs);
+
+  for ( ThreadIdType thread_loop = 1; thread_loop < m_NumberOfThreads; thread_loop++ )
+    {
+    if ( m_ThreadInfoArray[thread_loop].ThreadExitCode != ThreadInfoStruct::SUCCESS )
+      {
+      itkExceptionMacro("Exception occurred during MultipleMethodExecute in thread " << thread_loop);
+      }
+    }
+}
+
 // Print method for the multithreader
 void MultiThreader::PrintSelf(std::ostream & os, Indent indent) const
 {
@@ -404,9 +705,18 @@ void MultiThreader::PrintSelf(std::ostream & os, Indent indent) const
 
   os << indent << "Thread Count: " << m_NumberOfThreads << "\n";
   os << indent << "Global Maximum Number Of Threads: "
-     << m_GlobalMaximumNumberOfThreads << std::endl;
+     << GetGlobalMaximumNumberOfThreads() << std::endl;
   os << indent << "Global Default Number Of Threads: "
      << m_GlobalDefaultNumberOfThreads << std::endl;
+  os << indent << "Use Thread Pool: "
+     << ( m_UseThreadPool ? "On" : "Off" ) << std::endl;
+  os << indent << "Global Default Use Thread Pool: "
+     << ( m_GlobalDefaultUseThreadPool ? "On" : "Off" ) << std::endl;
+  os << indent << "Exact Number Of Threads: "
+     << ( m_ExactNumberOfThreads ? "On" : "Off" ) << std::endl;
+  os << indent << "Thread Arena: " << m_ThreadArena.GetPointer() << std::endl;
+  os << indent << "Global Default Thread Arena: "
+     << m_GlobalDefaultThreadArena.GetPointer() << std::endl;
 }
 
 
@@ -46,9 +46,9 @@ void MultiThreader::MultipleMethodExecute()
   ThreadIdType thread_loop;
 
   // obey the global maximum number of threads limit
-  if ( m_NumberOfThreads > m_GlobalMaximumNumberOfThreads )
+  if ( m_NumberOfThreads > GetGlobalMaximumNumberOfThreads() )
     {
-    m_NumberOfThreads = m_GlobalMaximumNumberOfThreads;
+    m_NumberOfThreads = GetGlobalMaximumNumberOfThreads();
     }
 
   for ( thread_loop = 0; thread_loop < m_NumberOfThreads; thread_loop++ )
@@ -68,62 +68,42 @@ void MultiThreader::MultipleMethodExecute()
 
 ThreadIdType MultiThreader::SpawnThread(ThreadFunctionType f, void *UserData)
 {
-  int id = 0;
+  m_SpawnedThreadMutex.Lock();
+  ThreadIdType      id = this->AcquireSpawnedThreadID();
+  ThreadInfoStruct *info = &m_SpawnedThreadInfoArray[id];
 
-  while ( id < ITK_MAX_THREADS )
-    {
-    if ( !m_SpawnedThreadActiveFlagLock[id]  )
-      {
-      m_SpawnedThreadActiveFlagLock[id] = MutexLock::New();
-      }
-    m_SpawnedThreadActiveFlagLock[id]->Lock();
-    if ( m_SpawnedThreadActiveFlag[id] == 0 )
-      {
-      // We've got a useable thread id, so grab it
-      m_SpawnedThreadActiveFlag[id] = 1;
-      m_SpawnedThreadActiveFlagLock[id]->Unlock();
-      break;
-      }
-    m_SpawnedThreadActiveFlagLock[id]->Unlock();
-
-    id++;
-    }
-
-  if ( id >= ITK_MAX_THREADS )
-    {
-    itkExceptionMacro(<< "You have too many active threads!");
-    }
-
-  m_SpawnedThreadInfoArray[id].UserData        = UserData;
-  m_SpawnedThreadInfoArray[id].NumberOfThreads = 1;
-  m_SpawnedThreadInfoArray[id].ActiveFlag = &m_SpawnedThreadActiveFlag[id];
-  m_SpawnedThreadInfoArray[id].ActiveFlagLock = m_SpawnedThreadActiveFlagLock[id];
+  info->UserData        = UserData;
+  info->NumberOfThreads = 1;
+  info->ActiveFlag = &m_SpawnedThreadActiveFlag[id];
+  info->ActiveFlagLock = m_SpawnedThreadActiveFlagLock[id];
+  m_SpawnedThreadMutex.Unlock();
 
   // There is no multi threading, so there is only one thread.
   // This won't work - so give an error message.
+  this->ReleaseSpawnedThreadID(id);
   itkExceptionMacro(<< "Cannot spawn thread in a single threaded environment!");
-  m_SpawnedThreadActiveFlagLock[id] = 0;
-  id = -1;
   return id;
 }
 
 void MultiThreader::TerminateThread(ThreadIdType ThreadID)
 {
-  if ( !m_SpawnedThreadActiveFlag[ThreadID] )
+  m_SpawnedThreadMutex.Lock();
+  if ( ThreadID >= m_SpawnedThreadActiveFlag.size() ||
+       !m_SpawnedThreadActiveFlag[ThreadID] )
     {
+    m_SpawnedThreadMutex.Unlock();
     return;
     }
 
   m_SpawnedThreadActiveFlagLock[ThreadID]->Lock();
   m_SpawnedThreadActiveFlag[ThreadID] = 0;
   m_SpawnedThreadActiveFlagLock[ThreadID]->Unlock();
+  m_SpawnedThreadMutex.Unlock();
 
   // There is no multi threading, so there is only one thread.
   // This won't work - so give an error message.
+  this->ReleaseSpawnedThreadID(id);
   itkExceptionMacro(<< "Cannot terminate thread in single threaded environment!");
-
-  m_SpawnedThreadActiveFlagLock[ThreadID] = 0;
-  m_SpawnedThreadActiveFlagLock[ThreadID] = 0;
 }
 
 void
@@ -48,14 +48,15 @@ void MultiThreader::MultipleMethodExecute()
   ThreadIdType thread_loop;
 
   DWORD  threadId;
-  HANDLE process_id[ITK_MAX_THREADS];
 
   // obey the global maximum number of threads limit
-  if ( m_NumberOfThreads > m_GlobalMaximumNumberOfThreads )
+  if ( m_NumberOfThreads > GetGlobalMaximumNumberOfThreads() )
     {
-    m_NumberOfThreads = m_GlobalMaximumNumberOfThreads;
+    m_NumberOfThreads = GetGlobalMaximumNumberOfThreads();
     }
 
+  std::vector< HANDLE > process_id(m_NumberOfThreads);
+
   for ( thread_loop = 0; thread_loop < m_NumberOfThreads; thread_loop++ )
     {
     if ( m_MultipleMethod[thread_loop] == (ThreadFunctionType)0 )
@@ -65,6 +66,14 @@ void MultiThreader::MultipleMethodExecute()
       }
     }
 
+  // As in SingleMethodExecute, the threads of an exact execution are
+  // created: its jobs could wait behind the jobs of other executions.
+  if ( m_UseThreadPool && !m_ExactNumberOfThreads )
+    {
+    this->ThreadPoolMultipleMethodExecute();
+    return;
+    }
+
   // Using _beginthreadex on a PC
   //
   // We want to use _beginthreadex to start m_NumberOfThreads - 1
@@ -115,47 +124,29 @@ void MultiThreader::MultipleMethodExecute()
 
 ThreadIdType MultiThreader::SpawnThread(ThreadFunctionType f, void *UserData)
 {
-  ThreadIdType id = 0;
-
   DWORD threadId;
 
-  while ( id < ITK_MAX_THREADS )
-    {
-    if ( !m_SpawnedThreadActiveFlagLock[id]  )
-      {
-      m_SpawnedThreadActiveFlagLock[id] = MutexLock::New();
-      }
-    m_SpawnedThreadActiveFlagLock[id]->Lock();
-    if ( m_SpawnedThreadActiveFlag[id] == 0 )
-      {
-      // We've got a useable thread id, so grab it
-      m_SpawnedThreadActiveFlag[id] = 1;
-      m_SpawnedThreadActiveFlagLock[id]->Unlock();
-      break;
-      }
-    m_SpawnedThreadActiveFlagLock[id]->Unlock();
-
-    id++;
-    }
-
-  if ( id >= ITK_MAX_THREADS )
-    {
-    itkExceptionMacro(<< "You have too many active threads!");
-    }
+  m_SpawnedThreadMutex.Lock();
+  ThreadIdType         id = this->AcquireSpawnedThreadID();
+  ThreadInfoStruct *   info = &m_SpawnedThreadInfoArray[id];
+  ThreadProcessIDType *processID = &m_SpawnedThreadProcessID[id];
 
-  m_SpawnedThreadInfoArray[id].UserData        = UserData;
-  m_SpawnedThreadInfoArray[id].NumberOfThreads = 1;
-  m_SpawnedThreadInfoArray[id].ActiveFlag = &m_SpawnedThreadActiveFlag[id];
-  m_SpawnedThreadInfoArray[id].ActiveFlagLock = m_SpawnedThreadActiveFlagLock[id];
+  info->UserData        = UserData;
+  info->NumberOfThreads = 1;
+  info->ActiveFlag = &m_SpawnedThreadActiveFlag[id];
+  info->ActiveFlagLock = m_SpawnedThreadActiveFlagLock[id];
+  m_SpawnedThreadMutex.Unlock();
 
   // Using _beginthreadex on a PC
   //
-  m_SpawnedThreadProcessID[id] = (void *)
-                                 _beginthreadex(0, 0, ( unsigned int (__stdcall *)(void *) )f,
-                                                ( (void *)( &m_SpawnedThreadInfoArray[id] ) ), 0,
-                                                (unsigned int *)&threadId);
-  if ( m_SpawnedThreadProcessID[id] == 0 )
+  *processID = (void *)
+               _beginthreadex(0, 0, ( unsigned int (__stdcall *)(void *) )f,
+                              ( (void *)info ), 0,
+                              (unsigned int *)&threadId);
+  if ( *processID == 0 )
     {
+    // The slot is not used by any thread, it must not stay active.
+    this->ReleaseSpawnedThreadID(id);
     itkExceptionMacro("Error in thread creation !!!");
     }
   return id;
@@ -163,19 +154,23 @@ ThreadIdType MultiThreader::SpawnThread(ThreadFunctionType f, void *UserData)
 
 void MultiThreader::TerminateThread(ThreadIdType ThreadID)
 {
-  if ( !m_SpawnedThreadActiveFlag[ThreadID] )
+  m_SpawnedThreadMutex.Lock();
+  if ( ThreadID >= m_SpawnedThreadActiveFlag.size() ||
+       !m_SpawnedThreadActiveFlag[ThreadID] )
     {
+    m_SpawnedThreadMutex.Unlock();
     return;
     }
 
+  // The slot can be reused as soon as its flag is cleared
+  const ThreadProcessIDType processID = m_SpawnedThreadProcessID[ThreadID];
   m_SpawnedThreadActiveFlagLock[ThreadID]->Lock();
   m_SpawnedThreadActiveFlag[ThreadID] = 0;
   m_SpawnedThreadActiveFlagLock[ThreadID]->Unlock();
+  m_SpawnedThreadMutex.Unlock();
 
-  WaitForSingleObject(m_SpawnedThreadProcessID[ThreadID], INFINITE);
-  CloseHandle(m_SpawnedThreadProcessID[ThreadID]);
-  m_SpawnedThreadActiveFlagLock[ThreadID] = 0;
-  m_SpawnedThreadActiveFlagLock[ThreadID] = 0;
+  WaitForSingleObject(processID, INFINITE);
+  CloseHandle(processID);
 }
 
 void
@@ -0,0 +1,330 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkPipelineTracer.h"
+
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <vector>
+
+#if defined( _WIN32 )
+  #include "itkWindows.h"
+
+#elif defined( __APPLE__ )
+// OSAtomic.h optimizations only used in 10.5 and later
+  #include <AvailabilityMacros.h>
+  #if MAC_OS_X_VERSION_MAX_ALLOWED >= 1050
+    #include <libkern/OSAtomic.h>
+  #endif
+
+#elif defined( __GLIBCPP__ ) || defined( __GLIBCXX__ )
+  #if ( __GNUC__ > 4 ) || ( ( __GNUC__ == 4 ) && ( __GNUC_MINOR__ >= 2 ) )
+  #include <ext/atomicity.h>
+  #else
+  #include <bits/atomicity.h>
+  #endif
+
+#endif
+
+namespace itk
+{
+namespace
+{
+// The enabled flag is read by the threads executing the pipelines while
+// it may be switched by another thread.  It is only modified with the lock
+// of the tracer held, and is read and modified with atomic additions,
+// which also order the accesses to the recorded events.
+#if defined( WIN32 ) || defined( _WIN32 )
+volatile LONG TracerEnabled = 0;
+
+inline LONG TracerEnabledAdd(LONG value)
+{
+  return InterlockedExchangeAdd(&TracerEnabled, value) + value;
+}
+
+#elif defined( __APPLE__ ) && ( MAC_OS_X_VERSION_MIN_REQUIRED >= 1050 )
+volatile int32_t TracerEnabled = 0;
+
+inline int32_t TracerEnabledAdd(int32_t value)
+{
+  return OSAtomicAdd32Barrier(value, &TracerEnabled);
+}
+
+#elif defined( __GLIBCPP__ ) || defined( __GLIBCXX__ )
+volatile _Atomic_word TracerEnabled = 0;
+
+inline _Atomic_word TracerEnabledAdd(_Atomic_word value)
+{
+  return __gnu_cxx::__exchange_and_add(&TracerEnabled, value) + value;
+}
+
+#else
+int                 TracerEnabled = 0;
+SimpleFastMutexLock TracerEnabledLock;
+
+inline int TracerEnabledAdd(int value)
+{
+  TracerEnabledLock.Lock();
+  TracerEnabled += value;
+  const int enabled = TracerEnabled;
+  TracerEnabledLock.Unlock();
+  return enabled;
+}
+
+#endif
+
+// The system threads which recorded events, in the order of their first
+// event.  It is only accessed with the lock of the tracer held.
+#if defined( ITK_USE_PTHREADS )
+typedef pthread_t SystemThreadType;
+
+inline SystemThreadType GetCurrentSystemThread()
+{
+  return pthread_self();
+}
+
+inline bool IsSameSystemThread(const SystemThreadType & a, const SystemThreadType & b)
+{
+  return pthread_equal(a, b) != 0;
+}
+
+#elif defined( ITK_USE_WIN32_THREADS )
+typedef DWORD SystemThreadType;
+
+inline SystemThreadType GetCurrentSystemThread()
+{
+  return GetCurrentThreadId();
+}
+
+inline bool IsSameSystemThread(const SystemThreadType & a, const SystemThreadType & b)
+{
+  return a == b;
+}
+
+#else
+typedef int SystemThreadType;
+
+inline SystemThreadType GetCurrentSystemThread()
+{
+  return 0;
+}
+
+inline bool IsSameSystemThread(const SystemThreadType & a, const SystemThreadType & b)
+{
+  return a == b;
+}
+
+#endif
+std::vector< SystemThreadType > TracerSystemThreads;
+} // end anonymous namespace
+
+SimpleFastMutexLock                  PipelineTracer:: m_Lock;
+PipelineTracer::EventContainerType   PipelineTracer:: m_Events;
+TimeProbesCollectorBase              PipelineTracer:: m_FilterProbes;
+RealTimeClock::Pointer               PipelineTracer:: m_Clock;
+double                               PipelineTracer:: m_Origin = 0.0;
+
+void
+PipelineTracer
+::SetEnabled(bool enabled)
+{
+  m_Lock.Lock();
+  const bool wasEnabled = Self::GetEnabled();
+  if ( enabled && !wasEnabled )
+    {
+    if ( m_Clock.IsNull() )
+      {
+      m_Clock = RealTimeClock::New();
+      }
+    m_Origin = m_Clock->GetTimeInSeconds();
+    m_Events.clear();
+    TracerSystemThreads.clear();
+    m_FilterProbes.Clear();
+    }
+  // The flag only changes with the lock held, so that adding the
+  // difference sets it to the requested value.
+  TracerEnabledAdd( ( enabled ? 1 : 0 ) - ( wasEnabled ? 1 : 0 ) );
+  m_Lock.Unlock();
+}
+
+bool
+PipelineTracer
+::GetEnabled()
+{
+  return TracerEnabledAdd(0) != 0;
+}
+
+double
+PipelineTracer
+::GetTimeStamp()
+{
+  if ( m_Clock.IsNull() )
+    {
+    return 0.0;
+    }
+  return m_Clock->GetTimeInSeconds() - m_Origin;
+}
+
+void
+PipelineTracer
+::AddEvent(const EventType & event)
+{
+  const SystemThreadType thread = GetCurrentSystemThread();
+
+  m_Lock.Lock();
+  // A few threads record events: a linear search is fast enough.
+  size_t systemThread = 0;
+  while ( systemThread < TracerSystemThreads.size()
+          && !IsSameSystemThread(TracerSystemThreads[systemThread], thread) )
+    {
+    ++systemThread;
+    }
+  if ( systemThread == TracerSystemThreads.size() )
+    {
+    TracerSystemThreads.push_back(thread);
+    }
+  m_Events.push_back(event);
+  m_Events.back().SystemThread = static_cast< ThreadIdType >( systemThread );
+  m_Lock.Unlock();
+}
+
+std::string
+PipelineTracer
+::GetProbeName(const void *object, const char *name)
+{
+  // Filters of the same class may execute concurrently, or one in the
+  // other, so the probes of different instances must not be shared.
+  std::ostringstream probeName;
+  probeName << name << " (" << object << ")";
+  return probeName.str();
+}
+
+void
+PipelineTracer
+::StartFilter(const void *object, const char *name)
+{
+  const std::string probeName = Self::GetProbeName(object, name);
+  m_Lock.Lock();
+  m_FilterProbes.Start( probeName.c_str() );
+  m_Lock.Unlock();
+}
+
+void
+PipelineTracer
+::StopFilter(const void *object, const char *name)
+{
+  const std::string probeName = Self::GetProbeName(object, name);
+  m_Lock.Lock();
+  try
+    {
+    m_FilterProbes.Stop( probeName.c_str() );
+    }
+  catch ( ... )
+    {
+    // The probes were cleared while the filter was running.
+    }
+  m_Lock.Unlock();
+}
+
+PipelineTracer::EventContainerType
+PipelineTracer
+::GetEvents()
+{
+  m_Lock.Lock();
+  EventContainerType events = m_Events;
+  m_Lock.Unlock();
+  return events;
+}
+
+void
+PipelineTracer
+::Clear()
+{
+  m_Lock.Lock();
+  m_Events.clear();
+  TracerSystemThreads.clear();
+  m_FilterProbes.Clear();
+  m_Lock.Unlock();
+}
+
+void
+PipelineTracer
+::WriteChromeTrace(std::ostream & os)
+{
+  const EventContainerType events = Self::GetEvents();
+
+  // Timestamps are in microseconds in the trace event format.
+  const std::streamsize precision = os.precision(3);
+  const std::ios_base::fmtflags flags = os.setf(std::ios_base::fixed, std::ios_base::floatfield);
+
+  os << "{\"traceEvents\":[" << std::endl;
+  for ( size_t i = 0; i < events.size(); ++i )
+    {
+    const EventType & event = events[i];
+    os << "{\"name\":";
+    TimeProbesCollectorBase::JSONWriteString(os, event.Name);
+    os << ",\"cat\":";
+    TimeProbesCollectorBase::JSONWriteString(os, event.Category);
+    os << ",\"ph\":\"X\","
+       << "\"ts\":" << event.Start * 1e6 << ","
+       << "\"dur\":" << event.Duration * 1e6 << ","
+       << "\"pid\":0,"
+       << "\"tid\":" << event.SystemThread << ","
+       << "\"args\":{\"object\":\"" << event.Object << "\","
+       << "\"threadId\":" << event.ThreadId << ","
+       << "\"outputBytes\":" << event.OutputBytes << ","
+       << "\"requestedRegionPixels\":" << event.RequestedRegionPixels << "}}"
+       << ( i + 1 < events.size() ? "," : "" ) << std::endl;
+    }
+  os << "],\"displayTimeUnit\":\"ms\"}" << std::endl;
+
+  os.flags(flags);
+  os.precision(precision);
+}
+
+void
+PipelineTracer
+::Report(std::ostream & os)
+{
+  const EventContainerType events = Self::GetEvents();
+
+  m_Lock.Lock();
+  m_FilterProbes.Report(os);
+  m_Lock.Unlock();
+
+  // Busy time of the threads, over all the multi-threaded executions.
+  typedef std::map< ThreadIdType, double > BusyTimeMapType;
+  BusyTimeMapType busy;
+  for ( size_t i = 0; i < events.size(); ++i )
+    {
+    if ( events[i].ThreadId > 0 )
+      {
+      busy[events[i].ThreadId - 1] += events[i].Duration;
+      }
+    }
+  if ( busy.empty() )
+    {
+    return;
+    }
+  os << std::setw(20) << " Thread " << std::setw(15) << " Busy (s)" << std::endl;
+  for ( BusyTimeMapType::const_iterator it = busy.begin(); it != busy.end(); ++it )
+    {
+    os << std::setw(20) << it->first << std::setw(15) << it->second << std::endl;
+    }
+}
+} // end namespace itk
@@ -109,6 +109,26 @@ ProcessObject
     }
 }
 
+/**
+ * Clamp the number of threads to the global maximum, which is not known
+ * at compile time.
+ */
+void
+ProcessObject
+::SetNumberOfThreads(ThreadIdType numberOfThreads)
+{
+  const ThreadIdType maximum = MultiThreader::GetGlobalMaximumNumberOfThreads();
+  const ThreadIdType clamped =
+    ( numberOfThreads < 1 ? 1 : ( numberOfThreads > maximum ? maximum : numberOfThreads ) );
+
+  itkDebugMacro("setting NumberOfThreads to " << clamped);
+  if ( m_NumberOfThreads != clamped )
+    {
+    m_NumberOfThreads = clamped;
+    this->Modified();
+    }
+}
+
 /**
  * Called by constructor to set up input array.
  */
@@ -1529,12 +1549,26 @@ ProcessObject
   m_AbortGenerateData = false;
   m_Progress = 0.0f;
 
+  // The tracer is checked once, so that the start and stop of its probes
+  // stay balanced if it is switched during the execution.
+  const bool tracing = PipelineTracer::GetEnabled();
+  double     traceStart = 0.0;
+  if ( tracing )
+    {
+    PipelineTracer::StartFilter( this, this->GetNameOfClass() );
+    traceStart = PipelineTracer::GetTimeStamp();
+    }
+
   try
     {
     this->GenerateData();
     }
   catch ( ProcessAborted & excp )
     {
+    if ( tracing )
+      {
+      PipelineTracer::StopFilter( this, this->GetNameOfClass() );
+      }
     this->InvokeEvent( AbortEvent() );
     this->ResetPipeline();
     this->RestoreInputReleaseDataFlags();
@@ -1542,11 +1576,28 @@ ProcessObject
     }
   catch (...)
     {
+    if ( tracing )
+      {
+      PipelineTracer::StopFilter( this, this->GetNameOfClass() );
+      }
     this->ResetPipeline();
     this->RestoreInputReleaseDataFlags();
     throw;
     }
 
+  if ( tracing )
+    {
+    PipelineTracer::EventType event;
+    event.Duration = PipelineTracer::GetTimeStamp() - traceStart;
+    PipelineTracer::StopFilter( this, this->GetNameOfClass() );
+    event.Name = this->GetNameOfClass();
+    event.Category = "GenerateData";
+    event.Object = this;
+    event.Start = traceStart;
+    this->AddOutputsToTraceEvent(event);
+    PipelineTracer::AddEvent(event);
+    }
+
   /**
    * If we ended due to aborting, push the progress up to 1.0 (since
    * it probably didn't end there)
@@ -1587,6 +1638,11 @@ ProcessObject
   m_Updating = false;
 }
 
+void
+ProcessObject
+::AddOutputsToTraceEvent( PipelineTracer::EventType & itkNotUsed(event) ) const
+{}
+
 /**
  *
  */
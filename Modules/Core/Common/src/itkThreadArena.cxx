@@ -0,0 +1,160 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkThreadArena.h"
+#include "itkMultiThreader.h"
+
+#if defined(ITK_USE_PTHREADS)
+#include "itkThreadArenaPThreads.cxx"
+#elif defined(ITK_USE_WIN32_THREADS)
+#include "itkThreadArenaWinThreads.cxx"
+#else
+#include "itkThreadArenaNoThreads.cxx"
+#endif
+
+namespace itk
+{
+ThreadArena
+::ThreadArena():
+  m_NumberOfActiveThreads(0)
+{
+  m_MaximumNumberOfThreads = MultiThreader::GetGlobalDefaultNumberOfThreads();
+}
+
+ThreadArena
+::~ThreadArena()
+{}
+
+void
+ThreadArena
+::SetMaximumNumberOfThreads(ThreadIdType numberOfThreads)
+{
+  if ( numberOfThreads < 1 )
+    {
+    numberOfThreads = 1;
+    }
+
+  m_Mutex.Lock();
+  const bool modified = ( m_MaximumNumberOfThreads != numberOfThreads );
+  m_MaximumNumberOfThreads = numberOfThreads;
+  m_Mutex.Unlock();
+
+  if ( modified )
+    {
+    this->Modified();
+    }
+}
+
+ThreadIdType
+ThreadArena
+::GetMaximumNumberOfThreads() const
+{
+  m_Mutex.Lock();
+  const ThreadIdType maximum = m_MaximumNumberOfThreads;
+  m_Mutex.Unlock();
+  return maximum;
+}
+
+ThreadIdType
+ThreadArena
+::GetNumberOfActiveThreads() const
+{
+  m_Mutex.Lock();
+  const ThreadIdType active = m_NumberOfActiveThreads;
+  m_Mutex.Unlock();
+  return active;
+}
+
+ThreadIdType
+ThreadArena
+::AcquireThreads(ThreadIdType numberOfThreads)
+{
+  m_Mutex.Lock();
+  ThreadIdType available = 0;
+  if ( m_MaximumNumberOfThreads > m_NumberOfActiveThreads )
+    {
+    available = m_MaximumNumberOfThreads - m_NumberOfActiveThreads;
+    }
+  const ThreadIdType granted = ( numberOfThreads < available ) ? numberOfThreads : available;
+  m_NumberOfActiveThreads += granted;
+  m_Mutex.Unlock();
+  return granted;
+}
+
+void
+ThreadArena
+::ReleaseThreads(ThreadIdType numberOfThreads)
+{
+  m_Mutex.Lock();
+  if ( numberOfThreads > m_NumberOfActiveThreads )
+    {
+    numberOfThreads = m_NumberOfActiveThreads;
+    }
+  m_NumberOfActiveThreads -= numberOfThreads;
+  m_Mutex.Unlock();
+}
+
+void
+ThreadArena
+::EnterThread()
+{
+  m_Mutex.Lock();
+  ++m_NumberOfActiveThreads;
+  m_Mutex.Unlock();
+}
+
+void
+ThreadArena
+::LeaveThread()
+{
+  this->ReleaseThreads(1);
+}
+
+ThreadArena::Scope
+::Scope(ThreadArena *arena):
+  m_Arena(arena)
+{
+  m_PreviousArena = ThreadArena::GetCurrentThreadArena();
+  if ( m_Arena )
+    {
+    m_Arena->EnterThread();
+    }
+  ThreadArena::SetCurrentThreadArena(m_Arena);
+}
+
+ThreadArena::Scope
+::~Scope()
+{
+  ThreadArena::SetCurrentThreadArena(m_PreviousArena);
+  if ( m_Arena )
+    {
+    m_Arena->LeaveThread();
+    }
+}
+
+void
+ThreadArena
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "MaximumNumberOfThreads: "
+     << this->GetMaximumNumberOfThreads() << std::endl;
+  os << indent << "NumberOfActiveThreads: "
+     << this->GetNumberOfActiveThreads() << std::endl;
+}
+}
@@ -0,0 +1,41 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkThreadArena.h"
+
+namespace itk
+{
+namespace
+{
+// Without a threading library there is only one thread.
+ThreadArena *CurrentThreadArena = 0;
+}
+
+ThreadArena *
+ThreadArena
+::GetCurrentThreadArena()
+{
+  return CurrentThreadArena;
+}
+
+void
+ThreadArena
+::SetCurrentThreadArena(ThreadArena *arena)
+{
+  CurrentThreadArena = arena;
+}
+} // end namespace itk
@@ -0,0 +1,49 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkThreadArena.h"
+#include "itkThreadSupport.h"
+
+namespace itk
+{
+namespace
+{
+pthread_key_t  CurrentThreadArenaKey;
+pthread_once_t CurrentThreadArenaKeyOnce = PTHREAD_ONCE_INIT;
+
+extern "C" void CreateCurrentThreadArenaKey()
+{
+  pthread_key_create(&CurrentThreadArenaKey, 0);
+}
+}
+
+ThreadArena *
+ThreadArena
+::GetCurrentThreadArena()
+{
+  pthread_once(&CurrentThreadArenaKeyOnce, CreateCurrentThreadArenaKey);
+  return static_cast< ThreadArena * >( pthread_getspecific(CurrentThreadArenaKey) );
+}
+
+void
+ThreadArena
+::SetCurrentThreadArena(ThreadArena *arena)
+{
+  pthread_once(&CurrentThreadArenaKeyOnce, CreateCurrentThreadArenaKey);
+  pthread_setspecific(CurrentThreadArenaKey, arena);
+}
+} // end namespace itk
@@ -0,0 +1,43 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkThreadArena.h"
+#include "itkThreadSupport.h"
+
+namespace itk
+{
+namespace
+{
+// The index is allocated during the static initialization of the library,
+// before any thread of ITK can run.
+DWORD CurrentThreadArenaIndex = TlsAlloc();
+}
+
+ThreadArena *
+ThreadArena
+::GetCurrentThreadArena()
+{
+  return static_cast< ThreadArena * >( TlsGetValue(CurrentThreadArenaIndex) );
+}
+
+void
+ThreadArena
+::SetCurrentThreadArena(ThreadArena *arena)
+{
+  TlsSetValue(CurrentThreadArenaIndex, arena);
+}
+} // end namespace itk
@@ -0,0 +1,422 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkThreadPool.h"
+
+#if defined(ITK_USE_PTHREADS)
+#include "itkThreadPoolPThreads.cxx"
+#elif defined(ITK_USE_WIN32_THREADS)
+#include "itkThreadPoolWinThreads.cxx"
+#else
+#include "itkThreadPoolNoThreads.cxx"
+#endif
+
+namespace itk
+{
+ThreadPool::Pointer ThreadPool:: m_Instance = 0;
+SimpleFastMutexLock ThreadPool:: m_InstanceLock;
+
+ThreadPool::JobGroup::JobGroup():
+  m_PendingJobs(0)
+{
+  m_Condition = ConditionVariable::New();
+}
+
+ThreadPool::JobGroup::~JobGroup()
+{}
+
+SizeValueType
+ThreadPool::JobGroup
+::GetNumberOfPendingJobs() const
+{
+  m_Mutex.Lock();
+  const SizeValueType pending = m_PendingJobs;
+  m_Mutex.Unlock();
+  return pending;
+}
+
+ThreadPool::Pointer
+ThreadPool
+::New()
+{
+  return Self::GetInstance();
+}
+
+ThreadPool::Pointer
+ThreadPool
+::GetInstance()
+{
+  m_InstanceLock.Lock();
+  if ( !ThreadPool::m_Instance )
+    {
+    // Try the factory first
+    ThreadPool::m_Instance = ObjectFactory< Self >::Create();
+    // if the factory did not provide one, then create it here
+    if ( !ThreadPool::m_Instance )
+      {
+      ThreadPool::m_Instance = new ThreadPool;
+      // Remove extra reference from construction.
+      ThreadPool::m_Instance->UnRegister();
+      }
+    }
+  m_InstanceLock.Unlock();
+  return ThreadPool::m_Instance;
+}
+
+ThreadPool
+::ThreadPool():
+  m_NumberOfQueuedJobs(0),
+  m_NumberOfRunningJobs(0),
+  m_NextQueue(0),
+  m_StopWorkers(false),
+  m_ThreadAffinity(false)
+{
+  m_WakeUp = ConditionVariable::New();
+  // There is always at least one queue, so that jobs can be accepted (and
+  // executed by the waiting thread) even when no worker is running.
+  m_Queues.resize(1);
+}
+
+ThreadPool
+::~ThreadPool()
+{
+  this->StopWorkers(false);
+}
+
+void
+ThreadPool
+::AddJob(ThreadFunctionType function, void *data, JobGroup & group)
+{
+  JobType job;
+  job.Function = function;
+  job.UserData = data;
+  job.Group = &group;
+
+  group.m_Mutex.Lock();
+  ++group.m_PendingJobs;
+  group.m_Mutex.Unlock();
+
+  m_Mutex.Lock();
+  m_Queues[m_NextQueue % m_Queues.size()].push_back(job);
+  m_NextQueue = ( m_NextQueue + 1 ) % m_Queues.size();
+  ++m_NumberOfQueuedJobs;
+  m_WakeUp->Signal();
+  m_Mutex.Unlock();
+}
+
+bool
+ThreadPool
+::PopJob(ThreadIdType preferredQueue, JobType & job, bool worker)
+{
+  bool found = false;
+
+  m_Mutex.Lock();
+  // Workers being stopped do not start new jobs, the waiting threads
+  // keep executing them.
+  if ( worker && m_StopWorkers )
+    {
+    m_Mutex.Unlock();
+    return false;
+    }
+  const ThreadIdType numberOfQueues = static_cast< ThreadIdType >( m_Queues.size() );
+  const ThreadIdType first = preferredQueue % numberOfQueues;
+
+  // The own queue is used as a stack for cache locality, the queues of the
+  // other workers are stolen from at the opposite end.
+  if ( !m_Queues[first].empty() )
+    {
+    job = m_Queues[first].back();
+    m_Queues[first].pop_back();
+    found = true;
+    }
+  for ( ThreadIdType i = 1; i < numberOfQueues && !found; ++i )
+    {
+    JobQueueType & victim = m_Queues[( first + i ) % numberOfQueues];
+    if ( !victim.empty() )
+      {
+      job = victim.front();
+      victim.pop_front();
+      found = true;
+      }
+    }
+  if ( found )
+    {
+    --m_NumberOfQueuedJobs;
+    ++m_NumberOfRunningJobs;
+    }
+  m_Mutex.Unlock();
+
+  return found;
+}
+
+void
+ThreadPool
+::ExecuteJob(const JobType & job)
+{
+  // Exceptions must not leave the worker. MultiThreader routes its
+  // methods through a proxy that records them for the caller.
+  try
+    {
+    ( *job.Function )(job.UserData);
+    }
+  catch ( ... )
+    {}
+
+  m_Mutex.Lock();
+  --m_NumberOfRunningJobs;
+  m_Mutex.Unlock();
+
+  JobGroup *group = job.Group;
+  group->m_Mutex.Lock();
+  --group->m_PendingJobs;
+  if ( group->m_PendingJobs == 0 )
+    {
+    group->m_Condition->Broadcast();
+    }
+  group->m_Mutex.Unlock();
+}
+
+void
+ThreadPool
+::WaitForJobs(JobGroup & group)
+{
+  JobType job;
+
+  for (;; )
+    {
+    group.m_Mutex.Lock();
+    const SizeValueType pending = group.m_PendingJobs;
+    group.m_Mutex.Unlock();
+    if ( pending == 0 )
+      {
+      return;
+      }
+
+    // Help with the queued jobs rather than sleeping.
+    if ( this->PopJob(0, job, false) )
+      {
+      this->ExecuteJob(job);
+      continue;
+      }
+
+    // Nothing left in the queues: the remaining jobs of the group are
+    // running on workers.
+    group.m_Mutex.Lock();
+    while ( group.m_PendingJobs > 0 )
+      {
+      group.m_Condition->Wait(&group.m_Mutex);
+      }
+    group.m_Mutex.Unlock();
+    return;
+    }
+}
+
+ITK_THREAD_RETURN_TYPE
+ThreadPool
+::WorkerMain(void *arg)
+{
+  WorkerType *worker = reinterpret_cast< WorkerType * >( arg );
+  ThreadPool *pool = worker->Pool;
+  JobType     job;
+
+  for (;; )
+    {
+    if ( pool->PopJob(worker->Index, job, true) )
+      {
+      pool->ExecuteJob(job);
+      continue;
+      }
+
+    pool->m_Mutex.Lock();
+    while ( pool->m_NumberOfQueuedJobs <= 0 && !pool->m_StopWorkers )
+      {
+      pool->m_WakeUp->Wait(&pool->m_Mutex);
+      }
+    const bool stop = pool->m_StopWorkers;
+    pool->m_Mutex.Unlock();
+
+    if ( stop )
+      {
+      break;
+      }
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+void
+ThreadPool
+::StartWorkers(ThreadIdType first, ThreadIdType count)
+{
+  if ( !Self::PlatformSupportsWorkThreads() )
+    {
+    return;
+    }
+
+  // One queue per worker. The running workers keep their queue and their
+  // jobs, the new workers start stealing jobs as soon as they run.
+  m_Mutex.Lock();
+  if ( m_Queues.size() < count )
+    {
+    m_Queues.resize(count);
+    }
+  m_Mutex.Unlock();
+
+  for ( ThreadIdType i = first; i < count; ++i )
+    {
+    WorkerType *worker = new WorkerType;
+    worker->Pool = this;
+    worker->Index = i;
+    worker->ProcessID = Self::CreateWorkerThread(worker);
+    if ( m_ThreadAffinity )
+      {
+      Self::SetWorkerThreadAffinity(worker->ProcessID, i);
+      }
+    m_Mutex.Lock();
+    m_Workers.push_back(worker);
+    m_Mutex.Unlock();
+    }
+}
+
+bool
+ThreadPool
+::StopWorkers(bool onlyIfIdle)
+{
+  m_Mutex.Lock();
+  // A running job may be executing on one of the workers, which cannot be
+  // joined from itself, and jobs nested in it may be waiting for the
+  // other workers.
+  if ( onlyIfIdle && m_NumberOfRunningJobs > 0 )
+    {
+    m_Mutex.Unlock();
+    return false;
+    }
+  std::vector< WorkerType * > workers;
+  workers.swap(m_Workers);
+  m_StopWorkers = true;
+  m_WakeUp->Broadcast();
+  m_Mutex.Unlock();
+
+  for ( size_t i = 0; i < workers.size(); ++i )
+    {
+    Self::JoinWorkerThread(workers[i]->ProcessID);
+    delete workers[i];
+    }
+
+  // Gather the jobs that were not executed into the first queue.
+  m_Mutex.Lock();
+  for ( size_t i = 1; i < m_Queues.size(); ++i )
+    {
+    m_Queues[0].insert( m_Queues[0].end(), m_Queues[i].begin(), m_Queues[i].end() );
+    }
+  m_Queues.resize(1);
+  m_NextQueue = 0;
+  m_StopWorkers = false;
+  m_Mutex.Unlock();
+  return true;
+}
+
+void
+ThreadPool
+::AddWorkThreads(ThreadIdType count)
+{
+  if ( this->GetNumberOfWorkThreads() < count )
+    {
+    m_ResizeMutex.Lock();
+    const ThreadIdType current = this->GetNumberOfWorkThreads();
+    if ( current < count )
+      {
+      this->StartWorkers(current, count);
+      }
+    m_ResizeMutex.Unlock();
+    }
+}
+
+void
+ThreadPool
+::SetNumberOfWorkThreads(ThreadIdType count)
+{
+  m_ResizeMutex.Lock();
+  const ThreadIdType current = this->GetNumberOfWorkThreads();
+  if ( current < count )
+    {
+    this->StartWorkers(current, count);
+    this->Modified();
+    }
+  else if ( current > count && this->StopWorkers(true) )
+    {
+    this->StartWorkers(0, count);
+    this->Modified();
+    }
+  m_ResizeMutex.Unlock();
+}
+
+ThreadIdType
+ThreadPool
+::GetNumberOfWorkThreads() const
+{
+  m_Mutex.Lock();
+  const ThreadIdType count = static_cast< ThreadIdType >( m_Workers.size() );
+  m_Mutex.Unlock();
+  return count;
+}
+
+void
+ThreadPool
+::SetThreadAffinity(bool affinity)
+{
+  m_ResizeMutex.Lock();
+  if ( m_ThreadAffinity != affinity )
+    {
+    m_ThreadAffinity = affinity;
+    // Restart the workers so that the new placement applies. While jobs
+    // are running, only the workers started later are placed.
+    const ThreadIdType count = this->GetNumberOfWorkThreads();
+    if ( count > 0 && this->StopWorkers(true) )
+      {
+      this->StartWorkers(0, count);
+      }
+    this->Modified();
+    }
+  m_ResizeMutex.Unlock();
+}
+
+SizeValueType
+ThreadPool
+::GetNumberOfQueuedJobs() const
+{
+  m_Mutex.Lock();
+  const long queued = m_NumberOfQueuedJobs;
+  m_Mutex.Unlock();
+  return queued > 0 ? static_cast< SizeValueType >( queued ) : 0;
+}
+
+void
+ThreadPool
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "ThreadPool (single instance): "
+     << (void *)ThreadPool::m_Instance << std::endl;
+  os << indent << "Number Of Work Threads: "
+     << this->GetNumberOfWorkThreads() << std::endl;
+  os << indent << "Number Of Queued Jobs: "
+     << this->GetNumberOfQueuedJobs() << std::endl;
+  os << indent << "Thread Affinity: "
+     << ( m_ThreadAffinity ? "On" : "Off" ) << std::endl;
+}
+}
@@ -0,0 +1,88 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkThreadPool.h"
+#include <unistd.h>
+
+#if defined( __linux__ )
+#include <sched.h>
+#endif
+
+namespace itk
+{
+extern "C"
+{
+typedef void *( *c_worker_cast )(void *);
+}
+
+bool ThreadPool::PlatformSupportsWorkThreads()
+{
+  return true;
+}
+
+ThreadProcessIDType
+ThreadPool
+::CreateWorkerThread(WorkerType *worker)
+{
+  pthread_attr_t attr;
+  pthread_t      threadHandle;
+
+  pthread_attr_init(&attr);
+#if !defined( __CYGWIN__ )
+  pthread_attr_setscope(&attr, PTHREAD_SCOPE_SYSTEM);
+#endif
+
+  const int threadError =
+    pthread_create( &threadHandle, &attr, reinterpret_cast< c_worker_cast >( &ThreadPool::WorkerMain ),
+                    reinterpret_cast< void * >( worker ) );
+  pthread_attr_destroy(&attr);
+  if ( threadError != 0 )
+    {
+    itkGenericExceptionMacro(<< "Unable to create a thread.  pthread_create() returned "
+                             << threadError);
+    }
+  return threadHandle;
+}
+
+void
+ThreadPool
+::JoinWorkerThread(ThreadProcessIDType id)
+{
+  pthread_join(id, 0);
+}
+
+void
+ThreadPool
+::SetWorkerThreadAffinity(ThreadProcessIDType id, ThreadIdType core)
+{
+#if defined( __linux__ ) && defined( CPU_SET )
+  long numberOfCores = sysconf(_SC_NPROCESSORS_ONLN);
+  if ( numberOfCores < 1 )
+    {
+    numberOfCores = 1;
+    }
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  CPU_SET(core % numberOfCores, &cpuSet);
+  // Pinning is only a hint, failure leaves the thread free to migrate.
+  pthread_setaffinity_np(id, sizeof( cpu_set_t ), &cpuSet);
+#else
+  (void)id;
+  (void)core;
+#endif
+}
+} // end namespace itk
@@ -0,0 +1,63 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkThreadPool.h"
+#include "itkWindows.h"
+#include <process.h>
+
+namespace itk
+{
+bool ThreadPool::PlatformSupportsWorkThreads()
+{
+  return true;
+}
+
+ThreadProcessIDType
+ThreadPool
+::CreateWorkerThread(WorkerType *worker)
+{
+  // Using _beginthreadex on a PC
+  DWORD  threadId;
+  HANDLE threadHandle =  (HANDLE)_beginthreadex(0, 0,
+                                                ( unsigned int (__stdcall *)(void *) ) &ThreadPool::WorkerMain,
+                                                ( (void *)worker ), 0, (unsigned int *)&threadId);
+  if ( threadHandle == NULL )
+    {
+    itkGenericExceptionMacro(<< "Error in thread creation !!!");
+    }
+  return threadHandle;
+}
+
+void
+ThreadPool
+::JoinWorkerThread(ThreadProcessIDType id)
+{
+  WaitForSingleObject(id, INFINITE);
+  CloseHandle(id);
+}
+
+void
+ThreadPool
+::SetWorkerThreadAffinity(ThreadProcessIDType id, ThreadIdType core)
+{
+  SYSTEM_INFO sysInfo;
+  GetSystemInfo(&sysInfo);
+  const DWORD numberOfCores = sysInfo.dwNumberOfProcessors > 0 ? sysInfo.dwNumberOfProcessors : 1;
+  // Pinning is only a hint, failure leaves the thread free to migrate.
+  SetThreadAffinityMask( id, static_cast< DWORD_PTR >( 1 ) << ( core % numberOfCores ) );
+}
+} // end namespace itk
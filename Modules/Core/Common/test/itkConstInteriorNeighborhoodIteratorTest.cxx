@@ -0,0 +1,192 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkConstInteriorNeighborhoodIterator.h"
+#include "itkConstNeighborhoodIterator.h"
+#include "itkNeighborhoodAlgorithm.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkVectorImage.h"
+
+// Checks that the interior iterator walks region like a
+// ConstNeighborhoodIterator, with the same neighbors.
+template< class TImage >
+bool CompareWithNeighborhoodIterator(const TImage *image,
+                                     const typename TImage::RegionType & region,
+                                     const typename TImage::SizeType & radius)
+{
+  typedef itk::ConstInteriorNeighborhoodIterator< TImage > InteriorIteratorType;
+  typedef itk::ConstNeighborhoodIterator< TImage >         NeighborhoodIteratorType;
+
+  InteriorIteratorType     iit(radius, image, region);
+  NeighborhoodIteratorType nit(radius, image, region);
+
+  if ( iit.Size() != nit.Size() || iit.GetCenterNeighborhoodIndex() != nit.GetCenterNeighborhoodIndex() )
+    {
+    std::cerr << "Size " << iit.Size() << " instead of " << nit.Size() << std::endl;
+    return false;
+    }
+  for ( unsigned int i = 0; i < iit.Size(); ++i )
+    {
+    if ( iit.GetOffset(i) != nit.GetOffset(i) )
+      {
+      std::cerr << "Offset " << i << " is " << iit.GetOffset(i)
+                << " instead of " << nit.GetOffset(i) << std::endl;
+      return false;
+      }
+    }
+
+  itk::SizeValueType count = 0;
+  for ( nit.GoToBegin(); !nit.IsAtEnd(); ++nit, ++iit, ++count )
+    {
+    if ( iit.IsAtEnd() )
+      {
+      std::cerr << "The iterator ended after " << count << " pixels." << std::endl;
+      return false;
+      }
+    if ( iit.GetIndex() != nit.GetIndex() )
+      {
+      std::cerr << "Index " << iit.GetIndex() << " instead of " << nit.GetIndex() << std::endl;
+      return false;
+      }
+    if ( iit.GetCenterPixel() != nit.GetCenterPixel() )
+      {
+      std::cerr << "Wrong center pixel at " << nit.GetIndex() << std::endl;
+      return false;
+      }
+    for ( unsigned int i = 0; i < iit.Size(); ++i )
+      {
+      if ( iit.GetPixel(i) != nit.GetPixel(i) )
+        {
+        std::cerr << "Wrong neighbor " << i << " at " << nit.GetIndex() << std::endl;
+        return false;
+        }
+      }
+    }
+  if ( !iit.IsAtEnd() || count != region.GetNumberOfPixels() )
+    {
+    std::cerr << "The iterator did not end after " << count << " pixels." << std::endl;
+    return false;
+    }
+  return true;
+}
+
+int itkConstInteriorNeighborhoodIteratorTest(int, char* [])
+{
+  typedef itk::Image< int, 3 >         ImageType;
+  typedef itk::VectorImage< float, 2 > VectorImageType;
+
+  // Image whose pixels hold their position in the buffer
+  ImageType::IndexType  start = {{ -3, 5, 2 }};
+  ImageType::SizeType   size = {{ 11, 9, 7 }};
+  ImageType::RegionType region(start, size);
+  ImageType::Pointer    image = ImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+  int value = 0;
+  for ( itk::ImageRegionIteratorWithIndex< ImageType > it(image, region); !it.IsAtEnd(); ++it )
+    {
+    it.Set(value++);
+    }
+
+  ImageType::SizeType radius = {{ 2, 1, 3 }};
+  ImageType::RegionType interior = region;
+  interior.ShrinkByRadius(radius);
+  if ( !CompareWithNeighborhoodIterator< ImageType >(image, interior, radius) )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Region of a single line
+  ImageType::RegionType line = interior;
+  line.SetSize(1, 1);
+  line.SetSize(2, 1);
+  if ( !CompareWithNeighborhoodIterator< ImageType >(image, line, radius) )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Neighborhoods outside the buffer
+  if ( itk::ConstInteriorNeighborhoodIterator< ImageType >::IsInteriorRegion(radius, image, region) )
+    {
+    std::cerr << "The region is not interior." << std::endl;
+    return EXIT_FAILURE;
+    }
+  try
+    {
+    itk::ConstInteriorNeighborhoodIterator< ImageType > iit(radius, image, region);
+    std::cerr << "Exception not thrown." << std::endl;
+    return EXIT_FAILURE;
+    }
+  catch ( itk::ExceptionObject & err )
+    {
+    std::cout << "Expected exception caught: " << err.GetDescription() << std::endl;
+    }
+
+  // Pixels of variable length
+  VectorImageType::SizeType   vectorSize = {{ 8, 6 }};
+  VectorImageType::RegionType vectorRegion;
+  vectorRegion.SetSize(vectorSize);
+  VectorImageType::Pointer vectorImage = VectorImageType::New();
+  vectorImage->SetRegions(vectorRegion);
+  vectorImage->SetNumberOfComponentsPerPixel(3);
+  vectorImage->Allocate();
+  for ( itk::SizeValueType i = 0; i < vectorRegion.GetNumberOfPixels() * 3; ++i )
+    {
+    vectorImage->GetBufferPointer()[i] = static_cast< float >( i );
+    }
+  VectorImageType::SizeType vectorRadius = {{ 1, 2 }};
+  VectorImageType::RegionType vectorInterior = vectorRegion;
+  vectorInterior.ShrinkByRadius(vectorRadius);
+  if ( !CompareWithNeighborhoodIterator< VectorImageType >(vectorImage, vectorInterior, vectorRadius) )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // The tiles cover the region once
+  typedef itk::NeighborhoodAlgorithm::ImageInteriorTilesCalculator< ImageType > TilesCalculatorType;
+  TilesCalculatorType::TileListType tiles = TilesCalculatorType()(interior, radius, 256);
+  if ( tiles.size() < 2 )
+    {
+    std::cerr << "The region is not split into tiles." << std::endl;
+    return EXIT_FAILURE;
+    }
+  image->FillBuffer(0);
+  for ( TilesCalculatorType::TileListType::const_iterator tit = tiles.begin(); tit != tiles.end(); ++tit )
+    {
+    if ( !interior.IsInside(*tit) )
+      {
+      std::cerr << "Tile " << *tit << " is outside the region." << std::endl;
+      return EXIT_FAILURE;
+      }
+    for ( itk::ImageRegionIteratorWithIndex< ImageType > it(image, *tit); !it.IsAtEnd(); ++it )
+      {
+      it.Set(it.Get() + 1);
+      }
+    }
+  for ( itk::ImageRegionIteratorWithIndex< ImageType > it(image, region); !it.IsAtEnd(); ++it )
+    {
+    if ( it.Get() != ( interior.IsInside(it.GetIndex()) ? 1 : 0 ) )
+      {
+      std::cerr << "Pixel " << it.GetIndex() << " is in " << it.Get() << " tiles." << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
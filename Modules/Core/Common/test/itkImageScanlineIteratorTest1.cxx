@@ -0,0 +1,188 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include <iostream>
+
+#include "itkImageScanlineIterator.h"
+#include "itkImageRegionConstIterator.h"
+
+// Walk the region with a scanline iterator and a region iterator and
+// check that they visit the same pixels in the same order.
+template< class TImage >
+bool ScanlineVisitsRegion(const TImage *image, const typename TImage::RegionType & region)
+{
+  itk::ImageScanlineConstIterator< TImage > sit(image, region);
+  itk::ImageRegionConstIterator< TImage >   rit(image, region);
+
+  typename TImage::SizeValueType lines = 0;
+  sit.GoToBegin();
+  while ( !sit.IsAtEnd() )
+    {
+    if ( sit.GetIndex()[0] != region.GetIndex()[0] )
+      {
+      std::cerr << "Line does not start at the region start: " << sit.GetIndex() << std::endl;
+      return false;
+      }
+    if ( sit.GetLineEndOffset() - sit.GetLineBeginOffset()
+         != static_cast< itk::OffsetValueType >( region.GetSize()[0] ) )
+      {
+      std::cerr << "Wrong line length at " << sit.GetIndex() << std::endl;
+      return false;
+      }
+    while ( !sit.IsAtEndOfLine() )
+      {
+      if ( rit.IsAtEnd() || sit.GetIndex() != rit.GetIndex() || sit.Get() != rit.Get() )
+        {
+        std::cerr << "Mismatch at " << sit.GetIndex() << std::endl;
+        return false;
+        }
+      ++sit;
+      ++rit;
+      }
+    sit.NextLine();
+    ++lines;
+    }
+  if ( !rit.IsAtEnd() )
+    {
+    std::cerr << "Scanline iterator stopped before the end of the region" << std::endl;
+    return false;
+    }
+  const typename TImage::SizeValueType expectedLines =
+    region.GetNumberOfPixels() / ( region.GetSize()[0] > 0 ? region.GetSize()[0] : 1 );
+  if ( lines != expectedLines )
+    {
+    std::cerr << "Visited " << lines << " lines instead of " << expectedLines << std::endl;
+    return false;
+    }
+  return true;
+}
+
+int itkImageScanlineIteratorTest1(int, char* [] )
+{
+  typedef itk::Image< int, 3 > ImageType;
+
+  ImageType::Pointer image = ImageType::New();
+
+  ImageType::SizeType  size  = {{ 11, 7, 5 }};
+  ImageType::IndexType start = {{ -2, 3, 1 }};
+  ImageType::RegionType largestRegion(start, size);
+  image->SetRegions(largestRegion);
+  image->Allocate();
+
+  // Fill the image through the write access of the scanline iterator.
+  itk::ImageScanlineIterator< ImageType > it(image, largestRegion);
+  int value = 0;
+  while ( !it.IsAtEnd() )
+    {
+    while ( !it.IsAtEndOfLine() )
+      {
+      it.Set(value++);
+      ++it;
+      }
+    it.NextLine();
+    }
+  if ( value != static_cast< int >( largestRegion.GetNumberOfPixels() ) )
+    {
+    std::cerr << "Set " << value << " pixels instead of "
+              << largestRegion.GetNumberOfPixels() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  int status = EXIT_SUCCESS;
+
+  if ( !ScanlineVisitsRegion(image.GetPointer(), largestRegion) )
+    {
+    status = EXIT_FAILURE;
+    }
+
+  // A strict sub-region
+  ImageType::SizeType  subSize  = {{ 4, 3, 2 }};
+  ImageType::IndexType subStart = {{ 1, 4, 2 }};
+  ImageType::RegionType subRegion(subStart, subSize);
+  if ( !ScanlineVisitsRegion(image.GetPointer(), subRegion) )
+    {
+    status = EXIT_FAILURE;
+    }
+
+  // A region made of a single line
+  subSize[1] = 1;
+  subSize[2] = 1;
+  subRegion.SetSize(subSize);
+  if ( !ScanlineVisitsRegion(image.GetPointer(), subRegion) )
+    {
+    status = EXIT_FAILURE;
+    }
+
+  // An empty region
+  subSize.Fill(0);
+  subRegion.SetSize(subSize);
+  if ( !ScanlineVisitsRegion(image.GetPointer(), subRegion) )
+    {
+    status = EXIT_FAILURE;
+    }
+
+  // Value() and GoToBeginOfLine()/GoToEndOfLine()
+  it.GoToBegin();
+  it.NextLine();
+  it.GoToEndOfLine();
+  if ( !it.IsAtEndOfLine() )
+    {
+    std::cerr << "GoToEndOfLine() failed" << std::endl;
+    status = EXIT_FAILURE;
+    }
+  it.GoToBeginOfLine();
+  it.Value() = -1;
+  ImageType::IndexType secondLine = start;
+  secondLine[1] += 1;
+  if ( image->GetPixel(secondLine) != -1 )
+    {
+    std::cerr << "Value() did not write at the beginning of the second line" << std::endl;
+    status = EXIT_FAILURE;
+    }
+
+  // SetIndex() in the middle of a line
+  ImageType::IndexType middle = start;
+  middle[0] += 5;
+  middle[2] += 2;
+  it.SetIndex(middle);
+  int count = 0;
+  while ( !it.IsAtEndOfLine() )
+    {
+    ++count;
+    ++it;
+    }
+  if ( count != static_cast< int >( size[0] ) - 5 )
+    {
+    std::cerr << "SetIndex() did not set the line end correctly" << std::endl;
+    status = EXIT_FAILURE;
+    }
+
+  // GoToEnd()
+  it.GoToEnd();
+  if ( !it.IsAtEnd() )
+    {
+    std::cerr << "GoToEnd() failed" << std::endl;
+    status = EXIT_FAILURE;
+    }
+
+  if ( status == EXIT_SUCCESS )
+    {
+    std::cout << "Test passed." << std::endl;
+    }
+  return status;
+}
@@ -0,0 +1,183 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageSource.h"
+#include "itkImageRegionIterator.h"
+#include "itkSimpleFastMutexLock.h"
+
+namespace itk
+{
+namespace ImageSourceDynamicMultiThreadingTest
+{
+/** Source incrementing every pixel of the regions it is asked to generate,
+ * and counting the ThreadedGenerateData() calls per thread. */
+template< class TOutputImage >
+class CountingImageSource:public ImageSource< TOutputImage >
+{
+public:
+  typedef CountingImageSource         Self;
+  typedef ImageSource< TOutputImage > Superclass;
+  typedef SmartPointer< Self >        Pointer;
+  typedef SmartPointer< const Self >  ConstPointer;
+
+  itkNewMacro(Self);
+  itkTypeMacro(CountingImageSource, ImageSource);
+
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+
+  void SetSize(const typename TOutputImage::SizeType & size)
+  {
+    m_Size = size;
+  }
+
+  unsigned int GetNumberOfCalls() const
+  {
+    return m_NumberOfCalls;
+  }
+
+  unsigned int GetNumberOfCallingThreads() const
+  {
+    unsigned int count = 0;
+    for ( size_t i = 0; i < m_CallsPerThread.size(); ++i )
+      {
+      if ( m_CallsPerThread[i] > 0 )
+        {
+        ++count;
+        }
+      }
+    return count;
+  }
+
+protected:
+  CountingImageSource():m_NumberOfCalls(0)
+  {
+    m_Size.Fill(0);
+  }
+
+  virtual void GenerateOutputInformation()
+  {
+    TOutputImage *output = this->GetOutput();
+    typename TOutputImage::RegionType region;
+    region.SetSize(m_Size);
+    output->SetLargestPossibleRegion(region);
+  }
+
+  virtual void BeforeThreadedGenerateData()
+  {
+    this->GetOutput()->FillBuffer(0);
+    m_NumberOfCalls = 0;
+    m_CallsPerThread.assign(this->GetNumberOfThreads(), 0);
+  }
+
+  virtual void ThreadedGenerateData(const OutputImageRegionType & region, ThreadIdType threadId)
+  {
+    ImageRegionIterator< TOutputImage > it(this->GetOutput(), region);
+    for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+      {
+      it.Set( it.Get() + 1 );
+      }
+    // Every thread only touches its own counter
+    ++m_CallsPerThread[threadId];
+    m_Lock.Lock();
+    ++m_NumberOfCalls;
+    m_Lock.Unlock();
+  }
+
+private:
+  CountingImageSource(const Self &); //purposely not implemented
+  void operator=(const Self &);      //purposely not implemented
+
+  typename TOutputImage::SizeType m_Size;
+  unsigned int                    m_NumberOfCalls;
+  std::vector< unsigned int >     m_CallsPerThread;
+  SimpleFastMutexLock             m_Lock;
+};
+}
+}
+
+int itkImageSourceDynamicMultiThreadingTest(int, char* [])
+{
+  typedef itk::Image< unsigned int, 3 > ImageType;
+  typedef itk::ImageSourceDynamicMultiThreadingTest::CountingImageSource< ImageType > SourceType;
+
+  SourceType::Pointer source = SourceType::New();
+
+  ImageType::SizeType size;
+  size[0] = 17;
+  size[1] = 23;
+  size[2] = 41;
+  source->SetSize(size);
+  source->SetNumberOfThreads(4);
+
+  if ( source->GetDynamicMultiThreading() )
+    {
+    std::cerr << "DynamicMultiThreading is expected to be off by default" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Static scheduling: at most one call per thread.
+  source->Update();
+  if ( source->GetNumberOfCalls() > source->GetNumberOfThreads() )
+    {
+    std::cerr << "Static scheduling made " << source->GetNumberOfCalls()
+              << " calls with " << source->GetNumberOfThreads() << " threads" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Dynamic scheduling: many pieces, each pixel generated exactly once.
+  source->DynamicMultiThreadingOn();
+  source->SetNumberOfPiecesPerThread(0);
+  if ( source->GetNumberOfPiecesPerThread() != 1 )
+    {
+    std::cerr << "NumberOfPiecesPerThread is expected to be clamped to 1" << std::endl;
+    return EXIT_FAILURE;
+    }
+  source->SetNumberOfPiecesPerThread(5);
+  source->Update();
+
+  const unsigned int expectedPieces =
+    itk::ImageSourceCommon::GetGlobalDefaultSplitter()->GetNumberOfSplits(
+      source->GetOutput()->GetRequestedRegion(), source->GetNumberOfThreads() * 5 );
+  if ( source->GetNumberOfCalls() != expectedPieces )
+    {
+    std::cerr << "Dynamic scheduling made " << source->GetNumberOfCalls()
+              << " calls instead of " << expectedPieces << std::endl;
+    return EXIT_FAILURE;
+    }
+  if ( source->GetNumberOfCallingThreads() > source->GetNumberOfThreads() )
+    {
+    std::cerr << "Unexpected thread ids in ThreadedGenerateData" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  itk::ImageRegionIterator< ImageType > it( source->GetOutput(),
+                                            source->GetOutput()->GetBufferedRegion() );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    if ( it.Get() != 1 )
+      {
+      std::cerr << "Pixel " << it.GetIndex() << " generated " << it.Get() << " times" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  source->Print(std::cout);
+
+  std::cout << "[TEST PASSED]" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -17,6 +17,8 @@
  *=========================================================================*/
 
 #include "itkMultiThreader.h"
+#include "itkNumericTraits.h"
+#include "itkSimpleFastMutexLock.h"
 
 bool VerifyRange(int value, int min, int max, const char * msg)
 {
@@ -38,8 +40,21 @@ bool VerifyRange(int value, int min, int max, const char * msg)
 bool SetAndVerifyGlobalMaximumNumberOfThreads( int value )
 {
   itk::MultiThreader::SetGlobalMaximumNumberOfThreads( value );
-  return VerifyRange( itk::MultiThreader::GetGlobalMaximumNumberOfThreads(),
-        1, ITK_MAX_THREADS, "Range error in MaximumNumberOfThreads");
+  const int maximum = itk::MultiThreader::GetGlobalMaximumNumberOfThreads();
+
+#if defined(ITK_USE_PTHREADS) || defined(ITK_USE_WIN32_THREADS)
+  // ITK_MAX_THREADS is not a ceiling anymore: reasonable values must be
+  // accepted as they are.
+  if( value >= 1 && value <= 2 * ITK_MAX_THREADS && maximum != value )
+    {
+    std::cerr << "GlobalMaximumNumberOfThreads " << value
+              << " was changed to " << maximum << std::endl;
+    return false;
+    }
+#endif
+
+  return VerifyRange( maximum,
+        1, itk::NumericTraits< int >::max(), "Range error in MaximumNumberOfThreads");
 }
 
 bool SetAndVerifyGlobalDefaultNumberOfThreads( int value )
@@ -50,6 +65,47 @@ bool SetAndVerifyGlobalDefaultNumberOfThreads( int value )
         "Range error in DefaultNumberOfThreads");
 }
 
+ITK_THREAD_RETURN_TYPE MarkThreadMethod( void * arg )
+{
+  typedef itk::MultiThreader::ThreadInfoStruct ThreadInfoType;
+  ThreadInfoType * info = static_cast< ThreadInfoType * >( arg );
+  std::vector< int > * marks = static_cast< std::vector< int > * >( info->UserData );
+  ( *marks )[info->ThreadID] += 1;
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+struct SpawnThreadData
+{
+  itk::MultiThreader *     Spawner;
+  itk::SimpleFastMutexLock Lock;
+  int                      NumberOfSpawnedThreads;
+};
+
+ITK_THREAD_RETURN_TYPE SpawnedThreadMethod( void * arg )
+{
+  typedef itk::MultiThreader::ThreadInfoStruct ThreadInfoType;
+  ThreadInfoType * info = static_cast< ThreadInfoType * >( arg );
+  SpawnThreadData * data = static_cast< SpawnThreadData * >( info->UserData );
+  data->Lock.Lock();
+  ++data->NumberOfSpawnedThreads;
+  data->Lock.Unlock();
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+// Spawn and terminate threads on a threader shared with the other threads
+ITK_THREAD_RETURN_TYPE SpawningThreadMethod( void * arg )
+{
+  typedef itk::MultiThreader::ThreadInfoStruct ThreadInfoType;
+  ThreadInfoType * info = static_cast< ThreadInfoType * >( arg );
+  SpawnThreadData * data = static_cast< SpawnThreadData * >( info->UserData );
+  for( unsigned int i = 0; i < 20; ++i )
+    {
+    const itk::ThreadIdType id = data->Spawner->SpawnThread( SpawnedThreadMethod, data );
+    data->Spawner->TerminateThread( id );
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+
 bool SetAndVerifyNumberOfThreads( int value, itk::MultiThreader * threader )
 {
   threader->SetNumberOfThreads( value );
@@ -91,6 +147,7 @@ int itkMultiThreaderTest(int argc, char* argv[])
   result &= SetAndVerifyGlobalMaximumNumberOfThreads(  ITK_MAX_THREADS  );
   result &= SetAndVerifyGlobalMaximumNumberOfThreads(  ITK_MAX_THREADS - 1 );
   result &= SetAndVerifyGlobalMaximumNumberOfThreads(  ITK_MAX_THREADS + 1 );
+  result &= SetAndVerifyGlobalMaximumNumberOfThreads(  2 * ITK_MAX_THREADS );
 
   if( !result )
     {
@@ -126,6 +183,54 @@ int itkMultiThreaderTest(int argc, char* argv[])
 
   }
 
+#if defined(ITK_USE_PTHREADS) || defined(ITK_USE_WIN32_THREADS)
+  {
+  // Execute with more threads than ITK_MAX_THREADS
+  const itk::ThreadIdType manyThreads = ITK_MAX_THREADS + 8;
+  itk::MultiThreader::SetGlobalMaximumNumberOfThreads( manyThreads );
+
+  itk::MultiThreader::Pointer threader3 = itk::MultiThreader::New();
+  threader3->SetNumberOfThreads( manyThreads );
+  if( threader3->GetNumberOfThreads() != manyThreads )
+    {
+    std::cerr << "NumberOfThreads " << manyThreads << " was changed to "
+              << threader3->GetNumberOfThreads() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::vector< int > marks( manyThreads, 0 );
+  threader3->SetSingleMethod( MarkThreadMethod, &marks );
+  threader3->SingleMethodExecute();
+  for( itk::ThreadIdType i = 0; i < manyThreads; ++i )
+    {
+    if( marks[i] != 1 )
+      {
+      std::cerr << "Thread " << i << " was executed " << marks[i] << " times" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  }
+
+  {
+  // Spawn threads concurrently from several threads
+  itk::MultiThreader::Pointer spawner = itk::MultiThreader::New();
+  SpawnThreadData data;
+  data.Spawner = spawner;
+  data.NumberOfSpawnedThreads = 0;
+
+  itk::MultiThreader::Pointer threader4 = itk::MultiThreader::New();
+  threader4->SetNumberOfThreads( 8 );
+  threader4->SetSingleMethod( SpawningThreadMethod, &data );
+  threader4->SingleMethodExecute();
+  if( data.NumberOfSpawnedThreads != 8 * 20 )
+    {
+    std::cerr << data.NumberOfSpawnedThreads << " threads were spawned instead of "
+              << 8 * 20 << std::endl;
+    return EXIT_FAILURE;
+    }
+  }
+#endif
+
   return EXIT_SUCCESS;
 }
 
@@ -0,0 +1,237 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkPipelineTracer.h"
+#include "itkUnaryFunctorImageFilter.h"
+#include "itkImage.h"
+
+#include <sstream>
+
+namespace
+{
+template< class TPixel >
+class PipelineTracerTestFunctor
+{
+public:
+  TPixel operator()(const TPixel & value) const
+  {
+    return value + 1;
+  }
+  bool operator!=(const PipelineTracerTestFunctor &) const
+  {
+    return false;
+  }
+  bool operator==(const PipelineTracerTestFunctor & other) const
+  {
+    return !( *this != other );
+  }
+};
+}
+
+int itkPipelineTracerTest(int, char *[])
+{
+  typedef itk::Image< short, 2 > ImageType;
+  typedef itk::UnaryFunctorImageFilter< ImageType, ImageType,
+                                        PipelineTracerTestFunctor< short > > FilterType;
+
+  ImageType::SizeType size;
+  size.Fill(64);
+  ImageType::RegionType region(size);
+  ImageType::Pointer    image = ImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+  image->FillBuffer(1);
+
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(image);
+  filter->SetNumberOfThreads(2);
+
+  // Nothing is recorded while the tracer is disabled.
+  itk::PipelineTracer::EnabledOff();
+  itk::PipelineTracer::Clear();
+  filter->Update();
+  if ( !itk::PipelineTracer::GetEvents().empty() )
+    {
+    std::cerr << "Events were recorded with the tracer disabled." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  itk::PipelineTracer::EnabledOn();
+  filter->Modified();
+  filter->Update();
+  itk::PipelineTracer::EnabledOff();
+
+  const itk::PipelineTracer::EventContainerType events =
+    itk::PipelineTracer::GetEvents();
+
+  unsigned int       generateDataEvents = 0;
+  itk::SizeValueType  threadedPixels = 0;
+  itk::ThreadIdType   pipelineThread = 0;
+  itk::ThreadIdType   firstThreadSystemThread = 0;
+  bool                otherSystemThread = false;
+  for ( unsigned int i = 0; i < events.size(); ++i )
+    {
+    const itk::PipelineTracer::EventType & event = events[i];
+    std::cout << event.Category << " " << event.Name << " thread " << event.ThreadId
+              << " system thread " << event.SystemThread
+              << " start " << event.Start << " duration " << event.Duration
+              << " bytes " << event.OutputBytes << std::endl;
+    if ( event.Name != filter->GetNameOfClass() || event.Object != filter.GetPointer() )
+      {
+      std::cerr << "Unexpected event of " << event.Name << std::endl;
+      return EXIT_FAILURE;
+      }
+    if ( event.Start < 0.0 || event.Duration < 0.0 )
+      {
+      std::cerr << "Negative time in event." << std::endl;
+      return EXIT_FAILURE;
+      }
+    if ( event.Category == "GenerateData" )
+      {
+      ++generateDataEvents;
+      if ( event.ThreadId != 0
+           || event.RequestedRegionPixels != region.GetNumberOfPixels()
+           || event.OutputBytes != region.GetNumberOfPixels() * sizeof( short ) )
+        {
+        std::cerr << "Wrong GenerateData event." << std::endl;
+        return EXIT_FAILURE;
+        }
+      pipelineThread = event.SystemThread;
+      }
+    else if ( event.Category == "ThreadedGenerateData" )
+      {
+      if ( event.ThreadId == 0 )
+        {
+        std::cerr << "ThreadedGenerateData event on the pipeline thread." << std::endl;
+        return EXIT_FAILURE;
+        }
+      threadedPixels += event.RequestedRegionPixels;
+      if ( event.ThreadId == 1 )
+        {
+        firstThreadSystemThread = event.SystemThread;
+        }
+      else
+        {
+        otherSystemThread = true;
+        }
+      }
+    else
+      {
+      std::cerr << "Unexpected category " << event.Category << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  if ( generateDataEvents != 1 )
+    {
+    std::cerr << "Expected one GenerateData event, got " << generateDataEvents << std::endl;
+    return EXIT_FAILURE;
+    }
+  if ( threadedPixels != region.GetNumberOfPixels() )
+    {
+    std::cerr << "The threads processed " << threadedPixels << " pixels instead of "
+              << region.GetNumberOfPixels() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // The first thread of the execution is the one updating the pipeline,
+  // the other ones are created for the execution.
+  if ( firstThreadSystemThread != pipelineThread )
+    {
+    std::cerr << "The first thread did not run on the pipeline thread." << std::endl;
+    return EXIT_FAILURE;
+    }
+  if ( otherSystemThread && !filter->GetMultiThreader()->GetUseThreadPool() )
+    {
+    for ( unsigned int i = 0; i < events.size(); ++i )
+      {
+      if ( events[i].ThreadId > 1 && events[i].SystemThread == pipelineThread )
+        {
+        std::cerr << "Thread " << events[i].ThreadId - 1
+                  << " was recorded on the pipeline thread." << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  std::ostringstream trace;
+  itk::PipelineTracer::WriteChromeTrace(trace);
+  std::cout << trace.str() << std::endl;
+  if ( trace.str().find("\"traceEvents\"") == std::string::npos
+       || trace.str().find("\"ph\":\"X\"") == std::string::npos )
+    {
+    std::cerr << "Malformed trace." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::ostringstream report;
+  itk::PipelineTracer::Report(report);
+  std::cout << report.str() << std::endl;
+  if ( report.str().find( filter->GetNameOfClass() ) == std::string::npos )
+    {
+    std::cerr << "The report does not list the filter." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Every filter has a probe of its own, even in the same class.
+  FilterType::Pointer second = FilterType::New();
+  second->SetInput( filter->GetOutput() );
+  itk::PipelineTracer::EnabledOn();
+  filter->Modified();
+  second->Update();
+  itk::PipelineTracer::EnabledOff();
+
+  std::ostringstream instanceReport;
+  itk::PipelineTracer::Report(instanceReport);
+  std::cout << instanceReport.str() << std::endl;
+  std::ostringstream firstObject;
+  firstObject << "(" << static_cast< const void * >( filter.GetPointer() ) << ")";
+  std::ostringstream secondObject;
+  secondObject << "(" << static_cast< const void * >( second.GetPointer() ) << ")";
+  if ( instanceReport.str().find( firstObject.str() ) == std::string::npos
+       || instanceReport.str().find( secondObject.str() ) == std::string::npos )
+    {
+    std::cerr << "The report does not list both filters." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // The names are escaped in the trace.
+  itk::PipelineTracer::EnabledOn();
+  itk::PipelineTracer::EventType quoted;
+  quoted.Name = "A \"quoted\" \\ name";
+  quoted.Category = "GenerateData";
+  itk::PipelineTracer::AddEvent(quoted);
+  itk::PipelineTracer::EnabledOff();
+  std::ostringstream quotedTrace;
+  itk::PipelineTracer::WriteChromeTrace(quotedTrace);
+  if ( quotedTrace.str().find("\"name\":\"A \\\"quoted\\\" \\\\ name\"") == std::string::npos )
+    {
+    std::cerr << "The name is not escaped in the trace: " << quotedTrace.str() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Enabling the tracer again starts a new trace.
+  itk::PipelineTracer::EnabledOn();
+  itk::PipelineTracer::EnabledOff();
+  if ( !itk::PipelineTracer::GetEvents().empty() )
+    {
+    std::cerr << "Enabling the tracer did not clear the events." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,226 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMultiThreader.h"
+#include "itkThreadArena.h"
+#include "itkSimpleFastMutexLock.h"
+
+namespace
+{
+class ThreadArenaTestUserData
+{
+public:
+  ThreadArenaTestUserData()
+  {
+    m_NestedThreads = 0;
+    m_OuterNumberOfThreads = 0;
+    m_MaximumNestedNumberOfThreads = 0;
+    m_MaximumActiveThreads = 0;
+  }
+
+  itk::ThreadIdType        m_NestedThreads;
+  itk::ThreadIdType        m_OuterNumberOfThreads;
+  itk::ThreadIdType        m_MaximumNestedNumberOfThreads;
+  itk::ThreadIdType        m_MaximumActiveThreads;
+  itk::SimpleFastMutexLock m_Mutex;
+};
+
+ITK_THREAD_RETURN_TYPE ThreadArenaTestInnerCallback( void *arg )
+{
+  itk::MultiThreader::ThreadInfoStruct *info =
+    static_cast< itk::MultiThreader::ThreadInfoStruct * >( arg );
+  ThreadArenaTestUserData *data = static_cast< ThreadArenaTestUserData * >( info->UserData );
+
+  itk::ThreadArena *arena = itk::ThreadArena::GetCurrentThreadArena();
+
+  data->m_Mutex.Lock();
+  if ( info->NumberOfThreads > data->m_MaximumNestedNumberOfThreads )
+    {
+    data->m_MaximumNestedNumberOfThreads = info->NumberOfThreads;
+    }
+  if ( arena && arena->GetNumberOfActiveThreads() > data->m_MaximumActiveThreads )
+    {
+    data->m_MaximumActiveThreads = arena->GetNumberOfActiveThreads();
+    }
+  data->m_Mutex.Unlock();
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+ITK_THREAD_RETURN_TYPE ThreadArenaTestOuterCallback( void *arg )
+{
+  itk::MultiThreader::ThreadInfoStruct *info =
+    static_cast< itk::MultiThreader::ThreadInfoStruct * >( arg );
+  ThreadArenaTestUserData *data = static_cast< ThreadArenaTestUserData * >( info->UserData );
+
+  data->m_Mutex.Lock();
+  data->m_OuterNumberOfThreads = info->NumberOfThreads;
+  data->m_Mutex.Unlock();
+
+  // The inner threader has no arena of its own: it uses the arena of the
+  // thread executing it.
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  threader->SetNumberOfThreads( data->m_NestedThreads );
+  threader->SetSingleMethod( ThreadArenaTestInnerCallback, data );
+  threader->SingleMethodExecute();
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+bool ThreadArenaTestCheck( const char *name, itk::ThreadIdType value, itk::ThreadIdType expected )
+{
+  if ( value != expected )
+    {
+    std::cerr << name << ": got " << value << ", expected " << expected << std::endl;
+    return false;
+    }
+  return true;
+}
+
+bool ThreadArenaTestRun( bool useThreadPool )
+{
+  bool passed = true;
+
+  itk::ThreadArena::Pointer arena = itk::ThreadArena::New();
+  arena->SetMaximumNumberOfThreads( 3 );
+
+  // Arena set on the threader: the outer execution gets the whole budget
+  // and the nested executions run on their calling thread.
+  {
+  ThreadArenaTestUserData data;
+  data.m_NestedThreads = 4;
+
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  threader->SetUseThreadPool( useThreadPool );
+  threader->SetThreadArena( arena );
+  threader->SetNumberOfThreads( 8 );
+  threader->SetSingleMethod( ThreadArenaTestOuterCallback, &data );
+  threader->SingleMethodExecute();
+
+  passed &= ThreadArenaTestCheck( "Outer threads", data.m_OuterNumberOfThreads, 3 );
+  passed &= ThreadArenaTestCheck( "Nested threads", data.m_MaximumNestedNumberOfThreads, 1 );
+  passed &= ThreadArenaTestCheck( "Active threads", data.m_MaximumActiveThreads, 3 );
+  passed &= ThreadArenaTestCheck( "Remaining threads", arena->GetNumberOfActiveThreads(), 0 );
+  passed &= ThreadArenaTestCheck( "Requested threads", threader->GetNumberOfThreads(), 8 );
+  }
+
+  // Arena of the calling thread: the thread in the scope counts as one.
+  {
+  ThreadArenaTestUserData data;
+  data.m_NestedThreads = 4;
+
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  threader->SetUseThreadPool( useThreadPool );
+  threader->SetNumberOfThreads( 8 );
+  threader->SetSingleMethod( ThreadArenaTestOuterCallback, &data );
+  {
+  itk::ThreadArena::Scope scope( arena );
+  passed &= ThreadArenaTestCheck( "Scope threads", arena->GetNumberOfActiveThreads(), 1 );
+  threader->SingleMethodExecute();
+  }
+
+  passed &= ThreadArenaTestCheck( "Scoped outer threads", data.m_OuterNumberOfThreads, 3 );
+  passed &= ThreadArenaTestCheck( "Scoped nested threads", data.m_MaximumNestedNumberOfThreads, 1 );
+  passed &= ThreadArenaTestCheck( "Scoped remaining threads", arena->GetNumberOfActiveThreads(), 0 );
+  if ( itk::ThreadArena::GetCurrentThreadArena() != 0 )
+    {
+    std::cerr << "The arena of the thread was not restored" << std::endl;
+    passed = false;
+    }
+  }
+
+  // Global default arena
+  {
+  ThreadArenaTestUserData data;
+  data.m_NestedThreads = 2;
+
+  itk::MultiThreader::SetGlobalDefaultThreadArena( arena );
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  threader->SetUseThreadPool( useThreadPool );
+  threader->SetNumberOfThreads( 2 );
+  threader->SetSingleMethod( ThreadArenaTestOuterCallback, &data );
+  threader->SingleMethodExecute();
+  itk::MultiThreader::SetGlobalDefaultThreadArena( 0 );
+
+  // 1 thread entering + 1 granted, the nested executions share the last one.
+  passed &= ThreadArenaTestCheck( "Default outer threads", data.m_OuterNumberOfThreads, 2 );
+  passed &= ThreadArenaTestCheck( "Default active threads", data.m_MaximumActiveThreads <= 3, 1 );
+  passed &= ThreadArenaTestCheck( "Default remaining threads", arena->GetNumberOfActiveThreads(), 0 );
+  }
+
+  // Without arena all the requested threads are used.
+  {
+  ThreadArenaTestUserData data;
+  data.m_NestedThreads = 4;
+
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  threader->SetUseThreadPool( useThreadPool );
+  threader->SetNumberOfThreads( 4 );
+  threader->SetSingleMethod( ThreadArenaTestOuterCallback, &data );
+  threader->SingleMethodExecute();
+
+  passed &= ThreadArenaTestCheck( "Unbounded outer threads", data.m_OuterNumberOfThreads, 4 );
+  passed &= ThreadArenaTestCheck( "Unbounded nested threads", data.m_MaximumNestedNumberOfThreads, 4 );
+  }
+
+  return passed;
+}
+}
+
+int itkThreadArenaTest( int, char *[] )
+{
+  itk::ThreadArena::Pointer arena = itk::ThreadArena::New();
+  arena->Print( std::cout );
+
+  arena->SetMaximumNumberOfThreads( 0 );
+  if ( arena->GetMaximumNumberOfThreads() != 1 )
+    {
+    std::cerr << "MaximumNumberOfThreads was not clamped to 1" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  arena->SetMaximumNumberOfThreads( 5 );
+  if ( arena->AcquireThreads( 3 ) != 3 || arena->AcquireThreads( 3 ) != 2
+       || arena->AcquireThreads( 1 ) != 0 )
+    {
+    std::cerr << "AcquireThreads does not respect the budget" << std::endl;
+    return EXIT_FAILURE;
+    }
+  arena->ReleaseThreads( 5 );
+  if ( arena->GetNumberOfActiveThreads() != 0 )
+    {
+    std::cerr << "ReleaseThreads did not release the threads" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+#if defined(ITK_USE_PTHREADS) || defined(ITK_USE_WIN32_THREADS)
+  if ( !ThreadArenaTestRun( false ) )
+    {
+    std::cerr << "[TEST FAILED] with threads created by the MultiThreader" << std::endl;
+    return EXIT_FAILURE;
+    }
+  if ( !ThreadArenaTestRun( true ) )
+    {
+    std::cerr << "[TEST FAILED] with the ThreadPool" << std::endl;
+    return EXIT_FAILURE;
+    }
+#endif
+
+  std::cout << "[TEST PASSED]" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,323 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMultiThreader.h"
+#include "itkThreadPool.h"
+#include "itkBarrier.h"
+
+namespace
+{
+const itk::ThreadIdType ThreadPoolTestMaximumThreads = 16;
+
+class ThreadPoolTestUserData
+{
+public:
+  ThreadPoolTestUserData()
+  {
+    for ( itk::ThreadIdType i = 0; i < ThreadPoolTestMaximumThreads; ++i )
+      {
+      m_Count[i] = 0;
+      }
+    m_NestedThreads = 0;
+  }
+
+  // Every thread writes its own slot, no locking is needed.
+  unsigned int      m_Count[ThreadPoolTestMaximumThreads];
+  itk::ThreadIdType m_NestedThreads;
+};
+
+ITK_THREAD_RETURN_TYPE ThreadPoolTestCallback( void *arg )
+{
+  itk::MultiThreader::ThreadInfoStruct *info =
+    static_cast< itk::MultiThreader::ThreadInfoStruct * >( arg );
+  ThreadPoolTestUserData *data = static_cast< ThreadPoolTestUserData * >( info->UserData );
+
+  ++data->m_Count[info->ThreadID];
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+ITK_THREAD_RETURN_TYPE ThreadPoolTestNestedCallback( void *arg )
+{
+  itk::MultiThreader::ThreadInfoStruct *info =
+    static_cast< itk::MultiThreader::ThreadInfoStruct * >( arg );
+  ThreadPoolTestUserData *data = static_cast< ThreadPoolTestUserData * >( info->UserData );
+
+  // Each outer thread runs its own inner threader on the pool.
+  ThreadPoolTestUserData inner;
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  threader->UseThreadPoolOn();
+  threader->SetNumberOfThreads( data->m_NestedThreads );
+  threader->SetSingleMethod( ThreadPoolTestCallback, &inner );
+  threader->SingleMethodExecute();
+
+  for ( itk::ThreadIdType i = 0; i < threader->GetNumberOfThreads(); ++i )
+    {
+    data->m_Count[info->ThreadID] += inner.m_Count[i];
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+ITK_THREAD_RETURN_TYPE ThreadPoolTestThrowingCallback( void *arg )
+{
+  itk::MultiThreader::ThreadInfoStruct *info =
+    static_cast< itk::MultiThreader::ThreadInfoStruct * >( arg );
+
+  if( info->ThreadID == 1 )
+    {
+    itkGenericExceptionMacro( << "Expected exception from thread 1" );
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+ITK_THREAD_RETURN_TYPE ThreadPoolTestBarrierCallback( void *arg )
+{
+  itk::MultiThreader::ThreadInfoStruct *info =
+    static_cast< itk::MultiThreader::ThreadInfoStruct * >( arg );
+  itk::Barrier *barrier = static_cast< itk::Barrier * >( info->UserData );
+
+  // Returns only once all the threads of the execution run.
+  barrier->Wait();
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+ITK_THREAD_RETURN_TYPE ThreadPoolTestExactCallback( void *arg )
+{
+  itk::MultiThreader::ThreadInfoStruct *info =
+    static_cast< itk::MultiThreader::ThreadInfoStruct * >( arg );
+  itk::Barrier *outerBarrier = static_cast< itk::Barrier * >( info->UserData );
+
+  // Once the outer threads occupy all the workers of the pool, each of
+  // them runs an inner execution whose methods wait for each other.
+  outerBarrier->Wait();
+  itk::Barrier::Pointer barrier = itk::Barrier::New();
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  threader->UseThreadPoolOn();
+  threader->ExactNumberOfThreadsOn();
+  threader->SetNumberOfThreads( info->NumberOfThreads );
+  barrier->Initialize( threader->GetNumberOfThreads() );
+  for ( itk::ThreadIdType i = 0; i < threader->GetNumberOfThreads(); ++i )
+    {
+    threader->SetMultipleMethod( i, ThreadPoolTestBarrierCallback, barrier.GetPointer() );
+    }
+  threader->MultipleMethodExecute();
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+bool VerifyCounts( const ThreadPoolTestUserData & data, itk::ThreadIdType numberOfThreads,
+                   unsigned int expected, const char *msg )
+{
+  for ( itk::ThreadIdType i = 0; i < numberOfThreads; ++i )
+    {
+    if ( data.m_Count[i] != expected )
+      {
+      std::cerr << msg << ": thread " << i << " ran " << data.m_Count[i]
+                << " times instead of " << expected << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int itkThreadPoolTest(int, char* [])
+{
+  const unsigned int numberOfExecutions = 200;
+
+  itk::ThreadPool::Pointer pool = itk::ThreadPool::GetInstance();
+  if( pool.IsNull() || pool != itk::ThreadPool::New() )
+    {
+    std::cerr << "ThreadPool is expected to be a singleton" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  bool result = true;
+
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  threader->UseThreadPoolOn();
+  threader->SetNumberOfThreads( 4 );
+  const itk::ThreadIdType numberOfThreads = threader->GetNumberOfThreads();
+
+  // SingleMethodExecute, many short executions.
+  {
+  ThreadPoolTestUserData data;
+  threader->SetSingleMethod( ThreadPoolTestCallback, &data );
+  for ( unsigned int i = 0; i < numberOfExecutions; ++i )
+    {
+    threader->SingleMethodExecute();
+    }
+  result &= VerifyCounts( data, numberOfThreads, numberOfExecutions, "SingleMethodExecute" );
+  }
+
+  // The workers must have been created on demand and persist.
+  if ( itk::MultiThreader::GetGlobalMaximumNumberOfThreads() > 1
+       && pool->GetNumberOfWorkThreads() < numberOfThreads - 1 )
+    {
+    std::cerr << "Expected at least " << numberOfThreads - 1 << " workers, got "
+              << pool->GetNumberOfWorkThreads() << std::endl;
+    result = false;
+    }
+
+  // MultipleMethodExecute.
+  {
+  ThreadPoolTestUserData data;
+  for ( itk::ThreadIdType i = 0; i < numberOfThreads; ++i )
+    {
+    threader->SetMultipleMethod( i, ThreadPoolTestCallback, &data );
+    }
+  for ( unsigned int i = 0; i < numberOfExecutions; ++i )
+    {
+    threader->MultipleMethodExecute();
+    }
+  result &= VerifyCounts( data, numberOfThreads, numberOfExecutions, "MultipleMethodExecute" );
+  }
+
+  // Nested executions share the pool without deadlocking.
+  {
+  ThreadPoolTestUserData data;
+  data.m_NestedThreads = 3;
+  threader->SetSingleMethod( ThreadPoolTestNestedCallback, &data );
+  threader->SingleMethodExecute();
+  itk::MultiThreader::Pointer reference = itk::MultiThreader::New();
+  reference->SetNumberOfThreads( data.m_NestedThreads );
+  result &= VerifyCounts( data, numberOfThreads, reference->GetNumberOfThreads(), "Nested SingleMethodExecute" );
+  }
+
+  // A nested execution wider than the pool grows it while the jobs of the
+  // outer execution run on the workers.
+  {
+  pool->SetNumberOfWorkThreads( 2 );
+  ThreadPoolTestUserData data;
+  data.m_NestedThreads = 8;
+  threader->SetSingleMethod( ThreadPoolTestNestedCallback, &data );
+  threader->SingleMethodExecute();
+  itk::MultiThreader::Pointer reference = itk::MultiThreader::New();
+  reference->SetNumberOfThreads( data.m_NestedThreads );
+  result &= VerifyCounts( data, numberOfThreads, reference->GetNumberOfThreads(), "Nested wider SingleMethodExecute" );
+  if ( reference->GetNumberOfThreads() > 2 && pool->GetNumberOfWorkThreads() < reference->GetNumberOfThreads() - 1 )
+    {
+    std::cerr << "The pool did not grow for the nested execution" << std::endl;
+    result = false;
+    }
+  }
+
+  // Exceptions thrown by a job are reported by SingleMethodExecute.
+  if ( numberOfThreads > 1 )
+    {
+    threader->SetSingleMethod( ThreadPoolTestThrowingCallback, 0 );
+    bool caught = false;
+    try
+      {
+      threader->SingleMethodExecute();
+      }
+    catch ( itk::ExceptionObject & e )
+      {
+      std::cout << "Caught expected exception: " << e.GetDescription() << std::endl;
+      caught = true;
+      }
+    if ( !caught )
+      {
+      std::cerr << "Exception thrown in a pool job was not reported" << std::endl;
+      result = false;
+      }
+    }
+
+  // Exceptions thrown by a job are reported by MultipleMethodExecute.
+  if ( numberOfThreads > 1 )
+    {
+    for ( itk::ThreadIdType i = 0; i < numberOfThreads; ++i )
+      {
+      threader->SetMultipleMethod( i, ThreadPoolTestThrowingCallback, 0 );
+      }
+    bool caught = false;
+    try
+      {
+      threader->MultipleMethodExecute();
+      }
+    catch ( itk::ExceptionObject & e )
+      {
+      std::cout << "Caught expected exception: " << e.GetDescription() << std::endl;
+      caught = true;
+      }
+    if ( !caught )
+      {
+      std::cerr << "Exception thrown in a MultipleMethod pool job was not reported" << std::endl;
+      result = false;
+      }
+    }
+
+  // The methods of an exact execution all run at once, even when the
+  // workers of the pool are all busy with the outer execution.
+  {
+  pool->SetNumberOfWorkThreads( numberOfThreads - 1 );
+  itk::Barrier::Pointer outerBarrier = itk::Barrier::New();
+  outerBarrier->Initialize( numberOfThreads );
+  threader->SetSingleMethod( ThreadPoolTestExactCallback, outerBarrier.GetPointer() );
+  threader->SingleMethodExecute();
+  }
+
+  // Resizing the pool and pinning the workers keeps it functional.
+  {
+  pool->SetNumberOfWorkThreads( 2 );
+  pool->ThreadAffinityOn();
+  ThreadPoolTestUserData data;
+  threader->SetSingleMethod( ThreadPoolTestCallback, &data );
+  for ( unsigned int i = 0; i < numberOfExecutions; ++i )
+    {
+    threader->SingleMethodExecute();
+    }
+  pool->ThreadAffinityOff();
+  result &= VerifyCounts( data, numberOfThreads, numberOfExecutions, "Resized pool" );
+  }
+
+  // The pool is selectable per threader and by default.
+  itk::MultiThreader::SetGlobalDefaultUseThreadPool( false );
+  if ( itk::MultiThreader::New()->GetUseThreadPool() )
+    {
+    std::cerr << "GlobalDefaultUseThreadPool is not honored" << std::endl;
+    result = false;
+    }
+  itk::MultiThreader::SetGlobalDefaultUseThreadPool( true );
+  if ( !itk::MultiThreader::New()->GetUseThreadPool() )
+    {
+    std::cerr << "GlobalDefaultUseThreadPool is not honored" << std::endl;
+    result = false;
+    }
+
+  pool->Print( std::cout );
+  threader->Print( std::cout );
+
+  if ( pool->GetNumberOfQueuedJobs() != 0 )
+    {
+    std::cerr << "Jobs are left in the queues" << std::endl;
+    result = false;
+    }
+
+  if ( !result )
+    {
+    std::cout << "[TEST FAILED]" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "[TEST PASSED]" << std::endl;
+  return EXIT_SUCCESS;
+}
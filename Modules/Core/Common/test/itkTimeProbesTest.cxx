@@ -21,6 +21,7 @@
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
 
 template <class T>
 void TestTransformIndexToPhysicalPoint(T * image)
@@ -151,6 +152,36 @@ int itkTimeProbesTest(int, char* [] )
   // Print to the standar error
   collector.Report( std::cerr );
 
+  // Test the JSON report
+  std::ostringstream json;
+  collector.JSONReport( json );
+  std::cout << json.str();
+  if ( json.str().find("\"Name\": \"i->TransformIndexToPhysicalPoint\"") == std::string::npos
+       || json.str().find("\"StandardDeviation\"") == std::string::npos )
+    {
+    std::cerr << "JSONReport() is missing probes" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Statistics over several passes
+  itk::TimeProbe probe;
+  for ( unsigned int pass = 0; pass < 3; ++pass )
+    {
+    probe.Start();
+    TestTransformIndexToPhysicalPoint<Image3DType> (image3D);
+    probe.Stop();
+    }
+  const double tolerance = 1e-9 * probe.GetMaximum();
+  if ( probe.GetMinimum() > probe.GetMean() + tolerance
+       || probe.GetMean() > probe.GetMaximum() + tolerance
+       || probe.GetStandardDeviation() < 0.0 )
+    {
+    std::cerr << "Inconsistent probe statistics: minimum " << probe.GetMinimum()
+              << " mean " << probe.GetMean() << " maximum " << probe.GetMaximum()
+              << " standard deviation " << probe.GetStandardDeviation() << std::endl;
+    return EXIT_FAILURE;
+    }
+
 
   return EXIT_SUCCESS;
 
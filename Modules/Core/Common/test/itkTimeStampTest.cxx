@@ -56,16 +56,18 @@ int itkTimeStampTest(int, char*[])
 
     // Set up the multithreader
     itk::MultiThreader::Pointer multithreader = itk::MultiThreader::New();
-    multithreader->SetNumberOfThreads( ITK_MAX_THREADS+10 );// this will be clamped
+    const itk::ThreadIdType maximumNumberOfThreads =
+      itk::MultiThreader::GetGlobalMaximumNumberOfThreads();
+    multithreader->SetNumberOfThreads( maximumNumberOfThreads+10 );// this will be clamped
     multithreader->SetSingleMethod( modified_function, &helper);
 
     // Test that the number of threads has actually been clamped
     const itk::ThreadIdType numberOfThreads = multithreader->GetNumberOfThreads();
 
-    if( numberOfThreads > ITK_MAX_THREADS )
+    if( numberOfThreads > maximumNumberOfThreads )
       {
       std::cerr << "[TEST FAILED]" << std::endl;
-      std::cerr << "numberOfThreads > ITK_MAX_THREADS" << std::endl;
+      std::cerr << "numberOfThreads > GlobalMaximumNumberOfThreads" << std::endl;
       return EXIT_FAILURE;
       }
 
@@ -136,6 +136,7 @@ IsoContourDistanceImageFilter< TInputImage, TOutputImage >
   // Initialize the barrier for the thread synchronization in
   // the narrowband case.
   this->m_Barrier->Initialize(actualThreads);
+  this->GetMultiThreader()->ExactNumberOfThreadsOn();
 
   if ( m_NarrowBanding )
     {
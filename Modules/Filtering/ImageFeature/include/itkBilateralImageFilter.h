@@ -48,6 +48,31 @@ namespace itk
  * Bilateral filtering is capable of reducing the noise in an image
  * by an order of magnitude while maintaining edges.
  *
+ * The range distances can be measured on a guide image instead of the
+ * input, for joint (or cross) bilateral filtering: the input is then
+ * smoothed where the guide is homogeneous, and its edges follow the
+ * ones of the guide.
+ *
+ * The cost of the filter grows with the size of the domain kernel. When
+ * UseBilateralGrid is on, the filter is approximated on a bilateral
+ * grid (Paris and Durand, A Fast Approximation of the Bilateral Filter
+ * using a Signal Processing Approach. ECCV. 2006.) whose cost is
+ * roughly linear in the number of pixels. The pixels are accumulated
+ * in the cells of a grid spanning the image domain and the range of
+ * intensities, the grid is blurred by a Gaussian, and the output is
+ * interpolated in the grid. The cells measure GridSamplingFactor times
+ * the domain and range sigmas. The smaller the factor, the closer the
+ * approximation and the larger the grid; the default of 1, as used by
+ * Paris and Durand, keeps the differences with the exact filter within
+ * a fraction of the range sigma away from the image borders.
+ *
+ * The grid holds two single precision values per cell, and its number
+ * of cells along the range grows with the dynamic range of the
+ * intensities. When the grid would exceed MaximumNumberOfGridCells, its
+ * range cells are coarsened, up to twice the range sigma. Beyond that
+ * the filter throws an exception, and the GridSamplingFactor or the
+ * MaximumNumberOfGridCells must be raised.
+ *
  * The bilateral operator used here was described by Tomasi and
  * Manduchi (Bilateral Filtering for Gray and ColorImages. IEEE
  * ICCV. 1998.)
@@ -128,6 +153,13 @@ public:
   typedef
   Image< double, itkGetStaticConstMacro(ImageDimension) > GaussianImageType;
 
+  /** Bilateral grid type, whose last dimension spans the range of
+   * intensities. */
+  itkStaticConstMacro(GridDimension, unsigned int,
+                      TOutputImage::ImageDimension + 1);
+  typedef float                                                          GridPixelType;
+  typedef Image< GridPixelType, itkGetStaticConstMacro(GridDimension) > GridImageType;
+
   /** Standard get/set macros for filter parameters.
    * DomainSigma is specified in the same units as the Image spacing.
    * RangeSigma is specified in the units of intensity. */
@@ -169,6 +201,28 @@ public:
   itkSetMacro(NumberOfRangeGaussianSamples, unsigned long);
   itkGetConstMacro(NumberOfRangeGaussianSamples, unsigned long);
 
+  /** Set/Get the image whose intensities are used to compute the range
+   * distances. When it is not set, the input image is used. */
+  void SetGuideImage(const InputImageType *guide);
+
+  const InputImageType * GetGuideImage() const;
+
+  /** Approximate the filter on a bilateral grid. Default is off. */
+  itkSetMacro(UseBilateralGrid, bool);
+  itkGetConstMacro(UseBilateralGrid, bool);
+  itkBooleanMacro(UseBilateralGrid);
+
+  /** Set/Get the size of the cells of the bilateral grid, as a fraction
+   * of the domain and range sigmas. Default is 1. */
+  itkSetClampMacro( GridSamplingFactor, double, 0.05, NumericTraits< double >::max() );
+  itkGetConstMacro(GridSamplingFactor, double);
+
+  /** Set/Get the maximum number of cells of the bilateral grid. Blurring
+   * the grid needs up to four times 4 bytes per cell. Default is 2^25
+   * cells, i.e. 512 MB. */
+  itkSetMacro(MaximumNumberOfGridCells, SizeValueType);
+  itkGetConstMacro(MaximumNumberOfGridCells, SizeValueType);
+
 #ifdef ITK_USE_CONCEPT_CHECKING
   /** Begin concept checking */
   itkConceptMacro( OutputHasNumericTraitsCheck,
@@ -189,6 +243,9 @@ protected:
   /** Do some setup before the ThreadedGenerateData */
   void BeforeThreadedGenerateData();
 
+  /** Release the bilateral grid. */
+  void AfterThreadedGenerateData();
+
   /** Standard pipeline method. This filter is implemented as a multi-threaded
    * filter. */
   void ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
@@ -207,6 +264,38 @@ private:
   BilateralImageFilter(const Self &); //purposely not implemented
   void operator=(const Self &);       //purposely not implemented
 
+  /** State shared by the threads accumulating the pixels in the grid. */
+  struct GridThreadStruct {
+    Self *                 Filter;
+    const InputImageType * Input;
+    const InputImageType * Guide;
+    /** Cell of each row of the input requested region, along each
+     * dimension. */
+    std::vector< OffsetValueType > Cells[ImageDimension];
+  };
+
+  /** Accumulate the pixels in the bilateral grid, on several threads,
+   * and blur it. */
+  void GenerateBilateralGrid();
+
+  /** Static function used as a "callback" by the MultiThreader to
+   * accumulate the pixels of the cells of a thread. */
+  static ITK_THREAD_RETURN_TYPE GridThreaderCallback(void *arg);
+
+  /** Accumulate the pixels of the slab of cells, along the last
+   * dimension of the image, of a thread. */
+  void ThreadedAccumulateGrid(const GridThreadStruct & str,
+                              ThreadIdType threadId, ThreadIdType numberOfThreads);
+
+  /** Interpolate the output of the region in the blurred grid. */
+  void ThreadedInterpolateGrid(const OutputImageRegionType & outputRegionForThread,
+                               ThreadIdType threadId);
+
+  /** Lower cell of the grid interpolated at coordinate, in cells, along a
+   * dimension of numberOfCells cells, and weight of the upper cell. */
+  static void LocateInGrid(double coordinate, SizeValueType numberOfCells,
+                           OffsetValueType & cell, double & fraction);
+
   /** The standard deviation of the gaussian blurring kernel in the image
       range. Units are intensity. */
   double m_RangeSigma;
@@ -233,6 +322,21 @@ private:
   double                m_DynamicRange;
   double                m_DynamicRangeUsed;
   std::vector< double > m_RangeGaussianTable;
+
+  /** Bilateral grid, holding the sums of the pixels and their numbers,
+   * blurred. Cell i along dimension d holds the pixels around index
+   * m_GridStart[d] + i * m_GridCellSize[d] of the requested region of
+   * the input, and cell i along the last dimension the intensities
+   * around m_GridRangeStart + i * m_GridRangeCellSize. */
+  bool                               m_UseBilateralGrid;
+  double                             m_GridSamplingFactor;
+  SizeValueType                      m_MaximumNumberOfGridCells;
+  typename GridImageType::Pointer    m_GridValues;
+  typename GridImageType::Pointer    m_GridWeights;
+  typename InputImageType::IndexType m_GridStart;
+  ArrayType                          m_GridCellSize;
+  double                             m_GridRangeStart;
+  double                             m_GridRangeCellSize;
 };
 } // end namespace itk
 
@@ -25,6 +25,8 @@
 #include "itkZeroFluxNeumannBoundaryCondition.h"
 #include "itkProgressReporter.h"
 #include "itkStatisticsImageFilter.h"
+#include "itkDiscreteGaussianImageFilter.h"
+#include "itkImageScanlineIterator.h"
 
 namespace itk
 {
@@ -43,6 +45,30 @@ BilateralImageFilter< TInputImage, TOutputImage >
   this->m_DomainMu = 2.5;  // keep small to keep kernels small
   this->m_RangeMu = 4.0;   // can be bigger then DomainMu since we only
                            // index into a single table
+  this->m_UseBilateralGrid = false;
+  this->m_GridSamplingFactor = 1.0;
+  this->m_MaximumNumberOfGridCells = 33554432;
+  this->m_GridStart.Fill(0);
+  this->m_GridCellSize.Fill(1.0);
+  this->m_GridRangeStart = 0.0;
+  this->m_GridRangeCellSize = 1.0;
+}
+
+template< class TInputImage, class TOutputImage >
+void
+BilateralImageFilter< TInputImage, TOutputImage >
+::SetGuideImage(const InputImageType *guide)
+{
+  // Process object is not const-correct so the const casting is required.
+  this->ProcessObject::SetNthInput( 1, const_cast< InputImageType * >( guide ) );
+}
+
+template< class TInputImage, class TOutputImage >
+const typename BilateralImageFilter< TInputImage, TOutputImage >::InputImageType *
+BilateralImageFilter< TInputImage, TOutputImage >
+::GetGuideImage() const
+{
+  return itkDynamicCastInDebugMode< const InputImageType * >( this->ProcessObject::GetInput(1) );
 }
 
 template< class TInputImage, class TOutputImage >
@@ -105,6 +131,14 @@ throw( InvalidRequestedRegionError )
   if ( inputRequestedRegion.Crop( inputPtr->GetLargestPossibleRegion() ) )
     {
     inputPtr->SetRequestedRegion(inputRequestedRegion);
+
+    // the range distances are measured over the same neighborhoods of
+    // the guide image
+    InputImageType *guidePtr = const_cast< InputImageType * >( this->GetGuideImage() );
+    if ( guidePtr )
+      {
+      guidePtr->SetRequestedRegion(inputRequestedRegion);
+      }
     return;
     }
   else
@@ -129,6 +163,12 @@ void
 BilateralImageFilter< TInputImage, TOutputImage >
 ::BeforeThreadedGenerateData()
 {
+  if ( m_UseBilateralGrid )
+    {
+    this->GenerateBilateralGrid();
+    return;
+    }
+
   // Build a small image of the N-dimensional Gaussian used for domain filter
   //
   // Gaussian image size will be (2*vcl_ceil(2.5*sigma)+1) x
@@ -139,6 +179,7 @@ BilateralImageFilter< TInputImage, TOutputImage >
   typename InputImageType::SizeType domainKernelSize;
 
   const InputImageType *inputImage = this->GetInput();
+  const InputImageType *rangeImage = this->GetGuideImage() ? this->GetGuideImage() : inputImage;
 
   const typename InputImageType::SpacingType inputSpacing = inputImage->GetSpacing();
   const typename InputImageType::PointType inputOrigin  = inputImage->GetOrigin();
@@ -210,7 +251,7 @@ BilateralImageFilter< TInputImage, TOutputImage >
   typename StatisticsImageFilter< TInputImage >::Pointer statistics =
     StatisticsImageFilter< TInputImage >::New();
 
-  statistics->SetInput(inputImage);
+  statistics->SetInput(rangeImage);
   statistics->GetOutput()
   ->SetRequestedRegion( this->GetOutput()->GetRequestedRegion() );
   statistics->Update();
@@ -246,13 +287,345 @@ BilateralImageFilter< TInputImage, TOutputImage >
     }
 }
 
+template< class TInputImage, class TOutputImage >
+void
+BilateralImageFilter< TInputImage, TOutputImage >
+::GenerateBilateralGrid()
+{
+  const InputImageType *input = this->GetInput();
+  const InputImageType *guide = this->GetGuideImage() ? this->GetGuideImage() : input;
+
+  // The grid covers the requested region of the input, which holds the
+  // neighborhoods of the output pixels
+  const typename InputImageType::RegionType region = input->GetRequestedRegion();
+  const typename InputImageType::SpacingType & spacing = input->GetSpacing();
+
+  // Range of the intensities
+  ImageRegionConstIterator< InputImageType > git(guide, region);
+  double minimum = NumericTraits< double >::max();
+  double maximum = NumericTraits< double >::NonpositiveMin();
+  for ( git.GoToBegin(); !git.IsAtEnd(); ++git )
+    {
+    const double value = static_cast< double >( git.Get() );
+    minimum = vnl_math_min(minimum, value);
+    maximum = vnl_math_max(maximum, value);
+    }
+  m_DynamicRange = maximum - minimum;
+  m_DynamicRangeUsed = m_RangeMu * m_RangeSigma;
+
+  // Size of the cells
+  typename GridImageType::SizeType gridSize;
+  SizeValueType                    numberOfDomainCells = 1;
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    m_GridStart[d] = region.GetIndex(d);
+    m_GridCellSize[d] = vnl_math_max(m_GridSamplingFactor * m_DomainSigma[d] / spacing[d], 1.0);
+    gridSize[d] = Math::Round< SizeValueType >( ( region.GetSize(d) - 1 ) / m_GridCellSize[d] ) + 1;
+    numberOfDomainCells *= gridSize[d];
+    }
+
+  // The intensities are padded by RangeMu sigmas, so that the blur of the
+  // grid does not reach its border along the range. The range cells are
+  // coarsened when the grid would not fit in MaximumNumberOfGridCells,
+  // the number of range cells being at most rangeExtent / cellSize + 4.
+  const double rangeExtent = m_DynamicRange + 2.0 * m_RangeMu * m_RangeSigma;
+  const double maximumRangeCells = static_cast< double >( m_MaximumNumberOfGridCells )
+                                   / static_cast< double >( numberOfDomainCells );
+  m_GridRangeCellSize = m_GridSamplingFactor * m_RangeSigma;
+  if ( rangeExtent / m_GridRangeCellSize + 4.0 > maximumRangeCells )
+    {
+    const double coarsestCellSize = vnl_math_max(m_GridSamplingFactor, 2.0) * m_RangeSigma;
+    if ( maximumRangeCells <= 4.0 || rangeExtent / ( maximumRangeCells - 4.0 ) > coarsestCellSize )
+      {
+      itkExceptionMacro(<< "The bilateral grid of " << numberOfDomainCells
+                        << " cells along the image domain does not fit in MaximumNumberOfGridCells ("
+                        << m_MaximumNumberOfGridCells << ") for a dynamic range of " << m_DynamicRange
+                        << ", even with range cells of " << coarsestCellSize
+                        << ". Increase GridSamplingFactor or MaximumNumberOfGridCells.");
+      }
+    m_GridRangeCellSize = rangeExtent / ( maximumRangeCells - 4.0 );
+    }
+  const SizeValueType padding = Math::Ceil< SizeValueType >(m_RangeMu * m_RangeSigma / m_GridRangeCellSize);
+  m_GridRangeStart = minimum - padding * m_GridRangeCellSize;
+  gridSize[ImageDimension] = Math::Round< SizeValueType >(m_DynamicRange / m_GridRangeCellSize)
+                             + 2 * padding + 1;
+
+  typename GridImageType::RegionType gridRegion;
+  gridRegion.SetSize(gridSize);
+
+  m_GridValues = GridImageType::New();
+  m_GridValues->SetRegions(gridRegion);
+  m_GridValues->Allocate();
+  m_GridValues->FillBuffer(NumericTraits< GridPixelType >::Zero);
+
+  m_GridWeights = GridImageType::New();
+  m_GridWeights->SetRegions(gridRegion);
+  m_GridWeights->Allocate();
+  m_GridWeights->FillBuffer(NumericTraits< GridPixelType >::Zero);
+
+  // Accumulate the pixels in their nearest cell. Each thread fills the
+  // cells of a slab of the grid, so that they never write to the same
+  // cell.
+  GridThreadStruct str;
+  str.Filter = this;
+  str.Input = input;
+  str.Guide = guide;
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    str.Cells[d].resize( region.GetSize(d) );
+    for ( SizeValueType x = 0; x < region.GetSize(d); ++x )
+      {
+      str.Cells[d][x] = Math::Round< OffsetValueType >(x / m_GridCellSize[d]);
+      }
+    }
+
+  this->GetMultiThreader()->SetNumberOfThreads( this->GetNumberOfThreads() );
+  this->GetMultiThreader()->SetSingleMethod(this->GridThreaderCallback, &str);
+  this->GetMultiThreader()->SingleMethodExecute();
+
+  // Blur the grid with the domain and range Gaussians, scaled to the
+  // cells. Each grid is released by the blur once it is blurred.
+  typedef DiscreteGaussianImageFilter< GridImageType, GridImageType > GridBlurType;
+  typename GridBlurType::ArrayType variance;
+  double                           maximumSigma = 0.0;
+  for ( unsigned int d = 0; d <= ImageDimension; ++d )
+    {
+    const double sigma = ( d < ImageDimension )
+                         ? m_DomainSigma[d] / spacing[d] / m_GridCellSize[d]
+                         : m_RangeSigma / m_GridRangeCellSize;
+    variance[d] = sigma * sigma;
+    maximumSigma = vnl_math_max(maximumSigma, sigma);
+    }
+
+  typename GridImageType::Pointer *grids[2] = { &m_GridValues, &m_GridWeights };
+  for ( unsigned int g = 0; g < 2; ++g )
+    {
+    typename GridBlurType::Pointer blur = GridBlurType::New();
+    ( *grids[g] )->ReleaseDataFlagOn();
+    blur->SetInput(*grids[g]);
+    blur->SetVariance(variance);
+    blur->SetUseImageSpacingOff();
+    blur->SetMaximumKernelWidth( 2 * Math::Ceil< int >(4.0 * maximumSigma) + 1 );
+    blur->SetNumberOfThreads( this->GetNumberOfThreads() );
+    blur->Update();
+    *grids[g] = blur->GetOutput();
+    ( *grids[g] )->DisconnectPipeline();
+    }
+}
+
+template< class TInputImage, class TOutputImage >
+ITK_THREAD_RETURN_TYPE
+BilateralImageFilter< TInputImage, TOutputImage >
+::GridThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  GridThreadStruct *               str = static_cast< GridThreadStruct * >( info->UserData );
+
+  str->Filter->ThreadedAccumulateGrid(*str, info->ThreadID, info->NumberOfThreads);
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< class TInputImage, class TOutputImage >
+void
+BilateralImageFilter< TInputImage, TOutputImage >
+::ThreadedAccumulateGrid(const GridThreadStruct & str,
+                         ThreadIdType threadId, ThreadIdType numberOfThreads)
+{
+  const unsigned int last = ImageDimension - 1;
+
+  const typename GridImageType::SizeType & gridSize = m_GridValues->GetBufferedRegion().GetSize();
+  const OffsetValueType *gridOffsets = m_GridValues->GetOffsetTable();
+  GridPixelType *        values = m_GridValues->GetBufferPointer();
+  GridPixelType *        weights = m_GridWeights->GetBufferPointer();
+
+  // The slab of cells of the thread, and the rows of pixels falling in
+  // it
+  const OffsetValueType firstCell =
+    static_cast< OffsetValueType >( gridSize[last] * threadId / numberOfThreads );
+  const OffsetValueType endCell =
+    static_cast< OffsetValueType >( gridSize[last] * ( threadId + 1 ) / numberOfThreads );
+
+  const std::vector< OffsetValueType > & lastCells = str.Cells[last];
+  SizeValueType first = 0;
+  while ( first < lastCells.size() && lastCells[first] < firstCell )
+    {
+    ++first;
+    }
+  SizeValueType end = first;
+  while ( end < lastCells.size() && lastCells[end] < endCell )
+    {
+    ++end;
+    }
+  if ( first == end )
+    {
+    return;
+    }
+
+  typename InputImageType::RegionType slab = str.Input->GetRequestedRegion();
+  slab.SetIndex(last, slab.GetIndex(last) + static_cast< OffsetValueType >( first ) );
+  slab.SetSize(last, end - first);
+
+  ImageScanlineConstIterator< InputImageType > it(str.Input, slab);
+  ImageScanlineConstIterator< InputImageType > git(str.Guide, slab);
+  while ( !it.IsAtEnd() )
+    {
+    const typename InputImageType::IndexType & index = it.GetIndex();
+    OffsetValueType lineOffset = 0;
+    for ( unsigned int d = 1; d < ImageDimension; ++d )
+      {
+      lineOffset += str.Cells[d][index[d] - m_GridStart[d]] * gridOffsets[d];
+      }
+
+    const std::vector< OffsetValueType > & cells = str.Cells[0];
+    for ( SizeValueType x = index[0] - m_GridStart[0]; !it.IsAtEndOfLine(); ++it, ++git, ++x )
+      {
+      const double          rangeCoordinate =
+        ( static_cast< double >( git.Get() ) - m_GridRangeStart ) / m_GridRangeCellSize;
+      const OffsetValueType offset = lineOffset + cells[x] * gridOffsets[0]
+                                     + Math::Round< OffsetValueType >(rangeCoordinate)
+                                     * gridOffsets[ImageDimension];
+      values[offset] += static_cast< GridPixelType >( it.Get() );
+      weights[offset] += NumericTraits< GridPixelType >::One;
+      }
+    it.NextLine();
+    git.NextLine();
+    }
+}
+
+template< class TInputImage, class TOutputImage >
+void
+BilateralImageFilter< TInputImage, TOutputImage >
+::LocateInGrid(double coordinate, SizeValueType numberOfCells,
+               OffsetValueType & cell, double & fraction)
+{
+  const OffsetValueType lastCell = static_cast< OffsetValueType >( numberOfCells ) - 1;
+
+  cell = Math::Floor< OffsetValueType >(coordinate);
+  cell = vnl_math_max( vnl_math_min(cell, lastCell - 1), NumericTraits< OffsetValueType >::Zero );
+  fraction = vnl_math_max( vnl_math_min(coordinate - cell, 1.0), 0.0 );
+  if ( lastCell == 0 )
+    {
+    fraction = 0.0;
+    }
+}
+
+template< class TInputImage, class TOutputImage >
+void
+BilateralImageFilter< TInputImage, TOutputImage >
+::ThreadedInterpolateGrid(const OutputImageRegionType & outputRegionForThread,
+                          ThreadIdType threadId)
+{
+  const InputImageType *input = this->GetInput();
+  const InputImageType *guide = this->GetGuideImage() ? this->GetGuideImage() : input;
+  OutputImageType *     output = this->GetOutput();
+
+  const typename GridImageType::SizeType & gridSize = m_GridValues->GetBufferedRegion().GetSize();
+  const OffsetValueType *gridOffsets = m_GridValues->GetOffsetTable();
+  const GridPixelType *  values = m_GridValues->GetBufferPointer();
+  const GridPixelType *  weights = m_GridWeights->GetBufferPointer();
+
+  // Steps to the upper cells, null along the dimensions of a single
+  // cell
+  OffsetValueType steps[GridDimension];
+  for ( unsigned int k = 0; k < GridDimension; ++k )
+    {
+    steps[k] = ( gridSize[k] > 1 ) ? gridOffsets[k] : 0;
+    }
+  const unsigned int numberOfCorners = 1u << GridDimension;
+
+  // Cells of the rows along the first dimension
+  const SizeValueType            lineLength = outputRegionForThread.GetSize(0);
+  std::vector< OffsetValueType > lineCells(lineLength);
+  std::vector< double >          lineFractions(lineLength);
+  for ( SizeValueType x = 0; x < lineLength; ++x )
+    {
+    const double coordinate = ( outputRegionForThread.GetIndex(0) + static_cast< OffsetValueType >( x )
+                                - m_GridStart[0] ) / m_GridCellSize[0];
+    this->LocateInGrid(coordinate, gridSize[0], lineCells[x], lineFractions[x]);
+    }
+
+  ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
+
+  OffsetValueType cell;
+  double          fractions[GridDimension];
+
+  ImageScanlineConstIterator< InputImageType > it(input, outputRegionForThread);
+  ImageScanlineConstIterator< InputImageType > git(guide, outputRegionForThread);
+  ImageScanlineIterator< OutputImageType >     oit(output, outputRegionForThread);
+  while ( !it.IsAtEnd() )
+    {
+    const typename InputImageType::IndexType & index = it.GetIndex();
+    OffsetValueType lineOffset = 0;
+    for ( unsigned int d = 1; d < ImageDimension; ++d )
+      {
+      this->LocateInGrid( ( index[d] - m_GridStart[d] ) / m_GridCellSize[d], gridSize[d],
+                          cell, fractions[d] );
+      lineOffset += cell * gridOffsets[d];
+      }
+
+    for ( SizeValueType x = 0; !it.IsAtEndOfLine(); ++it, ++git, ++oit, ++x )
+      {
+      fractions[0] = lineFractions[x];
+      this->LocateInGrid( ( static_cast< double >( git.Get() ) - m_GridRangeStart ) / m_GridRangeCellSize,
+                          gridSize[ImageDimension], cell, fractions[ImageDimension] );
+      const OffsetValueType offset = lineOffset + lineCells[x] * gridOffsets[0]
+                                     + cell * gridOffsets[ImageDimension];
+
+      // Multilinear interpolation of the blurred sums and numbers of
+      // pixels at the corners of the cell
+      double val = 0.0;
+      double normFactor = 0.0;
+      for ( unsigned int c = 0; c < numberOfCorners; ++c )
+        {
+        double          weight = 1.0;
+        OffsetValueType cornerOffset = offset;
+        for ( unsigned int k = 0; k < GridDimension; ++k )
+          {
+          if ( c & ( 1u << k ) )
+            {
+            weight *= fractions[k];
+            cornerOffset += steps[k];
+            }
+          else
+            {
+            weight *= 1.0 - fractions[k];
+            }
+          }
+        val += weight * values[cornerOffset];
+        normFactor += weight * weights[cornerOffset];
+        }
+
+      if ( normFactor > 0.0 )
+        {
+        oit.Set( static_cast< OutputPixelType >( val / normFactor ) );
+        }
+      else
+        {
+        oit.Set( static_cast< OutputPixelType >( it.Get() ) );
+        }
+      progress.CompletedPixel();
+      }
+    it.NextLine();
+    git.NextLine();
+    oit.NextLine();
+    }
+}
+
 template< class TInputImage, class TOutputImage >
 void
 BilateralImageFilter< TInputImage, TOutputImage >
 ::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
                        ThreadIdType threadId)
 {
+  if ( m_UseBilateralGrid )
+    {
+    this->ThreadedInterpolateGrid(outputRegionForThread, threadId);
+    return;
+    }
+
   typename TInputImage::ConstPointer input = this->GetInput();
+  const InputImageType *guide = this->GetGuideImage();
   typename TOutputImage::Pointer output = this->GetOutput();
   typename TInputImage::IndexValueType i;
   const double  rangeDistanceThreshold = m_DynamicRangeUsed;
@@ -284,6 +657,7 @@ BilateralImageFilter< TInputImage, TOutputImage >
   // whether a specified region needs to use the boundary conditions or
   // not.
   NeighborhoodIteratorType               b_iter;
+  NeighborhoodIteratorType               g_iter;
   ImageRegionIterator< OutputImageType > o_iter;
   KernelConstIteratorType                k_it;
   KernelConstIteratorType                kernelEnd = m_GaussianKernel.End();
@@ -296,12 +670,18 @@ BilateralImageFilter< TInputImage, TOutputImage >
     b_iter = NeighborhoodIteratorType(m_GaussianKernel.GetRadius(),
                                       this->GetInput(), *fit);
     b_iter.OverrideBoundaryCondition(&BC);
+    if ( guide )
+      {
+      g_iter = NeighborhoodIteratorType(m_GaussianKernel.GetRadius(), guide, *fit);
+      g_iter.OverrideBoundaryCondition(&BC);
+      }
     o_iter = ImageRegionIterator< OutputImageType >(this->GetOutput(), *fit);
 
     while ( !b_iter.IsAtEnd() )
       {
       // Setup
-      centerPixel = static_cast< OutputPixelRealType >( b_iter.GetCenterPixel() );
+      centerPixel = static_cast< OutputPixelRealType >( guide ? g_iter.GetCenterPixel()
+                                                        : b_iter.GetCenterPixel() );
       val = 0.0;
       normFactor = 0.0;
 
@@ -311,7 +691,9 @@ BilateralImageFilter< TInputImage, TOutputImage >
         {
         // range distance between neighborhood pixel and neighborhood center
         pixel = static_cast< OutputPixelRealType >( b_iter.GetPixel(i) );
-        rangeDistance = pixel - centerPixel;
+        rangeDistance = ( guide )
+                        ? static_cast< OutputPixelRealType >( g_iter.GetPixel(i) ) - centerPixel
+                        : pixel - centerPixel;
         // flip sign if needed
         if ( rangeDistance < 0.0 )
           {
@@ -341,12 +723,25 @@ BilateralImageFilter< TInputImage, TOutputImage >
       o_iter.Set( static_cast< OutputPixelType >( val ) );
 
       ++b_iter;
+      if ( guide )
+        {
+        ++g_iter;
+        }
       ++o_iter;
       progress.CompletedPixel();
       }
     }
 }
 
+template< class TInputImage, class TOutputImage >
+void
+BilateralImageFilter< TInputImage, TOutputImage >
+::AfterThreadedGenerateData()
+{
+  m_GridValues = 0;
+  m_GridWeights = 0;
+}
+
 template< class TInputImage, class TOutputImage >
 void
 BilateralImageFilter< TInputImage, TOutputImage >
@@ -362,6 +757,9 @@ BilateralImageFilter< TInputImage, TOutputImage >
   os << indent << "Amount of dynamic range used: " << m_DynamicRangeUsed << std::endl;
   os << indent << "AutomaticKernelSize: " << m_AutomaticKernelSize << std::endl;
   os << indent << "Radius: " << m_Radius << std::endl;
+  os << indent << "UseBilateralGrid: " << m_UseBilateralGrid << std::endl;
+  os << indent << "GridSamplingFactor: " << m_GridSamplingFactor << std::endl;
+  os << indent << "MaximumNumberOfGridCells: " << m_MaximumNumberOfGridCells << std::endl;
 }
 } // end namespace itk
 
@@ -0,0 +1,198 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include <iostream>
+
+#include "itkBilateralImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkRandomImageSource.h"
+#include "itkMultiThreader.h"
+
+namespace
+{
+typedef itk::Image< float, 3 >                            ImageType;
+typedef itk::BilateralImageFilter< ImageType, ImageType > FilterType;
+
+ImageType::Pointer Filter(const ImageType *input, const ImageType *guide, bool useBilateralGrid,
+                          double rangeSigma = 20.0, double gridSamplingFactor = 0.5,
+                          itk::SizeValueType maximumNumberOfGridCells = 33554432)
+{
+  FilterType::Pointer filter = FilterType::New();
+
+  filter->SetInput(input);
+  filter->SetGuideImage(guide);
+  filter->SetDomainSigma(2.0);
+  filter->SetRangeSigma(rangeSigma);
+  filter->SetUseBilateralGrid(useBilateralGrid);
+  filter->SetGridSamplingFactor(gridSamplingFactor);
+  filter->SetMaximumNumberOfGridCells(maximumNumberOfGridCells);
+  filter->Update();
+  return filter->GetOutput();
+}
+
+// Mean and maximum absolute differences between two images, the
+// maximum being taken away from the borders
+void Compare(const ImageType *image1, const ImageType *image2, double & meanDifference,
+             double & maximumDifference)
+{
+  ImageType::RegionType inner = image1->GetBufferedRegion();
+
+  inner.ShrinkByRadius(5);
+
+  meanDifference = 0.0;
+  maximumDifference = 0.0;
+  itk::ImageRegionConstIteratorWithIndex< ImageType > it1( image1, image1->GetBufferedRegion() );
+  itk::ImageRegionConstIteratorWithIndex< ImageType > it2( image2, image2->GetBufferedRegion() );
+  for (; !it1.IsAtEnd(); ++it1, ++it2 )
+    {
+    const double difference = vcl_abs( it1.Get() - it2.Get() );
+    meanDifference += difference;
+    if ( inner.IsInside( it1.GetIndex() ) )
+      {
+      maximumDifference = vnl_math_max(maximumDifference, difference);
+      }
+    }
+  meanDifference /= image1->GetBufferedRegion().GetNumberOfPixels();
+}
+}
+
+int itkBilateralImageFilterGridTest(int, char* [])
+{
+  itk::MultiThreader::SetGlobalDefaultNumberOfThreads(4);
+
+  // Two noisy regions, separated by a sphere, and the same regions
+  // without noise
+  typedef itk::RandomImageSource< ImageType > SourceType;
+  SourceType::Pointer source = SourceType::New();
+  ImageType::SizeType size = {{ 41, 37, 29 }};
+  source->SetSize(size);
+  source->SetMin(-20.0);
+  source->SetMax(20.0);
+  source->Update();
+
+  ImageType::Pointer input = source->GetOutput();
+  ImageType::Pointer clean = ImageType::New();
+  clean->SetRegions( input->GetBufferedRegion() );
+  clean->Allocate();
+
+  itk::ImageRegionIteratorWithIndex< ImageType > it( input, input->GetBufferedRegion() );
+  itk::ImageRegionIteratorWithIndex< ImageType > cit( clean, clean->GetBufferedRegion() );
+  for (; !it.IsAtEnd(); ++it, ++cit )
+    {
+    double distance = 0.0;
+    for ( unsigned int d = 0; d < 3; ++d )
+      {
+      const double x = it.GetIndex()[d] - 0.5 * size[d];
+      distance += x * x;
+      }
+    cit.Set( ( distance < 144.0 ) ? 150.0f : 50.0f );
+    it.Set( it.Get() + cit.Get() );
+    }
+
+  double meanDifference;
+  double maximumDifference;
+
+  // The input as guide image gives the same result as no guide image
+  ImageType::Pointer exact = Filter(input, 0, false);
+  Compare(exact, Filter(input, input, false), meanDifference, maximumDifference);
+  if ( meanDifference != 0.0 )
+    {
+    std::cerr << "Test failed!" << std::endl;
+    std::cerr << "The input as guide image changes the output by " << meanDifference << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // The bilateral grid is close to the exact filter, for both the
+  // bilateral and the joint bilateral filters
+  const ImageType *guides[2] = { 0, clean };
+  for ( unsigned int g = 0; g < 2; ++g )
+    {
+    exact = Filter(input, guides[g], false);
+    Compare(exact, Filter(input, guides[g], true), meanDifference, maximumDifference);
+    std::cout << "Grid, guide " << g << ": mean difference " << meanDifference
+              << ", maximum difference " << maximumDifference << std::endl;
+    if ( meanDifference > 0.5 || maximumDifference > 2.0 )
+      {
+      std::cerr << "Test failed!" << std::endl;
+      std::cerr << "The bilateral grid differs from the exact filter by " << meanDifference
+                << " on average and by up to " << maximumDifference << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // A CT-like volume: air, soft tissue and bone, with the default
+  // sampling of the grid
+  ImageType::Pointer ct = ImageType::New();
+  ct->SetRegions( input->GetBufferedRegion() );
+  ct->Allocate();
+  itk::ImageRegionIteratorWithIndex< ImageType > ctit( ct, ct->GetBufferedRegion() );
+  for ( it.GoToBegin(); !ctit.IsAtEnd(); ++it, ++ctit )
+    {
+    double body = 0.0;
+    double bone = 0.0;
+    for ( unsigned int d = 0; d < 3; ++d )
+      {
+      const double x = ( ctit.GetIndex()[d] - 0.5 * size[d] ) / ( 0.4 * size[d] );
+      body += x * x;
+      bone += 4.0 * x * x;
+      }
+    const float noise = 1.5f * ( it.Get() - cit.Get() );
+    ctit.Set( ( bone < 1.0 ? 1200.0f : ( body < 1.0 ? 40.0f : -1000.0f ) ) + noise );
+    }
+
+  // A bound on the size of the grid coarsens its range cells, until they
+  // measure twice the range sigma. The differences with the exact filter
+  // stay within a fraction of the range sigma.
+  const double             ctRangeSigma = 100.0;
+  const itk::SizeValueType maximumNumbersOfGridCells[2] = { 33554432, 180000 };
+  exact = Filter(ct, 0, false, ctRangeSigma);
+  for ( unsigned int m = 0; m < 2; ++m )
+    {
+    Compare(exact, Filter(ct, 0, true, ctRangeSigma, 1.0, maximumNumbersOfGridCells[m]),
+            meanDifference, maximumDifference);
+    std::cout << "CT grid of at most " << maximumNumbersOfGridCells[m] << " cells: mean difference "
+              << meanDifference << ", maximum difference " << maximumDifference << std::endl;
+    if ( meanDifference > 0.05 * ctRangeSigma || maximumDifference > 0.5 * ctRangeSigma )
+      {
+      std::cerr << "Test failed!" << std::endl;
+      std::cerr << "The bilateral grid differs from the exact filter by " << meanDifference
+                << " on average and by up to " << maximumDifference << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  bool caught = false;
+  try
+    {
+    Filter(ct, 0, true, ctRangeSigma, 1.0, 80000);
+    }
+  catch ( itk::ExceptionObject & err )
+    {
+    std::cout << "Expected exception: " << err.GetDescription() << std::endl;
+    caught = true;
+    }
+  if ( !caught )
+    {
+    std::cerr << "Test failed!" << std::endl;
+    std::cerr << "A grid exceeding MaximumNumberOfGridCells did not throw" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -20,6 +20,7 @@
 
 #include "itkInPlaceImageFilter.h"
 #include "itkSimpleDataObjectDecorator.h"
+#include "itkIsSame.h"
 
 namespace itk
 {
@@ -36,6 +37,11 @@ namespace itk
  * the pipeline. The SetConstant() and GetConstant() methods are provided as shortcuts
  * to set or get the constant value without manipulating the decorator.
  *
+ * When the pixels of the images are stored as is in their buffers (not for
+ * ImageAdaptor or VectorImage), the functor is applied in plain loops over
+ * the contiguous spans of the buffers, which compilers can vectorize.
+ * Otherwise the pixels are visited with image iterators.
+ *
  * \sa UnaryFunctorImageFilter TernaryFunctorImageFilter
  *
  * \ingroup IntensityImageFilters   MultiThreaded
@@ -193,6 +199,27 @@ private:
   BinaryFunctorImageFilter(const Self &); //purposely not implemented
   void operator=(const Self &);           //purposely not implemented
 
+  /** Whether the pixels of the images are the values stored in their
+   * buffers. */
+  typedef typename IsSame< typename Input1ImageType::AccessorType,
+                           DefaultPixelAccessor< Input1ImagePixelType > >::Type Input1BufferIsPixelsType;
+  typedef typename IsSame< typename Input2ImageType::AccessorType,
+                           DefaultPixelAccessor< Input2ImagePixelType > >::Type Input2BufferIsPixelsType;
+  typedef typename IsSame< typename OutputImageType::AccessorType,
+                           DefaultPixelAccessor< OutputImagePixelType > >::Type OutputBufferIsPixelsType;
+
+  /** Apply the functor over the contiguous spans of the buffers.  Return
+   * false, without processing any pixel, when it is not possible. */
+  bool BufferThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                                  ThreadIdType threadId, TrueType, TrueType, TrueType);
+
+  template< class TInput1BufferIsPixels, class TInput2BufferIsPixels, class TOutputBufferIsPixels >
+  bool BufferThreadedGenerateData(const OutputImageRegionType &, ThreadIdType,
+                                  TInput1BufferIsPixels, TInput2BufferIsPixels, TOutputBufferIsPixels)
+  {
+    return false;
+  }
+
   FunctorType m_Functor;
 };
 } // end namespace itk
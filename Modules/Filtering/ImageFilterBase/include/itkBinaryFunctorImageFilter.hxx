@@ -20,6 +20,7 @@
 
 #include "itkBinaryFunctorImageFilter.h"
 #include "itkImageRegionIterator.h"
+#include "itkImageScanlineIterator.h"
 #include "itkProgressReporter.h"
 
 namespace itk
@@ -205,6 +206,12 @@ BinaryFunctorImageFilter< TInputImage1, TInputImage2, TOutputImage, TFunction >
 ::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
                        ThreadIdType threadId)
 {
+  if ( this->BufferThreadedGenerateData( outputRegionForThread, threadId, Input1BufferIsPixelsType(),
+                                         Input2BufferIsPixelsType(), OutputBufferIsPixelsType() ) )
+    {
+    return;
+    }
+
   // We use dynamic_cast since inputs are stored as DataObjects.  The
   // ImageToImageFilter::GetInput(int) always returns a pointer to a
   // TInputImage1 so it cannot be used for the second input.
@@ -214,14 +221,20 @@ BinaryFunctorImageFilter< TInputImage1, TInputImage2, TOutputImage, TFunction >
     dynamic_cast< const TInputImage2 * >( ProcessObject::GetInput(1) );
   OutputImagePointer outputPtr = this->GetOutput(0);
 
-  if( inputPtr1 && inputPtr2 )
+  const typename OutputImageRegionType::SizeType & regionSize = outputRegionForThread.GetSize();
+  if ( regionSize[0] == 0 )
     {
-    ImageRegionConstIterator< TInputImage1 > inputIt1(inputPtr1, outputRegionForThread);
-    ImageRegionConstIterator< TInputImage2 > inputIt2(inputPtr2, outputRegionForThread);
+    return;
+    }
+  const SizeValueType numberOfLinesToProcess = outputRegionForThread.GetNumberOfPixels() / regionSize[0];
+  ProgressReporter progress( this, threadId, numberOfLinesToProcess );
 
-    ImageRegionIterator< TOutputImage > outputIt(outputPtr, outputRegionForThread);
+  if( inputPtr1 && inputPtr2 )
+    {
+    ImageScanlineConstIterator< TInputImage1 > inputIt1(inputPtr1, outputRegionForThread);
+    ImageScanlineConstIterator< TInputImage2 > inputIt2(inputPtr2, outputRegionForThread);
 
-    ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
+    ImageScanlineIterator< TOutputImage > outputIt(outputPtr, outputRegionForThread);
 
     inputIt1.GoToBegin();
     inputIt2.GoToBegin();
@@ -229,46 +242,60 @@ BinaryFunctorImageFilter< TInputImage1, TInputImage2, TOutputImage, TFunction >
 
     while ( !inputIt1.IsAtEnd() )
       {
-      outputIt.Set( m_Functor( inputIt1.Get(), inputIt2.Get() ) );
-      ++inputIt2;
-      ++inputIt1;
-      ++outputIt;
+      while ( !inputIt1.IsAtEndOfLine() )
+        {
+        outputIt.Set( m_Functor( inputIt1.Get(), inputIt2.Get() ) );
+        ++inputIt2;
+        ++inputIt1;
+        ++outputIt;
+        }
+      inputIt1.NextLine();
+      inputIt2.NextLine();
+      outputIt.NextLine();
       progress.CompletedPixel(); // potential exception thrown here
       }
     }
   else if( inputPtr1 )
     {
-    ImageRegionConstIterator< TInputImage1 > inputIt1(inputPtr1, outputRegionForThread);
-    ImageRegionIterator< TOutputImage > outputIt(outputPtr, outputRegionForThread);
+    ImageScanlineConstIterator< TInputImage1 > inputIt1(inputPtr1, outputRegionForThread);
+    ImageScanlineIterator< TOutputImage > outputIt(outputPtr, outputRegionForThread);
     const Input2ImagePixelType & input2Value = this->GetConstant2();
-    ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
 
     inputIt1.GoToBegin();
     outputIt.GoToBegin();
 
     while ( !inputIt1.IsAtEnd() )
       {
-      outputIt.Set( m_Functor( inputIt1.Get(), input2Value ) );
-      ++inputIt1;
-      ++outputIt;
+      while ( !inputIt1.IsAtEndOfLine() )
+        {
+        outputIt.Set( m_Functor( inputIt1.Get(), input2Value ) );
+        ++inputIt1;
+        ++outputIt;
+        }
+      inputIt1.NextLine();
+      outputIt.NextLine();
       progress.CompletedPixel(); // potential exception thrown here
       }
     }
   else if( inputPtr2 )
     {
-    ImageRegionConstIterator< TInputImage2 > inputIt2(inputPtr2, outputRegionForThread);
-    ImageRegionIterator< TOutputImage > outputIt(outputPtr, outputRegionForThread);
+    ImageScanlineConstIterator< TInputImage2 > inputIt2(inputPtr2, outputRegionForThread);
+    ImageScanlineIterator< TOutputImage > outputIt(outputPtr, outputRegionForThread);
     const Input1ImagePixelType & input1Value = this->GetConstant1();
-    ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
 
     inputIt2.GoToBegin();
     outputIt.GoToBegin();
 
     while ( !inputIt2.IsAtEnd() )
       {
-      outputIt.Set( m_Functor( input1Value, inputIt2.Get() ) );
-      ++inputIt2;
-      ++outputIt;
+      while ( !inputIt2.IsAtEndOfLine() )
+        {
+        outputIt.Set( m_Functor( input1Value, inputIt2.Get() ) );
+        ++inputIt2;
+        ++outputIt;
+        }
+      inputIt2.NextLine();
+      outputIt.NextLine();
       progress.CompletedPixel(); // potential exception thrown here
       }
     }
@@ -277,6 +304,110 @@ BinaryFunctorImageFilter< TInputImage1, TInputImage2, TOutputImage, TFunction >
     itkGenericExceptionMacro(<<"At most one of the inputs can be a constant.");
     }
 }
+
+template< class TInputImage1, class TInputImage2, class TOutputImage, class TFunction  >
+bool
+BinaryFunctorImageFilter< TInputImage1, TInputImage2, TOutputImage, TFunction >
+::BufferThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                             ThreadIdType threadId, TrueType, TrueType, TrueType)
+{
+  const unsigned int ImageDimension = OutputImageType::ImageDimension;
+
+  const Input1ImageType *inputPtr1 =
+    dynamic_cast< const TInputImage1 * >( ProcessObject::GetInput(0) );
+  const Input2ImageType *inputPtr2 =
+    dynamic_cast< const TInputImage2 * >( ProcessObject::GetInput(1) );
+  OutputImageType *outputPtr = this->GetOutput(0);
+
+  if ( !inputPtr1 && !inputPtr2 )
+    {
+    // reported by the iterator implementation
+    return false;
+    }
+
+  const SizeValueType numberOfPixels = outputRegionForThread.GetNumberOfPixels();
+  if ( numberOfPixels == 0 )
+    {
+    return true;
+    }
+
+  // The span extends over the next dimension as long as the region covers
+  // the whole buffered region of all the images in the previous ones.
+  const typename OutputImageRegionType::SizeType & size = outputRegionForThread.GetSize();
+  SizeValueType spanLength = size[0];
+  unsigned int  firstOuterDimension = 1;
+  while ( firstOuterDimension < ImageDimension )
+    {
+    const unsigned int d = firstOuterDimension - 1;
+    if ( size[d] != outputPtr->GetBufferedRegion().GetSize(d)
+         || ( inputPtr1 && size[d] != inputPtr1->GetBufferedRegion().GetSize(d) )
+         || ( inputPtr2 && size[d] != inputPtr2->GetBufferedRegion().GetSize(d) ) )
+      {
+      break;
+      }
+    spanLength *= size[firstOuterDimension];
+    ++firstOuterDimension;
+    }
+  const SizeValueType numberOfSpans = numberOfPixels / spanLength;
+
+  ProgressReporter progress( this, threadId, numberOfSpans );
+
+  // A local copy of the functor lets the compiler keep its members in
+  // registers, as they cannot alias the output buffer.
+  FunctorType functor = m_Functor;
+
+  const typename OutputImageRegionType::IndexType & start = outputRegionForThread.GetIndex();
+  typename OutputImageRegionType::IndexType         index = start;
+
+  const Input1ImagePixelType input1Value = inputPtr1 ? Input1ImagePixelType() : this->GetConstant1();
+  const Input2ImagePixelType input2Value = inputPtr2 ? Input2ImagePixelType() : this->GetConstant2();
+
+  for ( SizeValueType span = 0; span < numberOfSpans; ++span )
+    {
+    OutputImagePixelType *out = outputPtr->GetBufferPointer() + outputPtr->ComputeOffset(index);
+
+    if ( inputPtr1 && inputPtr2 )
+      {
+      const Input1ImagePixelType *in1 = inputPtr1->GetBufferPointer() + inputPtr1->ComputeOffset(index);
+      const Input2ImagePixelType *in2 = inputPtr2->GetBufferPointer() + inputPtr2->ComputeOffset(index);
+      for ( SizeValueType i = 0; i < spanLength; ++i )
+        {
+        out[i] = functor(in1[i], in2[i]);
+        }
+      }
+    else if ( inputPtr1 )
+      {
+      const Input1ImagePixelType *in1 = inputPtr1->GetBufferPointer() + inputPtr1->ComputeOffset(index);
+      for ( SizeValueType i = 0; i < spanLength; ++i )
+        {
+        out[i] = functor(in1[i], input2Value);
+        }
+      }
+    else
+      {
+      const Input2ImagePixelType *in2 = inputPtr2->GetBufferPointer() + inputPtr2->ComputeOffset(index);
+      for ( SizeValueType i = 0; i < spanLength; ++i )
+        {
+        out[i] = functor(input1Value, in2[i]);
+        }
+      }
+
+    // move to the start of the next span
+    for ( unsigned int d = firstOuterDimension; d < ImageDimension; ++d )
+      {
+      ++index[d];
+      if ( static_cast< SizeValueType >( index[d] - start[d] ) < size[d] )
+        {
+        break;
+        }
+      index[d] = start[d];
+      }
+
+    progress.CompletedPixel(); // potential exception thrown here
+    }
+
+  return true;
+}
 } // end namespace itk
 
 #endif
@@ -24,6 +24,7 @@
 #include "itkNeighborhoodInnerProduct.h"
 #include "itkImageRegionIterator.h"
 #include "itkConstNeighborhoodIterator.h"
+#include "itkConstInteriorNeighborhoodIterator.h"
 #include "itkProgressReporter.h"
 
 namespace itk
@@ -89,6 +90,10 @@ NeighborhoodOperatorImageFilter< TInputImage, TOutputImage, TOperatorValueType >
 
   typedef typename BFC::FaceListType FaceListType;
 
+  typedef ConstInteriorNeighborhoodIterator< InputImageType >                     InteriorIteratorType;
+  typedef NeighborhoodAlgorithm::ImageInteriorTilesCalculator< InputImageType > TilesCalculatorType;
+  typedef typename TilesCalculatorType::TileListType                              TileListType;
+
   NeighborhoodInnerProduct< InputImageType, OperatorValueType, ComputingPixelType > smartInnerProduct;
   BFC                                                           faceCalculator;
   FaceListType                                                  faceList;
@@ -117,6 +122,27 @@ NeighborhoodOperatorImageFilter< TInputImage, TOutputImage, TOperatorValueType >
   ConstNeighborhoodIterator< InputImageType > bit;
   for ( fit = faceList.begin(); fit != faceList.end(); ++fit )
     {
+    // The non-boundary region is walked tile by tile, with an iterator
+    // that only moves the center of the neighborhood
+    if ( fit == faceList.begin()
+         && InteriorIteratorType::IsInteriorRegion(m_Operator.GetRadius(), input, *fit) )
+      {
+      const TileListType tiles = TilesCalculatorType()( *fit, m_Operator.GetRadius() );
+      for ( typename TileListType::const_iterator tit = tiles.begin(); tit != tiles.end(); ++tit )
+        {
+        InteriorIteratorType iit(m_Operator.GetRadius(), input, *tit);
+        it = ImageRegionIterator< OutputImageType >(output, *tit);
+        while ( !iit.IsAtEnd() )
+          {
+          it.Value() = static_cast< typename OutputImageType::PixelType >( smartInnerProduct(iit, m_Operator) );
+          ++iit;
+          ++it;
+          progress.CompletedPixel();
+          }
+        }
+      continue;
+      }
+
     bit =
       ConstNeighborhoodIterator< InputImageType >(m_Operator.GetRadius(),
                                                   input, *fit);
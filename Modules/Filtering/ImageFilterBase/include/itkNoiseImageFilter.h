@@ -20,7 +20,9 @@
 
 #include "itkBoxImageFilter.h"
 #include "itkImage.h"
+#include "itkIsSame.h"
 #include "itkNumericTraits.h"
+#include "itkProgressReporter.h"
 
 namespace itk
 {
@@ -35,6 +37,12 @@ namespace itk
  * to the neighborhood and calculating the standard deviation of the
  * residuals to this (hyper) plane.
  *
+ * The standard deviations of scalar pixels are computed from a
+ * SummedAreaTable of the pixels and of their squares, in constant time
+ * whatever the radius. The mean of each slab of pixels tabulated is
+ * subtracted from the pixels first, to keep the precision of the
+ * deviations of images with a large offset.
+ *
  * \sa Image
  * \sa Neighborhood
  * \sa NeighborhoodOperator
@@ -111,6 +119,21 @@ protected:
 private:
   NoiseImageFilter(const Self &); //purposely not implemented
   void operator=(const Self &);   //purposely not implemented
+
+  /** Compute the standard deviations from summed area tables when the
+   * pixels are scalars. Returns false otherwise. */
+  bool ThreadedGenerateBoxData(const OutputImageRegionType & outputRegionForThread,
+                               ThreadIdType threadId, const TrueType &);
+  bool ThreadedGenerateBoxData(const OutputImageRegionType &, ThreadIdType, const FalseType &)
+  {
+    return false;
+  }
+
+  /** Compute the standard deviations of the neighborhoods of the pixels
+   * of region, walked by bit. */
+  template< class TNeighborhoodIterator >
+  void ComputeStandardDeviations(TNeighborhoodIterator & bit, const OutputImageRegionType & region,
+                                 ProgressReporter & progress);
 };
 } // end namespace itk
 
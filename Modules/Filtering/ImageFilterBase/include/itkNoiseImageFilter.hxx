@@ -20,11 +20,14 @@
 #include "itkNoiseImageFilter.h"
 
 #include "itkConstNeighborhoodIterator.h"
+#include "itkConstInteriorNeighborhoodIterator.h"
 #include "itkNeighborhoodInnerProduct.h"
 #include "itkImageRegionIterator.h"
+#include "itkImageScanlineIterator.h"
 #include "itkNeighborhoodAlgorithm.h"
 #include "itkOffset.h"
 #include "itkProgressReporter.h"
+#include "itkSummedAreaTable.h"
 
 namespace itk
 {
@@ -39,15 +42,18 @@ NoiseImageFilter< TInputImage, TOutputImage >
 ::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
                        ThreadIdType threadId)
 {
-  unsigned int i;
+  typedef typename IsSame< InputRealType, typename NumericTraits< InputRealType >::ScalarRealType >::Type IsScalarType;
+  if ( this->ThreadedGenerateBoxData( outputRegionForThread, threadId, IsScalarType() ) )
+    {
+    return;
+    }
 
-  ZeroFluxNeumannBoundaryCondition< InputImageType > nbc;
+  typedef ConstInteriorNeighborhoodIterator< InputImageType >                     InteriorIteratorType;
+  typedef NeighborhoodAlgorithm::ImageInteriorTilesCalculator< InputImageType > TilesCalculatorType;
+  typedef typename TilesCalculatorType::TileListType                              TileListType;
 
-  ConstNeighborhoodIterator< InputImageType > bit;
-  ImageRegionIterator< OutputImageType >      it;
+  ZeroFluxNeumannBoundaryCondition< InputImageType > nbc;
 
-  // Allocate output
-  typename OutputImageType::Pointer output = this->GetOutput();
   typename  InputImageType::ConstPointer input  = this->GetInput();
 
   // Find the data-set boundary "faces"
@@ -60,44 +66,119 @@ NoiseImageFilter< TInputImage, TOutputImage >
   // support progress methods/callbacks
   ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
 
-  InputRealType value;
-  InputRealType sum;
-  InputRealType sumOfSquares;
-  InputRealType var;
-  InputRealType num;
-
   // Process each of the boundary faces.  These are N-d regions which border
   // the edge of the buffer.
   for ( fit = faceList.begin(); fit != faceList.end(); ++fit )
     {
-    bit = ConstNeighborhoodIterator< InputImageType >(this->GetRadius(),
-                                                      input, *fit);
-    unsigned int neighborhoodSize = bit.Size();
-    num = static_cast< InputRealType >( bit.Size() );
+    // The non-boundary region is walked tile by tile, with an iterator
+    // that only moves the center of the neighborhood
+    if ( fit == faceList.begin()
+         && InteriorIteratorType::IsInteriorRegion(this->GetRadius(), input, *fit) )
+      {
+      const TileListType tiles = TilesCalculatorType()( *fit, this->GetRadius() );
+      for ( typename TileListType::const_iterator tit = tiles.begin(); tit != tiles.end(); ++tit )
+        {
+        InteriorIteratorType iit(this->GetRadius(), input, *tit);
+        this->ComputeStandardDeviations(iit, *tit, progress);
+        }
+      continue;
+      }
 
-    it = ImageRegionIterator< OutputImageType >(output, *fit);
+    ConstNeighborhoodIterator< InputImageType > bit(this->GetRadius(), input, *fit);
     bit.OverrideBoundaryCondition(&nbc);
     bit.GoToBegin();
+    this->ComputeStandardDeviations(bit, *fit, progress);
+    }
+}
+
+template< class TInputImage, class TOutputImage >
+bool
+NoiseImageFilter< TInputImage, TOutputImage >
+::ThreadedGenerateBoxData(const OutputImageRegionType & outputRegionForThread,
+                          ThreadIdType threadId, const TrueType &)
+{
+  typedef SummedAreaTable< InputImageType >  TableType;
+  typedef typename TableType::RegionListType RegionListType;
+
+  const InputImageType *input = this->GetInput();
+  const InputSizeType   radius = this->GetRadius();
+
+  double num = 1.0;
+  for ( unsigned int d = 0; d < InputImageDimension; ++d )
+    {
+    num *= static_cast< double >( 2 * radius[d] + 1 );
+    }
 
-    while ( !bit.IsAtEnd() )
+  // support progress methods/callbacks
+  ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
+
+  // The tables are built slab after slab to bound the memory they use.
+  // The variances do not depend on the reference value subtracted from
+  // the pixels, which keeps the sums of squares small.
+  TableType table;
+  table.SetComputeSumOfSquares(true);
+  table.SetSubtractReferenceValue(true);
+  const RegionListType slabs = TableType::SplitRegion(outputRegionForThread, radius);
+  for ( typename RegionListType::const_iterator sit = slabs.begin(); sit != slabs.end(); ++sit )
+    {
+    table.Compute(input, *sit, radius);
+
+    ImageScanlineIterator< OutputImageType > it(this->GetOutput(), *sit);
+    while ( !it.IsAtEnd() )
       {
-      sum = NumericTraits< InputRealType >::Zero;
-      sumOfSquares = NumericTraits< InputRealType >::Zero;
-      for ( i = 0; i < neighborhoodSize; ++i )
+      typename TableType::OffsetValueType position = table.ComputeOffset( it.GetIndex() );
+      while ( !it.IsAtEndOfLine() )
         {
-        value = static_cast< InputRealType >( bit.GetPixel(i) );
-        sum += value;
-        sumOfSquares += ( value * value );
+        const double sum = table.GetSum(position);
+        const double var = ( table.GetSumOfSquares(position) - ( sum * sum / num ) ) / ( num - 1.0 );
+
+        // the differences of the tabulated sums may be slightly negative
+        // on flat neighborhoods
+        it.Set( static_cast< OutputPixelType >( var > 0.0 ? vcl_sqrt(var) : 0.0 ) );
+        ++position;
+        ++it;
+        progress.CompletedPixel();
         }
+      it.NextLine();
+      }
+    }
+  return true;
+}
 
-      // calculate the standard deviation value
-      var = ( sumOfSquares - ( sum * sum / num ) ) / ( num - 1.0 );
-      it.Set( static_cast< OutputPixelType >( vcl_sqrt(var) ) );
+template< class TInputImage, class TOutputImage >
+template< class TNeighborhoodIterator >
+void
+NoiseImageFilter< TInputImage, TOutputImage >
+::ComputeStandardDeviations(TNeighborhoodIterator & bit, const OutputImageRegionType & region,
+                            ProgressReporter & progress)
+{
+  ImageRegionIterator< OutputImageType > it(this->GetOutput(), region);
+
+  const unsigned int  neighborhoodSize = bit.Size();
+  const InputRealType num = static_cast< InputRealType >( neighborhoodSize );
+  InputRealType       value;
+  InputRealType       sum;
+  InputRealType       sumOfSquares;
+  InputRealType       var;
 
-      ++bit;
-      ++it;
-      progress.CompletedPixel();
+  while ( !bit.IsAtEnd() )
+    {
+    sum = NumericTraits< InputRealType >::Zero;
+    sumOfSquares = NumericTraits< InputRealType >::Zero;
+    for ( unsigned int i = 0; i < neighborhoodSize; ++i )
+      {
+      value = static_cast< InputRealType >( bit.GetPixel(i) );
+      sum += value;
+      sumOfSquares += ( value * value );
       }
+
+    // calculate the standard deviation value
+    var = ( sumOfSquares - ( sum * sum / num ) ) / ( num - 1.0 );
+    it.Set( static_cast< OutputPixelType >( vcl_sqrt(var) ) );
+
+    ++bit;
+    ++it;
+    progress.CompletedPixel();
     }
 }
 } // end namespace itk
@@ -21,6 +21,7 @@
 #include "itkInPlaceImageFilter.h"
 #include "itkNumericTraits.h"
 #include "itkImageRegionSplitterDirection.h"
+#include "itkIsSame.h"
 
 namespace itk
 {
@@ -44,6 +45,10 @@ namespace itk
  * G. Farneback & C.-F. Westin, "On Implementation of Recursive Gaussian
  * Filters", so far unpublished.
  *
+ * Images of scalar pixels are filtered in bundles of adjacent lines, which
+ * are read and written along contiguous memory and whose recursions are
+ * computed side by side, so that they can be vectorized.
+ *
  * \ingroup ImageFilters
  * \ingroup ITKImageFilterBase
  */
@@ -132,6 +137,13 @@ protected:
   void FilterDataArray(RealType *outs, const RealType *data, RealType *scratch,
                        unsigned int ln);
 
+  /** Apply the Recursive Filter to a bundle of BundleSize lines whose
+   * pixels are interleaved: pixel i of line b is at i * BundleSize + b
+   * in the parameters "outs", "data" and "scratch". The lines are
+   * filtered as FilterDataArray does. */
+  void FilterDataBundle(RealType *outs, const RealType *data, RealType *scratch,
+                        unsigned int ln);
+
 protected:
   /** Causal coefficients that multiply the input data. */
   ScalarRealType m_N0;
@@ -169,6 +181,20 @@ private:
   RecursiveSeparableImageFilter(const Self &); //purposely not implemented
   void operator=(const Self &);                //purposely not implemented
 
+  /** Number of lines of the bundles filtered together, which span a
+   * cache line of float pixels along the first dimension. */
+  itkStaticConstMacro(BundleSize, unsigned int, 16);
+
+  /** Filters the lines of the region in bundles when the pixels are
+   * scalars and the images hold them in their buffers. Returns false
+   * otherwise. */
+  bool ThreadedGenerateBundledData(const OutputImageRegionType & outputRegionForThread,
+                                   ThreadIdType threadId, const TrueType &);
+  bool ThreadedGenerateBundledData(const OutputImageRegionType &, ThreadIdType, const FalseType &)
+  {
+    return false;
+  }
+
   /** Direction in which the filter is to be applied
    * this should be in the range [0,ImageDimension-1]. */
   unsigned int m_Direction;
@@ -23,6 +23,8 @@
 #include "itkImageLinearIteratorWithIndex.h"
 #include "itkProgressReporter.h"
 #include <new>
+#include <vector>
+#include <algorithm>
 
 namespace itk
 {
@@ -154,6 +156,154 @@ RecursiveSeparableImageFilter< TInputImage, TOutputImage >
     }
 }
 
+/**
+ * Apply Recursive Filter to interleaved lines
+ */
+template< typename TInputImage, typename TOutputImage >
+void
+RecursiveSeparableImageFilter< TInputImage, TOutputImage >
+::FilterDataBundle(RealType *outs, const RealType *data,
+                   RealType *scratch, unsigned int ln)
+{
+  // local copies of the coefficients, which the compiler can keep in
+  // registers while writing to the arrays
+  const ScalarRealType n0 = m_N0;
+  const ScalarRealType n1 = m_N1;
+  const ScalarRealType n2 = m_N2;
+  const ScalarRealType n3 = m_N3;
+  const ScalarRealType d1 = m_D1;
+  const ScalarRealType d2 = m_D2;
+  const ScalarRealType d3 = m_D3;
+  const ScalarRealType d4 = m_D4;
+  const ScalarRealType m1 = m_M1;
+  const ScalarRealType m2 = m_M2;
+  const ScalarRealType m3 = m_M3;
+  const ScalarRealType m4 = m_M4;
+
+  /**
+   * Causal direction pass
+   */
+
+  /**
+   * Initialize borders
+   */
+  for ( unsigned int b = 0; b < BundleSize; b++ )
+    {
+    const RealType *in0 = data + b;
+    const RealType *in1 = in0 + BundleSize;
+    const RealType *in2 = in1 + BundleSize;
+    const RealType *in3 = in2 + BundleSize;
+    RealType *      sc0 = scratch + b;
+    RealType *      sc1 = sc0 + BundleSize;
+    RealType *      sc2 = sc1 + BundleSize;
+    RealType *      sc3 = sc2 + BundleSize;
+
+    // this value is assumed to exist from the border to infinity.
+    const RealType outV1 = in0[0];
+
+    sc0[0] = RealType(outV1  * n0 + outV1  * n1 + outV1  * n2 + outV1 * n3);
+    sc1[0] = RealType(in1[0] * n0 + outV1  * n1 + outV1  * n2 + outV1 * n3);
+    sc2[0] = RealType(in2[0] * n0 + in1[0] * n1 + outV1  * n2 + outV1 * n3);
+    sc3[0] = RealType(in3[0] * n0 + in2[0] * n1 + in1[0] * n2 + outV1 * n3);
+
+    // note that the outV1 value is multiplied by the Boundary coefficients m_BNi
+    sc0[0] -= RealType(outV1  * m_BN1 + outV1  * m_BN2 + outV1  * m_BN3 + outV1 * m_BN4);
+    sc1[0] -= RealType(sc0[0] * d1    + outV1  * m_BN2 + outV1  * m_BN3 + outV1 * m_BN4);
+    sc2[0] -= RealType(sc1[0] * d1    + sc0[0] * d2    + outV1  * m_BN3 + outV1 * m_BN4);
+    sc3[0] -= RealType(sc2[0] * d1    + sc1[0] * d2    + sc0[0] * d3    + outV1 * m_BN4);
+    }
+
+  /**
+   * Recursively filter the rest, all the lines at once
+   */
+  for ( unsigned int i = 4; i < ln; i++ )
+    {
+    const RealType *in0 = data + i * BundleSize;
+    const RealType *in1 = in0 - BundleSize;
+    const RealType *in2 = in1 - BundleSize;
+    const RealType *in3 = in2 - BundleSize;
+    RealType *      sc0 = scratch + i * BundleSize;
+    const RealType *sc1 = sc0 - BundleSize;
+    const RealType *sc2 = sc1 - BundleSize;
+    const RealType *sc3 = sc2 - BundleSize;
+    const RealType *sc4 = sc3 - BundleSize;
+    for ( unsigned int b = 0; b < BundleSize; b++ )
+      {
+      sc0[b]  = RealType(in0[b] * n0 + in1[b] * n1 + in2[b] * n2 + in3[b] * n3);
+      sc0[b] -= RealType(sc1[b] * d1 + sc2[b] * d2 + sc3[b] * d3 + sc4[b] * d4);
+      }
+    }
+
+  /**
+   * Store the causal result
+   */
+  for ( unsigned int i = 0; i < ln * BundleSize; i++ )
+    {
+    outs[i] = scratch[i];
+    }
+
+  /**
+   * AntiCausal direction pass
+   */
+
+  /**
+   * Initialize borders
+   */
+  for ( unsigned int b = 0; b < BundleSize; b++ )
+    {
+    const RealType *in0 = data + ( ln - 1 ) * BundleSize + b;
+    const RealType *in1 = in0 - BundleSize;
+    const RealType *in2 = in1 - BundleSize;
+    RealType *      sc0 = scratch + ( ln - 1 ) * BundleSize + b;
+    RealType *      sc1 = sc0 - BundleSize;
+    RealType *      sc2 = sc1 - BundleSize;
+    RealType *      sc3 = sc2 - BundleSize;
+
+    // this value is assumed to exist from the border to infinity.
+    const RealType outV2 = in0[0];
+
+    sc0[0] = RealType(outV2  * m1 + outV2  * m2 + outV2  * m3 + outV2 * m4);
+    sc1[0] = RealType(in0[0] * m1 + outV2  * m2 + outV2  * m3 + outV2 * m4);
+    sc2[0] = RealType(in1[0] * m1 + in0[0] * m2 + outV2  * m3 + outV2 * m4);
+    sc3[0] = RealType(in2[0] * m1 + in1[0] * m2 + in0[0] * m3 + outV2 * m4);
+
+    // note that the outV2value is multiplied by the Boundary coefficients m_BMi
+    sc0[0] -= RealType(outV2  * m_BM1 + outV2  * m_BM2 + outV2  * m_BM3 + outV2 * m_BM4);
+    sc1[0] -= RealType(sc0[0] * d1    + outV2  * m_BM2 + outV2  * m_BM3 + outV2 * m_BM4);
+    sc2[0] -= RealType(sc1[0] * d1    + sc0[0] * d2    + outV2  * m_BM3 + outV2 * m_BM4);
+    sc3[0] -= RealType(sc2[0] * d1    + sc1[0] * d2    + sc0[0] * d3    + outV2 * m_BM4);
+    }
+
+  /**
+   * Recursively filter the rest, all the lines at once
+   */
+  for ( unsigned int i = ln - 4; i > 0; i-- )
+    {
+    const RealType *in0 = data + i * BundleSize;
+    const RealType *in1 = in0 + BundleSize;
+    const RealType *in2 = in1 + BundleSize;
+    const RealType *in3 = in2 + BundleSize;
+    RealType *      sc0 = scratch + ( i - 1 ) * BundleSize;
+    const RealType *sc1 = sc0 + BundleSize;
+    const RealType *sc2 = sc1 + BundleSize;
+    const RealType *sc3 = sc2 + BundleSize;
+    const RealType *sc4 = sc3 + BundleSize;
+    for ( unsigned int b = 0; b < BundleSize; b++ )
+      {
+      sc0[b]  = RealType(in0[b] * m1 + in1[b] * m2 + in2[b] * m3 + in3[b] * m4);
+      sc0[b] -= RealType(sc1[b] * d1 + sc2[b] * d2 + sc3[b] * d3 + sc4[b] * d4);
+      }
+    }
+
+  /**
+   * Roll the antiCausal part into the output
+   */
+  for ( unsigned int i = 0; i < ln * BundleSize; i++ )
+    {
+    outs[i] += scratch[i];
+    }
+}
+
 //
 // we need all of the image in just the "Direction" we are separated into
 //
@@ -239,6 +389,12 @@ void
 RecursiveSeparableImageFilter< TInputImage, TOutputImage >
 ::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread, ThreadIdType threadId)
 {
+  typedef typename IsSame< RealType, ScalarRealType >::Type IsScalarType;
+  if ( this->ThreadedGenerateBundledData( outputRegionForThread, threadId, IsScalarType() ) )
+    {
+    return;
+    }
+
   typedef typename TOutputImage::PixelType OutputPixelType;
 
   typedef ImageLinearConstIteratorWithIndex< TInputImage > InputConstIteratorType;
@@ -321,6 +477,146 @@ RecursiveSeparableImageFilter< TInputImage, TOutputImage >
   delete[] scratch;
 }
 
+/**
+ * Compute Recursive filter
+ * in bundles of adjacent lines
+ */
+template< typename TInputImage, typename TOutputImage >
+bool
+RecursiveSeparableImageFilter< TInputImage, TOutputImage >
+::ThreadedGenerateBundledData(const OutputImageRegionType & outputRegionForThread,
+                              ThreadIdType threadId, const TrueType &)
+{
+  typedef typename TOutputImage::PixelType                         OutputPixelType;
+  typedef Image< InputPixelType, TInputImage::ImageDimension >     InputBufferImageType;
+  typedef Image< OutputPixelType, TOutputImage::ImageDimension >   OutputBufferImageType;
+  typedef typename OutputImageRegionType::IndexType                IndexType;
+  typedef typename OutputImageRegionType::SizeType                 SizeType;
+
+  // The buffers of image adaptors do not hold their pixels
+  const InputBufferImageType *inputImage =
+    dynamic_cast< const InputBufferImageType * >( this->GetInputImage() );
+  OutputBufferImageType *outputImage =
+    dynamic_cast< OutputBufferImageType * >( this->GetOutput() );
+  if ( TInputImage::ImageDimension < 2 || inputImage == 0 || outputImage == 0 )
+    {
+    return false;
+    }
+
+  // The lines of a bundle are adjacent along the first dimension, where
+  // the pixels are contiguous, or along the second one when the lines
+  // are along the first dimension.
+  const unsigned int direction = this->m_Direction;
+  const unsigned int bundleDirection = ( direction == 0 ) ? 1 : 0;
+
+  const IndexType & start = outputRegionForThread.GetIndex();
+  const SizeType &  size = outputRegionForThread.GetSize();
+  const unsigned int ln = size[direction];
+
+  const OffsetValueType inputStride = inputImage->GetOffsetTable()[direction];
+  const OffsetValueType outputStride = outputImage->GetOffsetTable()[direction];
+  const OffsetValueType inputBundleStride = inputImage->GetOffsetTable()[bundleDirection];
+  const OffsetValueType outputBundleStride = outputImage->GetOffsetTable()[bundleDirection];
+
+  std::vector< RealType > inps(ln * BundleSize);
+  std::vector< RealType > outs(ln * BundleSize);
+  std::vector< RealType > scratch(ln * BundleSize);
+
+  const SizeValueType numberOfLinesToProcess = outputRegionForThread.GetNumberOfPixels() / ln;
+  ProgressReporter    progress(this, threadId, numberOfLinesToProcess, 10);
+
+  IndexType index = start;
+  for (;; )
+    {
+    const unsigned int count = static_cast< unsigned int >(
+      std::min( static_cast< IndexValueType >( BundleSize ),
+                start[bundleDirection] + static_cast< IndexValueType >( size[bundleDirection] ) - index[bundleDirection] ) );
+
+    const InputPixelType *in = inputImage->GetBufferPointer() + inputImage->ComputeOffset(index);
+    OutputPixelType *     out = outputImage->GetBufferPointer() + outputImage->ComputeOffset(index);
+
+    // Interleave the lines, reading the memory in its order. The last
+    // bundle of a row is completed by repeating its last line.
+    if ( direction == 0 )
+      {
+      for ( unsigned int b = 0; b < BundleSize; b++ )
+        {
+        const InputPixelType *line = in + std::min(b, count - 1) * inputBundleStride;
+        for ( unsigned int i = 0; i < ln; i++ )
+          {
+          inps[i * BundleSize + b] = static_cast< RealType >( line[i] );
+          }
+        }
+      }
+    else
+      {
+      for ( unsigned int i = 0; i < ln; i++ )
+        {
+        const InputPixelType *pixels = in + i * inputStride;
+        for ( unsigned int b = 0; b < BundleSize; b++ )
+          {
+          inps[i * BundleSize + b] = static_cast< RealType >( pixels[std::min(b, count - 1) * inputBundleStride] );
+          }
+        }
+      }
+
+    this->FilterDataBundle(&outs[0], &inps[0], &scratch[0], ln);
+
+    if ( direction == 0 )
+      {
+      for ( unsigned int b = 0; b < count; b++ )
+        {
+        OutputPixelType *line = out + b * outputBundleStride;
+        for ( unsigned int i = 0; i < ln; i++ )
+          {
+          line[i] = static_cast< OutputPixelType >( outs[i * BundleSize + b] );
+          }
+        }
+      }
+    else
+      {
+      for ( unsigned int i = 0; i < ln; i++ )
+        {
+        OutputPixelType *pixels = out + i * outputStride;
+        for ( unsigned int b = 0; b < count; b++ )
+          {
+          pixels[b * outputBundleStride] = static_cast< OutputPixelType >( outs[i * BundleSize + b] );
+          }
+        }
+      }
+
+    for ( unsigned int b = 0; b < count; b++ )
+      {
+      progress.CompletedPixel();
+      }
+
+    // next bundle
+    index[bundleDirection] += count;
+    unsigned int d = bundleDirection;
+    while ( d < TInputImage::ImageDimension )
+      {
+      if ( d != direction )
+        {
+        if ( index[d] < start[d] + static_cast< IndexValueType >( size[d] ) )
+          {
+          break;
+          }
+        index[d] = start[d];
+        }
+      ++d;
+      if ( d < TInputImage::ImageDimension && d != direction )
+        {
+        ++index[d];
+        }
+      }
+    if ( d == TInputImage::ImageDimension )
+      {
+      break;
+      }
+    }
+  return true;
+}
+
 template< typename TInputImage, typename TOutputImage >
 void
 RecursiveSeparableImageFilter< TInputImage, TOutputImage >
@@ -0,0 +1,219 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkSummedAreaTable_h
+#define __itkSummedAreaTable_h
+
+#include "itkCastImageFilter.h"
+#include <list>
+#include <vector>
+
+namespace itk
+{
+/** \class SummedAreaTable
+ * \brief Tabulates the sums of the pixels of an image so that their sum
+ * over any box is computed in constant time.
+ *
+ * The table holds, for each index, the sum of the values of the pixels
+ * whose indices are all lower or equal. The sum over a box is then
+ * obtained from the 2^ImageDimension corners of the box, whatever its
+ * radius. The table covers the boxes of a given radius centered on the
+ * pixels of a region. It can also hold the sums of the squares of the
+ * values, to compute the variances over the boxes.
+ *
+ * The values summed are the pixels converted by a function object, by
+ * default a cast to TAccumulate. TAccumulate defaults to double, which
+ * avoids the drift of single precision sums over large regions, and
+ * keeps the sums of integer pixels exact up to 2^53. An integer type
+ * can be used to count pixels exactly.
+ *
+ * The pixels outside the buffered region of the image are replaced by
+ * the nearest pixel of the buffered region, as ZeroFluxNeumannBoundaryCondition
+ * does. When ReplicateBorder is off they are left out instead, and the
+ * number of pixels summed over each box is tabulated too. A mask image
+ * can be given as well, in which case only the pixels where the mask is
+ * not zero are summed and counted.
+ *
+ * The prefix sums grow with the number of positions of the table, and
+ * their differences lose the low order digits of the values. When
+ * SubtractReferenceValue is on, the mean of the values tabulated is
+ * subtracted from them first, so that the sums over the boxes, and above
+ * all the sums of their squares, keep their precision on images with a
+ * large offset. The sums are then the sums of the values minus
+ * GetReferenceValue().
+ *
+ * A table is usually built by each thread for its output region. The
+ * region can first be split by SplitRegion() to bound the memory used.
+ *
+ * \sa BoxImageFilter
+ *
+ * \ingroup ITKImageFilterBase
+ */
+template< class TImage, class TAccumulate = double,
+          class TFunction = Functor::Cast< typename TImage::PixelType, TAccumulate > >
+class SummedAreaTable
+{
+public:
+  /** Standard class typedefs. */
+  typedef SummedAreaTable Self;
+
+  /** Image related typedefs. */
+  typedef TImage                              ImageType;
+  typedef typename ImageType::PixelType       PixelType;
+  typedef typename ImageType::RegionType      RegionType;
+  typedef typename ImageType::SizeType        SizeType;
+  typedef typename ImageType::IndexType       IndexType;
+  typedef typename ImageType::OffsetValueType OffsetValueType;
+
+  itkStaticConstMacro(ImageDimension, unsigned int, TImage::ImageDimension);
+
+  typedef TAccumulate             AccumulateType;
+  typedef TFunction               FunctorType;
+  typedef std::list< RegionType > RegionListType;
+
+  SummedAreaTable();
+
+  /** Get/Set the function object converting the pixels to the values
+   * summed. */
+  FunctorType & GetFunctor() { return m_Functor; }
+  const FunctorType & GetFunctor() const { return m_Functor; }
+  void SetFunctor(const FunctorType & functor) { m_Functor = functor; }
+
+  /** Tabulate the sums of the squares of the values too. Off by
+   * default. */
+  void SetComputeSumOfSquares(bool compute) { m_ComputeSumOfSquares = compute; }
+  bool GetComputeSumOfSquares() const { return m_ComputeSumOfSquares; }
+
+  /** Replace the pixels outside the buffered region by the nearest
+   * pixel of the buffered region. On by default. */
+  void SetReplicateBorder(bool replicate) { m_ReplicateBorder = replicate; }
+  bool GetReplicateBorder() const { return m_ReplicateBorder; }
+
+  /** Subtract the mean of the values tabulated from the values before
+   * summing them. Off by default. The mean is rounded when the pixels
+   * are integers, so that their sums stay exact. */
+  void SetSubtractReferenceValue(bool subtract) { m_SubtractReferenceValue = subtract; }
+  bool GetSubtractReferenceValue() const { return m_SubtractReferenceValue; }
+
+  /** Value subtracted from the values summed by the last Compute(), zero
+   * unless SubtractReferenceValue is on. */
+  AccumulateType GetReferenceValue() const { return m_ReferenceValue; }
+
+  /** Build the table of the boxes of the given radius centered on the
+   * pixels of region, which must lie inside the buffered region of
+   * image. */
+  void Compute(const ImageType *image, const RegionType & region, const SizeType & radius);
+
+  /** Same as above, but only the pixels where mask is not zero are
+   * summed. The buffered region of mask must contain the one of image
+   * over the boxes. */
+  template< class TMaskImage >
+  void Compute(const ImageType *image, const TMaskImage *mask,
+               const RegionType & region, const SizeType & radius)
+  {
+    this->Tabulate(image, mask, region, radius);
+  }
+
+  /** Position in the table of the box centered on index. The box
+   * centered on the next pixel along the first dimension is at the next
+   * position. */
+  OffsetValueType ComputeOffset(const IndexType & index) const;
+
+  /** Sum of the values over the box at position, minus the reference
+   * value for each pixel summed. */
+  AccumulateType GetSum(OffsetValueType position) const
+  {
+    return this->GetBoxSum(position, 0);
+  }
+
+  /** Sum of the squares of the values minus the reference value over the
+   * box at position. Only available when ComputeSumOfSquares is on. */
+  AccumulateType GetSumOfSquares(OffsetValueType position) const
+  {
+    return this->GetBoxSum(position, m_SumOfSquaresComponent);
+  }
+
+  /** Number of pixels summed over the box at position. Only available
+   * when a mask is given or ReplicateBorder is off. */
+  AccumulateType GetCount(OffsetValueType position) const
+  {
+    return this->GetBoxSum(position, m_CountComponent);
+  }
+
+  /** Split region into slabs along its last dimension, so that the
+   * table of each slab holds at most maximumTableSize positions. The
+   * slabs are at least as thick as the boxes. The default bounds each
+   * component of a table of doubles to 8 MB. */
+  static RegionListType SplitRegion(const RegionType & region, const SizeType & radius,
+                                    SizeValueType maximumTableSize = 1048576);
+
+private:
+  template< class TMaskImage >
+  void Tabulate(const ImageType *image, const TMaskImage *mask,
+                const RegionType & region, const SizeType & radius);
+
+  AccumulateType GetBoxSum(OffsetValueType position, unsigned int component) const
+  {
+    const AccumulateType *entry = &m_Table[position * m_NumberOfComponents + component];
+    AccumulateType        sum = NumericTraits< AccumulateType >::Zero;
+
+    for ( unsigned int c = 0; c < m_CornerOffsets.size(); ++c )
+      {
+      if ( m_CornerIsAdded[c] )
+        {
+        sum += entry[m_CornerOffsets[c]];
+        }
+      else
+        {
+        sum -= entry[m_CornerOffsets[c]];
+        }
+      }
+    return sum;
+  }
+
+  FunctorType m_Functor;
+  bool        m_ComputeSumOfSquares;
+  bool        m_ReplicateBorder;
+  bool        m_SubtractReferenceValue;
+
+  AccumulateType m_ReferenceValue;
+
+  unsigned int m_NumberOfComponents;
+  unsigned int m_SumOfSquaresComponent;
+  unsigned int m_CountComponent;
+
+  SizeType m_Radius;
+
+  /** Index of the first position of the table, and number of positions
+   * between two consecutive ones along each dimension. */
+  IndexType       m_TableIndex;
+  OffsetValueType m_OffsetTable[ImageDimension + 1];
+
+  /** Offsets, in values, from the upper corner of a box to its corners,
+   * and whether the sums at the corners are added or subtracted. */
+  std::vector< OffsetValueType > m_CornerOffsets;
+  std::vector< bool >            m_CornerIsAdded;
+
+  std::vector< AccumulateType > m_Table;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkSummedAreaTable.hxx"
+#endif
+
+#endif
@@ -0,0 +1,298 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkSummedAreaTable_hxx
+#define __itkSummedAreaTable_hxx
+
+#include "itkSummedAreaTable.h"
+#include "itkImageRegionConstIterator.h"
+
+namespace itk
+{
+template< class TImage, class TAccumulate, class TFunction >
+SummedAreaTable< TImage, TAccumulate, TFunction >
+::SummedAreaTable()
+{
+  m_ComputeSumOfSquares = false;
+  m_ReplicateBorder = true;
+  m_SubtractReferenceValue = false;
+  m_ReferenceValue = NumericTraits< AccumulateType >::Zero;
+  m_NumberOfComponents = 1;
+  m_SumOfSquaresComponent = 0;
+  m_CountComponent = 0;
+  m_Radius.Fill(0);
+  m_TableIndex.Fill(0);
+  for ( unsigned int d = 0; d <= ImageDimension; ++d )
+    {
+    m_OffsetTable[d] = 0;
+    }
+}
+
+template< class TImage, class TAccumulate, class TFunction >
+void
+SummedAreaTable< TImage, TAccumulate, TFunction >
+::Compute(const ImageType *image, const RegionType & region, const SizeType & radius)
+{
+  this->Tabulate( image, static_cast< const ImageType * >( 0 ), region, radius );
+}
+
+template< class TImage, class TAccumulate, class TFunction >
+template< class TMaskImage >
+void
+SummedAreaTable< TImage, TAccumulate, TFunction >
+::Tabulate(const ImageType *image, const TMaskImage *mask,
+           const RegionType & region, const SizeType & radius)
+{
+  const bool countPixels = ( mask != 0 || !m_ReplicateBorder );
+
+  m_NumberOfComponents = 1;
+  m_SumOfSquaresComponent = 0;
+  m_CountComponent = 0;
+  if ( m_ComputeSumOfSquares )
+    {
+    m_SumOfSquaresComponent = m_NumberOfComponents++;
+    }
+  if ( countPixels )
+    {
+    m_CountComponent = m_NumberOfComponents++;
+    }
+  const unsigned int numberOfComponents = m_NumberOfComponents;
+
+  // The table starts one position before the lowest corner of the
+  // boxes, where all the sums are zero
+  m_Radius = radius;
+  SizeType tableSize;
+  m_OffsetTable[0] = 1;
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    m_TableIndex[d] = region.GetIndex(d) - static_cast< OffsetValueType >( radius[d] ) - 1;
+    tableSize[d] = region.GetSize(d) + 2 * radius[d] + 1;
+    m_OffsetTable[d + 1] = m_OffsetTable[d] * static_cast< OffsetValueType >( tableSize[d] );
+    }
+  m_Table.assign( m_OffsetTable[ImageDimension] * numberOfComponents,
+                  NumericTraits< AccumulateType >::Zero );
+
+  // The sum over a box adds the corners an even number of steps away
+  // from its upper corner, and subtracts the other ones
+  const unsigned int numberOfCorners = 1u << ImageDimension;
+  m_CornerOffsets.resize(numberOfCorners);
+  m_CornerIsAdded.resize(numberOfCorners);
+  for ( unsigned int c = 0; c < numberOfCorners; ++c )
+    {
+    OffsetValueType offset = 0;
+    bool            added = true;
+    for ( unsigned int d = 0; d < ImageDimension; ++d )
+      {
+      if ( !( c & ( 1u << d ) ) )
+        {
+        offset -= static_cast< OffsetValueType >( 2 * radius[d] + 1 ) * m_OffsetTable[d];
+        added = !added;
+        }
+      }
+    m_CornerOffsets[c] = offset * numberOfComponents;
+    m_CornerIsAdded[c] = added;
+    }
+
+  const RegionType & bufferedRegion = image->GetBufferedRegion();
+  const IndexType    bufferLow = bufferedRegion.GetIndex();
+  const IndexType    bufferHigh = bufferedRegion.GetUpperIndex();
+
+  // The reference value is the mean of the pixels of the buffered region
+  // covered by the boxes
+  m_ReferenceValue = NumericTraits< AccumulateType >::Zero;
+  if ( m_SubtractReferenceValue )
+    {
+    IndexType coveredIndex;
+    SizeType  coveredSize;
+    for ( unsigned int d = 0; d < ImageDimension; ++d )
+      {
+      coveredIndex[d] = m_TableIndex[d] + 1;
+      coveredSize[d] = tableSize[d] - 1;
+      }
+    RegionType covered(coveredIndex, coveredSize);
+    covered.Crop(bufferedRegion);
+
+    double sum = 0.0;
+    for ( ImageRegionConstIterator< ImageType > it(image, covered); !it.IsAtEnd(); ++it )
+      {
+      sum += static_cast< double >( m_Functor( it.Get() ) );
+      }
+    double mean = sum / static_cast< double >( covered.GetNumberOfPixels() );
+    if ( NumericTraits< PixelType >::is_integer )
+      {
+      mean = vcl_floor(mean + 0.5);
+      }
+    m_ReferenceValue = static_cast< AccumulateType >( mean );
+    }
+
+  // The part of the rows read from the buffered region
+  IndexType lineIndex;
+  SizeType  lineSize;
+  lineIndex[0] = vnl_math_max( m_TableIndex[0] + 1, bufferLow[0] );
+  lineSize.Fill(1);
+  lineSize[0] = vnl_math_min( m_TableIndex[0] + static_cast< OffsetValueType >( tableSize[0] ) - 1,
+                              bufferHigh[0] ) - lineIndex[0] + 1;
+
+  std::vector< AccumulateType > lineValues(lineSize[0]);
+  std::vector< bool >           lineIncluded(lineSize[0], true);
+
+  // Sum the values along the rows of the first dimension. The first row
+  // along each dimension is left to zero.
+  const OffsetValueType numberOfRows = m_OffsetTable[ImageDimension] / m_OffsetTable[1];
+  for ( OffsetValueType row = 0; row < numberOfRows; ++row )
+    {
+    OffsetValueType rest = row;
+    bool            outside = false;
+    bool            zeroRow = false;
+    for ( unsigned int d = 1; d < ImageDimension; ++d )
+      {
+      const OffsetValueType j = rest % static_cast< OffsetValueType >( tableSize[d] );
+      rest /= static_cast< OffsetValueType >( tableSize[d] );
+      zeroRow = zeroRow || j == 0;
+      lineIndex[d] = m_TableIndex[d] + j;
+      if ( lineIndex[d] < bufferLow[d] )
+        {
+        outside = true;
+        lineIndex[d] = bufferLow[d];
+        }
+      else if ( lineIndex[d] > bufferHigh[d] )
+        {
+        outside = true;
+        lineIndex[d] = bufferHigh[d];
+        }
+      }
+    if ( zeroRow || ( outside && !m_ReplicateBorder ) )
+      {
+      continue;
+      }
+
+    const RegionType                      line(lineIndex, lineSize);
+    ImageRegionConstIterator< ImageType > it(image, line);
+    for ( SizeValueType i = 0; !it.IsAtEnd(); ++it, ++i )
+      {
+      lineValues[i] = m_Functor( it.Get() ) - m_ReferenceValue;
+      }
+    if ( mask )
+      {
+      ImageRegionConstIterator< TMaskImage > mit(mask, line);
+      for ( SizeValueType i = 0; !mit.IsAtEnd(); ++mit, ++i )
+        {
+        lineIncluded[i] = ( mit.Get() != NumericTraits< typename TMaskImage::PixelType >::Zero );
+        }
+      }
+
+    AccumulateType *entry = &m_Table[row * m_OffsetTable[1] * numberOfComponents];
+    for ( SizeValueType x = 1; x < tableSize[0]; ++x )
+      {
+      AccumulateType *previous = entry;
+      entry += numberOfComponents;
+      for ( unsigned int k = 0; k < numberOfComponents; ++k )
+        {
+        entry[k] = previous[k];
+        }
+
+      OffsetValueType i = m_TableIndex[0] + static_cast< OffsetValueType >( x ) - lineIndex[0];
+      if ( i < 0 || i >= static_cast< OffsetValueType >( lineSize[0] ) )
+        {
+        if ( !m_ReplicateBorder )
+          {
+          continue;
+          }
+        i = ( i < 0 ) ? 0 : static_cast< OffsetValueType >( lineSize[0] ) - 1;
+        }
+      if ( lineIncluded[i] )
+        {
+        const AccumulateType value = lineValues[i];
+        entry[0] += value;
+        if ( m_ComputeSumOfSquares )
+          {
+          entry[m_SumOfSquaresComponent] += value * value;
+          }
+        if ( countPixels )
+          {
+          entry[m_CountComponent] += NumericTraits< AccumulateType >::One;
+          }
+        }
+      }
+    }
+
+  // Then accumulate the rows along the other dimensions, one after the
+  // other. Each pass walks the table in memory order.
+  AccumulateType *      table = &m_Table[0];
+  const OffsetValueType tableLength = static_cast< OffsetValueType >( m_Table.size() );
+  for ( unsigned int d = 1; d < ImageDimension; ++d )
+    {
+    const OffsetValueType stride = m_OffsetTable[d] * numberOfComponents;
+    const OffsetValueType blockLength = m_OffsetTable[d + 1] * numberOfComponents;
+    for ( OffsetValueType block = 0; block < tableLength; block += blockLength )
+      {
+      for ( OffsetValueType p = block + stride; p < block + blockLength; ++p )
+        {
+        table[p] += table[p - stride];
+        }
+      }
+    }
+}
+
+template< class TImage, class TAccumulate, class TFunction >
+typename SummedAreaTable< TImage, TAccumulate, TFunction >::OffsetValueType
+SummedAreaTable< TImage, TAccumulate, TFunction >
+::ComputeOffset(const IndexType & index) const
+{
+  OffsetValueType position = 0;
+
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    position += ( index[d] + static_cast< OffsetValueType >( m_Radius[d] ) - m_TableIndex[d] )
+                * m_OffsetTable[d];
+    }
+  return position;
+}
+
+template< class TImage, class TAccumulate, class TFunction >
+typename SummedAreaTable< TImage, TAccumulate, TFunction >::RegionListType
+SummedAreaTable< TImage, TAccumulate, TFunction >
+::SplitRegion(const RegionType & region, const SizeType & radius,
+              SizeValueType maximumTableSize)
+{
+  const unsigned int last = ImageDimension - 1;
+
+  SizeValueType planeSize = 1;
+  for ( unsigned int d = 0; d < last; ++d )
+    {
+    planeSize *= region.GetSize(d) + 2 * radius[d] + 1;
+    }
+
+  const SizeValueType boxSize = 2 * radius[last] + 1;
+  SizeValueType       thickness = maximumTableSize / planeSize;
+  thickness = ( thickness > 2 * boxSize ) ? thickness - boxSize : boxSize;
+
+  RegionListType        slabs;
+  RegionType            slab = region;
+  const OffsetValueType end = region.GetIndex(last) + static_cast< OffsetValueType >( region.GetSize(last) );
+  for ( OffsetValueType start = region.GetIndex(last); start < end;
+        start += static_cast< OffsetValueType >( thickness ) )
+    {
+    slab.SetIndex(last, start);
+    slab.SetSize( last, vnl_math_min( thickness, static_cast< SizeValueType >( end - start ) ) );
+    slabs.push_back(slab);
+    }
+  return slabs;
+}
+} // end namespace itk
+
+#endif
@@ -0,0 +1,161 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkAddImageFilter.h"
+#include "itkSqrtImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMath.h"
+
+// Check the functor filters on buffers processed in contiguous spans,
+// both when the spans cover whole slices and when they are restricted to
+// the lines of a sub-region.
+
+namespace
+{
+typedef itk::Image< float, 3 > FunctorSpanImageType;
+
+FunctorSpanImageType::Pointer FunctorSpanTestCreateImage( float scale )
+{
+  FunctorSpanImageType::SizeType size;
+  size[0] = 7;
+  size[1] = 5;
+  size[2] = 4;
+  FunctorSpanImageType::Pointer image = FunctorSpanImageType::New();
+  image->SetRegions( size );
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex< FunctorSpanImageType > it( image, image->GetBufferedRegion() );
+  for( ; !it.IsAtEnd(); ++it )
+    {
+    const FunctorSpanImageType::IndexType & index = it.GetIndex();
+    it.Set( scale * ( index[0] + 10 * index[1] + 100 * index[2] ) );
+    }
+  return image;
+}
+
+bool FunctorSpanTestCheck( const char * name,
+                           const FunctorSpanImageType * output,
+                           const FunctorSpanImageType::RegionType & region,
+                           float scale1, float scale2, bool sqrt )
+{
+  if( output->GetBufferedRegion() != region )
+    {
+    std::cerr << name << ": unexpected buffered region " << output->GetBufferedRegion() << std::endl;
+    return false;
+    }
+  itk::ImageRegionConstIteratorWithIndex< FunctorSpanImageType > it( output, region );
+  for( ; !it.IsAtEnd(); ++it )
+    {
+    const FunctorSpanImageType::IndexType & index = it.GetIndex();
+    const float value = index[0] + 10 * index[1] + 100 * index[2];
+    float expected = scale1 * value + scale2 * value;
+    if( sqrt )
+      {
+      expected = vcl_sqrt( scale1 * value );
+      }
+    if( !itk::Math::FloatAlmostEqual( it.Get(), expected ) )
+      {
+      std::cerr << name << ": got " << it.Get() << " at " << index
+                << ", expected " << expected << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int itkFunctorImageFilterSpanTest( int, char* [] )
+{
+  FunctorSpanImageType::Pointer image1 = FunctorSpanTestCreateImage( 1.0f );
+  FunctorSpanImageType::Pointer image2 = FunctorSpanTestCreateImage( 2.0f );
+
+  const FunctorSpanImageType::RegionType largest = image1->GetLargestPossibleRegion();
+
+  FunctorSpanImageType::IndexType subIndex;
+  subIndex[0] = 1;
+  subIndex[1] = 2;
+  subIndex[2] = 1;
+  FunctorSpanImageType::SizeType subSize;
+  subSize[0] = 5;
+  subSize[1] = 2;
+  subSize[2] = 3;
+  const FunctorSpanImageType::RegionType sub( subIndex, subSize );
+
+  bool passed = true;
+
+  typedef itk::AddImageFilter< FunctorSpanImageType > AddType;
+  typedef itk::SqrtImageFilter< FunctorSpanImageType, FunctorSpanImageType > SqrtType;
+
+  // Two images, whole buffer
+  {
+  AddType::Pointer add = AddType::New();
+  add->SetInput1( image1 );
+  add->SetInput2( image2 );
+  add->Update();
+  passed &= FunctorSpanTestCheck( "Add", add->GetOutput(), largest, 1.0f, 2.0f, false );
+  }
+
+  // Two images, sub-region of the buffers
+  {
+  AddType::Pointer add = AddType::New();
+  add->SetInput1( image1 );
+  add->SetInput2( image2 );
+  add->GetOutput()->SetRequestedRegion( sub );
+  add->Update();
+  passed &= FunctorSpanTestCheck( "Add sub-region", add->GetOutput(), sub, 1.0f, 2.0f, false );
+  }
+
+  // Constant first and second operands
+  {
+  AddType::Pointer add = AddType::New();
+  add->SetInput1( image1 );
+  add->SetConstant2( 0.0f );
+  add->GetOutput()->SetRequestedRegion( sub );
+  add->Update();
+  passed &= FunctorSpanTestCheck( "Add constant 2", add->GetOutput(), sub, 1.0f, 0.0f, false );
+
+  AddType::Pointer add1 = AddType::New();
+  add1->SetConstant1( 0.0f );
+  add1->SetInput2( image2 );
+  add1->Update();
+  passed &= FunctorSpanTestCheck( "Add constant 1", add1->GetOutput(), largest, 0.0f, 2.0f, false );
+  }
+
+  // Unary filter, whole buffer and sub-region
+  {
+  SqrtType::Pointer sqrtFilter = SqrtType::New();
+  sqrtFilter->SetInput( image1 );
+  sqrtFilter->Update();
+  passed &= FunctorSpanTestCheck( "Sqrt", sqrtFilter->GetOutput(), largest, 1.0f, 0.0f, true );
+
+  SqrtType::Pointer sqrtSub = SqrtType::New();
+  sqrtSub->SetInput( image1 );
+  sqrtSub->GetOutput()->SetRequestedRegion( sub );
+  sqrtSub->Update();
+  passed &= FunctorSpanTestCheck( "Sqrt sub-region", sqrtSub->GetOutput(), sub, 1.0f, 0.0f, true );
+  }
+
+  if( !passed )
+    {
+    std::cerr << "Test failed." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
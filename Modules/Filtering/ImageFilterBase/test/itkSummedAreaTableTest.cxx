@@ -0,0 +1,179 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include <iostream>
+
+#include "itkSummedAreaTable.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkRandomImageSource.h"
+
+namespace
+{
+typedef itk::Image< unsigned char, 3 > ImageType;
+typedef itk::Image< unsigned char, 3 > MaskImageType;
+typedef itk::SummedAreaTable< ImageType > TableType;
+
+// Sums the box of the given radius centered on index by walking it,
+// replicating the border of the buffered region or leaving the pixels
+// outside out.
+void BoxSums(const ImageType *image, const MaskImageType *mask,
+             const ImageType::IndexType & center, const ImageType::SizeType & radius,
+             bool replicateBorder, double & sum, double & sumOfSquares, double & count)
+{
+  const ImageType::RegionType & buffer = image->GetBufferedRegion();
+  const ImageType::IndexType    upper = buffer.GetUpperIndex();
+
+  sum = 0.0;
+  sumOfSquares = 0.0;
+  count = 0.0;
+
+  ImageType::OffsetType extent;
+  for ( unsigned int d = 0; d < 3; ++d )
+    {
+    extent[d] = static_cast< itk::OffsetValueType >( radius[d] );
+    }
+
+  ImageType::OffsetType offset;
+  for ( offset[2] = -extent[2]; offset[2] <= extent[2]; ++offset[2] )
+    {
+    for ( offset[1] = -extent[1]; offset[1] <= extent[1]; ++offset[1] )
+      {
+      for ( offset[0] = -extent[0]; offset[0] <= extent[0]; ++offset[0] )
+        {
+        ImageType::IndexType index = center + offset;
+        if ( !buffer.IsInside(index) )
+          {
+          if ( !replicateBorder )
+            {
+            continue;
+            }
+          for ( unsigned int d = 0; d < 3; ++d )
+            {
+            index[d] = vnl_math_max( index[d], buffer.GetIndex(d) );
+            index[d] = vnl_math_min( index[d], upper[d] );
+            }
+          }
+        if ( mask && !mask->GetPixel(index) )
+          {
+          continue;
+          }
+        const double value = image->GetPixel(index);
+        sum += value;
+        sumOfSquares += value * value;
+        count += 1.0;
+        }
+      }
+    }
+}
+
+int CompareTable(const ImageType *image, const MaskImageType *mask,
+                 const ImageType::RegionType & region, const ImageType::SizeType & radius,
+                 bool replicateBorder, itk::SizeValueType maximumTableSize)
+{
+  TableType table;
+  table.SetComputeSumOfSquares(true);
+  table.SetReplicateBorder(replicateBorder);
+
+  const TableType::RegionListType slabs = TableType::SplitRegion(region, radius, maximumTableSize);
+
+  itk::SizeValueType numberOfPixels = 0;
+  for ( TableType::RegionListType::const_iterator sit = slabs.begin(); sit != slabs.end(); ++sit )
+    {
+    if ( mask )
+      {
+      table.Compute(image, mask, *sit, radius);
+      }
+    else
+      {
+      table.Compute(image, *sit, radius);
+      }
+    numberOfPixels += sit->GetNumberOfPixels();
+
+    for ( itk::ImageRegionIteratorWithIndex< ImageType > it(const_cast< ImageType * >( image ), *sit);
+          !it.IsAtEnd(); ++it )
+      {
+      double sum, sumOfSquares, count;
+      BoxSums(image, mask, it.GetIndex(), radius, replicateBorder, sum, sumOfSquares, count);
+
+      const TableType::OffsetValueType position = table.ComputeOffset( it.GetIndex() );
+      if ( table.GetSum(position) != sum
+           || table.GetSumOfSquares(position) != sumOfSquares
+           || ( ( mask || !replicateBorder ) && table.GetCount(position) != count ) )
+        {
+        std::cerr << "Test failed!" << std::endl;
+        std::cerr << "Radius " << radius << ", replicate border " << replicateBorder
+                  << ", mask " << ( mask != 0 ) << ": box at " << it.GetIndex()
+                  << " sums to " << table.GetSum(position) << " instead of " << sum << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  if ( numberOfPixels != region.GetNumberOfPixels() )
+    {
+    std::cerr << "Test failed!" << std::endl;
+    std::cerr << "The " << slabs.size() << " slabs hold " << numberOfPixels
+              << " pixels instead of " << region.GetNumberOfPixels() << std::endl;
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
+}
+
+int itkSummedAreaTableTest(int, char* [])
+{
+  typedef itk::RandomImageSource< ImageType > SourceType;
+  SourceType::Pointer source = SourceType::New();
+  ImageType::SizeType size = {{ 23, 17, 11 }};
+  source->SetSize(size);
+  source->SetMin(0);
+  source->SetMax(255);
+  source->Update();
+
+  ImageType::Pointer image = source->GetOutput();
+  const ImageType::RegionType & region = image->GetBufferedRegion();
+
+  MaskImageType::Pointer mask = MaskImageType::New();
+  mask->SetRegions(region);
+  mask->Allocate();
+  for ( itk::ImageRegionIteratorWithIndex< MaskImageType > it(mask, region); !it.IsAtEnd(); ++it )
+    {
+    it.Set( ( it.GetIndex()[0] + 2 * it.GetIndex()[1] + it.GetIndex()[2] ) % 3 != 0 );
+    }
+
+  ImageType::RegionType inner = region;
+  inner.ShrinkByRadius(3);
+
+  ImageType::SizeType radii[3] = { {{ 1, 1, 1 }}, {{ 2, 0, 3 }}, {{ 4, 9, 1 }} };
+  for ( unsigned int r = 0; r < 3; ++r )
+    {
+    for ( int replicateBorder = 0; replicateBorder < 2; ++replicateBorder )
+      {
+      // whole image in a single table, inner region in thin slabs
+      if ( CompareTable(image, 0, region, radii[r], replicateBorder, 4194304) == EXIT_FAILURE
+           || CompareTable(image, 0, inner, radii[r], replicateBorder, 1000) == EXIT_FAILURE
+           || CompareTable(image, mask, region, radii[r], replicateBorder, 4000) == EXIT_FAILURE )
+        {
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
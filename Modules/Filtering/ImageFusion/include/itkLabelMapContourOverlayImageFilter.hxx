@@ -200,6 +200,7 @@ LabelMapContourOverlayImageFilter<TLabelMap, TFeatureImage, TOutputImage>
   nbOfThreads = this->SplitRequestedRegion(0, nbOfThreads, splitRegion);
 
   m_Barrier = Barrier::New();
+  this->GetMultiThreader()->ExactNumberOfThreadsOn();
   m_Barrier->Initialize( nbOfThreads );
 
   Superclass::BeforeThreadedGenerateData();
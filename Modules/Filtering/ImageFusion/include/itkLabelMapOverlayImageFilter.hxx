@@ -76,6 +76,7 @@ LabelMapOverlayImageFilter<TLabelMap, TFeatureImage, TOutputImage>
   // std::cout << "nbOfThreads: " << nbOfThreads << std::endl;
 
   m_Barrier = Barrier::New();
+  this->GetMultiThreader()->ExactNumberOfThreadsOn();
   m_Barrier->Initialize( nbOfThreads );
 
   Superclass::BeforeThreadedGenerateData();
@@ -303,7 +303,10 @@ BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
   typename ImageSource<TOutputImage>::ThreadStruct str1;
   str1.Filter = this;
 
+  // The points are split, and the per-thread lattices accumulated, over
+  // GetNumberOfThreads() threads: all of them must run.
   this->GetMultiThreader()->SetNumberOfThreads( this->GetNumberOfThreads() );
+  this->GetMultiThreader()->ExactNumberOfThreadsOn();
   this->GetMultiThreader()->SetSingleMethod( this->ThreaderCallback, &str1 );
 
   /**
@@ -26,6 +26,7 @@
 #include "itkLinearInterpolateImageFunction.h"
 #include "itkSize.h"
 #include "itkDefaultConvertPixelTraits.h"
+#include "itkIsSame.h"
 
 namespace itk
 {
@@ -314,7 +315,15 @@ protected:
                                      ThreadIdType threadId);
 
   /** Implementation for resampling that works for with linear
-   *  transformation types.
+   *  transformation types.  Each output scanline is mapped to a line of
+   *  the continuous index space of the input, whose start and step follow
+   *  from the affine mapping computed by BeforeThreadedGenerateData(). The
+   *  pixels of the line that fall outside the input buffer are found
+   *  analytically, and the linear and nearest neighbor interpolations of
+   *  scalar images are evaluated inline. The inline evaluation clamps the
+   *  values itself, and is only used when the filter is not a subclass,
+   *  so that an override of CastPixelWithBoundsChecking() is always
+   *  called.
    */
   virtual void LinearThreadedGenerateData(const OutputImageRegionType &
                                   outputRegionForThread,
@@ -328,6 +337,97 @@ private:
   ResampleImageFilter(const Self &); //purposely not implemented
   void operator=(const Self &);      //purposely not implemented
 
+  /** Affine mapping from the output index to the continuous index of the
+   * input. */
+  typedef Matrix< double,
+                  itkGetStaticConstMacro(ImageDimension),
+                  itkGetStaticConstMacro(ImageDimension) > IndexMappingMatrixType;
+  typedef Vector< double,
+                  itkGetStaticConstMacro(ImageDimension) > IndexMappingVectorType;
+
+  /** Interpolation evaluated by LinearThreadedGenerateData(). */
+  typedef enum {
+    GenericInterpolation,
+    NearestNeighborInterpolation,
+    LinearInterpolation
+    } ScanlineInterpolationType;
+
+  /** Select the scanline evaluation of images of scalars stored in an
+   * itk::Image, for which the interpolation can be inlined. */
+  struct DispatchBase {};
+  template< bool >
+  struct Dispatch: public DispatchBase {};
+
+  typedef Dispatch<
+    IsSame< InputImageType,
+            Image< InputPixelType, itkGetStaticConstMacro(InputImageDimension) > >::Value
+    && IsSame< InputPixelType, typename NumericTraits< InputPixelType >::ValueType >::Value
+    && IsSame< PixelType, PixelComponentType >::Value
+    && IsSame< InterpolatorOutputType, ComponentType >::Value > ScanlineDispatchType;
+
+  /** Compute m_IndexMappingMatrix and m_IndexMappingOffset. Returns false
+   * if the mapping is not affine. */
+  bool ComputeIndexMapping();
+
+  /** Range [begin, end) of the pixels of a scanline of length "length" that
+   * map inside the buffer of the input. */
+  void ComputeInsideSpan(const IndexMappingVectorType & start,
+                         const IndexMappingVectorType & step,
+                         SizeValueType length,
+                         SizeValueType & begin,
+                         SizeValueType & end) const;
+
+  /** Continuous index of the input of pixel "i" of a scanline. */
+  static void ComputeScanlineContinuousIndex(const IndexMappingVectorType & start,
+                                             const IndexMappingVectorType & step,
+                                             SizeValueType i,
+                                             ContinuousInputIndexType & index)
+  {
+    for ( unsigned int k = 0; k < ImageDimension; ++k )
+      {
+      index[k] = static_cast< TInterpolatorPrecisionType >(
+        start[k] + step[k] * static_cast< double >( i ) );
+      }
+  }
+
+  /** Test whether pixel "i" of a scanline maps inside the input buffer. */
+  bool IsInsideScanline(const IndexMappingVectorType & start,
+                        const IndexMappingVectorType & step,
+                        SizeValueType i) const
+  {
+    ContinuousInputIndexType index;
+    ComputeScanlineContinuousIndex(start, step, i, index);
+    return m_Interpolator->IsInsideBuffer(index);
+  }
+
+  /** Value of a pixel that maps outside the input buffer. */
+  PixelType EvaluateOutside(const ContinuousInputIndexType & index,
+                            const ComponentType minComponent,
+                            const ComponentType maxComponent) const;
+
+  /** Resample a scanline of length "length" and write it through the
+   * output iterator.  The generic version tests every pixel with the
+   * interpolator, the scalar one skips the pixels outside the input buffer
+   * analytically and inlines the linear and nearest neighbor
+   * interpolations. */
+  template< class TIterator >
+  void ResampleScanline(const Dispatch< false > &,
+                        TIterator & outIt,
+                        const IndexMappingVectorType & start,
+                        const IndexMappingVectorType & step,
+                        SizeValueType length,
+                        const ComponentType minComponent,
+                        const ComponentType maxComponent) const;
+
+  template< class TIterator >
+  void ResampleScanline(const Dispatch< true > &,
+                        TIterator & outIt,
+                        const IndexMappingVectorType & start,
+                        const IndexMappingVectorType & step,
+                        SizeValueType length,
+                        const ComponentType minComponent,
+                        const ComponentType maxComponent) const;
+
   SizeType                m_Size;      // Size of the output image
   TransformPointerType    m_Transform;         // Transform
   InterpolatorPointerType m_Interpolator;      // Image function for
@@ -343,6 +443,11 @@ private:
   IndexType       m_OutputStartIndex;          // output image start index
   bool            m_UseReferenceImage;
 
+  bool                      m_IndexMappingIsAffine;
+  IndexMappingMatrixType    m_IndexMappingMatrix;
+  IndexMappingVectorType    m_IndexMappingOffset;
+  ScanlineInterpolationType m_ScanlineInterpolation;
+
 };
 } // end namespace itk
 
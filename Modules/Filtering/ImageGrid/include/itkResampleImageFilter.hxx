@@ -23,9 +23,14 @@
 #include "itkIdentityTransform.h"
 #include "itkProgressReporter.h"
 #include "itkImageRegionIteratorWithIndex.h"
-#include "itkImageLinearIteratorWithIndex.h"
+#include "itkImageScanlineIterator.h"
 #include "itkSpecialCoordinatesImage.h"
 #include "itkDefaultConvertPixelTraits.h"
+#include "itkMatrixOffsetTransformBase.h"
+#include "itkNearestNeighborInterpolateImageFunction.h"
+#include "vnl/vnl_math.h"
+#include <algorithm>
+#include <typeinfo>
 
 namespace itk
 {
@@ -57,6 +62,11 @@ ResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType >
 
   m_DefaultPixelValue
     = NumericTraits<PixelType>::ZeroValue( m_DefaultPixelValue );
+
+  m_IndexMappingIsAffine = false;
+  m_IndexMappingMatrix.SetIdentity();
+  m_IndexMappingOffset.Fill(0.0);
+  m_ScanlineInterpolation = GenericInterpolation;
 }
 
 /**
@@ -182,6 +192,142 @@ ResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType >
                                          zeroComponent );
       }
     }
+
+  m_IndexMappingIsAffine = this->ComputeIndexMapping();
+
+  // The linear and nearest neighbor interpolations are inlined when the
+  // interpolator is exactly one of them, not a subclass that could
+  // override their evaluation. The inlined interpolations clamp their
+  // values as CastPixelWithBoundsChecking() does, so the filter must not
+  // be a subclass that could override it either.
+  m_ScanlineInterpolation = GenericInterpolation;
+  if ( typeid( *this ) == typeid( Self ) )
+    {
+    if ( typeid( *m_Interpolator ) == typeid( LinearInterpolatorType ) )
+      {
+      m_ScanlineInterpolation = LinearInterpolation;
+      }
+    else if ( typeid( *m_Interpolator )
+              == typeid( NearestNeighborInterpolateImageFunction< InputImageType,
+                                                                  TInterpolatorPrecisionType > ) )
+      {
+      m_ScanlineInterpolation = NearestNeighborInterpolation;
+      }
+    }
+}
+
+/**
+ * Compute the affine mapping from the output index to the input
+ * continuous index.
+ */
+template< class TInputImage,
+          class TOutputImage,
+          class TInterpolatorPrecisionType >
+bool
+ResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType >
+::ComputeIndexMapping()
+{
+  // Check whether the input or the output is a
+  // SpecialCoordinatesImage.  If either are, then we cannot use the
+  // fast path since index mapping will definitely not be linear.
+  typedef SpecialCoordinatesImage< PixelType, ImageDimension >
+  OutputSpecialCoordinatesImageType;
+  typedef SpecialCoordinatesImage< InputPixelType, InputImageDimension >
+  InputSpecialCoordinatesImageType;
+
+  const InputImageType *inputPtr = this->GetInput();
+  const OutputImageType *outputPtr = this->GetOutput();
+
+  if ( dynamic_cast< const InputSpecialCoordinatesImageType * >( inputPtr )
+       || dynamic_cast< const OutputSpecialCoordinatesImageType * >( outputPtr ) )
+    {
+    return false;
+    }
+
+  // Check whether we can use a fast path for resampling. Fast path
+  // can be used if the transformation is linear. Transform respond
+  // to the IsLinear() call.
+  if ( this->m_Transform->GetTransformCategory() != TransformType::Linear )
+    {
+    return false;
+    }
+
+  // The transform maps the physical point p to M p + t. The matrix and
+  // offset of a MatrixOffsetTransformBase are used directly, those of any
+  // other linear transform, such as a composite of linear transforms, are
+  // recovered from the images of the origin and of the unit vectors.
+  typedef MatrixOffsetTransformBase< TInterpolatorPrecisionType,
+                                     ImageDimension,
+                                     ImageDimension > MatrixOffsetTransformType;
+
+  IndexMappingMatrixType transformMatrix;
+  IndexMappingVectorType transformOffset;
+
+  const MatrixOffsetTransformType *matrixOffsetTransform =
+    dynamic_cast< const MatrixOffsetTransformType * >( this->m_Transform.GetPointer() );
+  if ( matrixOffsetTransform )
+    {
+    for ( unsigned int i = 0; i < ImageDimension; ++i )
+      {
+      transformOffset[i] = matrixOffsetTransform->GetOffset()[i];
+      for ( unsigned int j = 0; j < ImageDimension; ++j )
+        {
+        transformMatrix(i, j) = matrixOffsetTransform->GetMatrix()(i, j);
+        }
+      }
+    }
+  else
+    {
+    PointType point;
+    point.Fill(0.0);
+    const PointType origin = this->m_Transform->TransformPoint(point);
+    for ( unsigned int j = 0; j < ImageDimension; ++j )
+      {
+      point.Fill(0.0);
+      point[j] = 1.0;
+      const PointType image = this->m_Transform->TransformPoint(point);
+      for ( unsigned int i = 0; i < ImageDimension; ++i )
+        {
+        transformMatrix(i, j) = image[i] - origin[i];
+        }
+      }
+    for ( unsigned int i = 0; i < ImageDimension; ++i )
+      {
+      transformOffset[i] = origin[i];
+      }
+    }
+
+  // The output index x maps to the physical point O + D S x, and the
+  // physical point q to the input continuous index (D' S')^-1 (q - O').
+  IndexMappingMatrixType outputIndexToPhysicalPoint;
+  IndexMappingMatrixType inputIndexToPhysicalPoint;
+  for ( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    for ( unsigned int j = 0; j < ImageDimension; ++j )
+      {
+      outputIndexToPhysicalPoint(i, j) =
+        outputPtr->GetDirection()(i, j) * outputPtr->GetSpacing()[j];
+      inputIndexToPhysicalPoint(i, j) =
+        inputPtr->GetDirection()(i, j) * inputPtr->GetSpacing()[j];
+      }
+    }
+  const IndexMappingMatrixType inputPhysicalPointToIndex( inputIndexToPhysicalPoint.GetInverse() );
+
+  m_IndexMappingMatrix = inputPhysicalPointToIndex * transformMatrix * outputIndexToPhysicalPoint;
+
+  IndexMappingVectorType origin;
+  for ( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    origin[i] = outputPtr->GetOrigin()[i];
+    }
+  origin = transformMatrix * origin + transformOffset;
+  for ( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    origin[i] -= inputPtr->GetOrigin()[i];
+    }
+  m_IndexMappingOffset = inputPhysicalPointToIndex * origin;
+
+  return true;
 }
 
 /**
@@ -214,26 +360,10 @@ ResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType >
 ::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
                        ThreadIdType threadId)
 {
-  // Check whether the input or the output is a
-  // SpecialCoordinatesImage.  If either are, then we cannot use the
-  // fast path since index mapping will definitely not be linear.
-  typedef SpecialCoordinatesImage< PixelType, ImageDimension >
-  OutputSpecialCoordinatesImageType;
-  typedef SpecialCoordinatesImage< InputPixelType, InputImageDimension >
-  InputSpecialCoordinatesImageType;
-
-  if ( dynamic_cast< const InputSpecialCoordinatesImageType * >( this->GetInput() )
-       || dynamic_cast< const OutputSpecialCoordinatesImageType * >
-       ( this->GetOutput() ) )
-    {
-    this->NonlinearThreadedGenerateData(outputRegionForThread, threadId);
-    return;
-    }
-
-  // Check whether we can use a fast path for resampling. Fast path
-  // can be used if the transformation is linear. Transform respond
-  // to the IsLinear() call.
-  if ( this->m_Transform->GetTransformCategory() == TransformType::Linear )
+  // The fast path can be used if the output index maps to the input
+  // continuous index through an affine mapping, which was computed
+  // before the threads.
+  if ( m_IndexMappingIsAffine )
     {
     this->LinearThreadedGenerateData(outputRegionForThread, threadId);
     return;
@@ -380,131 +510,331 @@ ResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType >
                              outputRegionForThread,
                              ThreadIdType threadId)
 {
+  const SizeValueType lineLength = outputRegionForThread.GetSize(0);
+  if ( lineLength == 0 )
+    {
+    return;
+    }
+
   // Get the output pointers
   OutputImagePointer outputPtr = this->GetOutput();
 
-  // Get this input pointers
-  InputImageConstPointer inputPtr = this->GetInput();
-
   // Create an iterator that will walk the output region for this thread.
-  typedef ImageLinearIteratorWithIndex< TOutputImage > OutputIterator;
-
+  typedef ImageScanlineIterator< TOutputImage > OutputIterator;
   OutputIterator outIt(outputPtr, outputRegionForThread);
-  outIt.SetDirection(0);
-
-  // Define a few indices that will be used to translate from an input pixel
-  // to an output pixel
-  PointType outputPoint;         // Coordinates of current output pixel
-  PointType inputPoint;          // Coordinates of current input pixel
-  PointType tmpOutputPoint;
-  PointType tmpInputPoint;
-
-  ContinuousInputIndexType inputIndex;
-  ContinuousInputIndexType tmpInputIndex;
-
-  typedef typename PointType::VectorType VectorType;
-  VectorType delta;          // delta in input continuous index coordinate frame
 
-  IndexType  index;
-
-  // Support for progress methods/callbacks
+  // Support for progress methods/callbacks, updated once per scanline
   ProgressReporter progress( this,
                              threadId,
-                             outputRegionForThread.GetNumberOfPixels() );
-
-  typedef typename InterpolatorType::OutputType OutputType;
-
-  // Cache information from the superclass
-  PixelType defaultValue = this->GetDefaultPixelValue();
+                             outputRegionForThread.GetNumberOfPixels() / lineLength );
 
   // Min/max values of the output pixel type AND these values
   // represented as the output type of the interpolator
   const PixelComponentType minValue =  NumericTraits< PixelComponentType >::NonpositiveMin();
   const PixelComponentType maxValue =  NumericTraits< PixelComponentType >::max();
 
-  typedef typename InterpolatorType::OutputType OutputType;
   const ComponentType minOutputValue = static_cast< ComponentType >( minValue );
   const ComponentType maxOutputValue = static_cast< ComponentType >( maxValue );
 
-  // Determine the position of the first pixel in the scanline
-  index = outIt.GetIndex();
-  outputPtr->TransformIndexToPhysicalPoint(index, outputPoint);
-
-  // Compute corresponding input pixel position
-  inputPoint = this->m_Transform->TransformPoint(outputPoint);
-  inputPtr->TransformPhysicalPointToContinuousIndex(inputPoint, inputIndex);
-
   // As we walk across a scan line in the output image, we trace
-  // an oriented/scaled/translated line in the input image.  Cache
-  // the delta along this line in continuous index space of the input
-  // image. This allows us to use vector addition to model the
-  // transformation.
-  //
-  // To find delta, we take two pixels adjacent in a scanline
-  // and determine the continuous indices of these pixels when
-  // mapped to the input coordinate frame. We use the difference
-  // between these two continuous indices as the delta to apply
-  // to an index to trace line in the input image as we move
-  // across the scanline of the output image.
-  //
-  // We determine delta in this manner so that Images
-  // are both handled properly (taking into account the direction cosines).
-  //
-  ++index[0];
-  outputPtr->TransformIndexToPhysicalPoint(index, tmpOutputPoint);
-  tmpInputPoint = this->m_Transform->TransformPoint(tmpOutputPoint);
-  inputPtr->TransformPhysicalPointToContinuousIndex(tmpInputPoint,
-                                                    tmpInputIndex);
-  delta = tmpInputIndex - inputIndex;
+  // an oriented/scaled/translated line in the input image. The step
+  // along this line in continuous index space of the input image is
+  // the first column of the index mapping, and its start is the
+  // mapping of the first index of the scanline. Every continuous index
+  // is computed from the start rather than accumulated, so that the
+  // error does not grow along the line.
+  IndexMappingVectorType step;
+  for ( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    step[i] = m_IndexMappingMatrix(i, 0);
+    }
+  IndexMappingVectorType start;
 
   while ( !outIt.IsAtEnd() )
     {
-    // Determine the continuous index of the first pixel of output
-    // scanline when mapped to the input coordinate frame.
-    //
+    const IndexType index = outIt.GetIndex();
+    for ( unsigned int i = 0; i < ImageDimension; ++i )
+      {
+      start[i] = m_IndexMappingOffset[i];
+      for ( unsigned int j = 0; j < ImageDimension; ++j )
+        {
+        start[i] += m_IndexMappingMatrix(i, j) * static_cast< double >( index[j] );
+        }
+      }
 
-    // First get the position of the pixel in the output coordinate frame
-    index = outIt.GetIndex();
-    outputPtr->TransformIndexToPhysicalPoint(index, outputPoint);
+    this->ResampleScanline(ScanlineDispatchType(), outIt, start, step, lineLength,
+                           minOutputValue, maxOutputValue);
 
-    // Compute corresponding input pixel continuous index, this index
-    // will incremented in the scanline loop
-    inputPoint = this->m_Transform->TransformPoint(outputPoint);
-    inputPtr->TransformPhysicalPointToContinuousIndex(inputPoint, inputIndex);
+    outIt.NextLine();
+    progress.CompletedPixel();
+    }
+}
 
-    while ( !outIt.IsAtEndOfLine() )
+/**
+ * Find the pixels of a scanline that map inside the input buffer
+ */
+template< class TInputImage,
+          class TOutputImage,
+          class TInterpolatorPrecisionType >
+void
+ResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType >
+::ComputeInsideSpan(const IndexMappingVectorType & start,
+                    const IndexMappingVectorType & step,
+                    SizeValueType length,
+                    SizeValueType & begin,
+                    SizeValueType & end) const
+{
+  const ContinuousInputIndexType & lower = m_Interpolator->GetStartContinuousIndex();
+  const ContinuousInputIndexType & upper = m_Interpolator->GetEndContinuousIndex();
+
+  // The pixel i is inside if lower <= start + i * step < upper along every
+  // dimension, which bounds i to an interval.
+  double first = 0.0;
+  double last = static_cast< double >( length ) - 1.0;
+  for ( unsigned int k = 0; k < ImageDimension && first <= last; ++k )
+    {
+    if ( step[k] == 0.0 )
       {
-      PixelType  pixval;
-      OutputType value;
-      // Evaluate input at right position and copy to the output
-      if ( m_Interpolator->IsInsideBuffer(inputIndex) )
+      if ( !( start[k] >= lower[k] && start[k] < upper[k] ) )
         {
-        value = m_Interpolator->EvaluateAtContinuousIndex(inputIndex);
-        pixval = this->CastPixelWithBoundsChecking( value, minOutputValue, maxOutputValue );
-        outIt.Set(pixval);
+        last = -1.0;
         }
-      else
+      }
+    else
+      {
+      double bound0 = ( lower[k] - start[k] ) / step[k];
+      double bound1 = ( upper[k] - start[k] ) / step[k];
+      if ( bound0 > bound1 )
+        {
+        std::swap(bound0, bound1);
+        }
+      first = std::max( first, vcl_ceil(bound0) );
+      last = std::min( last, vcl_floor(bound1) );
+      }
+    }
+  first = std::min( first, static_cast< double >( length ) );
+  if ( first <= last )
+    {
+    begin = static_cast< SizeValueType >( first );
+    end = static_cast< SizeValueType >( last ) + 1;
+    }
+  else
+    {
+    begin = static_cast< SizeValueType >( first );
+    end = begin;
+    }
+
+  // The bounds are exact up to rounding. Adjust them with the test of the
+  // interpolator on the continuous index that will be interpolated; the
+  // pixels that pass it form an interval of the scanline.
+  while ( begin < end && !this->IsInsideScanline(start, step, begin) )
+    {
+    ++begin;
+    }
+  while ( end > begin && !this->IsInsideScanline(start, step, end - 1) )
+    {
+    --end;
+    }
+  while ( begin > 0 && this->IsInsideScanline(start, step, begin - 1) )
+    {
+    --begin;
+    }
+  while ( end < length && this->IsInsideScanline(start, step, end) )
+    {
+    ++end;
+    }
+}
+/**
+ * Value of a pixel that maps outside the input buffer
+ */
+template< class TInputImage,
+          class TOutputImage,
+          class TInterpolatorPrecisionType >
+typename ResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType >
+::PixelType
+ResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType >
+::EvaluateOutside(const ContinuousInputIndexType & index,
+                  const ComponentType minComponent,
+                  const ComponentType maxComponent) const
+{
+  if ( m_Extrapolator.IsNull() )
+    {
+    return m_DefaultPixelValue; // default background value
+    }
+  return this->CastPixelWithBoundsChecking( m_Extrapolator->EvaluateAtContinuousIndex(index),
+                                            minComponent, maxComponent );
+}
+
+/**
+ * Resample a scanline with the interpolator
+ */
+template< class TInputImage,
+          class TOutputImage,
+          class TInterpolatorPrecisionType >
+template< class TIterator >
+void
+ResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType >
+::ResampleScanline(const Dispatch< false > &,
+                   TIterator & outIt,
+                   const IndexMappingVectorType & start,
+                   const IndexMappingVectorType & step,
+                   SizeValueType length,
+                   const ComponentType minComponent,
+                   const ComponentType maxComponent) const
+{
+  ContinuousInputIndexType index;
+
+  for ( SizeValueType i = 0; i < length; ++i, ++outIt )
+    {
+    ComputeScanlineContinuousIndex(start, step, i, index);
+
+    // Evaluate input at right position and copy to the output
+    if ( m_Interpolator->IsInsideBuffer(index) )
+      {
+      outIt.Set( this->CastPixelWithBoundsChecking( m_Interpolator->EvaluateAtContinuousIndex(index),
+                                                    minComponent, maxComponent ) );
+      }
+    else
+      {
+      outIt.Set( this->EvaluateOutside(index, minComponent, maxComponent) );
+      }
+    }
+}
+
+/**
+ * Resample a scanline of scalars
+ */
+template< class TInputImage,
+          class TOutputImage,
+          class TInterpolatorPrecisionType >
+template< class TIterator >
+void
+ResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType >
+::ResampleScanline(const Dispatch< true > &,
+                   TIterator & outIt,
+                   const IndexMappingVectorType & start,
+                   const IndexMappingVectorType & step,
+                   SizeValueType length,
+                   const ComponentType minComponent,
+                   const ComponentType maxComponent) const
+{
+  if ( m_ScanlineInterpolation == GenericInterpolation )
+    {
+    this->ResampleScanline(Dispatch< false >(), outIt, start, step, length,
+                           minComponent, maxComponent);
+    return;
+    }
+
+  SizeValueType insideBegin;
+  SizeValueType insideEnd;
+  this->ComputeInsideSpan(start, step, length, insideBegin, insideEnd);
+
+  ContinuousInputIndexType index;
+  SizeValueType            i = 0;
+
+  for (; i < insideBegin; ++i, ++outIt )
+    {
+    ComputeScanlineContinuousIndex(start, step, i, index);
+    outIt.Set( this->EvaluateOutside(index, minComponent, maxComponent) );
+    }
+
+  // The interpolation reads the input buffer directly. Both interpolators
+  // are evaluated as LinearInterpolateImageFunction and
+  // NearestNeighborInterpolateImageFunction do, so that the result does
+  // not depend on the path.
+  const InputImageType *  inputPtr = this->GetInput();
+  const InputPixelType *  buffer = inputPtr->GetBufferPointer();
+  const OffsetValueType * offsetTable = inputPtr->GetOffsetTable();
+
+  typedef typename InterpolatorType::IndexType InputIndexType;
+  const InputIndexType & startIndex = m_Interpolator->GetStartIndex();
+  const InputIndexType & endIndex = m_Interpolator->GetEndIndex();
+
+  ComponentType value;
+
+  if ( m_ScanlineInterpolation == NearestNeighborInterpolation )
+    {
+    for (; i < insideEnd; ++i, ++outIt )
+      {
+      ComputeScanlineContinuousIndex(start, step, i, index);
+      OffsetValueType offset = 0;
+      for ( unsigned int k = 0; k < ImageDimension; ++k )
+        {
+        offset += ( Math::Round< IndexValueType >(index[k]) - startIndex[k] ) * offsetTable[k];
+        }
+      value = static_cast< ComponentType >( buffer[offset] );
+      outIt.Set( static_cast< PixelType >( value < minComponent ? minComponent
+                                           : ( value > maxComponent ? maxComponent : value ) ) );
+      }
+    }
+  else
+    {
+    // The neighbors of the base index are taken in the order of the bits
+    // of their number, and reduced along the first dimension first.
+    const unsigned int numberOfNeighbors = 1 << ImageDimension;
+    ComponentType      neighbors[1 << ImageDimension];
+    OffsetValueType    neighborIndex[1 << ImageDimension];
+    OffsetValueType    neighborOffset[ImageDimension];
+    double             distance[ImageDimension];
+
+    for (; i < insideEnd; ++i, ++outIt )
+      {
+      ComputeScanlineContinuousIndex(start, step, i, index);
+      OffsetValueType offset = 0;
+      for ( unsigned int k = 0; k < ImageDimension; ++k )
         {
-        if( m_Extrapolator.IsNull() )
+        IndexValueType base = Math::Floor< IndexValueType >(index[k]);
+        if ( base < startIndex[k] )
+          {
+          base = startIndex[k];
+          }
+        distance[k] = index[k] - static_cast< double >( base );
+        offset += ( base - startIndex[k] ) * offsetTable[k];
+
+        // A neighbor past the end of the buffer, or one that does not
+        // contribute, is replaced by the base pixel with a null weight.
+        if ( distance[k] <= 0. || base >= endIndex[k] )
           {
-          outIt.Set(defaultValue); // default background value
+          distance[k] = 0.;
+          neighborOffset[k] = 0;
           }
         else
           {
-          value = m_Extrapolator->EvaluateAtContinuousIndex( inputIndex );
-          pixval = this->CastPixelWithBoundsChecking( value, minOutputValue, maxOutputValue );
-          outIt.Set(pixval);
+          neighborOffset[k] = offsetTable[k];
           }
         }
 
-      progress.CompletedPixel();
-      ++outIt;
-      inputIndex += delta;
+      // The neighbor n is offset along the dimensions of the set bits of n.
+      neighborIndex[0] = offset;
+      neighbors[0] = static_cast< ComponentType >( buffer[offset] );
+      for ( unsigned int k = 0, count = 1; k < ImageDimension; ++k, count <<= 1 )
+        {
+        for ( unsigned int n = 0; n < count; ++n )
+          {
+          neighborIndex[count + n] = neighborIndex[n] + neighborOffset[k];
+          neighbors[count + n] = static_cast< ComponentType >( buffer[neighborIndex[count + n]] );
+          }
+        }
+      for ( unsigned int k = 0, count = numberOfNeighbors; k < ImageDimension; ++k )
+        {
+        count >>= 1;
+        for ( unsigned int n = 0; n < count; ++n )
+          {
+          neighbors[n] = neighbors[2 * n]
+                         + ( neighbors[2 * n + 1] - neighbors[2 * n] ) * distance[k];
+          }
+        }
+      value = neighbors[0];
+      outIt.Set( static_cast< PixelType >( value < minComponent ? minComponent
+                                           : ( value > maxComponent ? maxComponent : value ) ) );
       }
-    outIt.NextLine();
-    } //while( !outIt.IsAtEnd() )
+    }
 
-  return;
+  for (; i < length; ++i, ++outIt )
+    {
+    ComputeScanlineContinuousIndex(start, step, i, index);
+    outIt.Set( this->EvaluateOutside(index, minComponent, maxComponent) );
+    }
 }
 
 /**
@@ -0,0 +1,397 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include <iostream>
+
+#include "itkAffineTransform.h"
+#include "itkCompositeTransform.h"
+#include "itkResampleImageFilter.h"
+#include "itkNearestNeighborInterpolateImageFunction.h"
+#include "itkBSplineInterpolateImageFunction.h"
+#include "itkNearestNeighborExtrapolateImageFunction.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+
+/* Compare the scanline resampling of linear transforms with the
+ * resampling that transforms every point, for several transforms,
+ * interpolators and pixel types.
+ */
+
+namespace {
+
+template<class TCoordRepType, unsigned int NDimensions>
+class ResampleNonlinearAffineTransform:
+  public itk::AffineTransform<TCoordRepType,NDimensions>
+{
+public:
+  /** Standard class typedefs.   */
+  typedef ResampleNonlinearAffineTransform                   Self;
+  typedef itk::AffineTransform< TCoordRepType, NDimensions > Superclass;
+  typedef itk::SmartPointer< Self >                          Pointer;
+  typedef itk::SmartPointer< const Self >                    ConstPointer;
+
+  /** New macro for creation of through a smart pointer. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ResampleNonlinearAffineTransform, AffineTransform);
+
+  typedef typename Superclass::TransformCategoryType TransformCategoryType;
+
+  /** Force the resampling of every point. */
+  virtual TransformCategoryType GetTransformCategory() const
+  {
+    return Self::UnknownTransformCategory;
+  }
+};
+
+// A resampler whose cast of the interpolated values negates them
+template< class TInputImage, class TOutputImage >
+class ResampleNegatingImageFilter:
+  public itk::ResampleImageFilter< TInputImage, TOutputImage >
+{
+public:
+  /** Standard class typedefs.   */
+  typedef ResampleNegatingImageFilter                           Self;
+  typedef itk::ResampleImageFilter< TInputImage, TOutputImage > Superclass;
+  typedef itk::SmartPointer< Self >                             Pointer;
+  typedef itk::SmartPointer< const Self >                       ConstPointer;
+
+  /** New macro for creation of through a smart pointer. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ResampleNegatingImageFilter, ResampleImageFilter);
+
+  typedef typename Superclass::PixelType              PixelType;
+  typedef typename Superclass::InterpolatorOutputType InterpolatorOutputType;
+  typedef typename Superclass::ComponentType          ComponentType;
+
+protected:
+  virtual PixelType CastPixelWithBoundsChecking( const InterpolatorOutputType value,
+                                                 const ComponentType,
+                                                 const ComponentType ) const
+  {
+    return static_cast< PixelType >( -value );
+  }
+};
+
+template< class TInputImage, class TOutputImage >
+bool ResampleImageTest7Compare(const char *name,
+                               const TInputImage *input,
+                               const typename TOutputImage::RegionType & outputRegion,
+                               const typename TOutputImage::SpacingType & outputSpacing,
+                               const typename TOutputImage::PointType & outputOrigin,
+                               const typename TOutputImage::DirectionType & outputDirection,
+                               const itk::Transform< double, TInputImage::ImageDimension,
+                                                     TInputImage::ImageDimension > *transform,
+                               itk::InterpolateImageFunction< TInputImage, double > *interpolator,
+                               itk::ExtrapolateImageFunction< TInputImage, double > *extrapolator,
+                               double tolerance)
+{
+  const unsigned int Dimension = TInputImage::ImageDimension;
+
+  typedef itk::ResampleImageFilter< TInputImage, TOutputImage > FilterType;
+  typedef itk::AffineTransform< double, Dimension >             AffineTransformType;
+  typedef ResampleNonlinearAffineTransform< double, Dimension > NonlinearTransformType;
+
+  // The reference resamples the same affine mapping point by point.
+  typename NonlinearTransformType::Pointer nonlinear = NonlinearTransformType::New();
+  typename AffineTransformType::InputPointType  origin;
+  origin.Fill(0.0);
+  typename AffineTransformType::MatrixType      matrix;
+  typename AffineTransformType::OutputVectorType offset;
+  const typename AffineTransformType::OutputPointType mappedOrigin = transform->TransformPoint(origin);
+  for ( unsigned int j = 0; j < Dimension; ++j )
+    {
+    typename AffineTransformType::InputPointType unit;
+    unit.Fill(0.0);
+    unit[j] = 1.0;
+    const typename AffineTransformType::OutputPointType mappedUnit = transform->TransformPoint(unit);
+    for ( unsigned int i = 0; i < Dimension; ++i )
+      {
+      matrix(i, j) = mappedUnit[i] - mappedOrigin[i];
+      }
+    }
+  for ( unsigned int i = 0; i < Dimension; ++i )
+    {
+    offset[i] = mappedOrigin[i];
+    }
+  nonlinear->SetMatrix(matrix);
+  nonlinear->SetOffset(offset);
+
+  typename TOutputImage::Pointer outputs[2];
+  for ( unsigned int n = 0; n < 2; ++n )
+    {
+    typename FilterType::Pointer filter = FilterType::New();
+    filter->SetInput(input);
+    filter->SetSize( outputRegion.GetSize() );
+    filter->SetOutputStartIndex( outputRegion.GetIndex() );
+    filter->SetOutputSpacing(outputSpacing);
+    filter->SetOutputOrigin(outputOrigin);
+    filter->SetOutputDirection(outputDirection);
+    filter->SetDefaultPixelValue(7);
+    filter->SetInterpolator(interpolator);
+    filter->SetExtrapolator(extrapolator);
+    if ( n == 0 )
+      {
+      filter->SetTransform(transform);
+      }
+    else
+      {
+      filter->SetTransform(nonlinear);
+      }
+    filter->Update();
+    outputs[n] = filter->GetOutput();
+    outputs[n]->DisconnectPipeline();
+    }
+
+  itk::ImageRegionConstIterator< TOutputImage > it0( outputs[0], outputRegion );
+  itk::ImageRegionConstIterator< TOutputImage > it1( outputs[1], outputRegion );
+  double        maximumDifference = 0.0;
+  unsigned long numberOfDefaults = 0;
+  for (; !it0.IsAtEnd(); ++it0, ++it1 )
+    {
+    const double difference = vcl_abs( static_cast< double >( it0.Get() )
+                                       - static_cast< double >( it1.Get() ) );
+    maximumDifference = std::max( maximumDifference, difference );
+    if ( it1.Get() == 7 )
+      {
+      ++numberOfDefaults;
+      }
+    }
+
+  std::cout << name << ": maximum difference " << maximumDifference
+            << ", " << numberOfDefaults << " default pixels" << std::endl;
+  if ( maximumDifference > tolerance )
+    {
+    std::cerr << name << ": the scanline and pointwise resamplings differ by "
+              << maximumDifference << std::endl;
+    return false;
+    }
+  return true;
+}
+
+template< class TPixel, class TOutputPixel, unsigned int VDimension >
+bool ResampleImageTest7Run(double tolerance)
+{
+  typedef itk::Image< TPixel, VDimension >       InputImageType;
+  typedef itk::Image< TOutputPixel, VDimension > OutputImageType;
+
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize(1234);
+
+  // A randomly filled input, with a non trivial geometry, whose buffer is a
+  // part of the largest possible region.
+  typename InputImageType::SizeType  size;
+  typename InputImageType::IndexType start;
+  typename InputImageType::SpacingType spacing;
+  typename InputImageType::PointType origin;
+  typename InputImageType::DirectionType direction;
+  direction.SetIdentity();
+  for ( unsigned int i = 0; i < VDimension; ++i )
+    {
+    size[i] = 17 + 3 * i;
+    start[i] = 2 + i;
+    spacing[i] = 0.8 + 0.3 * i;
+    origin[i] = -3.0 + i;
+    }
+  if ( VDimension > 1 )
+    {
+    const double angle = 0.3;
+    direction(0, 0) = vcl_cos(angle);
+    direction(0, 1) = -vcl_sin(angle);
+    direction(1, 0) = vcl_sin(angle);
+    direction(1, 1) = vcl_cos(angle);
+    }
+
+  typename InputImageType::RegionType largestRegion(size);
+  typename InputImageType::RegionType bufferedRegion(start, size);
+  typename InputImageType::SizeType largestSize;
+  for ( unsigned int i = 0; i < VDimension; ++i )
+    {
+    largestSize[i] = size[i] + 2 * start[i];
+    }
+  largestRegion.SetSize(largestSize);
+
+  typename InputImageType::Pointer input = InputImageType::New();
+  input->SetLargestPossibleRegion(largestRegion);
+  input->SetBufferedRegion(bufferedRegion);
+  input->SetRequestedRegion(bufferedRegion);
+  input->SetSpacing(spacing);
+  input->SetOrigin(origin);
+  input->SetDirection(direction);
+  input->Allocate();
+  for ( itk::ImageRegionIterator< InputImageType > it(input, bufferedRegion); !it.IsAtEnd(); ++it )
+    {
+    it.Set( static_cast< TPixel >( generator->GetUniformVariate(0.0, 200.0) ) );
+    }
+
+  // The output covers the input and its surroundings, with another
+  // orientation and a finer spacing.
+  typename OutputImageType::RegionType outputRegion;
+  typename OutputImageType::SpacingType outputSpacing;
+  typename OutputImageType::PointType outputOrigin;
+  typename OutputImageType::DirectionType outputDirection;
+  outputDirection.SetIdentity();
+  for ( unsigned int i = 0; i < VDimension; ++i )
+    {
+    outputRegion.SetIndex( i, -3 );
+    outputRegion.SetSize( i, 41 + i );
+    outputSpacing[i] = 0.7;
+    outputOrigin[i] = -5.013;
+    }
+  if ( VDimension > 1 )
+    {
+    outputDirection(0, 0) = 0.0;
+    outputDirection(0, 1) = 1.0;
+    outputDirection(1, 0) = -1.0;
+    outputDirection(1, 1) = 0.0;
+    }
+
+  typedef itk::AffineTransform< double, VDimension > AffineTransformType;
+  typename AffineTransformType::Pointer affine = AffineTransformType::New();
+  typename AffineTransformType::OutputVectorType translation;
+  typename AffineTransformType::OutputVectorType scale;
+  for ( unsigned int i = 0; i < VDimension; ++i )
+    {
+    translation[i] = 1.31 - 0.73 * i;
+    scale[i] = 0.9 + 0.15 * i;
+    }
+  affine->Translate(translation);
+  affine->Scale(scale);
+  if ( VDimension > 1 )
+    {
+    affine->Rotate(0, 1, 0.41);
+    }
+
+  // A composite of linear transforms is linear, but not a matrix offset
+  // transform.
+  typedef itk::CompositeTransform< double, VDimension > CompositeTransformType;
+  typename AffineTransformType::Pointer shift = AffineTransformType::New();
+  shift->Translate(translation);
+  if ( VDimension > 1 )
+    {
+    shift->Shear(0, 1, 0.2);
+    }
+  typename CompositeTransformType::Pointer composite = CompositeTransformType::New();
+  composite->AddTransform(affine);
+  composite->AddTransform(shift);
+
+  typedef itk::LinearInterpolateImageFunction< InputImageType, double >          LinearType;
+  typedef itk::NearestNeighborInterpolateImageFunction< InputImageType, double > NearestType;
+  typedef itk::BSplineInterpolateImageFunction< InputImageType, double >         BSplineType;
+  typedef itk::NearestNeighborExtrapolateImageFunction< InputImageType, double > ExtrapolatorType;
+
+  typename LinearType::Pointer       linear = LinearType::New();
+  typename NearestType::Pointer      nearest = NearestType::New();
+  typename BSplineType::Pointer      bspline = BSplineType::New();
+  typename ExtrapolatorType::Pointer extrapolator = ExtrapolatorType::New();
+
+  bool success = true;
+  success &= ResampleImageTest7Compare< InputImageType, OutputImageType >(
+    "affine linear", input, outputRegion, outputSpacing, outputOrigin, outputDirection,
+    affine, linear, NULL, tolerance );
+  success &= ResampleImageTest7Compare< InputImageType, OutputImageType >(
+    "affine nearest", input, outputRegion, outputSpacing, outputOrigin, outputDirection,
+    affine, nearest, NULL, tolerance );
+  success &= ResampleImageTest7Compare< InputImageType, OutputImageType >(
+    "affine bspline", input, outputRegion, outputSpacing, outputOrigin, outputDirection,
+    affine, bspline, NULL, tolerance );
+  success &= ResampleImageTest7Compare< InputImageType, OutputImageType >(
+    "affine linear extrapolated", input, outputRegion, outputSpacing, outputOrigin,
+    outputDirection, affine, linear, extrapolator, tolerance );
+  success &= ResampleImageTest7Compare< InputImageType, OutputImageType >(
+    "composite linear", input, outputRegion, outputSpacing, outputOrigin, outputDirection,
+    composite, linear, NULL, tolerance );
+  success &= ResampleImageTest7Compare< InputImageType, OutputImageType >(
+    "composite nearest", input, outputRegion, outputSpacing, outputOrigin, outputDirection,
+    composite, nearest, NULL, tolerance );
+  return success;
+}
+
+// The scanline resampling of a subclass calls its override of
+// CastPixelWithBoundsChecking()
+bool ResampleImageTest7Override()
+{
+  typedef itk::Image< float, 2 >                                    ImageType;
+  typedef ResampleNegatingImageFilter< ImageType, ImageType >       FilterType;
+  typedef itk::AffineTransform< double, 2 >                         TransformType;
+  typedef itk::NearestNeighborInterpolateImageFunction< ImageType > NearestInterpolatorType;
+
+  ImageType::SizeType size;
+  size.Fill(9);
+  ImageType::Pointer input = ImageType::New();
+  input->SetRegions(size);
+  input->Allocate();
+  input->FillBuffer(2.0f);
+
+  for ( unsigned int i = 0; i < 2; ++i )
+    {
+    FilterType::Pointer filter = FilterType::New();
+    filter->SetInput(input);
+    filter->SetTransform( TransformType::New() );
+    if ( i == 1 )
+      {
+      filter->SetInterpolator( NearestInterpolatorType::New() );
+      }
+    filter->SetSize(size);
+    filter->Update();
+
+    itk::ImageRegionConstIterator< ImageType > it( filter->GetOutput(), filter->GetOutput()->GetBufferedRegion() );
+    for (; !it.IsAtEnd(); ++it )
+      {
+      if ( it.Get() != -2.0f )
+        {
+        std::cerr << "The override of CastPixelWithBoundsChecking() was not called, interpolator "
+                  << i << ": " << it.Get() << " instead of -2" << std::endl;
+        return false;
+        }
+      }
+    }
+  return true;
+}
+}
+
+int itkResampleImageTest7(int, char * [] )
+{
+  bool success = true;
+
+  std::cout << "2D float" << std::endl;
+  success &= ResampleImageTest7Run< float, float, 2 >(1e-3);
+  std::cout << "3D float" << std::endl;
+  success &= ResampleImageTest7Run< float, float, 3 >(1e-3);
+  // The rounding of the interpolated values to integers may differ by one
+  // unit between the paths.
+  std::cout << "2D short to unsigned char" << std::endl;
+  success &= ResampleImageTest7Run< short, unsigned char, 2 >(1.0);
+  std::cout << "3D unsigned char" << std::endl;
+  success &= ResampleImageTest7Run< unsigned char, unsigned char, 3 >(1.0);
+  std::cout << "1D double" << std::endl;
+  success &= ResampleImageTest7Run< double, double, 1 >(1e-6);
+  std::cout << "Override of CastPixelWithBoundsChecking" << std::endl;
+  success &= ResampleImageTest7Override();
+
+  if ( !success )
+    {
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
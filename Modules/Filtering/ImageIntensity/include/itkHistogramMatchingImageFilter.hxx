@@ -20,6 +20,8 @@
 
 #include "itkHistogramMatchingImageFilter.h"
 #include "itkImageRegionIterator.h"
+#include "itkImageScanlineIterator.h"
+#include "itkProgressReporter.h"
 #include "itkNumericTraits.h"
 #include <vector>
 
@@ -284,69 +286,71 @@ HistogramMatchingImageFilter< TInputImage, TOutputImage, THistogramMeasurement >
 ::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
                        ThreadIdType threadId)
 {
-  int          i;
   unsigned int j;
 
   // Get the input and output pointers;
   InputImageConstPointer input  = this->GetInput();
   OutputImagePointer     output = this->GetOutput();
 
+  const typename OutputImageRegionType::SizeType & regionSize = outputRegionForThread.GetSize();
+  if ( regionSize[0] == 0 )
+    {
+    return;
+    }
+  const SizeValueType numberOfLinesToProcess = outputRegionForThread.GetNumberOfPixels() / regionSize[0];
+
   // Transform the source image and write to output.
-  typedef ImageRegionConstIterator< InputImageType > InputConstIterator;
-  typedef ImageRegionIterator< OutputImageType >     OutputIterator;
+  typedef ImageScanlineConstIterator< InputImageType > InputConstIterator;
+  typedef ImageScanlineIterator< OutputImageType >     OutputIterator;
 
   InputConstIterator inIter(input, outputRegionForThread);
   OutputIterator     outIter(output, outputRegionForThread);
 
   // support progress methods/callbacks
-  SizeValueType updateVisits = 0;
-  SizeValueType totalPixels = 0;
-  if ( threadId == 0 )
-    {
-    totalPixels = outputRegionForThread.GetNumberOfPixels();
-    updateVisits = totalPixels / 10;
-    if ( updateVisits < 1 ) { updateVisits = 1; }
-    }
+  ProgressReporter progress( this, threadId, numberOfLinesToProcess, 10 );
 
   double srcValue, mappedValue;
 
-  for ( i = 0; !outIter.IsAtEnd(); ++inIter, ++outIter, i++ )
+  while ( !outIter.IsAtEnd() )
     {
-    if ( threadId == 0 && !( i % updateVisits ) )
+    while ( !outIter.IsAtEndOfLine() )
       {
-      this->UpdateProgress( (float)i / (float)totalPixels );
-      }
+      srcValue = static_cast< double >( inIter.Get() );
 
-    srcValue = static_cast< double >( inIter.Get() );
+      for ( j = 0; j < m_NumberOfMatchPoints + 2; j++ )
+        {
+        if ( srcValue < m_QuantileTable[0][j] )
+          {
+          break;
+          }
+        }
 
-    for ( j = 0; j < m_NumberOfMatchPoints + 2; j++ )
-      {
-      if ( srcValue < m_QuantileTable[0][j] )
+      if ( j == 0 )
         {
-        break;
+        // Linear interpolate from min to point[0]
+        mappedValue = m_ReferenceMinValue
+                      + ( srcValue - m_SourceMinValue ) * m_LowerGradient;
+        }
+      else if ( j == m_NumberOfMatchPoints + 2 )
+        {
+        // Linear interpolate from point[m_NumberOfMatchPoints+1] to max
+        mappedValue = m_ReferenceMaxValue
+                      + ( srcValue - m_SourceMaxValue ) * m_UpperGradient;
+        }
+      else
+        {
+        // Linear interpolate from point[j] and point[j+1].
+        mappedValue = m_QuantileTable[1][j - 1]
+                      + ( srcValue - m_QuantileTable[0][j - 1] ) * m_Gradients[j - 1];
         }
-      }
 
-    if ( j == 0 )
-      {
-      // Linear interpolate from min to point[0]
-      mappedValue = m_ReferenceMinValue
-                    + ( srcValue - m_SourceMinValue ) * m_LowerGradient;
-      }
-    else if ( j == m_NumberOfMatchPoints + 2 )
-      {
-      // Linear interpolate from point[m_NumberOfMatchPoints+1] to max
-      mappedValue = m_ReferenceMaxValue
-                    + ( srcValue - m_SourceMaxValue ) * m_UpperGradient;
+      outIter.Set( static_cast< OutputPixelType >( mappedValue ) );
+      ++inIter;
+      ++outIter;
       }
-    else
-      {
-      // Linear interpolate from point[j] and point[j+1].
-      mappedValue = m_QuantileTable[1][j - 1]
-                    + ( srcValue - m_QuantileTable[0][j - 1] ) * m_Gradients[j - 1];
-      }
-
-    outIter.Set( static_cast< OutputPixelType >( mappedValue ) );
+    inIter.NextLine();
+    outIter.NextLine();
+    progress.CompletedPixel();
     }
 }
 
@@ -20,6 +20,7 @@
 
 #include "itkNaryFunctorImageFilter.h"
 #include "itkImageRegionIterator.h"
+#include "itkImageScanlineIterator.h"
 #include "itkProgressReporter.h"
 
 namespace itk
@@ -49,8 +50,15 @@ NaryFunctorImageFilter< TInputImage, TOutputImage, TFunction >
   const unsigned int numberOfInputImages =
     static_cast< unsigned int >( this->GetNumberOfIndexedInputs() );
 
-  typedef ImageRegionConstIterator< TInputImage > ImageRegionConstIteratorType;
-  std::vector< ImageRegionConstIteratorType * > inputItrVector;
+  const typename OutputImageRegionType::SizeType & regionSize = outputRegionForThread.GetSize();
+  if ( regionSize[0] == 0 )
+    {
+    return;
+    }
+  const SizeValueType numberOfLinesToProcess = outputRegionForThread.GetNumberOfPixels() / regionSize[0];
+
+  typedef ImageScanlineConstIterator< TInputImage > ImageScanlineConstIteratorType;
+  std::vector< ImageScanlineConstIteratorType * > inputItrVector;
   inputItrVector.reserve(numberOfInputImages);
 
   // support progress methods/callbacks.
@@ -62,11 +70,10 @@ NaryFunctorImageFilter< TInputImage, TOutputImage, TFunction >
 
     if ( inputPtr )
       {
-      inputItrVector.push_back( new ImageRegionConstIteratorType(inputPtr, outputRegionForThread) );
+      inputItrVector.push_back( new ImageScanlineConstIteratorType(inputPtr, outputRegionForThread) );
       }
     }
-  ProgressReporter progress( this, threadId,
-                             outputRegionForThread.GetNumberOfPixels() );
+  ProgressReporter progress( this, threadId, numberOfLinesToProcess );
 
   const unsigned int numberOfValidInputImages = inputItrVector.size();
 
@@ -80,26 +87,36 @@ NaryFunctorImageFilter< TInputImage, TOutputImage, TFunction >
   NaryArrayType naryInputArray(numberOfValidInputImages);
 
   OutputImagePointer                  outputPtr = this->GetOutput(0);
-  ImageRegionIterator< TOutputImage > outputIt(outputPtr, outputRegionForThread);
+  ImageScanlineIterator< TOutputImage > outputIt(outputPtr, outputRegionForThread);
 
-  typename std::vector< ImageRegionConstIteratorType * >::iterator regionIterators;
-  const typename std::vector< ImageRegionConstIteratorType * >::const_iterator regionItEnd =
+  typename std::vector< ImageScanlineConstIteratorType * >::iterator regionIterators;
+  const typename std::vector< ImageScanlineConstIteratorType * >::const_iterator regionItEnd =
     inputItrVector.end();
 
   typename NaryArrayType::iterator arrayIt;
 
   while ( !outputIt.IsAtEnd() )
     {
-    arrayIt = naryInputArray.begin();
+    while ( !outputIt.IsAtEndOfLine() )
+      {
+      arrayIt = naryInputArray.begin();
+      regionIterators = inputItrVector.begin();
+      while ( regionIterators != regionItEnd )
+        {
+        *arrayIt++ = ( *regionIterators )->Get();
+        ++( *( *regionIterators ) );
+        ++regionIterators;
+        }
+      outputIt.Set( m_Functor(naryInputArray) );
+      ++outputIt;
+      }
     regionIterators = inputItrVector.begin();
     while ( regionIterators != regionItEnd )
       {
-      *arrayIt++ = ( *regionIterators )->Get();
-      ++( *( *regionIterators ) );
+      ( *regionIterators )->NextLine();
       ++regionIterators;
       }
-    outputIt.Set( m_Functor(naryInputArray) );
-    ++outputIt;
+    outputIt.NextLine();
     progress.CompletedPixel();
     }
 
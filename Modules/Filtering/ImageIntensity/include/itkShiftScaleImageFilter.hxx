@@ -20,6 +20,7 @@
 #include "itkShiftScaleImageFilter.h"
 
 #include "itkImageRegionIterator.h"
+#include "itkImageScanlineIterator.h"
 #include "itkNumericTraits.h"
 #include "itkProgressReporter.h"
 
@@ -86,32 +87,54 @@ ShiftScaleImageFilter< TInputImage, TOutputImage >
 {
   RealType value;
 
-  ImageRegionConstIterator< TInputImage > it (this->m_InputImage, outputRegionForThread);
-  ImageRegionIterator< TOutputImage >     ot (this->m_OutputImage, outputRegionForThread);
+  const typename OutputImageRegionType::SizeType & regionSize = outputRegionForThread.GetSize();
+  if ( regionSize[0] == 0 )
+    {
+    return;
+    }
+  const SizeValueType numberOfLinesToProcess = outputRegionForThread.GetNumberOfPixels() / regionSize[0];
+
+  ImageScanlineConstIterator< TInputImage > it (this->m_InputImage, outputRegionForThread);
+  ImageScanlineIterator< TOutputImage >     ot (this->m_OutputImage, outputRegionForThread);
 
   // support progress methods/callbacks
-  ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
+  ProgressReporter progress( this, threadId, numberOfLinesToProcess );
+
+  // The clamping counters are accumulated locally, and only written back
+  // once per line.
+  long underflow = 0;
+  long overflow = 0;
 
   // shift and scale the input pixels
   while ( !it.IsAtEnd() )
     {
-    value = ( static_cast< RealType >( it.Get() ) + m_Shift ) * m_Scale;
-    if ( value < NumericTraits< OutputImagePixelType >::NonpositiveMin() )
+    while ( !it.IsAtEndOfLine() )
       {
-      ot.Set ( NumericTraits< OutputImagePixelType >::NonpositiveMin() );
-      m_ThreadUnderflow[threadId]++;
+      value = ( static_cast< RealType >( it.Get() ) + m_Shift ) * m_Scale;
+      if ( value < NumericTraits< OutputImagePixelType >::NonpositiveMin() )
+        {
+        ot.Set ( NumericTraits< OutputImagePixelType >::NonpositiveMin() );
+        ++underflow;
+        }
+      else if ( value > NumericTraits< OutputImagePixelType >::max() )
+        {
+        ot.Set ( NumericTraits< OutputImagePixelType >::max() );
+        ++overflow;
+        }
+      else
+        {
+        ot.Set( static_cast< OutputImagePixelType >( value ) );
+        }
+      ++it;
+      ++ot;
       }
-    else if ( value > NumericTraits< OutputImagePixelType >::max() )
-      {
-      ot.Set ( NumericTraits< OutputImagePixelType >::max() );
-      m_ThreadOverflow[threadId]++;
-      }
-    else
-      {
-      ot.Set( static_cast< OutputImagePixelType >( value ) );
-      }
-    ++it;
-    ++ot;
+    it.NextLine();
+    ot.NextLine();
+
+    m_ThreadUnderflow[threadId] += underflow;
+    m_ThreadOverflow[threadId] += overflow;
+    underflow = 0;
+    overflow = 0;
 
     progress.CompletedPixel();
     }
@@ -101,6 +101,7 @@ BinaryContourImageFilter< TInputImage, TOutputImage >
   nbOfThreads = this->SplitRequestedRegion(0, nbOfThreads, splitRegion);
 
   m_Barrier = Barrier::New();
+  this->GetMultiThreader()->ExactNumberOfThreadsOn();
   m_Barrier->Initialize(nbOfThreads);
 
   RegionType tempRegion = output->GetRequestedRegion();
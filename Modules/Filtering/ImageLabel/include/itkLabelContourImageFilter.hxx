@@ -92,6 +92,7 @@ LabelContourImageFilter< TInputImage, TOutputImage >
   nbOfThreads = this->SplitRequestedRegion(0, nbOfThreads, splitRegion);
 
   m_Barrier = Barrier::New();
+  this->GetMultiThreader()->ExactNumberOfThreadsOn();
   m_Barrier->Initialize(nbOfThreads);
 
   OutputImageType* output = this->GetOutput();
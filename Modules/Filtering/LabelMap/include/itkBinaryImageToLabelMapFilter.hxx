@@ -93,6 +93,7 @@ BinaryImageToLabelMapFilter< TInputImage, TOutputImage >
   this->m_NumberOfLabels.clear();
   this->m_NumberOfLabels.resize(nbOfThreads, 0);
   this->m_Barrier = Barrier::New();
+  this->GetMultiThreader()->ExactNumberOfThreadsOn();
   this->m_Barrier->Initialize(nbOfThreads);
 
   SizeValueType pixelcount = output->GetRequestedRegion().GetNumberOfPixels();
@@ -268,6 +268,7 @@ LabelMapMaskImageFilter<TInputImage, TOutputImage>
   // std::cout << "nbOfThreads: " << nbOfThreads << std::endl;
 
   m_Barrier = Barrier::New();
+  this->GetMultiThreader()->ExactNumberOfThreadsOn();
   m_Barrier->Initialize( nbOfThreads );
 
   Superclass::BeforeThreadedGenerateData();
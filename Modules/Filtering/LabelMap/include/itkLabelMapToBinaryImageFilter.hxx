@@ -79,6 +79,7 @@ LabelMapToBinaryImageFilter< TInputImage, TOutputImage >
   numberOfThreads = this->SplitRequestedRegion(0, numberOfThreads, splitRegion);
 
   m_Barrier = Barrier::New();
+  this->GetMultiThreader()->ExactNumberOfThreadsOn();
 
   m_Barrier->Initialize(numberOfThreads);
 
@@ -20,6 +20,7 @@
 
 #include "itkImageToImageFilter.h"
 #include "itkImage.h"
+#include "itkIsSame.h"
 
 namespace itk
 {
@@ -43,6 +44,11 @@ namespace itk
  * When the Gaussian kernel is small, this filter tends to run faster than
  * itk::RecursiveGaussianImageFilter.
  *
+ * Images of scalar pixels are convolved one tile at a time along all the
+ * dimensions, through a small buffer of each thread, so that no image
+ * of intermediate results is allocated. Images of other pixel types are
+ * convolved one dimension after the other by a streamed mini-pipeline.
+ *
  * \sa GaussianOperator
  * \sa Image
  * \sa Neighborhood
@@ -207,7 +213,8 @@ public:
    * The default value is $ImageDimension^2$.
    *
    * This parameter was introduced to reduce the memory used by images
-   * internally, at the cost of performance.
+   * internally, at the cost of performance. It is not used for images
+   * of scalar pixels, which are convolved without intermediate images.
    */
   itkSetMacro(InternalNumberOfStreamDivisions, unsigned int);
   itkGetConstReferenceMacro(InternalNumberOfStreamDivisions, unsigned int);
@@ -245,16 +252,94 @@ protected:
   void PrintSelf(std::ostream & os, Indent indent) const;
 
   /** Standard pipeline method. While this class does not implement a
-   * ThreadedGenerateData(), its GenerateData() delegates all
-   * calculations to an NeighborhoodOperatorImageFilter.  Since the
-   * NeighborhoodOperatorImageFilter is multithreaded, this filter is
-   * multithreaded by default. */
+   * ThreadedGenerateData(), its GenerateData() splits the output
+   * requested region between threads for images of scalar pixels, and
+   * otherwise delegates all calculations to an
+   * NeighborhoodOperatorImageFilter, which is multithreaded. */
   void GenerateData();
 
 private:
   DiscreteGaussianImageFilter(const Self &); //purposely not implemented
   void operator=(const Self &);              //purposely not implemented
 
+  typedef typename NumericTraits< OutputPixelValueType >::RealType RealValueType;
+  typedef typename TOutputImage::RegionType                         OutputImageRegionType;
+  typedef typename TOutputImage::IndexType                          IndexType;
+  typedef typename TOutputImage::SizeType                           SizeType;
+
+  /** Half kernels, center first, of every dimension filtered. */
+  typedef std::vector< std::vector< RealValueType > > KernelsType;
+
+  /** Convolves the output requested region with the kernels of the
+   * dimensions filtered in a single pass when the pixels are scalars.
+   * Returns false for other pixel types. */
+  bool GenerateScalarData(const KernelsType & kernels, const TrueType &);
+  bool GenerateScalarData(const KernelsType &, const FalseType &)
+  {
+    return false;
+  }
+
+  /** Region of a buffer of pixels, with the offsets between its
+   * consecutive pixels along every dimension. */
+  template< class TPixel >
+  struct ConvolutionBuffer {
+    TPixel *        Buffer;
+    IndexType       Start;
+    SizeType        Size;
+    OffsetValueType Strides[ImageDimension];
+
+    TPixel * GetPointer(const IndexType & index) const
+    {
+      OffsetValueType offset = 0;
+      for ( unsigned int d = 0; d < ImageDimension; d++ )
+        {
+        offset += ( index[d] - Start[d] ) * Strides[d];
+        }
+      return Buffer + offset;
+    }
+  };
+
+  /** State shared by the threads convolving the image. */
+  struct ScalarThreadStruct {
+    Self *                 Filter;
+    const InputImageType * Input;
+    OutputImageType *      Output;
+    KernelsType            Kernels;
+  };
+
+  /** Static function used as a "callback" by the MultiThreader to
+   * convolve the region of a thread. */
+  static ITK_THREAD_RETURN_TYPE ScalarThreaderCallback(void *arg);
+
+  /** Convolves the region of a thread, one tile at a time. */
+  void ThreadedGenerateScalarData(const ScalarThreadStruct & str,
+                                  const OutputImageRegionType & region,
+                                  ThreadIdType threadId);
+
+  /** Returns the size of the tiles of region, along its two last
+   * dimensions, that needs the least computations without a buffer
+   * much larger than a cache. */
+  SizeType ComputeTileSize(const ScalarThreadStruct & str,
+                           const OutputImageRegionType & region) const;
+
+  /** Returns the region of the pixels convolved along dimension axis
+   * for the tile: the tile padded by the kernels of the dimensions
+   * convolved after it, cropped to the input. */
+  OutputImageRegionType ComputeConvolvedRegion(const ScalarThreadStruct & str,
+                                               const OutputImageRegionType & tile,
+                                               unsigned int axis) const;
+
+  /** Convolves source along dimension axis into region of destination,
+   * clamping the pixels read to the region of source. */
+  template< class TSourcePixel >
+  static void ConvolveAlongAxis(const ConvolutionBuffer< TSourcePixel > & source,
+                                const ConvolutionBuffer< OutputPixelType > & destination,
+                                const OutputImageRegionType & region,
+                                const std::vector< RealValueType > & kernel,
+                                unsigned int axis,
+                                std::vector< RealValueType > & accumulator,
+                                std::vector< RealValueType > & line);
+
   /** The variance of the gaussian blurring kernel in each dimensional
     direction. */
   ArrayType m_Variance;
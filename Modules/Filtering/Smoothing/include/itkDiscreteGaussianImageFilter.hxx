@@ -23,7 +23,9 @@
 #include "itkGaussianOperator.h"
 #include "itkImageRegionIterator.h"
 #include "itkProgressAccumulator.h"
+#include "itkProgressReporter.h"
 #include "itkStreamingImageFilter.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -229,6 +231,23 @@ DiscreteGaussianImageFilter< TInputImage, TOutputImage >
     oper[reverse_i].CreateDirectional();
     }
 
+  // Images of scalar pixels are convolved without a mini-pipeline
+  KernelsType kernels(filterDimensionality);
+  for ( i = 0; i < filterDimensionality; ++i )
+    {
+    const OperatorType & op = oper[filterDimensionality - i - 1];
+    const SizeValueType  radius = op.GetRadius(i);
+    for ( SizeValueType k = 0; k <= radius; ++k )
+      {
+      kernels[i].push_back( op[radius + k] );
+      }
+    }
+  typedef typename IsSame< OutputPixelType, OutputPixelValueType >::Type IsScalarType;
+  if ( this->GenerateScalarData( kernels, IsScalarType() ) )
+    {
+    return;
+    }
+
   // Create a chain of filters
   //
   //
@@ -328,6 +347,400 @@ DiscreteGaussianImageFilter< TInputImage, TOutputImage >
     }
 }
 
+template< class TInputImage, class TOutputImage >
+bool
+DiscreteGaussianImageFilter< TInputImage, TOutputImage >
+::GenerateScalarData(const KernelsType & kernels, const TrueType &)
+{
+  // The buffers of image adaptors do not hold their pixels
+  typedef Image< InputPixelType, ImageDimension >  InputBufferImageType;
+  typedef Image< OutputPixelType, ImageDimension > OutputBufferImageType;
+  if ( dynamic_cast< const InputBufferImageType * >( this->GetInput() ) == 0
+       || dynamic_cast< OutputBufferImageType * >( this->GetOutput() ) == 0 )
+    {
+    return false;
+    }
+
+  ScalarThreadStruct str;
+  str.Filter = this;
+  str.Input = this->GetInput();
+  str.Output = this->GetOutput();
+  str.Kernels = kernels;
+
+  this->GetMultiThreader()->SetNumberOfThreads( this->GetNumberOfThreads() );
+  this->GetMultiThreader()->SetSingleMethod(this->ScalarThreaderCallback, &str);
+  this->GetMultiThreader()->SingleMethodExecute();
+  return true;
+}
+
+template< class TInputImage, class TOutputImage >
+ITK_THREAD_RETURN_TYPE
+DiscreteGaussianImageFilter< TInputImage, TOutputImage >
+::ScalarThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  ScalarThreadStruct *             str = static_cast< ScalarThreadStruct * >( info->UserData );
+
+  OutputImageRegionType splitRegion;
+  const ThreadIdType    total = str->Filter->SplitRequestedRegion(info->ThreadID, info->NumberOfThreads, splitRegion);
+  if ( info->ThreadID < total )
+    {
+    str->Filter->ThreadedGenerateScalarData(*str, splitRegion, info->ThreadID);
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< class TInputImage, class TOutputImage >
+void
+DiscreteGaussianImageFilter< TInputImage, TOutputImage >
+::ThreadedGenerateScalarData(const ScalarThreadStruct & str,
+                             const OutputImageRegionType & region,
+                             ThreadIdType threadId)
+{
+  const unsigned int filterDimensionality = static_cast< unsigned int >( str.Kernels.size() );
+  const SizeType     tileSize = this->ComputeTileSize(str, region);
+
+  SizeValueType numberOfTiles = 1;
+  for ( unsigned int d = 0; d < ImageDimension; d++ )
+    {
+    numberOfTiles *= ( region.GetSize(d) + tileSize[d] - 1 ) / tileSize[d];
+    }
+  ProgressReporter progress(this, threadId, numberOfTiles);
+
+  ConvolutionBuffer< const InputPixelType > input;
+  input.Buffer = str.Input->GetBufferPointer();
+  input.Start = str.Input->GetBufferedRegion().GetIndex();
+  input.Size = str.Input->GetBufferedRegion().GetSize();
+
+  ConvolutionBuffer< OutputPixelType > output;
+  output.Buffer = str.Output->GetBufferPointer();
+  output.Start = str.Output->GetBufferedRegion().GetIndex();
+  output.Size = str.Output->GetBufferedRegion().GetSize();
+
+  for ( unsigned int d = 0; d < ImageDimension; d++ )
+    {
+    input.Strides[d] = str.Input->GetOffsetTable()[d];
+    output.Strides[d] = str.Output->GetOffsetTable()[d];
+    }
+
+  // The tile is convolved along the last dimension filtered first, into
+  // one buffer, then along the previous ones, from one buffer into the
+  // other, and finally along the first dimension into the output.
+  std::vector< OutputPixelType > buffers[2];
+  std::vector< RealValueType >   accumulator;
+  std::vector< RealValueType >   line;
+
+  IndexType tileIndex = region.GetIndex();
+  for (;; )
+    {
+    OutputImageRegionType tile;
+    tile.SetIndex(tileIndex);
+    for ( unsigned int d = 0; d < ImageDimension; d++ )
+      {
+      const IndexValueType end = region.GetIndex(d) + static_cast< IndexValueType >( region.GetSize(d) );
+      tile.SetSize( d, std::min( tileSize[d], static_cast< SizeValueType >( end - tileIndex[d] ) ) );
+      }
+
+    ConvolutionBuffer< OutputPixelType > previous;
+    for ( unsigned int axis = filterDimensionality; axis-- > 0; )
+      {
+      ConvolutionBuffer< OutputPixelType > convolved = output;
+      OutputImageRegionType                convolvedRegion = tile;
+      if ( axis > 0 )
+        {
+        convolvedRegion = this->ComputeConvolvedRegion(str, tile, axis);
+        std::vector< OutputPixelType > & buffer = buffers[axis % 2];
+        if ( buffer.size() < convolvedRegion.GetNumberOfPixels() )
+          {
+          buffer.resize( convolvedRegion.GetNumberOfPixels() );
+          }
+        convolved.Buffer = &buffer[0];
+        convolved.Start = convolvedRegion.GetIndex();
+        convolved.Size = convolvedRegion.GetSize();
+        OffsetValueType stride = 1;
+        for ( unsigned int d = 0; d < ImageDimension; d++ )
+          {
+          convolved.Strides[d] = stride;
+          stride *= convolved.Size[d];
+          }
+        }
+
+      if ( axis == filterDimensionality - 1 )
+        {
+        ConvolveAlongAxis(input, convolved, convolvedRegion, str.Kernels[axis], axis, accumulator, line);
+        }
+      else
+        {
+        ConvolveAlongAxis(previous, convolved, convolvedRegion, str.Kernels[axis], axis, accumulator, line);
+        }
+      previous = convolved;
+      }
+    progress.CompletedPixel();
+
+    // next tile
+    unsigned int d = 0;
+    while ( d < ImageDimension )
+      {
+      tileIndex[d] += static_cast< IndexValueType >( tileSize[d] );
+      if ( tileIndex[d] < region.GetIndex(d) + static_cast< IndexValueType >( region.GetSize(d) ) )
+        {
+        break;
+        }
+      tileIndex[d] = region.GetIndex(d);
+      ++d;
+      }
+    if ( d == ImageDimension )
+      {
+      break;
+      }
+    }
+}
+
+template< class TInputImage, class TOutputImage >
+typename DiscreteGaussianImageFilter< TInputImage, TOutputImage >::SizeType
+DiscreteGaussianImageFilter< TInputImage, TOutputImage >
+::ComputeTileSize(const ScalarThreadStruct & str, const OutputImageRegionType & region) const
+{
+  // Largest number of pixels of the two buffers, about the size of a
+  // second level cache for float pixels.
+  const double maximumBufferSize = 262144.0;
+
+  const unsigned int filterDimensionality = static_cast< unsigned int >( str.Kernels.size() );
+  const SizeType &   inputSize = str.Input->GetBufferedRegion().GetSize();
+
+  SizeType tileSize = region.GetSize();
+  if ( ImageDimension < 2 )
+    {
+    return tileSize;
+    }
+
+  // The tiles are whole along the first dimensions, so that the lines
+  // convolved are as long as possible, and are cut along the two last
+  // ones in powers of two.
+  const unsigned int       lastAxis = ImageDimension - 1;
+  const unsigned int       previousAxis = ImageDimension > 2 ? ImageDimension - 2 : lastAxis;
+  std::vector< SizeValueType > lastSizes;
+  std::vector< SizeValueType > previousSizes;
+  for ( SizeValueType n = 1; n < region.GetSize(lastAxis); n *= 2 )
+    {
+    lastSizes.push_back(n);
+    }
+  lastSizes.push_back( region.GetSize(lastAxis) );
+  for ( SizeValueType n = 1; previousAxis != lastAxis && n < region.GetSize(previousAxis); n *= 2 )
+    {
+    previousSizes.push_back(n);
+    }
+  previousSizes.push_back( region.GetSize(previousAxis) );
+
+  // Number of multiplications per pixel and buffer size of every
+  // candidate. The convolution along a dimension is computed on the tile
+  // padded along the previous dimensions.
+  std::vector< SizeType > candidates;
+  std::vector< double >   costs;
+  std::vector< double >   bufferSizes;
+  std::vector< double >   tileSizes;
+  double                  minimumCost = NumericTraits< double >::max();
+  for ( size_t i = 0; i < lastSizes.size(); i++ )
+    {
+    for ( size_t j = 0; j < previousSizes.size(); j++ )
+      {
+      SizeType candidate = region.GetSize();
+      candidate[lastAxis] = lastSizes[i];
+      candidate[previousAxis] = previousSizes[j];
+
+      double cost = 0.0;
+      double bufferSize = 0.0;
+      for ( unsigned int axis = 0; axis < filterDimensionality; axis++ )
+        {
+        double convolvedSize = 1.0;
+        for ( unsigned int d = 0; d < ImageDimension; d++ )
+          {
+          SizeValueType size = candidate[d];
+          if ( d < axis )
+            {
+            size = std::min( size + 2 * ( str.Kernels[d].size() - 1 ), inputSize[d] );
+            }
+          convolvedSize *= static_cast< double >( size );
+          }
+        cost += convolvedSize * ( 2 * str.Kernels[axis].size() - 1 );
+        if ( axis > 0 && axis + 2 >= filterDimensionality )
+          {
+          bufferSize += convolvedSize;
+          }
+        }
+      double numberOfPixels = 1.0;
+      for ( unsigned int d = 0; d < ImageDimension; d++ )
+        {
+        numberOfPixels *= static_cast< double >( candidate[d] );
+        }
+      cost /= numberOfPixels;
+
+      candidates.push_back(candidate);
+      costs.push_back(cost);
+      bufferSizes.push_back(bufferSize);
+      tileSizes.push_back(numberOfPixels);
+      minimumCost = std::min(minimumCost, cost);
+      }
+    }
+
+  // The cheapest, and then largest, tiles whose buffers fit, unless they
+  // need a quarter more computations than the cheapest tiles, in which
+  // case the tiles with the smallest buffers among those that do not.
+  size_t best = candidates.size();
+  for ( size_t c = 0; c < candidates.size(); c++ )
+    {
+    if ( bufferSizes[c] <= maximumBufferSize
+         && ( best == candidates.size() || costs[c] < costs[best]
+              || ( costs[c] == costs[best] && tileSizes[c] > tileSizes[best] ) ) )
+      {
+      best = c;
+      }
+    }
+  if ( best == candidates.size() || costs[best] > 1.25 * minimumCost )
+    {
+    best = candidates.size();
+    for ( size_t c = 0; c < candidates.size(); c++ )
+      {
+      if ( costs[c] <= 1.25 * minimumCost
+           && ( best == candidates.size() || bufferSizes[c] < bufferSizes[best] ) )
+        {
+        best = c;
+        }
+      }
+    }
+  return candidates[best];
+}
+
+template< class TInputImage, class TOutputImage >
+typename DiscreteGaussianImageFilter< TInputImage, TOutputImage >::OutputImageRegionType
+DiscreteGaussianImageFilter< TInputImage, TOutputImage >
+::ComputeConvolvedRegion(const ScalarThreadStruct & str,
+                         const OutputImageRegionType & tile,
+                         unsigned int axis) const
+{
+  const typename InputImageType::RegionType & inputRegion = str.Input->GetBufferedRegion();
+
+  OutputImageRegionType convolvedRegion = tile;
+  for ( unsigned int d = 0; d < axis; d++ )
+    {
+    const IndexValueType radius = static_cast< IndexValueType >( str.Kernels[d].size() - 1 );
+    const IndexValueType start = std::max( tile.GetIndex(d) - radius, inputRegion.GetIndex(d) );
+    const IndexValueType end = std::min( tile.GetIndex(d) + static_cast< IndexValueType >( tile.GetSize(d) ) + radius,
+                                         inputRegion.GetIndex(d) + static_cast< IndexValueType >( inputRegion.GetSize(d) ) );
+    convolvedRegion.SetIndex(d, start);
+    convolvedRegion.SetSize( d, static_cast< SizeValueType >( end - start ) );
+    }
+  return convolvedRegion;
+}
+
+template< class TInputImage, class TOutputImage >
+template< class TSourcePixel >
+void
+DiscreteGaussianImageFilter< TInputImage, TOutputImage >
+::ConvolveAlongAxis(const ConvolutionBuffer< TSourcePixel > & source,
+                    const ConvolutionBuffer< OutputPixelType > & destination,
+                    const OutputImageRegionType & region,
+                    const std::vector< RealValueType > & kernel,
+                    unsigned int axis,
+                    std::vector< RealValueType > & accumulator,
+                    std::vector< RealValueType > & line)
+{
+  const SizeValueType  width = region.GetSize(0);
+  const IndexValueType radius = static_cast< IndexValueType >( kernel.size() - 1 );
+  const IndexValueType first = source.Start[axis];
+  const IndexValueType last = first + static_cast< IndexValueType >( source.Size[axis] ) - 1;
+
+  if ( accumulator.size() < width )
+    {
+    accumulator.resize(width);
+    }
+  if ( axis == 0 && line.size() < width + 2 * radius )
+    {
+    line.resize(width + 2 * radius);
+    }
+  RealValueType *acc = &accumulator[0];
+
+  // The kernels being symmetric, the pixels at the same distance on both
+  // sides are added before being multiplied. Each line of the region is
+  // accumulated one kernel weight at a time, along the whole line.
+  IndexType index = region.GetIndex();
+  for (;; )
+    {
+    if ( axis == 0 )
+      {
+      // copy the line with the pixels clamped on its sides
+      IndexType sourceIndex = index;
+      sourceIndex[0] = first;
+      const TSourcePixel *in = source.GetPointer(sourceIndex);
+      RealValueType *     padded = &line[0];
+      for ( IndexValueType m = 0; m < static_cast< IndexValueType >( width ) + 2 * radius; m++ )
+        {
+        const IndexValueType x = std::min( std::max( index[0] - radius + m, first ), last );
+        padded[m] = static_cast< RealValueType >( in[x - first] );
+        }
+      const RealValueType *center = padded + radius;
+      for ( SizeValueType x = 0; x < width; x++ )
+        {
+        acc[x] = kernel[0] * center[x];
+        }
+      for ( IndexValueType k = 1; k <= radius; k++ )
+        {
+        const RealValueType  weight = kernel[k];
+        const RealValueType *before = center - k;
+        const RealValueType *after = center + k;
+        for ( SizeValueType x = 0; x < width; x++ )
+          {
+          acc[x] += weight * ( before[x] + after[x] );
+          }
+        }
+      }
+    else
+      {
+      IndexType sourceIndex = index;
+      const TSourcePixel *center = source.GetPointer(sourceIndex);
+      for ( SizeValueType x = 0; x < width; x++ )
+        {
+        acc[x] = kernel[0] * static_cast< RealValueType >( center[x] );
+        }
+      for ( IndexValueType k = 1; k <= radius; k++ )
+        {
+        sourceIndex[axis] = std::max(index[axis] - k, first);
+        const TSourcePixel *before = source.GetPointer(sourceIndex);
+        sourceIndex[axis] = std::min(index[axis] + k, last);
+        const TSourcePixel *after = source.GetPointer(sourceIndex);
+        const RealValueType weight = kernel[k];
+        for ( SizeValueType x = 0; x < width; x++ )
+          {
+          acc[x] += weight * ( static_cast< RealValueType >( before[x] )
+                               + static_cast< RealValueType >( after[x] ) );
+          }
+        }
+      }
+
+    OutputPixelType *out = destination.GetPointer(index);
+    for ( SizeValueType x = 0; x < width; x++ )
+      {
+      out[x] = static_cast< OutputPixelType >( acc[x] );
+      }
+
+    // next line
+    unsigned int d = 1;
+    while ( d < ImageDimension )
+      {
+      if ( ++index[d] < region.GetIndex(d) + static_cast< IndexValueType >( region.GetSize(d) ) )
+        {
+        break;
+        }
+      index[d] = region.GetIndex(d);
+      ++d;
+      }
+    if ( d >= ImageDimension )
+      {
+      break;
+      }
+    }
+}
+
 template< class TInputImage, class TOutputImage >
 void
 DiscreteGaussianImageFilter< TInputImage, TOutputImage >
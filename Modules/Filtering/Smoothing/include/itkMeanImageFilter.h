@@ -20,7 +20,9 @@
 
 #include "itkBoxImageFilter.h"
 #include "itkImage.h"
+#include "itkIsSame.h"
 #include "itkNumericTraits.h"
+#include "itkProgressReporter.h"
 
 namespace itk
 {
@@ -32,6 +34,9 @@ namespace itk
  *
  * A mean filter is one of the family of linear filters.
  *
+ * The means of scalar pixels are computed from a SummedAreaTable, in
+ * constant time whatever the radius.
+ *
  * \sa Image
  * \sa Neighborhood
  * \sa NeighborhoodOperator
@@ -108,6 +113,21 @@ protected:
 private:
   MeanImageFilter(const Self &); //purposely not implemented
   void operator=(const Self &);  //purposely not implemented
+
+  /** Compute the means from summed area tables when the pixels are
+   * scalars. Returns false otherwise. */
+  bool ThreadedGenerateBoxData(const OutputImageRegionType & outputRegionForThread,
+                               ThreadIdType threadId, const TrueType &);
+  bool ThreadedGenerateBoxData(const OutputImageRegionType &, ThreadIdType, const FalseType &)
+  {
+    return false;
+  }
+
+  /** Compute the means of the neighborhoods of the pixels of region,
+   * walked by bit. */
+  template< class TNeighborhoodIterator >
+  void ComputeMeans(TNeighborhoodIterator & bit, const OutputImageRegionType & region,
+                    ProgressReporter & progress);
 };
 } // end namespace itk
 
@@ -20,11 +20,14 @@
 #include "itkMeanImageFilter.h"
 
 #include "itkConstNeighborhoodIterator.h"
+#include "itkConstInteriorNeighborhoodIterator.h"
 #include "itkNeighborhoodInnerProduct.h"
 #include "itkImageRegionIterator.h"
+#include "itkImageScanlineIterator.h"
 #include "itkNeighborhoodAlgorithm.h"
 #include "itkOffset.h"
 #include "itkProgressReporter.h"
+#include "itkSummedAreaTable.h"
 
 namespace itk
 {
@@ -39,15 +42,18 @@ MeanImageFilter< TInputImage, TOutputImage >
 ::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
                        ThreadIdType threadId)
 {
-  unsigned int i;
+  typedef typename IsSame< InputRealType, typename NumericTraits< InputRealType >::ScalarRealType >::Type IsScalarType;
+  if ( this->ThreadedGenerateBoxData( outputRegionForThread, threadId, IsScalarType() ) )
+    {
+    return;
+    }
 
-  ZeroFluxNeumannBoundaryCondition< InputImageType > nbc;
+  typedef ConstInteriorNeighborhoodIterator< InputImageType >                     InteriorIteratorType;
+  typedef NeighborhoodAlgorithm::ImageInteriorTilesCalculator< InputImageType > TilesCalculatorType;
+  typedef typename TilesCalculatorType::TileListType                              TileListType;
 
-  ConstNeighborhoodIterator< InputImageType > bit;
-  ImageRegionIterator< OutputImageType >      it;
+  ZeroFluxNeumannBoundaryCondition< InputImageType > nbc;
 
-  // Allocate output
-  typename OutputImageType::Pointer output = this->GetOutput();
   typename  InputImageType::ConstPointer input  = this->GetInput();
 
   // Find the data-set boundary "faces"
@@ -60,34 +66,104 @@ MeanImageFilter< TInputImage, TOutputImage >
   // support progress methods/callbacks
   ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
 
-  InputRealType sum;
-
   // Process each of the boundary faces.  These are N-d regions which border
   // the edge of the buffer.
   for ( fit = faceList.begin(); fit != faceList.end(); ++fit )
     {
-    bit = ConstNeighborhoodIterator< InputImageType >(this->GetRadius(),
-                                                      input, *fit);
-    unsigned int neighborhoodSize = bit.Size();
-    it = ImageRegionIterator< OutputImageType >(output, *fit);
+    // The non-boundary region is walked tile by tile, with an iterator
+    // that only moves the center of the neighborhood
+    if ( fit == faceList.begin()
+         && InteriorIteratorType::IsInteriorRegion(this->GetRadius(), input, *fit) )
+      {
+      const TileListType tiles = TilesCalculatorType()( *fit, this->GetRadius() );
+      for ( typename TileListType::const_iterator tit = tiles.begin(); tit != tiles.end(); ++tit )
+        {
+        InteriorIteratorType iit(this->GetRadius(), input, *tit);
+        this->ComputeMeans(iit, *tit, progress);
+        }
+      continue;
+      }
+
+    ConstNeighborhoodIterator< InputImageType > bit(this->GetRadius(), input, *fit);
     bit.OverrideBoundaryCondition(&nbc);
     bit.GoToBegin();
+    this->ComputeMeans(bit, *fit, progress);
+    }
+}
 
-    while ( !bit.IsAtEnd() )
+template< class TInputImage, class TOutputImage >
+bool
+MeanImageFilter< TInputImage, TOutputImage >
+::ThreadedGenerateBoxData(const OutputImageRegionType & outputRegionForThread,
+                          ThreadIdType threadId, const TrueType &)
+{
+  typedef SummedAreaTable< InputImageType >  TableType;
+  typedef typename TableType::RegionListType RegionListType;
+
+  const InputImageType *input = this->GetInput();
+  const InputSizeType   radius = this->GetRadius();
+
+  double neighborhoodSize = 1.0;
+  for ( unsigned int d = 0; d < InputImageDimension; ++d )
+    {
+    neighborhoodSize *= static_cast< double >( 2 * radius[d] + 1 );
+    }
+
+  // support progress methods/callbacks
+  ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
+
+  // The tables are built slab after slab to bound the memory they use
+  TableType table;
+  table.SetSubtractReferenceValue(true);
+  const RegionListType slabs = TableType::SplitRegion(outputRegionForThread, radius);
+  for ( typename RegionListType::const_iterator sit = slabs.begin(); sit != slabs.end(); ++sit )
+    {
+    table.Compute(input, *sit, radius);
+    const double reference = table.GetReferenceValue();
+
+    ImageScanlineIterator< OutputImageType > it(this->GetOutput(), *sit);
+    while ( !it.IsAtEnd() )
       {
-      sum = NumericTraits< InputRealType >::Zero;
-      for ( i = 0; i < neighborhoodSize; ++i )
+      typename TableType::OffsetValueType position = table.ComputeOffset( it.GetIndex() );
+      while ( !it.IsAtEndOfLine() )
         {
-        sum += static_cast< InputRealType >( bit.GetPixel(i) );
+        it.Set( static_cast< OutputPixelType >( reference + table.GetSum(position) / neighborhoodSize ) );
+        ++position;
+        ++it;
+        progress.CompletedPixel();
         }
+      it.NextLine();
+      }
+    }
+  return true;
+}
 
-      // get the mean value
-      it.Set( static_cast< OutputPixelType >( sum / double(neighborhoodSize) ) );
+template< class TInputImage, class TOutputImage >
+template< class TNeighborhoodIterator >
+void
+MeanImageFilter< TInputImage, TOutputImage >
+::ComputeMeans(TNeighborhoodIterator & bit, const OutputImageRegionType & region,
+               ProgressReporter & progress)
+{
+  ImageRegionIterator< OutputImageType > it(this->GetOutput(), region);
+
+  const unsigned int neighborhoodSize = bit.Size();
+  InputRealType      sum;
 
-      ++bit;
-      ++it;
-      progress.CompletedPixel();
+  while ( !bit.IsAtEnd() )
+    {
+    sum = NumericTraits< InputRealType >::Zero;
+    for ( unsigned int i = 0; i < neighborhoodSize; ++i )
+      {
+      sum += static_cast< InputRealType >( bit.GetPixel(i) );
       }
+
+    // get the mean value
+    it.Set( static_cast< OutputPixelType >( sum / double(neighborhoodSize) ) );
+
+    ++bit;
+    ++it;
+    progress.CompletedPixel();
     }
 }
 } // end namespace itk
@@ -20,9 +20,30 @@
 
 #include "itkBoxImageFilter.h"
 #include "itkImage.h"
+#include "itkIsSame.h"
+#include "itkProgressReporter.h"
+
+#include <vector>
 
 namespace itk
 {
+/** \cond HIDE_META_PROGRAMMING */
+/** Pixel types whose values can be counted in a histogram with one bin per
+ * value, used by MedianImageFilter to update the median incrementally. */
+template< class TPixel >
+struct MedianImageFilterHistogramPixel:public FalseType {};
+template< >
+struct MedianImageFilterHistogramPixel< char >:public TrueType {};
+template< >
+struct MedianImageFilterHistogramPixel< signed char >:public TrueType {};
+template< >
+struct MedianImageFilterHistogramPixel< unsigned char >:public TrueType {};
+template< >
+struct MedianImageFilterHistogramPixel< short >:public TrueType {};
+template< >
+struct MedianImageFilterHistogramPixel< unsigned short >:public TrueType {};
+/** \endcond */
+
 /** \class MedianImageFilter
  * \brief Applies a median filter to an image
  *
@@ -35,6 +56,14 @@ namespace itk
  * This filter requires that the input pixel type provides an operator<()
  * (LessThan Comparable).
  *
+ * For 8 and 16 bit integer pixel types, the median is tracked in a
+ * histogram with one bin per value, updated as the neighborhood slides
+ * along each line of the image: only the pixels entering and leaving the
+ * neighborhood are processed, instead of the whole neighborhood.  For the
+ * other pixel types (floating point, 32 bit and larger integers), the
+ * median of each neighborhood is selected with std::nth_element().  Both
+ * methods give the exact median.
+ *
  * \sa Image
  * \sa Neighborhood
  * \sa NeighborhoodOperator
@@ -115,6 +144,79 @@ protected:
 private:
   MedianImageFilter(const Self &); //purposely not implemented
   void operator=(const Self &);    //purposely not implemented
+
+  typedef typename MedianImageFilterHistogramPixel< InputPixelType >::Type UseHistogramType;
+
+  /** Compute the median with a histogram sliding along the lines. */
+  void InternalThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                                    ThreadIdType threadId, TrueType useHistogram);
+
+  /** Compute the median by selection in each neighborhood. */
+  void InternalThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                                    ThreadIdType threadId, FalseType useHistogram);
+
+  /** \class Histogram
+   * Counts of the values of the neighborhood, with one bin per value of
+   * the pixel type, and tracking of the bin of the median.
+   * \ingroup ITKSmoothing */
+  class Histogram
+  {
+  public:
+    Histogram();
+
+    /** Set the rank of the tracked value in the sorted neighborhood. */
+    void SetRank(SizeValueType rank) { m_Rank = rank; }
+
+    void AddPixel(const InputPixelType & value)
+    {
+      const SizeValueType bin = GetBin(value);
+
+      ++m_Counts[bin];
+      if ( bin < m_RankBin )
+        {
+        ++m_CountBelowRankBin;
+        }
+    }
+
+    void RemovePixel(const InputPixelType & value)
+    {
+      const SizeValueType bin = GetBin(value);
+
+      --m_Counts[bin];
+      if ( bin < m_RankBin )
+        {
+        --m_CountBelowRankBin;
+        }
+    }
+
+    /** Value of the given rank, the histogram must hold more values than
+     * the rank. */
+    InputPixelType GetRankValue();
+
+  private:
+    static SizeValueType GetBin(const InputPixelType & value)
+    {
+      return static_cast< SizeValueType >( static_cast< long >( value )
+                                           - static_cast< long >( NumericTraits< InputPixelType >::NonpositiveMin() ) );
+    }
+
+    std::vector< SizeValueType > m_Counts;
+    SizeValueType                m_Rank;
+    SizeValueType                m_RankBin;
+    SizeValueType                m_CountBelowRankBin;
+  };
+
+  /** Compute the median of the pixels of region, walked by bit, with a
+   * histogram sliding along its lines. */
+  template< class TNeighborhoodIterator >
+  void HistogramMedian(TNeighborhoodIterator & bit, const OutputImageRegionType & region,
+                       Histogram & histogram, ProgressReporter & progress);
+
+  /** Compute the median of the pixels of region, walked by bit, by
+   * selection in each neighborhood. */
+  template< class TNeighborhoodIterator >
+  void SelectionMedian(TNeighborhoodIterator & bit, const OutputImageRegionType & region,
+                       std::vector< InputPixelType > & pixels, ProgressReporter & progress);
 };
 } // end namespace itk
 
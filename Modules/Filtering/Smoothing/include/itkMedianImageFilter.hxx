@@ -20,6 +20,7 @@
 #include "itkMedianImageFilter.h"
 
 #include "itkConstNeighborhoodIterator.h"
+#include "itkConstInteriorNeighborhoodIterator.h"
 #include "itkNeighborhoodInnerProduct.h"
 #include "itkImageRegionIterator.h"
 #include "itkNeighborhoodAlgorithm.h"
@@ -42,8 +43,53 @@ MedianImageFilter< TInputImage, TOutputImage >
 ::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
                        ThreadIdType threadId)
 {
-  // Allocate output
-  typename OutputImageType::Pointer output = this->GetOutput();
+  this->InternalThreadedGenerateData( outputRegionForThread, threadId, UseHistogramType() );
+}
+
+template< class TInputImage, class TOutputImage >
+MedianImageFilter< TInputImage, TOutputImage >
+::Histogram::Histogram():
+  m_Rank(0),
+  m_RankBin(0),
+  m_CountBelowRankBin(0)
+{
+  m_Counts.resize( GetBin( NumericTraits< InputPixelType >::max() ) + 1, 0 );
+}
+
+template< class TInputImage, class TOutputImage >
+typename MedianImageFilter< TInputImage, TOutputImage >::InputPixelType
+MedianImageFilter< TInputImage, TOutputImage >
+::Histogram::GetRankValue()
+{
+  // The value of the given rank is in the first bin for which the count of
+  // the values in the previous bins and in the bin exceeds the rank.  The
+  // bin moves little between neighboring pixels, so it is searched from its
+  // previous position.
+  while ( m_CountBelowRankBin > m_Rank )
+    {
+    --m_RankBin;
+    m_CountBelowRankBin -= m_Counts[m_RankBin];
+    }
+  while ( m_CountBelowRankBin + m_Counts[m_RankBin] <= m_Rank )
+    {
+    m_CountBelowRankBin += m_Counts[m_RankBin];
+    ++m_RankBin;
+    }
+
+  return static_cast< InputPixelType >( static_cast< long >( m_RankBin )
+                                        + static_cast< long >( NumericTraits< InputPixelType >::NonpositiveMin() ) );
+}
+
+template< class TInputImage, class TOutputImage >
+void
+MedianImageFilter< TInputImage, TOutputImage >
+::InternalThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                               ThreadIdType threadId, TrueType)
+{
+  typedef ConstInteriorNeighborhoodIterator< InputImageType >                     InteriorIteratorType;
+  typedef NeighborhoodAlgorithm::ImageInteriorTilesCalculator< InputImageType > TilesCalculatorType;
+  typedef typename TilesCalculatorType::TileListType                              TileListType;
+
   typename  InputImageType::ConstPointer input  = this->GetInput();
 
   // Find the data-set boundary "faces"
@@ -54,46 +100,202 @@ MedianImageFilter< TInputImage, TOutputImage >
   // support progress methods/callbacks
   ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
 
-  // All of our neighborhoods have an odd number of pixels, so there is
-  // always a median index (if there where an even number of pixels
-  // in the neighborhood we have to average the middle two values).
-
   ZeroFluxNeumannBoundaryCondition< InputImageType > nbc;
-  std::vector< InputPixelType >                      pixels;
+  Histogram                                          histogram;
+
   // Process each of the boundary faces.  These are N-d regions which border
   // the edge of the buffer.
   for ( typename NeighborhoodAlgorithm::ImageBoundaryFacesCalculator< InputImageType >::FaceListType::iterator
         fit = faceList.begin(); fit != faceList.end(); ++fit )
     {
-    ImageRegionIterator< OutputImageType > it = ImageRegionIterator< OutputImageType >(output, *fit);
+    if ( fit->GetNumberOfPixels() == 0 )
+      {
+      continue;
+      }
+
+    // The non-boundary region is walked tile by tile, with an iterator
+    // that only moves the center of the neighborhood
+    if ( fit == faceList.begin()
+         && InteriorIteratorType::IsInteriorRegion(this->GetRadius(), input, *fit) )
+      {
+      const TileListType tiles = TilesCalculatorType()( *fit, this->GetRadius() );
+      for ( typename TileListType::const_iterator tit = tiles.begin(); tit != tiles.end(); ++tit )
+        {
+        InteriorIteratorType iit(this->GetRadius(), input, *tit);
+        this->HistogramMedian(iit, *tit, histogram, progress);
+        }
+      continue;
+      }
 
     ConstNeighborhoodIterator< InputImageType > bit =
       ConstNeighborhoodIterator< InputImageType >(this->GetRadius(), input, *fit);
     bit.OverrideBoundaryCondition(&nbc);
     bit.GoToBegin();
-    const unsigned int neighborhoodSize = bit.Size();
-    const unsigned int medianPosition = neighborhoodSize / 2;
-    while ( !bit.IsAtEnd() )
+    this->HistogramMedian(bit, *fit, histogram, progress);
+    }
+}
+
+template< class TInputImage, class TOutputImage >
+template< class TNeighborhoodIterator >
+void
+MedianImageFilter< TInputImage, TOutputImage >
+::HistogramMedian(TNeighborhoodIterator & bit, const OutputImageRegionType & region,
+                  Histogram & histogram, ProgressReporter & progress)
+{
+  ImageRegionIterator< OutputImageType > it = ImageRegionIterator< OutputImageType >(this->GetOutput(), region);
+
+  const unsigned int neighborhoodSize = bit.Size();
+  histogram.SetRank(neighborhoodSize / 2);
+
+  // The neighborhood slides along the first dimension: the pixels of its
+  // first column leave it and the pixels after its last column enter it.
+  const typename InputImageType::SizeValueType radius = this->GetRadius()[0];
+  std::vector< unsigned int > leaving;
+  std::vector< unsigned int > entering;
+  for ( unsigned int i = 0; i < neighborhoodSize; ++i )
+    {
+    const typename InputImageType::OffsetType offset = bit.GetOffset(i);
+    if ( offset[0] == -static_cast< OffsetValueType >( radius ) )
       {
-      // collect all the pixels in the neighborhood, note that we use
-      // GetPixel on the NeighborhoodIterator to honor the boundary conditions
-      pixels.resize(neighborhoodSize);
-      for ( unsigned int i = 0; i < neighborhoodSize; ++i )
-        {
-        pixels[i] = ( bit.GetPixel(i) );
-        }
+      leaving.push_back(i);
+      }
+    else if ( offset[0] == static_cast< OffsetValueType >( radius ) )
+      {
+      entering.push_back(i);
+      }
+    }
+
+  // With a null radius the neighborhood is one column: it is both the
+  // leaving and the entering column.
+  if ( radius == 0 )
+    {
+    entering = leaving;
+    }
 
-      // get the median value
-      const typename std::vector< InputPixelType >::iterator medianIterator = pixels.begin() + medianPosition;
-      std::nth_element( pixels.begin(), medianIterator, pixels.end() );
-      it.Set( static_cast< typename OutputImageType::PixelType >( *medianIterator ) );
+  const SizeValueType lineLength = region.GetSize(0);
+  while ( !bit.IsAtEnd() )
+    {
+    // start the line with the whole neighborhood, honoring the boundary
+    // conditions through GetPixel
+    for ( unsigned int i = 0; i < neighborhoodSize; ++i )
+      {
+      histogram.AddPixel( bit.GetPixel(i) );
+      }
 
-      ++bit;
+    for ( SizeValueType x = 0; x < lineLength; ++x )
+      {
+      it.Set( static_cast< typename OutputImageType::PixelType >( histogram.GetRankValue() ) );
+
+      if ( x + 1 < lineLength )
+        {
+        for ( unsigned int i = 0; i < leaving.size(); ++i )
+          {
+          histogram.RemovePixel( bit.GetPixel(leaving[i]) );
+          }
+        ++bit;
+        for ( unsigned int i = 0; i < entering.size(); ++i )
+          {
+          histogram.AddPixel( bit.GetPixel(entering[i]) );
+          }
+        }
+      else
+        {
+        // empty the histogram for the next line
+        for ( unsigned int i = 0; i < neighborhoodSize; ++i )
+          {
+          histogram.RemovePixel( bit.GetPixel(i) );
+          }
+        ++bit;
+        }
       ++it;
       progress.CompletedPixel();
       }
     }
 }
+
+template< class TInputImage, class TOutputImage >
+void
+MedianImageFilter< TInputImage, TOutputImage >
+::InternalThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                               ThreadIdType threadId, FalseType)
+{
+  typedef ConstInteriorNeighborhoodIterator< InputImageType >                     InteriorIteratorType;
+  typedef NeighborhoodAlgorithm::ImageInteriorTilesCalculator< InputImageType > TilesCalculatorType;
+  typedef typename TilesCalculatorType::TileListType                              TileListType;
+
+  typename  InputImageType::ConstPointer input  = this->GetInput();
+
+  // Find the data-set boundary "faces"
+  NeighborhoodAlgorithm::ImageBoundaryFacesCalculator< InputImageType > bC;
+  typename NeighborhoodAlgorithm::ImageBoundaryFacesCalculator< InputImageType >::FaceListType
+  faceList = bC( input, outputRegionForThread, this->GetRadius() );
+
+  // support progress methods/callbacks
+  ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
+
+  ZeroFluxNeumannBoundaryCondition< InputImageType > nbc;
+  std::vector< InputPixelType >                      pixels;
+  // Process each of the boundary faces.  These are N-d regions which border
+  // the edge of the buffer.
+  for ( typename NeighborhoodAlgorithm::ImageBoundaryFacesCalculator< InputImageType >::FaceListType::iterator
+        fit = faceList.begin(); fit != faceList.end(); ++fit )
+    {
+    // The non-boundary region is walked tile by tile, with an iterator
+    // that only moves the center of the neighborhood
+    if ( fit == faceList.begin()
+         && InteriorIteratorType::IsInteriorRegion(this->GetRadius(), input, *fit) )
+      {
+      const TileListType tiles = TilesCalculatorType()( *fit, this->GetRadius() );
+      for ( typename TileListType::const_iterator tit = tiles.begin(); tit != tiles.end(); ++tit )
+        {
+        InteriorIteratorType iit(this->GetRadius(), input, *tit);
+        this->SelectionMedian(iit, *tit, pixels, progress);
+        }
+      continue;
+      }
+
+    ConstNeighborhoodIterator< InputImageType > bit =
+      ConstNeighborhoodIterator< InputImageType >(this->GetRadius(), input, *fit);
+    bit.OverrideBoundaryCondition(&nbc);
+    bit.GoToBegin();
+    this->SelectionMedian(bit, *fit, pixels, progress);
+    }
+}
+
+template< class TInputImage, class TOutputImage >
+template< class TNeighborhoodIterator >
+void
+MedianImageFilter< TInputImage, TOutputImage >
+::SelectionMedian(TNeighborhoodIterator & bit, const OutputImageRegionType & region,
+                  std::vector< InputPixelType > & pixels, ProgressReporter & progress)
+{
+  ImageRegionIterator< OutputImageType > it = ImageRegionIterator< OutputImageType >(this->GetOutput(), region);
+
+  // All of our neighborhoods have an odd number of pixels, so there is
+  // always a median index (if there where an even number of pixels
+  // in the neighborhood we have to average the middle two values).
+  const unsigned int neighborhoodSize = bit.Size();
+  const unsigned int medianPosition = neighborhoodSize / 2;
+  while ( !bit.IsAtEnd() )
+    {
+    // collect all the pixels in the neighborhood, note that we use
+    // GetPixel on the NeighborhoodIterator to honor the boundary conditions
+    pixels.resize(neighborhoodSize);
+    for ( unsigned int i = 0; i < neighborhoodSize; ++i )
+      {
+      pixels[i] = ( bit.GetPixel(i) );
+      }
+
+    // get the median value
+    const typename std::vector< InputPixelType >::iterator medianIterator = pixels.begin() + medianPosition;
+    std::nth_element( pixels.begin(), medianIterator, pixels.end() );
+    it.Set( static_cast< typename OutputImageType::PixelType >( *medianIterator ) );
+
+    ++bit;
+    ++it;
+    progress.CompletedPixel();
+    }
+}
 } // end namespace itk
 
 #endif
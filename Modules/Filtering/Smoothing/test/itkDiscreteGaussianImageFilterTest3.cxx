@@ -0,0 +1,167 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include <iostream>
+
+#include "itkDiscreteGaussianImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkRandomImageSource.h"
+#include "itkMultiThreader.h"
+
+// Compares the convolution of an image of scalars, computed tile by
+// tile, with the one of the same image of vectors of one component,
+// computed by the mini-pipeline of NeighborhoodOperatorImageFilters.
+template< class TInputImage, class TOutputImage >
+int itkDiscreteGaussianImageFilterTest3Compare(
+  const typename TInputImage::SizeType & size,
+  const typename TInputImage::IndexType & start,
+  const typename TOutputImage::RegionType & requestedRegion,
+  const double variance[],
+  unsigned int filterDimensionality)
+{
+  const unsigned int Dimension = TInputImage::ImageDimension;
+
+  typedef typename TOutputImage::PixelType                   OutputPixelType;
+  typedef itk::Vector< OutputPixelType, 1 >                  VectorPixelType;
+  typedef itk::Image< VectorPixelType, Dimension >           VectorImageType;
+
+  typedef itk::RandomImageSource< TInputImage > SourceType;
+  typename SourceType::Pointer source = SourceType::New();
+  source->SetSize(size);
+  source->SetMin(0);
+  source->SetMax(255);
+  source->Update();
+
+  typename TInputImage::Pointer input = source->GetOutput();
+  input->DisconnectPipeline();
+  typename TInputImage::RegionType region = input->GetLargestPossibleRegion();
+  region.SetIndex(start);
+  input->SetRegions(region);
+
+  typename VectorImageType::Pointer vectorInput = VectorImageType::New();
+  vectorInput->SetRegions(region);
+  vectorInput->Allocate();
+  itk::ImageRegionConstIterator< TInputImage > inIt(input, region);
+  itk::ImageRegionIterator< VectorImageType >  vectorIt(vectorInput, region);
+  for (; !inIt.IsAtEnd(); ++inIt, ++vectorIt )
+    {
+    VectorPixelType value;
+    value[0] = static_cast< OutputPixelType >( inIt.Get() );
+    vectorIt.Set(value);
+    }
+
+  typedef itk::DiscreteGaussianImageFilter< TInputImage, TOutputImage > FilterType;
+  typename FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(input);
+  filter->SetVariance(variance);
+  filter->SetMaximumKernelWidth(64);
+  filter->SetFilterDimensionality(filterDimensionality);
+  filter->GetOutput()->SetRequestedRegion(requestedRegion);
+  filter->Update();
+
+  typedef itk::DiscreteGaussianImageFilter< VectorImageType, VectorImageType > VectorFilterType;
+  typename VectorFilterType::Pointer vectorFilter = VectorFilterType::New();
+  vectorFilter->SetInput(vectorInput);
+  vectorFilter->SetVariance(variance);
+  vectorFilter->SetMaximumKernelWidth(64);
+  vectorFilter->SetFilterDimensionality(filterDimensionality);
+  vectorFilter->GetOutput()->SetRequestedRegion(requestedRegion);
+  vectorFilter->Update();
+
+  itk::ImageRegionConstIterator< TOutputImage >    outIt(filter->GetOutput(), requestedRegion);
+  itk::ImageRegionConstIterator< VectorImageType > expectedIt(vectorFilter->GetOutput(), requestedRegion);
+  for (; !outIt.IsAtEnd(); ++outIt, ++expectedIt )
+    {
+    const double difference = static_cast< double >( outIt.Get() ) - expectedIt.Get()[0];
+    if ( vcl_abs(difference) > 1e-3 )
+      {
+      std::cerr << "Test failed!" << std::endl;
+      std::cerr << "Pixel " << outIt.GetIndex() << " is " << outIt.Get()
+                << " instead of " << expectedIt.Get()[0] << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  return EXIT_SUCCESS;
+}
+
+int itkDiscreteGaussianImageFilterTest3(int, char* [])
+{
+  itk::MultiThreader::SetGlobalDefaultNumberOfThreads(4);
+
+  typedef itk::Image< float, 3 >         FloatImageType3D;
+  typedef itk::Image< unsigned char, 2 > CharImageType2D;
+  typedef itk::Image< float, 2 >         FloatImageType2D;
+
+  // Small volume, convolved at once
+  FloatImageType3D::SizeType  size3D = {{ 37, 29, 23 }};
+  FloatImageType3D::IndexType start3D = {{ 3, -2, 5 }};
+  FloatImageType3D::RegionType region3D(start3D, size3D);
+  const double variance3D[3] = { 2.0, 4.5, 1.0 };
+  for ( unsigned int filterDimensionality = 1; filterDimensionality <= 3; filterDimensionality++ )
+    {
+    if ( itkDiscreteGaussianImageFilterTest3Compare< FloatImageType3D, FloatImageType3D >(
+           size3D, start3D, region3D, variance3D, filterDimensionality) == EXIT_FAILURE )
+      {
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Requested region inside the image
+  FloatImageType3D::RegionType requested3D = region3D;
+  requested3D.ShrinkByRadius(6);
+  if ( itkDiscreteGaussianImageFilterTest3Compare< FloatImageType3D, FloatImageType3D >(
+         size3D, start3D, requested3D, variance3D, 3) == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Volume whose regions are convolved in several tiles
+  FloatImageType3D::SizeType  largeSize3D = {{ 96, 96, 64 }};
+  FloatImageType3D::IndexType largeStart3D = {{ 0, 0, 0 }};
+  FloatImageType3D::RegionType largeRegion3D(largeStart3D, largeSize3D);
+  const double largeVariance3D[3] = { 9.0, 9.0, 9.0 };
+  if ( itkDiscreteGaussianImageFilterTest3Compare< FloatImageType3D, FloatImageType3D >(
+         largeSize3D, largeStart3D, largeRegion3D, largeVariance3D, 3) == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Volume whose slices are convolved in several tiles
+  FloatImageType3D::SizeType  wideSize3D = {{ 300, 480, 4 }};
+  FloatImageType3D::RegionType wideRegion3D(largeStart3D, wideSize3D);
+  const double wideVariance3D[3] = { 4.0, 4.0, 1.0 };
+  if ( itkDiscreteGaussianImageFilterTest3Compare< FloatImageType3D, FloatImageType3D >(
+         wideSize3D, largeStart3D, wideRegion3D, wideVariance3D, 3) == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Input and output pixels of different types
+  CharImageType2D::SizeType  size2D = {{ 53, 41 }};
+  CharImageType2D::IndexType start2D = {{ -7, 11 }};
+  FloatImageType2D::RegionType region2D(start2D, size2D);
+  const double variance2D[2] = { 3.0, 0.5 };
+  if ( itkDiscreteGaussianImageFilterTest3Compare< CharImageType2D, FloatImageType2D >(
+         size2D, start2D, region2D, variance2D, 2) == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,170 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include <iostream>
+
+#include "itkMeanImageFilter.h"
+#include "itkNoiseImageFilter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkRandomImageSource.h"
+#include "itkMultiThreader.h"
+
+// Compares the means and the standard deviations computed from summed
+// area tables with the ones of the neighborhoods walked pixel by pixel,
+// the pixels outside the image being replaced by the nearest border
+// pixel. The pixels are drawn between minimum and maximum.
+template< class TInputImage >
+int itkMeanAndNoiseImageFiltersOnScalarImageCompare(
+  const typename TInputImage::SizeType & size,
+  const typename TInputImage::RegionType & requestedRegion,
+  const typename TInputImage::SizeType & radius,
+  double minimum = 0.0, double maximum = 255.0)
+{
+  const unsigned int Dimension = TInputImage::ImageDimension;
+
+  typedef itk::Image< float, Dimension > OutputImageType;
+
+  typedef itk::RandomImageSource< TInputImage > SourceType;
+  typename SourceType::Pointer source = SourceType::New();
+  source->SetSize(size);
+  source->SetMin(minimum);
+  source->SetMax(maximum);
+  source->Update();
+
+  typename TInputImage::Pointer input = source->GetOutput();
+  const typename TInputImage::RegionType region = input->GetLargestPossibleRegion();
+
+  typedef itk::MeanImageFilter< TInputImage, OutputImageType >  MeanFilterType;
+  typedef itk::NoiseImageFilter< TInputImage, OutputImageType > NoiseFilterType;
+
+  typename MeanFilterType::Pointer mean = MeanFilterType::New();
+  mean->SetInput(input);
+  mean->SetRadius(radius);
+  mean->GetOutput()->SetRequestedRegion(requestedRegion);
+  mean->Update();
+
+  typename NoiseFilterType::Pointer noise = NoiseFilterType::New();
+  noise->SetInput(input);
+  noise->SetRadius(radius);
+  noise->GetOutput()->SetRequestedRegion(requestedRegion);
+  noise->Update();
+
+  itk::SizeValueType neighborhoodSize = 1;
+  for ( unsigned int d = 0; d < Dimension; ++d )
+    {
+    neighborhoodSize *= 2 * radius[d] + 1;
+    }
+  const double num = neighborhoodSize;
+
+  itk::ImageRegionConstIteratorWithIndex< OutputImageType > meanIt(mean->GetOutput(), requestedRegion);
+  itk::ImageRegionConstIteratorWithIndex< OutputImageType > noiseIt(noise->GetOutput(), requestedRegion);
+  for (; !meanIt.IsAtEnd(); ++meanIt, ++noiseIt )
+    {
+    double sum = 0.0;
+    double sumOfSquares = 0.0;
+
+    for ( itk::SizeValueType n = 0; n < neighborhoodSize; ++n )
+      {
+      typename TInputImage::IndexType index = meanIt.GetIndex();
+      itk::SizeValueType              rest = n;
+      for ( unsigned int d = 0; d < Dimension; ++d )
+        {
+        index[d] += static_cast< itk::OffsetValueType >( rest % ( 2 * radius[d] + 1 ) )
+                    - static_cast< itk::OffsetValueType >( radius[d] );
+        rest /= 2 * radius[d] + 1;
+        index[d] = vnl_math_max( index[d], region.GetIndex(d) );
+        index[d] = vnl_math_min( index[d], region.GetUpperIndex()[d] );
+        }
+      const double value = input->GetPixel(index);
+      sum += value;
+      sumOfSquares += value * value;
+      }
+
+    const double expectedMean = sum / num;
+    const double expectedNoise = vcl_sqrt( vnl_math_max( ( sumOfSquares - sum * sum / num ) / ( num - 1.0 ), 0.0 ) );
+    // The means are rounded to float
+    if ( vcl_abs( meanIt.Get() - expectedMean ) > 1e-3 + 1e-6 * vcl_abs(expectedMean)
+         || vcl_abs( noiseIt.Get() - expectedNoise ) > 1e-3 )
+      {
+      std::cerr << "Test failed!" << std::endl;
+      std::cerr << "Radius " << radius << ": pixel " << meanIt.GetIndex()
+                << " mean is " << meanIt.Get() << " instead of " << expectedMean
+                << ", noise is " << noiseIt.Get() << " instead of " << expectedNoise << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  return EXIT_SUCCESS;
+}
+
+int itkMeanAndNoiseImageFiltersOnScalarImageTest(int, char* [])
+{
+  itk::MultiThreader::SetGlobalDefaultNumberOfThreads(4);
+
+  typedef itk::Image< unsigned char, 2 > ImageType2D;
+  typedef itk::Image< float, 3 >         ImageType3D;
+
+  ImageType2D::SizeType   size2D = {{ 45, 37 }};
+  ImageType2D::RegionType region2D;
+  region2D.SetSize(size2D);
+  ImageType2D::SizeType radius2D = {{ 1, 1 }};
+  if ( itkMeanAndNoiseImageFiltersOnScalarImageCompare< ImageType2D >(size2D, region2D, radius2D)
+       == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Large radii and a radius of zero
+  radius2D[0] = 0;
+  radius2D[1] = 12;
+  if ( itkMeanAndNoiseImageFiltersOnScalarImageCompare< ImageType2D >(size2D, region2D, radius2D)
+       == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Requested region inside the image
+  ImageType3D::SizeType   size3D = {{ 29, 21, 13 }};
+  ImageType3D::RegionType region3D;
+  region3D.SetSize(size3D);
+  ImageType3D::RegionType requested3D = region3D;
+  requested3D.ShrinkByRadius(4);
+  ImageType3D::SizeType radius3D = {{ 2, 3, 1 }};
+  if ( itkMeanAndNoiseImageFiltersOnScalarImageCompare< ImageType3D >(size3D, requested3D, radius3D)
+       == EXIT_FAILURE
+       || itkMeanAndNoiseImageFiltersOnScalarImageCompare< ImageType3D >(size3D, region3D, radius3D)
+       == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Small deviations on top of a large offset, over tables large enough
+  // for the sums of squares to lose them without a reference value
+  ImageType3D::SizeType largeSize3D = {{ 64, 64, 64 }};
+  ImageType3D::RegionType largeRegion3D;
+  largeRegion3D.SetSize(largeSize3D);
+  radius3D.Fill(1);
+  if ( itkMeanAndNoiseImageFiltersOnScalarImageCompare< ImageType3D >(largeSize3D, largeRegion3D, radius3D,
+                                                                      100000.0, 100001.0)
+       == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -18,8 +18,67 @@
 
 #include "itkRandomImageSource.h"
 #include "itkMedianImageFilter.h"
+#include "itkCastImageFilter.h"
 #include "itkTextOutput.h"
 
+namespace
+{
+// Compare the sliding histogram median of a short image with the median
+// selected in each neighborhood of the same image converted to float.
+template< unsigned int VDimension >
+bool MedianImageFilterCompareHistogramToSelection( unsigned long radius0, unsigned long radius1 )
+{
+  typedef itk::Image< short, VDimension > ShortImageType;
+  typedef itk::Image< float, VDimension > FloatImageType;
+
+  typename itk::RandomImageSource< ShortImageType >::Pointer random =
+    itk::RandomImageSource< ShortImageType >::New();
+  random->SetMin( -500 );
+  random->SetMax( 500 );
+  typename ShortImageType::SizeValueType randomSize[VDimension];
+  for( unsigned int d = 0; d < VDimension; ++d )
+    {
+    randomSize[d] = 9 + d;
+    }
+  random->SetSize( randomSize );
+
+  typedef itk::CastImageFilter< ShortImageType, FloatImageType > CastType;
+  typename CastType::Pointer cast = CastType::New();
+  cast->SetInput( random->GetOutput() );
+
+  typename ShortImageType::SizeType radius;
+  radius.Fill( radius1 );
+  radius[0] = radius0;
+
+  typedef itk::MedianImageFilter< ShortImageType, ShortImageType > ShortMedianType;
+  typename ShortMedianType::Pointer shortMedian = ShortMedianType::New();
+  shortMedian->SetInput( random->GetOutput() );
+  shortMedian->SetRadius( radius );
+  shortMedian->Update();
+
+  typedef itk::MedianImageFilter< FloatImageType, FloatImageType > FloatMedianType;
+  typename FloatMedianType::Pointer floatMedian = FloatMedianType::New();
+  floatMedian->SetInput( cast->GetOutput() );
+  floatMedian->SetRadius( radius );
+  floatMedian->Update();
+
+  itk::ImageRegionConstIterator< ShortImageType > sit( shortMedian->GetOutput(),
+    shortMedian->GetOutput()->GetBufferedRegion() );
+  itk::ImageRegionConstIterator< FloatImageType > fit( floatMedian->GetOutput(),
+    floatMedian->GetOutput()->GetBufferedRegion() );
+  for( ; !sit.IsAtEnd(); ++sit, ++fit )
+    {
+    if( static_cast< float >( sit.Get() ) != fit.Get() )
+      {
+      std::cerr << "Histogram median " << sit.Get() << " differs from selected median "
+                << fit.Get() << " at " << sit.GetIndex() << " with radius " << radius << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
 
 int itkMedianImageFilterTest(int, char* [] )
 {
@@ -88,6 +147,15 @@ int itkMedianImageFilterTest(int, char* [] )
   const FloatImage2DType::SizeType & radius = median->GetRadius();
   std::cout << "median->GetRadius():" << radius << std::endl;
 
+  // The integer pixel types use a sliding histogram, check it against the
+  // selection used for the other pixel types.
+  if( !MedianImageFilterCompareHistogramToSelection< 2 >( 0, 1 )
+      || !MedianImageFilterCompareHistogramToSelection< 2 >( 1, 1 )
+      || !MedianImageFilterCompareHistogramToSelection< 2 >( 3, 2 )
+      || !MedianImageFilterCompareHistogramToSelection< 3 >( 2, 1 ) )
+    {
+    return EXIT_FAILURE;
+    }
 
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,167 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include <iostream>
+
+#include "itkRecursiveGaussianImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkRandomImageSource.h"
+#include "itkMultiThreader.h"
+
+// Compares the filtering of an image of scalars, whose lines are
+// filtered in bundles, with the one of the same image of vectors of one
+// component, whose lines are filtered one at a time.
+template< class TImage >
+int itkRecursiveGaussianImageFiltersOnScalarImageCompare(
+  const typename TImage::SizeType & size,
+  const typename TImage::RegionType & requestedRegion,
+  bool inPlace)
+{
+  const unsigned int Dimension = TImage::ImageDimension;
+
+  typedef itk::Vector< float, 1 >                  VectorPixelType;
+  typedef itk::Image< VectorPixelType, Dimension > VectorImageType;
+
+  typedef itk::RandomImageSource< TImage > SourceType;
+  typename SourceType::Pointer source = SourceType::New();
+  source->SetSize(size);
+  source->SetMin(0);
+  source->SetMax(255);
+  source->Update();
+
+  typename TImage::Pointer input = source->GetOutput();
+  input->DisconnectPipeline();
+  typename TImage::RegionType region = input->GetLargestPossibleRegion();
+
+  typename VectorImageType::Pointer vectorInput = VectorImageType::New();
+  vectorInput->SetRegions(region);
+  vectorInput->Allocate();
+  itk::ImageRegionConstIterator< TImage >     inIt(input, region);
+  itk::ImageRegionIterator< VectorImageType > vectorIt(vectorInput, region);
+  for (; !inIt.IsAtEnd(); ++inIt, ++vectorIt )
+    {
+    VectorPixelType value;
+    value[0] = inIt.Get();
+    vectorIt.Set(value);
+    }
+
+  typedef itk::RecursiveGaussianImageFilter< TImage, TImage >                   FilterType;
+  typedef itk::RecursiveGaussianImageFilter< VectorImageType, VectorImageType > VectorFilterType;
+
+  for ( unsigned int direction = 0; direction < Dimension; direction++ )
+    {
+    for ( int order = FilterType::ZeroOrder; order <= FilterType::SecondOrder; order++ )
+      {
+      typename VectorFilterType::Pointer vectorFilter = VectorFilterType::New();
+      vectorFilter->SetInput(vectorInput);
+      vectorFilter->SetDirection(direction);
+      vectorFilter->SetOrder( static_cast< typename VectorFilterType::OrderEnumType >( order ) );
+      vectorFilter->SetSigma(2.5);
+      vectorFilter->GetOutput()->SetRequestedRegion(requestedRegion);
+      vectorFilter->Update();
+
+      // The filter running in place overwrites its input
+      typename TImage::Pointer filterInput = input;
+      if ( inPlace )
+        {
+        filterInput = TImage::New();
+        filterInput->SetRegions(region);
+        filterInput->Allocate();
+        itk::ImageRegionConstIterator< TImage > copyInIt(input, region);
+        itk::ImageRegionIterator< TImage >      copyOutIt(filterInput, region);
+        for (; !copyInIt.IsAtEnd(); ++copyInIt, ++copyOutIt )
+          {
+          copyOutIt.Set( copyInIt.Get() );
+          }
+        }
+
+      typename FilterType::Pointer filter = FilterType::New();
+      filter->SetInput(filterInput);
+      filter->SetInPlace(inPlace);
+      filter->SetDirection(direction);
+      filter->SetOrder( static_cast< typename FilterType::OrderEnumType >( order ) );
+      filter->SetSigma(2.5);
+      filter->GetOutput()->SetRequestedRegion(requestedRegion);
+      filter->Update();
+
+      const typename TImage::RegionType & outputRegion = filter->GetOutput()->GetBufferedRegion();
+      if ( outputRegion != vectorFilter->GetOutput()->GetBufferedRegion() )
+        {
+        std::cerr << "Test failed!" << std::endl;
+        std::cerr << "Buffered region " << outputRegion << " instead of "
+                  << vectorFilter->GetOutput()->GetBufferedRegion() << std::endl;
+        return EXIT_FAILURE;
+        }
+
+      itk::ImageRegionConstIterator< TImage >          outIt(filter->GetOutput(), requestedRegion);
+      itk::ImageRegionConstIterator< VectorImageType > expectedIt(vectorFilter->GetOutput(), requestedRegion);
+      for (; !outIt.IsAtEnd(); ++outIt, ++expectedIt )
+        {
+        if ( vcl_abs( outIt.Get() - expectedIt.Get()[0] ) > 1e-3 )
+          {
+          std::cerr << "Test failed!" << std::endl;
+          std::cerr << "Direction " << direction << ", order " << order
+                    << ": pixel " << outIt.GetIndex() << " is " << outIt.Get()
+                    << " instead of " << expectedIt.Get()[0] << std::endl;
+          return EXIT_FAILURE;
+          }
+        }
+      }
+    }
+  return EXIT_SUCCESS;
+}
+
+int itkRecursiveGaussianImageFiltersOnScalarImageTest(int, char* [])
+{
+  itk::MultiThreader::SetGlobalDefaultNumberOfThreads(4);
+
+  typedef itk::Image< float, 2 > ImageType2D;
+  typedef itk::Image< float, 3 > ImageType3D;
+
+  // Lines not a multiple of the bundles
+  ImageType2D::SizeType   size2D = {{ 45, 37 }};
+  ImageType2D::RegionType region2D;
+  region2D.SetSize(size2D);
+  if ( itkRecursiveGaussianImageFiltersOnScalarImageCompare< ImageType2D >(size2D, region2D, false)
+       == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Requested region inside the image
+  ImageType3D::SizeType   size3D = {{ 29, 21, 13 }};
+  ImageType3D::RegionType region3D;
+  region3D.SetSize(size3D);
+  ImageType3D::RegionType requested3D = region3D;
+  requested3D.ShrinkByRadius(4);
+  if ( itkRecursiveGaussianImageFiltersOnScalarImageCompare< ImageType3D >(size3D, requested3D, false)
+       == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Filter running in place
+  if ( itkRecursiveGaussianImageFiltersOnScalarImageCompare< ImageType3D >(size3D, region3D, true)
+       == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
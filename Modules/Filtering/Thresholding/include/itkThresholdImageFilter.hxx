@@ -30,6 +30,7 @@
 
 #include "itkThresholdImageFilter.h"
 #include "itkImageRegionIterator.h"
+#include "itkImageScanlineIterator.h"
 #include "itkNumericTraits.h"
 #include "itkObjectFactory.h"
 #include "itkProgressReporter.h"
@@ -142,31 +143,43 @@ ThresholdImageFilter< TImage >
 
   // Define/declare an iterator that will walk the output region for this
   // thread.
-  typedef ImageRegionConstIterator< TImage > InputIterator;
-  typedef ImageRegionIterator< TImage >      OutputIterator;
+  typedef ImageScanlineConstIterator< TImage > InputIterator;
+  typedef ImageScanlineIterator< TImage >      OutputIterator;
 
   InputIterator  inIt(inputPtr, outputRegionForThread);
   OutputIterator outIt(outputPtr, outputRegionForThread);
 
+  const typename OutputImageRegionType::SizeType & regionSize = outputRegionForThread.GetSize();
+  if ( regionSize[0] == 0 )
+    {
+    return;
+    }
+  const SizeValueType numberOfLinesToProcess = outputRegionForThread.GetNumberOfPixels() / regionSize[0];
+
   // support progress methods/callbacks
-  ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
+  ProgressReporter progress( this, threadId, numberOfLinesToProcess );
 
   // walk the regions, threshold each pixel
   while ( !outIt.IsAtEnd() )
     {
-    const PixelType value = inIt.Get();
-    if ( m_Lower <= value && value <= m_Upper )
-      {
-      // pixel passes to output unchanged and is replaced by m_OutsideValue in
-      // the inverse output image
-      outIt.Set( inIt.Get() );
-      }
-    else
+    while ( !outIt.IsAtEndOfLine() )
       {
-      outIt.Set(m_OutsideValue);
+      const PixelType value = inIt.Get();
+      if ( m_Lower <= value && value <= m_Upper )
+        {
+        // pixel passes to output unchanged and is replaced by m_OutsideValue in
+        // the inverse output image
+        outIt.Set( value );
+        }
+      else
+        {
+        outIt.Set(m_OutsideValue);
+        }
+      ++inIt;
+      ++outIt;
       }
-    ++inIt;
-    ++outIt;
+    inIt.NextLine();
+    outIt.NextLine();
     progress.CompletedPixel();
     }
 }
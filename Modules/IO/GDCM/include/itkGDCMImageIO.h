@@ -106,7 +106,9 @@ public:
   /** Set the spacing and dimesion information for the current filename. */
   virtual void ReadImageInformation();
 
-  /** Reads the data from disk into the memory buffer provided. */
+  /** Reads the data from disk into the memory buffer provided. The
+   * frames of encapsulated multi-frame images holding one fragment per
+   * frame are decoded on several threads. */
   virtual void Read(void *buffer);
 
   /** Get the original component type of the image. This differs from
@@ -278,6 +280,10 @@ protected:
 
   void InternalReadImageInformation(std::ifstream & file);
 
+  /** Returns a GDCMImageIO with the same reading and writing options, so
+   * that the slices of a series can be read concurrently. */
+  virtual LightObject::Pointer InternalClone() const;
+
   double m_RescaleSlope;
   double m_RescaleIntercept;
 
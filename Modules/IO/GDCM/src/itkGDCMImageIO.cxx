@@ -34,6 +34,7 @@
 #include "vnl/vnl_cross.h"
 
 #include "itkMetaDataObject.h"
+#include "itkMultiThreader.h"
 
 #include "itksys/SystemTools.hxx"
 #include "itksys/Base64.h"
@@ -51,8 +52,10 @@
 #include "gdcmUIDGenerator.h"
 #include "gdcmAttribute.h"
 #include "gdcmGlobal.h"
+#include "gdcmSequenceOfFragments.h"
 
 #include <fstream>
+#include <algorithm>
 
 namespace itk
 {
@@ -238,6 +241,102 @@ bool GDCMImageIO::CanReadFile(const char *filename)
   return false;
 }
 
+namespace
+{
+/** The frames of a multi-frame image, each one a 2D image of its own, and
+ * where they are decoded. */
+struct DecodeFramesThreadStruct {
+  std::vector< gdcm::Image > Frames;
+  char *                     Buffer;
+  SizeValueType              FrameLength;
+  std::vector< char >        Decoded;
+};
+
+ITK_THREAD_RETURN_TYPE DecodeFramesThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  DecodeFramesThreadStruct *       str = static_cast< DecodeFramesThreadStruct * >( info->UserData );
+
+  // The frames are shared round robin, every thread decoding its own
+  // frames with its own codec.
+  for ( size_t i = info->ThreadID; i < str->Frames.size(); i += info->NumberOfThreads )
+    {
+    str->Decoded[i] = str->Frames[i].GetBuffer(str->Buffer + i * str->FrameLength);
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+/** Returns true when the pixel data of image holds one compressed
+ * fragment per frame, which can then be decoded independently. Palette
+ * images and images holding overlays in their pixel data are decoded by
+ * gdcm as a whole. */
+bool CanDecodeFramesIndependently(const gdcm::Image & image)
+{
+  if ( image.GetNumberOfDimensions() != 3
+       || image.GetDimension(2) < 2
+       || image.GetPlanarConfiguration() != 0
+       || image.AreOverlaysInPixelData()
+       || image.GetPhotometricInterpretation() == gdcm::PhotometricInterpretation::PALETTE_COLOR )
+    {
+    return false;
+    }
+  const gdcm::SequenceOfFragments *sf = image.GetDataElement().GetSequenceOfFragments();
+  return sf && sf->GetNumberOfFragments() == image.GetDimension(2);
+}
+
+/** Decodes the frames of image on several threads, directly into buffer.
+ * The compressed fragments are copied to the frames first, so that the
+ * threads share no reference counted gdcm object. */
+bool DecodeFrames(const gdcm::Image & image, char *buffer)
+{
+  const gdcm::SequenceOfFragments *sf = image.GetDataElement().GetSequenceOfFragments();
+  const unsigned int               numberOfFrames = image.GetDimension(2);
+
+  DecodeFramesThreadStruct str;
+  str.Buffer = buffer;
+  str.FrameLength = image.GetBufferLength() / numberOfFrames;
+  str.Decoded.resize(numberOfFrames, 0);
+  str.Frames.resize(numberOfFrames, image);
+  for ( unsigned int i = 0; i < numberOfFrames; ++i )
+    {
+    const gdcm::ByteValue *bv = sf->GetFragment(i).GetByteValue();
+    if ( !bv )
+      {
+      return false;
+      }
+    gdcm::Fragment frag;
+    frag.SetByteValue( bv->GetPointer(), bv->GetLength() );
+    gdcm::SmartPointer< gdcm::SequenceOfFragments > fragments = new gdcm::SequenceOfFragments;
+    fragments->AddFragment(frag);
+
+    gdcm::DataElement pixelData( image.GetDataElement().GetTag() );
+    pixelData.SetVR( image.GetDataElement().GetVR() );
+    pixelData.SetValue(*fragments);
+    pixelData.SetVLToUndefined();
+
+    gdcm::Image & frame = str.Frames[i];
+    frame.SetNumberOfDimensions(2);
+    frame.SetDataElement(pixelData);
+    frame.SetLUT( *new gdcm::LookupTable );
+    }
+
+  MultiThreader::Pointer threader = MultiThreader::New();
+  threader->SetNumberOfThreads( std::min( threader->GetNumberOfThreads(),
+                                          static_cast< ThreadIdType >( numberOfFrames ) ) );
+  threader->SetSingleMethod(DecodeFramesThreaderCallback, &str);
+  threader->SingleMethodExecute();
+
+  for ( unsigned int i = 0; i < numberOfFrames; ++i )
+    {
+    if ( !str.Decoded[i] )
+      {
+      return false;
+      }
+    }
+  return true;
+}
+} // end anonymous namespace
+
 void GDCMImageIO::Read(void *pointer)
 {
   const char *filename = m_FileName.c_str();
@@ -277,7 +376,14 @@ void GDCMImageIO::Read(void *pointer)
     len *= 3;
     }
 
-  if ( !image.GetBuffer( (char*)pointer ) )
+  if ( CanDecodeFramesIndependently(image) )
+    {
+    if ( !DecodeFrames( image, (char*)pointer ) )
+      {
+      itkExceptionMacro(<< "Failed to get the buffer!");
+      }
+    }
+  else if ( !image.GetBuffer( (char*)pointer ) )
     {
     itkExceptionMacro(<< "Failed to get the buffer!");
     return;
@@ -1185,6 +1291,25 @@ bool GDCMImageIO::GetLabelFromTag(const std::string & tag,
   return false;
 }
 
+LightObject::Pointer GDCMImageIO::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+  Self::Pointer        rval = dynamic_cast< Self * >( loPtr.GetPointer() );
+  if ( rval.IsNull() )
+    {
+    itkExceptionMacro(<< "downcast to type "
+                      << this->GetNameOfClass()
+                      << " failed.");
+    }
+
+  rval->SetUIDPrefix(m_UIDPrefix);
+  rval->SetKeepOriginalUID(m_KeepOriginalUID);
+  rval->SetLoadPrivateTags(m_LoadPrivateTags);
+  rval->SetCompressionType(m_CompressionType);
+
+  return loPtr;
+}
+
 void GDCMImageIO::PrintSelf(std::ostream & os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
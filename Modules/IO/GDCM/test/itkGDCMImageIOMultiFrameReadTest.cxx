@@ -0,0 +1,209 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageSeriesReader.h"
+#include "itkGDCMImageIO.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkMetaDataObject.h"
+#include "itkRandomImageSource.h"
+#include "itkExtractImageFilter.h"
+#include <sstream>
+
+// Writes a compressed multi-frame file and a compressed series, and
+// checks that they are decoded identically when their frames and slices
+// are read on several threads.
+
+typedef itk::Image< short, 3 > Image3DType;
+typedef itk::Image< short, 2 > Image2DType;
+
+static bool SameImages(const Image3DType *a, const Image3DType *b)
+{
+  if ( a->GetLargestPossibleRegion().GetSize() != b->GetLargestPossibleRegion().GetSize() )
+    {
+    std::cerr << "Size mismatch: " << a->GetLargestPossibleRegion().GetSize()
+              << " != " << b->GetLargestPossibleRegion().GetSize() << std::endl;
+    return false;
+    }
+  itk::ImageRegionConstIterator< Image3DType > ita( a, a->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator< Image3DType > itb( b, b->GetLargestPossibleRegion() );
+  for (; !ita.IsAtEnd(); ++ita, ++itb )
+    {
+    if ( ita.Get() != itb.Get() )
+      {
+      std::cerr << "Pixel mismatch at " << ita.GetIndex() << ": "
+                << ita.Get() << " != " << itb.Get() << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+int itkGDCMImageIOMultiFrameReadTest( int argc, char* argv[] )
+{
+  if( argc < 2 )
+    {
+    std::cerr << "Usage: " << argv[0] <<
+      " OutputTestDirectory" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  typedef itk::RandomImageSource< Image3DType >         RandomImageSourceType;
+  typedef itk::ImageFileWriter< Image3DType >           WriterType;
+  typedef itk::ImageFileReader< Image3DType >           ReaderType;
+  typedef itk::ImageSeriesReader< Image3DType >         SeriesReaderType;
+  typedef itk::ExtractImageFilter< Image3DType, Image2DType > ExtractType;
+  typedef itk::ImageFileWriter< Image2DType >           Writer2DType;
+  typedef itk::GDCMImageIO                              ImageIOType;
+
+  // Several threads even on a single processor
+  itk::MultiThreader::SetGlobalDefaultNumberOfThreads(4);
+
+  // The options of the ImageIO are kept by its clones.
+  ImageIOType::Pointer gdcmIO = ImageIOType::New();
+  gdcmIO->SetCompressionType(ImageIOType::JPEG);
+  gdcmIO->KeepOriginalUIDOn();
+  gdcmIO->LoadPrivateTagsOn();
+  gdcmIO->SetUIDPrefix("1.2.3");
+  gdcmIO->UseCompressionOn();
+  ImageIOType::Pointer clone = dynamic_cast< ImageIOType * >( gdcmIO->Clone().GetPointer() );
+  if ( clone.IsNull()
+       || clone->GetCompressionType() != ImageIOType::JPEG
+       || !clone->GetKeepOriginalUID()
+       || !clone->GetLoadPrivateTags()
+       || clone->GetUIDPrefix() != std::string("1.2.3")
+       || !clone->GetUseCompression() )
+    {
+    std::cerr << "The clone of the ImageIO lost its options" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  Image3DType::SizeType size;
+  size[0] = 32;
+  size[1] = 24;
+  size[2] = 7;
+
+  RandomImageSourceType::Pointer source = RandomImageSourceType::New();
+  source->SetMin(0);
+  source->SetMax(1000);
+  source->SetSize(size);
+  source->Update();
+  Image3DType::Pointer volume = source->GetOutput();
+
+  // GDCM will not write the geometry of the frames unless the modality
+  // is one of CT, MR or RT.
+  itk::MetaDataDictionary dictionary;
+  itk::EncapsulateMetaData< std::string >(dictionary, "0008|0060", "CT");
+  volume->SetMetaDataDictionary(dictionary);
+
+  const ImageIOType::TCompressionType compressionTypes[] = { ImageIOType::JPEG, ImageIOType::JPEG2000 };
+  for ( unsigned int c = 0; c < 2; ++c )
+    {
+    std::ostringstream filename;
+    filename << argv[1] << "/itkGDCMImageIOMultiFrameReadTest" << c << ".dcm";
+
+    ImageIOType::Pointer writeIO = ImageIOType::New();
+    writeIO->SetCompressionType(compressionTypes[c]);
+
+    WriterType::Pointer writer = WriterType::New();
+    writer->SetInput(volume);
+    writer->SetImageIO(writeIO);
+    writer->UseCompressionOn();
+    writer->SetFileName( filename.str() );
+
+    ReaderType::Pointer reader = ReaderType::New();
+    reader->SetImageIO( ImageIOType::New() );
+    reader->SetFileName( filename.str() );
+    try
+      {
+      writer->Update();
+      reader->Update();
+      }
+    catch( itk::ExceptionObject & excp )
+      {
+      std::cerr << excp << std::endl;
+      return EXIT_FAILURE;
+      }
+    if ( !SameImages( volume, reader->GetOutput() ) )
+      {
+      std::cerr << "Failed to read " << filename.str() << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // A series of compressed slices read with one ImageIO
+  SeriesReaderType::FileNamesContainer fileNames;
+  for ( unsigned int k = 0; k < size[2]; ++k )
+    {
+    Image3DType::RegionType sliceRegion = volume->GetLargestPossibleRegion();
+    sliceRegion.SetIndex(2, k);
+    sliceRegion.SetSize(2, 0);
+
+    ExtractType::Pointer extract = ExtractType::New();
+    extract->SetInput(volume);
+    extract->SetExtractionRegion(sliceRegion);
+    extract->SetDirectionCollapseToIdentity();
+
+    std::ostringstream filename;
+    filename << argv[1] << "/itkGDCMImageIOMultiFrameReadTest_slice" << k << ".dcm";
+    fileNames.push_back( filename.str() );
+
+    Writer2DType::Pointer writer = Writer2DType::New();
+    writer->SetInput( extract->GetOutput() );
+    writer->SetImageIO(gdcmIO);
+    writer->UseCompressionOn();
+    writer->SetFileName( filename.str() );
+    try
+      {
+      writer->Update();
+      }
+    catch( itk::ExceptionObject & excp )
+      {
+      std::cerr << excp << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  SeriesReaderType::Pointer seriesReader = SeriesReaderType::New();
+  seriesReader->SetImageIO( ImageIOType::New() );
+  seriesReader->SetFileNames(fileNames);
+  seriesReader->SetNumberOfReadingThreads(3);
+  try
+    {
+    seriesReader->Update();
+    }
+  catch( itk::ExceptionObject & excp )
+    {
+    std::cerr << excp << std::endl;
+    return EXIT_FAILURE;
+    }
+  if ( !SameImages( volume, seriesReader->GetOutput() ) )
+    {
+    std::cerr << "Failed to read the series" << std::endl;
+    return EXIT_FAILURE;
+    }
+  if ( seriesReader->GetMetaDataDictionaryArray()->size() != size[2] )
+    {
+    std::cerr << "Expected " << size[2] << " dictionaries, got "
+              << seriesReader->GetMetaDataDictionaryArray()->size() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -126,9 +126,48 @@ public:
   virtual void WriteImageInformation();
 
   /** Writes the data to disk from the memory buffer provided. Make sure
-   * that the IORegions has been set properly. */
+   * that the IORegions has been set properly. When a paste region smaller
+   * than the image was requested, it is pasted into the voxel data of an
+   * existing file; otherwise the file is created anew, even when the
+   * image is written in several pieces. */
   virtual void Write(const void *buffer);
 
+  /** Records whether the paste region is smaller than the image, after
+   * checking the file to paste into as the superclass does. */
+  virtual unsigned int GetActualNumberOfSplitsForWriting(unsigned int numberOfRequestedSplits,
+                                                         const ImageIORegion & pasteRegion,
+                                                         const ImageIORegion & largestPossibleRegion);
+
+  /*-------- This part of the interfaces deals with the voxel data layout. ----- */
+
+  typedef std::vector< SizeValueType > ChunkSizeType;
+
+  /** The voxel data is written in chunks of this size, given in the ITK
+   * order of the dimensions. Only the chunks overlapping a region are
+   * read or written. A size of zero, or a missing dimension, spans the
+   * whole image. When empty, the default, each chunk holds one slice of
+   * the image. */
+  void SetChunkSize(const ChunkSizeType & chunkSize);
+  itkGetConstReferenceMacro(ChunkSize, ChunkSizeType);
+
+  /** Deflate level of the chunks, from 0, which disables the
+   * compression, to 9. The default is 5. */
+  itkSetClampMacro(CompressionLevel, int, 0, 9);
+  itkGetConstMacro(CompressionLevel, int);
+
+  /** Shuffle the bytes of the voxels before deflating them, which
+   * usually compresses multi-byte components better. Off by default. */
+  itkSetMacro(UseShuffle, bool);
+  itkGetConstMacro(UseShuffle, bool);
+  itkBooleanMacro(UseShuffle);
+
+  /** Size in bytes of the cache of chunks kept by HDF5 for the open
+   * file. Regions read or written piece by piece should be given a
+   * cache holding the chunks shared by consecutive pieces. Zero, the
+   * default, keeps the HDF5 default of 1 MiB. */
+  itkSetMacro(ChunkCacheSize, SizeValueType);
+  itkGetConstMacro(ChunkCacheSize, SizeValueType);
+
 protected:
   HDF5ImageIO();
   ~HDF5ImageIO();
@@ -186,9 +225,16 @@ private:
                        unsigned long numElements);
   void SetupStreaming(H5::DataSpace *imageSpace,
                       H5::DataSpace *slabSpace);
+  void CloseH5File();
   H5::H5File  *m_H5File;
   H5::DataSet *m_VoxelDataSet;
   bool         m_ImageInformationWritten;
+  bool         m_PasteRequested;
+
+  ChunkSizeType m_ChunkSize;
+  int           m_CompressionLevel;
+  bool          m_UseShuffle;
+  SizeValueType m_ChunkCacheSize;
 };
 } // end namespace itk
 
@@ -27,21 +27,34 @@ namespace itk
 
 HDF5ImageIO::HDF5ImageIO() : m_H5File(0),
                              m_VoxelDataSet(0),
-                             m_ImageInformationWritten(false)
+                             m_ImageInformationWritten(false),
+                             m_PasteRequested(false),
+                             m_CompressionLevel(5),
+                             m_UseShuffle(false),
+                             m_ChunkCacheSize(0)
 {
 }
 
 HDF5ImageIO::~HDF5ImageIO()
+{
+  this->CloseH5File();
+}
+
+void
+HDF5ImageIO
+::CloseH5File()
 {
   if(this->m_VoxelDataSet != 0)
     {
     m_VoxelDataSet->close();
     delete m_VoxelDataSet;
+    this->m_VoxelDataSet = 0;
     }
   if(this->m_H5File != 0)
     {
     this->m_H5File->close();
     delete this->m_H5File;
+    this->m_H5File = 0;
     }
 }
 
@@ -52,6 +65,26 @@ HDF5ImageIO
   Superclass::PrintSelf(os, indent);
   // just prints out the pointer value.
   os << indent << "H5File: " << this->m_H5File << std::endl;
+  os << indent << "ChunkSize: [";
+  for(unsigned int i = 0; i < this->m_ChunkSize.size(); i++)
+    {
+    os << (i == 0 ? "" : ", ") << this->m_ChunkSize[i];
+    }
+  os << "]" << std::endl;
+  os << indent << "CompressionLevel: " << this->m_CompressionLevel << std::endl;
+  os << indent << "UseShuffle: " << this->m_UseShuffle << std::endl;
+  os << indent << "ChunkCacheSize: " << this->m_ChunkCacheSize << std::endl;
+}
+
+void
+HDF5ImageIO
+::SetChunkSize(const ChunkSizeType & chunkSize)
+{
+  if(this->m_ChunkSize != chunkSize)
+    {
+    this->m_ChunkSize = chunkSize;
+    this->Modified();
+    }
 }
 
 //
@@ -69,6 +102,30 @@ const std::string VoxelType("/VoxelType");
 const std::string VoxelData("/VoxelData");
 const std::string MetaDataName("/MetaData");
 
+//
+// file access properties giving the chunk cache its size, zero
+// keeping the HDF5 default.
+H5::FileAccPropList
+ChunkCacheAccessPropList(size_t cacheSize)
+{
+  H5::FileAccPropList plist;
+  if(cacheSize > 0)
+    {
+    int    mdcElements;
+    size_t slots;
+    size_t bytes;
+    double w0;
+    plist.getCache(mdcElements,slots,bytes,w0);
+    // keep the number of hash slots in proportion with the cache size
+    if(cacheSize > bytes)
+      {
+      slots = ( slots * ( cacheSize / bytes ) ) | 1;
+      }
+    plist.setCache(mdcElements,slots,cacheSize,w0);
+    }
+  return plist;
+}
+
 template <typename TScalar>
 H5::PredType GetType()
 {
@@ -667,8 +724,11 @@ HDF5ImageIO
 {
   try
     {
+    this->CloseH5File();
     this->m_H5File = new H5::H5File(this->GetFileName(),
-                                    H5F_ACC_RDONLY);
+                                    H5F_ACC_RDONLY,
+                                    H5::FileCreatPropList::DEFAULT,
+                                    ChunkCacheAccessPropList(this->m_ChunkCacheSize));
 
     // not sure what to do with this initially
     //eventually it will be needed if the file versions change
@@ -1016,8 +1076,11 @@ HDF5ImageIO
 
   try
     {
+    this->CloseH5File();
     this->m_H5File = new H5::H5File(this->GetFileName(),
-                                    H5F_ACC_TRUNC);
+                                    H5F_ACC_TRUNC,
+                                    H5::FileCreatPropList::DEFAULT,
+                                    ChunkCacheAccessPropList(this->m_ChunkCacheSize));
     this->WriteString(ItkVersion,
                       Version::GetITKVersion());
 
@@ -1216,7 +1279,15 @@ void
 HDF5ImageIO
 ::Write(const void *buffer)
 {
-  this->WriteImageInformation();
+  // A paste region smaller than the image is pasted into the voxel data
+  // of an existing file, whose header was checked against this image by
+  // GetActualNumberOfSplitsForWriting. Otherwise, the file is created for
+  // the first piece and the next streamed pieces are written to it.
+  const bool pasting = !this->m_ImageInformationWritten
+    && this->m_PasteRequested
+    && this->RequestedToStream()
+    && itksys::SystemTools::FileExists(this->GetFileName());
+
   try
     {
     int numComponents = this->GetNumberOfComponents();
@@ -1224,14 +1295,32 @@ HDF5ImageIO
     // HDF5 dimensions listed slowest moving first, ITK are fastest
     // moving first.
     hsize_t *dims = new hsize_t[numDims + (numComponents == 1 ? 0 : 1)];
+    hsize_t *chunkDims = new hsize_t[numDims + (numComponents == 1 ? 0 : 1)];
 
     for(int i(0), j(numDims-1); i < numDims; i++, j--)
       {
       dims[j] = this->m_Dimensions[i];
+      // by default a chunk is a slice: the whole image but the slowest
+      // moving dimension
+      if(this->m_ChunkSize.empty())
+        {
+        chunkDims[j] = (i == numDims - 1 && numDims > 1) ? 1 : dims[j];
+        }
+      else if(static_cast<size_t>(i) < this->m_ChunkSize.size()
+              && this->m_ChunkSize[i] > 0
+              && this->m_ChunkSize[i] < dims[j])
+        {
+        chunkDims[j] = this->m_ChunkSize[i];
+        }
+      else
+        {
+        chunkDims[j] = dims[j];
+        }
       }
     if(numComponents > 1)
       {
       dims[numDims] = numComponents;
+      chunkDims[numDims] = numComponents;
       numDims++;
       }
 
@@ -1240,18 +1329,34 @@ HDF5ImageIO
     std::string VoxelDataName(ImageGroup);
     VoxelDataName += "/0";
     VoxelDataName += VoxelData;
-    // set up properties for chunked, compressed writes.
-    // in this case, set the chunk size to be the N-1 dimension
-    // region
-    H5::DSetCreatPropList plist;
-    plist.setDeflate(5);
-    dims[0] = 1;
-    plist.setChunk(numDims,dims);
 
     //
     // Create DataSet Once, potentially write to it many times
-    if(this->m_VoxelDataSet == 0)
+    if(pasting)
+      {
+      this->CloseH5File();
+      this->m_H5File = new H5::H5File(this->GetFileName(),
+                                      H5F_ACC_RDWR,
+                                      H5::FileCreatPropList::DEFAULT,
+                                      ChunkCacheAccessPropList(this->m_ChunkCacheSize));
+      this->m_VoxelDataSet = new H5::DataSet();
+      *(this->m_VoxelDataSet) = this->m_H5File->openDataSet(VoxelDataName);
+      this->m_ImageInformationWritten = true;
+      }
+    else if(this->m_VoxelDataSet == 0)
       {
+      this->WriteImageInformation();
+      // set up properties for chunked, compressed writes.
+      H5::DSetCreatPropList plist;
+      plist.setChunk(numDims,chunkDims);
+      if(this->m_UseShuffle)
+        {
+        plist.setShuffle();
+        }
+      if(this->m_CompressionLevel > 0)
+        {
+        plist.setDeflate(this->m_CompressionLevel);
+        }
       this->m_VoxelDataSet = new H5::DataSet();
       *(this->m_VoxelDataSet) = this->m_H5File->createDataSet(VoxelDataName,
                                                               dataType,
@@ -1260,6 +1365,7 @@ HDF5ImageIO
     H5::DataSpace dspace;
     this->SetupStreaming(&imageSpace,&dspace);
     this->m_VoxelDataSet->write(buffer,dataType,dspace,imageSpace);
+    delete [] chunkDims;
     delete [] dims;
     }
   // catch failure caused by the H5File operations
@@ -1282,6 +1388,23 @@ HDF5ImageIO
     {
     itkExceptionMacro(<< error.getCDetailMsg());
     }
+  // catch failure caused by the property lists
+  catch( H5::PropListIException & error )
+    {
+    itkExceptionMacro(<< error.getCDetailMsg());
+    }
+}
+
+unsigned int
+HDF5ImageIO
+::GetActualNumberOfSplitsForWriting(unsigned int numberOfRequestedSplits,
+                                    const ImageIORegion & pasteRegion,
+                                    const ImageIORegion & largestPossibleRegion)
+{
+  this->m_PasteRequested = ( pasteRegion != largestPossibleRegion );
+  return StreamingImageIOBase::GetActualNumberOfSplitsForWriting(numberOfRequestedSplits,
+                                                                 pasteRegion,
+                                                                 largestPossibleRegion);
 }
 
 //
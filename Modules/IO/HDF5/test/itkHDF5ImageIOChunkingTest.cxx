@@ -0,0 +1,245 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ImageIO.h"
+#include "itkHDF5ImageIOFactory.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIterator.h"
+#include "itkIOTestHelper.h"
+#include "itk_H5Cpp.h"
+
+namespace
+{
+typedef itk::Image<short,3> ImageType;
+
+short ExpectedPixel(const ImageType::IndexType &index, const ImageType::RegionType &pasted)
+{
+  if(pasted.IsInside(index))
+    {
+    return 1234;
+    }
+  return static_cast<short>(index[0] + 10 * index[1] - 100 * index[2]);
+}
+
+// check the layout of the voxel data in the file
+bool CheckLayout(const char *fileName, const hsize_t *expectedChunk, int expectedFilters)
+{
+  H5::H5File file(fileName,H5F_ACC_RDONLY);
+  H5::DataSet voxelData = file.openDataSet("/ITKImage/0/VoxelData");
+  H5::DSetCreatPropList plist = voxelData.getCreatePlist();
+  hsize_t chunk[3];
+  if(plist.getChunk(3,chunk) != 3)
+    {
+    std::cout << "The voxel data is not chunked" << std::endl;
+    return false;
+    }
+  bool success = true;
+  for(unsigned i = 0; i < 3; i++)
+    {
+    if(chunk[i] != expectedChunk[i])
+      {
+      std::cout << "Chunk dimension " << i << " is " << chunk[i]
+                << " instead of " << expectedChunk[i] << std::endl;
+      success = false;
+      }
+    }
+  if(plist.getNfilters() != expectedFilters)
+    {
+    std::cout << plist.getNfilters() << " filters instead of "
+              << expectedFilters << std::endl;
+    success = false;
+    }
+  voxelData.close();
+  file.close();
+  return success;
+}
+
+bool CheckImage(const ImageType *image, const ImageType::RegionType &pasted)
+{
+  itk::ImageRegionConstIterator<ImageType> it(image,image->GetBufferedRegion());
+  for(it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+    if(it.Get() != ExpectedPixel(it.GetIndex(),pasted))
+      {
+      std::cout << "Pixel " << it.GetIndex() << " is " << it.Get()
+                << " instead of " << ExpectedPixel(it.GetIndex(),pasted)
+                << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int
+itkHDF5ImageIOChunkingTest(int ac, char * av [])
+{
+  std::string prefix("");
+  if(ac > 1)
+    {
+    prefix = *++av;
+    --ac;
+    itksys::SystemTools::ChangeDirectory(prefix.c_str());
+    }
+  itk::ObjectFactoryBase::RegisterFactory(itk::HDF5ImageIOFactory::New() );
+
+  const char *fileName = "ChunkedShortImage.hdf5";
+  const char *defaultFileName = "DefaultChunkedShortImage.hdf5";
+
+  ImageType::SizeType size;
+  size[0] = 37;
+  size[1] = 29;
+  size[2] = 23;
+  ImageType::Pointer im = ImageType::New();
+  im->SetRegions(size);
+  im->Allocate();
+  ImageType::RegionType nothingPasted;
+  nothingPasted.SetSize(0,0);
+  itk::ImageRegionIterator<ImageType> it(im,im->GetLargestPossibleRegion());
+  for(it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+    it.Set(ExpectedPixel(it.GetIndex(),nothingPasted));
+    }
+
+  typedef itk::ImageFileWriter<ImageType> WriterType;
+  typedef itk::ImageFileReader<ImageType> ReaderType;
+  int success(EXIT_SUCCESS);
+  try
+    {
+    // chunks of 16x16x8 voxels, shuffled and deflated
+    itk::HDF5ImageIO::Pointer io = itk::HDF5ImageIO::New();
+    itk::HDF5ImageIO::ChunkSizeType chunkSize(3);
+    chunkSize[0] = 16;
+    chunkSize[1] = 16;
+    chunkSize[2] = 8;
+    io->SetChunkSize(chunkSize);
+    io->SetCompressionLevel(6);
+    io->UseShuffleOn();
+    io->SetChunkCacheSize(4 * 1024 * 1024);
+    io->Print(std::cout);
+
+    WriterType::Pointer writer = WriterType::New();
+    writer->SetImageIO(io);
+    writer->SetFileName(fileName);
+    writer->SetInput(im);
+    writer->Update();
+    writer = WriterType::Pointer();
+    io = itk::HDF5ImageIO::Pointer();
+
+    const hsize_t expectedChunk[3] = { 8, 16, 16 };
+    if(!CheckLayout(fileName,expectedChunk,2))
+      {
+      success = EXIT_FAILURE;
+      }
+
+    // paste a region into the existing file
+    ImageType::RegionType pasted;
+    pasted.SetIndex(0,5);
+    pasted.SetIndex(1,6);
+    pasted.SetIndex(2,7);
+    pasted.SetSize(0,10);
+    pasted.SetSize(1,9);
+    pasted.SetSize(2,8);
+
+    // only the region pasted is buffered
+    ImageType::Pointer patch = ImageType::New();
+    patch->SetLargestPossibleRegion(im->GetLargestPossibleRegion());
+    patch->SetBufferedRegion(pasted);
+    patch->SetRequestedRegion(pasted);
+    patch->Allocate();
+    patch->FillBuffer(1234);
+    itk::ImageIORegion ioRegion(3);
+    itk::ImageIORegionAdaptor<3>::Convert(pasted, ioRegion, im->GetLargestPossibleRegion().GetIndex());
+    WriterType::Pointer paster = WriterType::New();
+    paster->SetFileName(fileName);
+    paster->SetInput(patch);
+    paster->SetIORegion(ioRegion);
+    paster->Update();
+    paster = WriterType::Pointer();
+
+    ReaderType::Pointer reader = ReaderType::New();
+    reader->SetFileName(fileName);
+    reader->Update();
+    if(!CheckImage(reader->GetOutput(),pasted))
+      {
+      std::cout << "The pasted image was not read back" << std::endl;
+      success = EXIT_FAILURE;
+      }
+    if(!CheckLayout(fileName,expectedChunk,2))
+      {
+      success = EXIT_FAILURE;
+      }
+
+    // read a region, which only reads the chunks overlapping it
+    itk::HDF5ImageIO::Pointer readIO = itk::HDF5ImageIO::New();
+    readIO->SetChunkCacheSize(2 * 1024 * 1024);
+    ReaderType::Pointer regionReader = ReaderType::New();
+    regionReader->SetImageIO(readIO);
+    regionReader->SetFileName(fileName);
+    regionReader->SetUseStreaming(true);
+    ImageType::RegionType region;
+    region.SetIndex(0,3);
+    region.SetIndex(1,20);
+    region.SetIndex(2,4);
+    region.SetSize(0,30);
+    region.SetSize(1,5);
+    region.SetSize(2,12);
+    regionReader->GetOutput()->SetRequestedRegion(region);
+    regionReader->Update();
+    if(regionReader->GetOutput()->GetBufferedRegion() != region)
+      {
+      std::cout << "The region read is " << regionReader->GetOutput()->GetBufferedRegion()
+                << " instead of " << region << std::endl;
+      success = EXIT_FAILURE;
+      }
+    else if(!CheckImage(regionReader->GetOutput(),pasted))
+      {
+      std::cout << "The region was not read back" << std::endl;
+      success = EXIT_FAILURE;
+      }
+
+    // by default the chunks are slices, deflated
+    WriterType::Pointer defaultWriter = WriterType::New();
+    defaultWriter->SetFileName(defaultFileName);
+    defaultWriter->SetInput(im);
+    defaultWriter->Update();
+    defaultWriter = WriterType::Pointer();
+    const hsize_t expectedDefaultChunk[3] = { 1, 29, 37 };
+    if(!CheckLayout(defaultFileName,expectedDefaultChunk,1))
+      {
+      success = EXIT_FAILURE;
+      }
+    }
+  catch(itk::ExceptionObject &err)
+    {
+    std::cout << "itkHDF5ImageIOChunkingTest" << std::endl
+              << "Exception Object caught: " << std::endl
+              << err << std::endl;
+    return EXIT_FAILURE;
+    }
+  catch(H5::Exception &err)
+    {
+    std::cout << "itkHDF5ImageIOChunkingTest" << std::endl
+              << "HDF5 Exception caught: " << std::endl
+              << err.getCDetailMsg() << std::endl;
+    return EXIT_FAILURE;
+    }
+  itk::IOTestHelper::Remove(fileName);
+  itk::IOTestHelper::Remove(defaultFileName);
+  return success;
+}
@@ -19,6 +19,7 @@
 #include "itkIOTestHelper.h"
 #include "itkPipelineMonitorImageFilter.h"
 #include "itkStreamingImageFilter.h"
+#include "itkExtractImageFilter.h"
 
 template <typename TPixel>
 int HDF5ReadWriteTest2(const char *fileName)
@@ -114,6 +115,115 @@ int HDF5ReadWriteTest2(const char *fileName)
   return success;
 }
 
+// A streamed write, or a write whose IORegion is the whole image,
+// replaces an existing file even when the image differs in size and
+// spacing: it is only pasted into the file when a paste region smaller
+// than the image is requested.
+int HDF5StreamOverExistingFileTest(const char *fileName)
+{
+  typedef itk::Image<short,3> ImageType;
+  typedef itk::ImageFileWriter<ImageType> WriterType;
+  typedef itk::ImageFileReader<ImageType> ReaderType;
+
+  ImageType::SizeType oldSize;
+  oldSize.Fill(4);
+  ImageType::Pointer oldImage = ImageType::New();
+  oldImage->SetRegions(oldSize);
+  oldImage->Allocate();
+  oldImage->FillBuffer(7);
+
+  ImageType::SizeType size;
+  size[0] = 6;
+  size[1] = 5;
+  size[2] = 7;
+  ImageType::SpacingType spacing;
+  spacing[0] = 0.5;
+  spacing[1] = 2.0;
+  spacing[2] = 3.0;
+  ImageType::Pointer im = ImageType::New();
+  im->SetRegions(size);
+  im->SetSpacing(spacing);
+  im->Allocate();
+  itk::ImageRegionIterator<ImageType> it(im,im->GetLargestPossibleRegion());
+  short value = 0;
+  for(it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+    it.Set(value++);
+    }
+
+  try
+    {
+    // the image is written in 3 streamed pieces, then in one piece whose
+    // IORegion is the whole image
+    for(int pieces = 3; pieces > 0; pieces -= 2)
+      {
+      WriterType::Pointer oldWriter = WriterType::New();
+      oldWriter->SetFileName(fileName);
+      oldWriter->SetInput(oldImage);
+      oldWriter->Update();
+      oldWriter = WriterType::Pointer();
+
+      // the extractor only produces the piece requested by the writer
+      typedef itk::ExtractImageFilter<ImageType,ImageType> ExtractType;
+      ExtractType::Pointer extractor = ExtractType::New();
+      extractor->SetInput(im);
+      extractor->SetExtractionRegion(im->GetLargestPossibleRegion());
+      extractor->SetDirectionCollapseToIdentity();
+      extractor->InPlaceOff();
+
+      WriterType::Pointer writer = WriterType::New();
+      writer->SetFileName(fileName);
+      writer->SetInput(extractor->GetOutput());
+      if(pieces > 1)
+        {
+        writer->SetNumberOfStreamDivisions(pieces);
+        }
+      else
+        {
+        itk::ImageIORegion ioRegion(3);
+        itk::ImageIORegionAdaptor<3>::Convert(im->GetLargestPossibleRegion(), ioRegion,
+                                              im->GetLargestPossibleRegion().GetIndex());
+        writer->SetIORegion(ioRegion);
+        }
+      writer->Update();
+      writer = WriterType::Pointer();
+
+      ReaderType::Pointer reader = ReaderType::New();
+      reader->SetFileName(fileName);
+      reader->Update();
+      ImageType::Pointer im2 = reader->GetOutput();
+      if(im2->GetLargestPossibleRegion().GetSize() != size
+         || im2->GetSpacing() != spacing)
+        {
+        std::cout << "The write in " << pieces << " piece(s) over " << fileName
+                  << " kept the size " << im2->GetLargestPossibleRegion().GetSize()
+                  << " and spacing " << im2->GetSpacing() << " of the existing file"
+                  << std::endl;
+        return EXIT_FAILURE;
+        }
+      itk::ImageRegionIterator<ImageType> it2(im2,im2->GetLargestPossibleRegion());
+      for(it.GoToBegin(),it2.GoToBegin(); !it.IsAtEnd(); ++it,++it2)
+        {
+        if(it.Get() != it2.Get())
+          {
+          std::cout << "Pixel " << it2.GetIndex() << " is " << it2.Get()
+                    << " instead of " << it.Get() << std::endl;
+          return EXIT_FAILURE;
+          }
+        }
+      }
+    }
+  catch(itk::ExceptionObject &err)
+    {
+    std::cout << "HDF5StreamOverExistingFileTest" << std::endl
+              << "Exception Object caught: " << std::endl
+              << err << std::endl;
+    return EXIT_FAILURE;
+    }
+  itk::IOTestHelper::Remove(fileName);
+  return EXIT_SUCCESS;
+}
+
 int
 itkHDF5ImageIOStreamingReadWriteTest(int ac, char * av [])
 {
@@ -130,5 +240,6 @@ itkHDF5ImageIOStreamingReadWriteTest(int ac, char * av [])
   result += HDF5ReadWriteTest2<unsigned char>("StreamingUCharImage.hdf5");
   result += HDF5ReadWriteTest2<float>("StreamingFloatImage.hdf5");
   result += HDF5ReadWriteTest2<itk::RGBPixel<unsigned char> >("StreamingRGBImage.hdf5");
+  result += HDF5StreamOverExistingFileTest("StreamingOverExistingImage.hdf5");
   return result != 0;
 }
@@ -20,6 +20,7 @@
 
 #include "itkObject.h"
 #include "itkNumericTraits.h"
+#include "itkMultiThreader.h"
 
 namespace itk
 {
@@ -47,16 +48,36 @@ public:
   /** Determine the output data type. */
   typedef typename OutputConvertTraits::ComponentType OutputComponentType;
   typedef ConvertPixelBuffer                          Self;
-  /** General method converts from one type to another. */
+  /** General method converts from one type to another. Large buffers
+   * are split between the threads of threader, up to its number of
+   * threads, so that a caller running in a thread arena or a pool job
+   * keeps its threading settings. The number of threads of threader is
+   * restored on return. Without threader, the buffers are split between
+   * the threads of a MultiThreader of their own. */
   static void Convert(InputPixelType *inputData,
                       int inputNumberOfComponents,
-                      OutputPixelType *outputData, size_t size);
+                      OutputPixelType *outputData, size_t size,
+                      MultiThreader *threader = 0);
 
   static void ConvertVectorImage(InputPixelType *inputData,
                                  int inputNumberOfComponents,
-                                 OutputPixelType *outputData, size_t size);
+                                 OutputPixelType *outputData, size_t size,
+                                 MultiThreader *threader = 0);
+
+  /** Buffers with fewer pixels per thread than this are converted on
+   * fewer threads. */
+  itkStaticConstMacro(MinimumNumberOfPixelsPerThread, size_t, 65536);
 
 protected:
+  /** Convert a block of pixels on the calling thread. */
+  static void ConvertBlock(InputPixelType *inputData,
+                           int inputNumberOfComponents,
+                           OutputPixelType *outputData, size_t size);
+
+  static void ConvertVectorImageBlock(InputPixelType *inputData,
+                                      int inputNumberOfComponents,
+                                      OutputPixelType *outputData, size_t size);
+
   /** Convert to Gray output. */
   /** Input values are cast to output values. */
   static void ConvertGrayToGray(InputPixelType *inputData,
@@ -146,6 +167,24 @@ private:
   ConvertPixelBuffer();
   ~ConvertPixelBuffer();
 
+  /** The buffers shared by the threads converting them. */
+  struct ConvertThreadStruct
+  {
+    InputPixelType *  InputData;
+    int               InputNumberOfComponents;
+    OutputPixelType * OutputData;
+    size_t            Size;
+    bool              VectorImage;
+  };
+
+  /** Split the conversion between threads when the buffer is large. */
+  static void ThreadedConvert(InputPixelType *inputData,
+                              int inputNumberOfComponents,
+                              OutputPixelType *outputData, size_t size,
+                              bool vectorImage, MultiThreader *threader);
+
+  static ITK_THREAD_RETURN_TYPE ConvertThreaderCallback(void *arg);
+
   /** the most common case, where InputComponentType == unsigned
    *  char, the alpha is in the range 0..255. I presume in the
    *  mythical world of rgba<X> for all integral scalar types X, alpha
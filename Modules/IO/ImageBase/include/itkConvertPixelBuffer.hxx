@@ -33,7 +33,116 @@ void
 ConvertPixelBuffer< InputPixelType, OutputPixelType, OutputConvertTraits >
 ::Convert(InputPixelType *inputData,
           int inputNumberOfComponents,
-          OutputPixelType *outputData, size_t size)
+          OutputPixelType *outputData, size_t size,
+          MultiThreader *threader)
+{
+  ThreadedConvert(inputData, inputNumberOfComponents, outputData, size, false, threader);
+}
+
+template< typename InputPixelType,
+          typename OutputPixelType,
+          class OutputConvertTraits
+          >
+void
+ConvertPixelBuffer< InputPixelType, OutputPixelType, OutputConvertTraits >
+::ThreadedConvert(InputPixelType *inputData,
+                  int inputNumberOfComponents,
+                  OutputPixelType *outputData, size_t size,
+                  bool vectorImage, MultiThreader *threader)
+{
+  ThreadIdType numberOfThreads = threader ? threader->GetNumberOfThreads()
+                                 : MultiThreader::GetGlobalDefaultNumberOfThreads();
+  if ( size / MinimumNumberOfPixelsPerThread < numberOfThreads )
+    {
+    numberOfThreads = static_cast< ThreadIdType >( size / MinimumNumberOfPixelsPerThread );
+    }
+
+  if ( numberOfThreads <= 1 )
+    {
+    if ( vectorImage )
+      {
+      ConvertVectorImageBlock(inputData, inputNumberOfComponents, outputData, size);
+      }
+    else
+      {
+      ConvertBlock(inputData, inputNumberOfComponents, outputData, size);
+      }
+    return;
+    }
+
+  // Converting no pixel throws the exception of an unsupported
+  // conversion on the calling thread.
+  if ( !vectorImage )
+    {
+    ConvertBlock(inputData, inputNumberOfComponents, outputData, 0);
+    }
+
+  ConvertThreadStruct str;
+  str.InputData = inputData;
+  str.InputNumberOfComponents = inputNumberOfComponents;
+  str.OutputData = outputData;
+  str.Size = size;
+  str.VectorImage = vectorImage;
+
+  if ( threader )
+    {
+    const ThreadIdType previousNumberOfThreads = threader->GetNumberOfThreads();
+    threader->SetNumberOfThreads(numberOfThreads);
+    threader->SetSingleMethod(ConvertThreaderCallback, &str);
+    threader->SingleMethodExecute();
+    threader->SetNumberOfThreads(previousNumberOfThreads);
+    }
+  else
+    {
+    MultiThreader::Pointer ownThreader = MultiThreader::New();
+    ownThreader->SetNumberOfThreads(numberOfThreads);
+    ownThreader->SetSingleMethod(ConvertThreaderCallback, &str);
+    ownThreader->SingleMethodExecute();
+    }
+}
+
+template< typename InputPixelType,
+          typename OutputPixelType,
+          class OutputConvertTraits
+          >
+ITK_THREAD_RETURN_TYPE
+ConvertPixelBuffer< InputPixelType, OutputPixelType, OutputConvertTraits >
+::ConvertThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  const ConvertThreadStruct *      str = static_cast< const ConvertThreadStruct * >( info->UserData );
+
+  // Each thread converts a contiguous range of pixels
+  const size_t begin = str->Size * info->ThreadID / info->NumberOfThreads;
+  const size_t end = str->Size * ( info->ThreadID + 1 ) / info->NumberOfThreads;
+  const size_t components = static_cast< size_t >( str->InputNumberOfComponents );
+
+  if ( str->VectorImage )
+    {
+    ConvertVectorImageBlock(str->InputData + begin * components,
+                            str->InputNumberOfComponents,
+                            str->OutputData + begin * components,
+                            end - begin);
+    }
+  else
+    {
+    ConvertBlock(str->InputData + begin * components,
+                 str->InputNumberOfComponents,
+                 str->OutputData + begin,
+                 end - begin);
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename InputPixelType,
+          typename OutputPixelType,
+          class OutputConvertTraits
+          >
+void
+ConvertPixelBuffer< InputPixelType, OutputPixelType, OutputConvertTraits >
+::ConvertBlock(InputPixelType *inputData,
+               int inputNumberOfComponents,
+               OutputPixelType *outputData, size_t size)
 {
   switch ( OutputConvertTraits::GetNumberOfComponents() )
     {
@@ -705,7 +814,20 @@ void
 ConvertPixelBuffer< InputPixelType, OutputPixelType, OutputConvertTraits >
 ::ConvertVectorImage(InputPixelType *inputData,
                      int inputNumberOfComponents,
-                     OutputPixelType *outputData, size_t size)
+                     OutputPixelType *outputData, size_t size,
+                     MultiThreader *threader)
+{
+  ThreadedConvert(inputData, inputNumberOfComponents, outputData, size, true, threader);
+}
+
+template< typename InputPixelType,
+          typename OutputPixelType,
+          class OutputConvertTraits >
+void
+ConvertPixelBuffer< InputPixelType, OutputPixelType, OutputConvertTraits >
+::ConvertVectorImageBlock(InputPixelType *inputData,
+                          int inputNumberOfComponents,
+                          OutputPixelType *outputData, size_t size)
 {
   size_t length = size * (size_t)inputNumberOfComponents;
 
@@ -19,6 +19,7 @@
 #define __itkImageFileReader_h
 
 #include "itkImageIOBase.h"
+#include "itkImageIOPrefetcher.h"
 #include "itkImageSource.h"
 #include "itkMacro.h"
 #include "itkImageRegion.h"
@@ -153,6 +154,31 @@ public:
   itkGetConstReferenceMacro(UseStreaming, bool);
   itkBooleanMacro(UseStreaming);
 
+  /** Set/Get whether the pixel data should be memory mapped from the file
+   * instead of read into a newly allocated buffer, when the ImageIO
+   * reports that this is possible (see ImageIOBase::CanMemoryMapRead()).
+   * The mapping is only used when the whole file is read and no pixel
+   * type conversion is required; otherwise the file is read as usual.
+   * The pages of the file are then loaded on first access and are shared
+   * with the file cache, which makes opening a large image almost free
+   * when only part of it is used.  The output buffer is a private
+   * copy-on-write mapping: it can be modified, but the file is not.
+   * Default is off. */
+  itkSetMacro(UseMemoryMapping, bool);
+  itkGetConstReferenceMacro(UseMemoryMapping, bool);
+  itkBooleanMacro(UseMemoryMapping);
+
+  /** Set/Get whether, when the output is streamed, the region following
+   * the one just read is read on a background thread while the
+   * downstream filters process the current one (see ImageIOPrefetcher).
+   * The next region is assumed to follow the current one along the
+   * slowest dimension that is split; when another region is requested,
+   * the prefetched pixels are dropped and the region is read as usual.
+   * Default is off. */
+  itkSetMacro(UsePrefetching, bool);
+  itkGetConstReferenceMacro(UsePrefetching, bool);
+  itkBooleanMacro(UsePrefetching);
+
 protected:
   ImageFileReader();
   ~ImageFileReader();
@@ -178,10 +204,25 @@ protected:
 
   bool m_UseStreaming;
 
+  bool m_UseMemoryMapping;
+
+  bool m_UsePrefetching;
+
 private:
   ImageFileReader(const Self &); //purposely not implemented
   void operator=(const Self &);  //purposely not implemented
 
+  /** Map the pixel data of the file as the buffer of the output, if
+   * possible. Return false if the output must be allocated and read. */
+  bool MemoryMapOutput();
+
+  /** Read the IORegion of the ImageIO to buffer, from the prefetched
+   * pixels if they are those of the region, and start prefetching the
+   * next region when prefetching is on. */
+  void ReadFromImageIO(void *buffer);
+
+  ImageIOPrefetcher::Pointer m_Prefetcher;
+
   std::string m_ExceptionMessage;
 
   // The region that the ImageIO class will return when we ask to
@@ -24,6 +24,7 @@
 #include "itkConvertPixelBuffer.h"
 #include "itkPixelTraits.h"
 #include "itkVectorImage.h"
+#include "itkMemoryMappedImageContainer.h"
 
 #include "itksys/SystemTools.hxx"
 #include "itkStdAlgorithm.h"
@@ -39,6 +40,8 @@ ImageFileReader< TOutputImage, ConvertPixelTraits >
   this->SetFileName("");
   m_UserSpecifiedImageIO = false;
   m_UseStreaming = true;
+  m_UseMemoryMapping = false;
+  m_UsePrefetching = false;
 }
 
 template< class TOutputImage, class ConvertPixelTraits >
@@ -64,6 +67,8 @@ void ImageFileReader< TOutputImage, ConvertPixelTraits >
 
   os << indent << "UserSpecifiedImageIO flag: " << m_UserSpecifiedImageIO << "\n";
   os << indent << "m_UseStreaming: " << m_UseStreaming << "\n";
+  os << indent << "m_UseMemoryMapping: " << m_UseMemoryMapping << "\n";
+  os << indent << "m_UsePrefetching: " << m_UsePrefetching << "\n";
 }
 
 template< class TOutputImage, class ConvertPixelTraits >
@@ -89,6 +94,13 @@ ImageFileReader< TOutputImage, ConvertPixelTraits >
 
   itkDebugMacro(<< "Reading file for GenerateOutputInformation()" << this->GetFileName());
 
+  // The file or the ImageIO may have changed since the last region was
+  // prefetched
+  if ( m_Prefetcher )
+    {
+    m_Prefetcher->Discard();
+    }
+
   // Check to see if we can read the file given the name or prefix
   //
   if ( this->GetFileName() == "" )
@@ -358,9 +370,6 @@ void ImageFileReader< TOutputImage, ConvertPixelTraits >
                  << "Allocating the buffer with the EnlargedRequestedRegion \n"
                  << output->GetRequestedRegion() << "\n");
 
-  // allocated the output image to the size of the enlarge requested region
-  this->AllocateOutputs();
-
   // Test if the file exists and if it can be opened.
   // An exception will be thrown otherwise, since we can't
   // successfully read the file. We catch the exception because some
@@ -383,6 +392,15 @@ void ImageFileReader< TOutputImage, ConvertPixelTraits >
   itkDebugMacro (<< "Setting imageIO IORegion to: " << m_ActualIORegion);
   m_ImageIO->SetIORegion(m_ActualIORegion);
 
+  if ( m_UseMemoryMapping && this->MemoryMapOutput() )
+    {
+    itkDebugMacro(<< "Pixel data memory mapped.");
+    return;
+    }
+
+  // allocated the output image to the size of the enlarge requested region
+  this->AllocateOutputs();
+
   char *loadBuffer = 0;
   // the size of the buffer is computed based on the actual number of
   // pixels to be read and the actual size of the pixels to be read
@@ -411,7 +429,7 @@ void ImageFileReader< TOutputImage, ConvertPixelTraits >
                      << m_ImageIO->GetNumberOfComponents() );
 
       loadBuffer = new char[sizeOfActualIORegion];
-      m_ImageIO->Read( static_cast< void * >( loadBuffer ) );
+      this->ReadFromImageIO( static_cast< void * >( loadBuffer ) );
 
       // See note below as to why the buffered region is needed and
       // not actualIOregion
@@ -431,7 +449,7 @@ void ImageFileReader< TOutputImage, ConvertPixelTraits >
       OutputImagePixelType *outputBuffer = output->GetPixelContainer()->GetBufferPointer();
 
       loadBuffer = new char[sizeOfActualIORegion];
-      m_ImageIO->Read( static_cast< void * >( loadBuffer ) );
+      this->ReadFromImageIO( static_cast< void * >( loadBuffer ) );
 
       // we use std::copy here as it should be optimized to memcpy for
       // plain old data, but still is oop
@@ -443,7 +461,7 @@ void ImageFileReader< TOutputImage, ConvertPixelTraits >
       itkDebugMacro(<< "No buffer conversion required.");
 
       OutputImagePixelType *outputBuffer = output->GetPixelContainer()->GetBufferPointer();
-      m_ImageIO->Read(outputBuffer);
+      this->ReadFromImageIO(outputBuffer);
       }
     }
   catch ( ... )
@@ -469,6 +487,117 @@ void ImageFileReader< TOutputImage, ConvertPixelTraits >
     }
 }
 
+template< class TOutputImage, class ConvertPixelTraits >
+void
+ImageFileReader< TOutputImage, ConvertPixelTraits >
+::ReadFromImageIO(void *buffer)
+{
+  if ( !m_UsePrefetching )
+    {
+    m_Prefetcher = 0;
+    m_ImageIO->Read(buffer);
+    return;
+    }
+
+  if ( m_Prefetcher.IsNull() )
+    {
+    m_Prefetcher = ImageIOPrefetcher::New();
+    }
+  if ( m_Prefetcher->Read(m_ImageIO, buffer) )
+    {
+    itkDebugMacro(<< "Region read by the prefetcher.");
+    }
+  else
+    {
+    m_ImageIO->Read(buffer);
+    }
+  m_Prefetcher->Start(m_ImageIO);
+}
+
+template< class TOutputImage, class ConvertPixelTraits >
+bool
+ImageFileReader< TOutputImage, ConvertPixelTraits >
+::MemoryMapOutput()
+{
+  typename TOutputImage::Pointer output = this->GetOutput();
+
+  // the pixels must be used as they are stored; the buffer of a
+  // VectorImage holds the components of its pixels, which is checked
+  // against its vector length instead of the pixel traits
+  ImageIOBase::IOComponentType ioType =
+    ImageIOBase
+    ::MapPixelType< typename ConvertPixelTraits::ComponentType >::CType;
+  const bool isVectorImage( strcmp(output->GetNameOfClass(), "VectorImage") == 0 );
+  const unsigned int numberOfComponents = isVectorImage
+                                          ? output->GetNumberOfComponentsPerPixel()
+                                          : ConvertPixelTraits::GetNumberOfComponents();
+  if ( m_ImageIO->GetComponentType() != ioType
+       || m_ImageIO->GetNumberOfComponents() != numberOfComponents )
+    {
+    return false;
+    }
+
+  // and the whole file must be read, in the layout of the output buffer
+  const unsigned int ioDimension = m_ImageIO->GetNumberOfDimensions();
+  if ( m_ActualIORegion.GetImageDimension() != ioDimension )
+    {
+    return false;
+    }
+  for ( unsigned int i = 0; i < ioDimension; ++i )
+    {
+    if ( m_ActualIORegion.GetIndex(i) != 0
+         || m_ActualIORegion.GetSize(i) != m_ImageIO->GetDimensions(i) )
+      {
+      return false;
+      }
+    }
+  if ( m_ActualIORegion.GetNumberOfPixels() !=
+       output->GetRequestedRegion().GetNumberOfPixels() )
+    {
+    return false;
+    }
+
+  std::string          dataFileName;
+  ImageIOBase::SizeType offset = 0;
+  if ( !m_ImageIO->CanMemoryMapRead(dataFileName, offset) )
+    {
+    return false;
+    }
+
+  // the components must be aligned in memory as they would be in an
+  // allocated buffer, and the elements of the buffer must have the size
+  // of the stored pixels, or components for a VectorImage
+  const SizeValueType numberOfElements = isVectorImage
+                                         ? m_ActualIORegion.GetNumberOfPixels() * numberOfComponents
+                                         : m_ActualIORegion.GetNumberOfPixels();
+  const SizeValueType sizeOfElement = isVectorImage
+                                      ? m_ImageIO->GetComponentSize()
+                                      : m_ImageIO->GetComponentSize() * numberOfComponents;
+  if ( offset < 0
+       || offset % sizeof( typename ConvertPixelTraits::ComponentType ) != 0
+       || sizeof( OutputImagePixelType ) != sizeOfElement )
+    {
+    return false;
+    }
+
+  typedef typename TOutputImage::PixelContainer PixelContainerType;
+  typedef MemoryMappedImageContainer< typename PixelContainerType::ElementIdentifier,
+                                      typename PixelContainerType::Element >
+  MappedContainerType;
+
+  typename MappedContainerType::Pointer container = MappedContainerType::New();
+  if ( !container->MapFile( dataFileName, static_cast< SizeValueType >( offset ),
+                            numberOfElements ) )
+    {
+    itkDebugMacro(<< "Unable to map " << dataFileName << ", reading it instead.");
+    return false;
+    }
+
+  output->SetBufferedRegion( output->GetRequestedRegion() );
+  output->SetPixelContainer(container);
+  return true;
+}
+
 template< class TOutputImage, class ConvertPixelTraits >
 void
 ImageFileReader< TOutputImage, ConvertPixelTraits >
@@ -480,6 +609,10 @@ ImageFileReader< TOutputImage, ConvertPixelTraits >
     this->GetOutput()->GetPixelContainer()->GetBufferPointer();
   bool isVectorImage(strcmp(this->GetOutput()->GetNameOfClass(),
                             "VectorImage") == 0);
+
+  // Large buffers are converted on the threads of the reader
+  MultiThreader *threader = this->GetMultiThreader();
+  threader->SetNumberOfThreads( this->GetNumberOfThreads() );
   // TODO:
   // Pass down the PixelType (RGB, VECTOR, etc.) so that any vector to
   // scalar conversion be type specific. i.e. RGB to scalar would use
@@ -507,7 +640,8 @@ ImageFileReader< TOutputImage, ConvertPixelTraits >
         ::ConvertVectorImage(static_cast< type * >( inputData ),        \
                              m_ImageIO->GetNumberOfComponents(),        \
                              outputData,                                \
-                             numberOfPixels);                           \
+                             numberOfPixels,                            \
+                             threader);                                 \
       }                                                                 \
     else                                                                \
       {                                                                 \
@@ -518,7 +652,8 @@ ImageFileReader< TOutputImage, ConvertPixelTraits >
         ::Convert(static_cast< type * >( inputData ),                   \
                   m_ImageIO->GetNumberOfComponents(),                   \
                   outputData,                                           \
-                  numberOfPixels);                                      \
+                  numberOfPixels,                                       \
+                  threader);                                            \
       }                                                                 \
     }
 
@@ -76,6 +76,9 @@ public:
   /** Run-time type information (and related methods). */
   itkTypeMacro(ImageIOBase, Superclass);
 
+  /** Returns a new ImageIO of the same type, with the same options. */
+  itkCloneMacro(Self);
+
   /** Set/Get the name of the file to be read. */
   itkSetStringMacro(FileName);
   itkGetStringMacro(FileName);
@@ -316,6 +319,19 @@ public:
     return false;
   }
 
+  /** Determine if the pixel data of the current file can be memory
+   * mapped instead of read, that is if it is stored uncompressed, in the
+   * byte order of the host and in the layout returned by Read(), as one
+   * contiguous block of a single file.  If so, the name of that file and
+   * the offset in bytes of the first pixel are returned.  This must be
+   * queried after the header of the file has been read.  Default is
+   * false. */
+  virtual bool CanMemoryMapRead(std::string & itkNotUsed(dataFileName),
+                                SizeType & itkNotUsed(offset))
+  {
+    return false;
+  }
+
   /** Read the spacing and dimensions of the image.
    * Assumes SetFileName has been called with a valid file name. */
   virtual void ReadImageInformation() = 0;
@@ -524,6 +540,11 @@ protected:
   ~ImageIOBase();
   void PrintSelf(std::ostream & os, Indent indent) const;
 
+  /** Returns an ImageIO of the same type using the same compression and
+   * streaming options, and the same image description. Subclasses with
+   * options of their own copy them as well. */
+  virtual LightObject::Pointer InternalClone() const;
+
   virtual const ImageRegionSplitterBase* GetImageRegionSplitter(void) const;
 
   /** Used internally to keep track of the type of the pixel. */
@@ -25,6 +25,12 @@ namespace itk
 {
 /** \class ImageIOFactory
  * \brief Create instances of ImageIO objects using an object factory.
+ *
+ * When reading, the ImageIOs that declare SupportedReadExtensions are
+ * probed according to the extension of the file rather than to their
+ * order of registration, while the ones that declare none keep their
+ * precedence. See CreateImageIO().
+ *
  * \ingroup ITKIOImageBase
  */
 class ITK_EXPORT ImageIOFactory:public Object
@@ -48,7 +54,15 @@ public:
   typedef enum { ReadMode, WriteMode } FileModeType;
 
   /** Create the appropriate ImageIO depending on the particulars of the file.
-    */
+   * In WriteMode, the ImageIOs are probed in the order of registration. In
+   * ReadMode, the ImageIOs that declare no SupportedReadExtensions are
+   * still probed in the order of registration, but the ImageIOs that
+   * declare extensions are ranked among them: the one that last read a
+   * file with the same extension from the same directory first, then the
+   * ones supporting the extension of the file, and last the ones that only
+   * declare other extensions. When several ImageIOs that declare
+   * extensions can read a file, the one returned may thus not be the
+   * first registered. */
   static ImageIOBasePointer CreateImageIO(const char *path, FileModeType mode);
 
 protected:
@@ -0,0 +1,114 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkImageIOPrefetcher_h
+#define __itkImageIOPrefetcher_h
+
+#include "itkImageIOBase.h"
+#include "itkMultiThreader.h"
+#include <vector>
+
+namespace itk
+{
+/** \class ImageIOPrefetcher
+ * \brief Read the next streamed region of a file on a background thread.
+ *
+ * When a pipeline is streamed, the reader is asked for consecutive
+ * regions of the file, each one following the previous one along the
+ * slowest dimension that is split. After a region is read, Start()
+ * predicts the next one and reads it on a background thread with its
+ * own copy of the ImageIO, while the downstream filters process the
+ * current region. Read() then gets the pixels of that region without
+ * waiting for the file, or reports that the prediction was wrong.
+ *
+ * The ImageIO must support reading a file while other instances of the
+ * same class read other files.
+ *
+ * \sa ImageFileReader::SetUsePrefetching
+ * \ingroup IOFilters
+ * \ingroup ITKIOImageBase
+ */
+class ITK_EXPORT ImageIOPrefetcher:public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef ImageIOPrefetcher    Self;
+  typedef Object               Superclass;
+  typedef SmartPointer< Self > Pointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ImageIOPrefetcher, Object);
+
+  /** Start reading the region following the IORegion of imageIO, if
+   * there is one. The file name and the pixel layout are taken from
+   * imageIO, which must have read the image information. */
+  void Start(ImageIOBase *imageIO);
+
+  /** Copy the IORegion of imageIO to buffer if it is the prefetched
+   * region, waiting for the background read to complete. Return false,
+   * leaving the buffer untouched, if another region was prefetched or
+   * if the background read failed. */
+  bool Read(ImageIOBase *imageIO, void *buffer);
+
+  /** Wait for the background read and drop its pixels. */
+  void Discard();
+
+  /** Compute the region following "region" along the slowest dimension
+   * in which it does not cover the image of imageIO. Return false when
+   * "region" is the last one. */
+  static bool ComputeNextRegion(const ImageIOBase *imageIO,
+                                const ImageIORegion & region,
+                                ImageIORegion & next);
+
+protected:
+  ImageIOPrefetcher();
+  ~ImageIOPrefetcher();
+  void PrintSelf(std::ostream & os, Indent indent) const;
+
+private:
+  ImageIOPrefetcher(const Self &); //purposely not implemented
+  void operator=(const Self &);    //purposely not implemented
+
+  /** Wait for the background read to complete. */
+  void Wait();
+
+  static ITK_THREAD_RETURN_TYPE ReadThreaderCallback(void *arg);
+
+  MultiThreader::Pointer m_Threader;
+  ThreadIdType           m_ThreadID;
+  bool                   m_Running;
+
+  /** The copy of the ImageIO used by the background thread */
+  ImageIOBase::Pointer m_ImageIO;
+  bool                 m_ImageInformationRead;
+
+  /** The pixel layout expected by the reader */
+  ImageIOBase::IOComponentType m_ComponentType;
+  unsigned int                 m_NumberOfComponents;
+  std::vector< SizeValueType > m_Dimensions;
+
+  std::string         m_FileName;
+  ImageIORegion       m_Region;
+  std::vector< char > m_Buffer;
+  bool                m_Succeeded;
+};
+} // end namespace itk
+
+#endif // __itkImageIOPrefetcher_h
@@ -23,6 +23,7 @@
 #include <string>
 #include "itkMetaDataDictionary.h"
 #include "itkImageFileReader.h"
+#include "itkSimpleFastMutexLock.h"
 
 namespace itk
 {
@@ -154,9 +155,21 @@ public:
   itkGetConstReferenceMacro(UseStreaming, bool);
   itkBooleanMacro(UseStreaming);
 
+  /** Set/Get the number of threads reading slices concurrently. Each
+   * thread reads and decodes one file at a time directly into the output
+   * buffer, so this also bounds the number of files being read at once.
+   * The meta data dictionaries are stored in the order of the files
+   * whatever the order in which the slices are read. The default, 1,
+   * reads the files one after the other. When an ImageIO is set, the
+   * other threads read with clones of it, so it must copy its options
+   * in InternalClone(). */
+  itkSetClampMacro(NumberOfReadingThreads, ThreadIdType, 1, NumericTraits< ThreadIdType >::max());
+  itkGetConstMacro(NumberOfReadingThreads, ThreadIdType);
+
 protected:
   ImageSeriesReader():m_ImageIO(0), m_ReverseOrder(false),
-    m_UseStreaming(true), m_MetaDataDictionaryArrayUpdate(true) {}
+    m_UseStreaming(true), m_NumberOfReadingThreads(1),
+    m_MetaDataDictionaryArrayUpdate(true) {}
   ~ImageSeriesReader();
   void PrintSelf(std::ostream & os, Indent indent) const;
 
@@ -185,6 +198,8 @@ protected:
 
   bool m_UseStreaming;
 
+  ThreadIdType m_NumberOfReadingThreads;
+
 private:
   ImageSeriesReader(const Self &); //purposely not implemented
   void operator=(const Self &);    //purposely not implemented
@@ -193,6 +208,55 @@ private:
 
   int ComputeMovingDimensionIndex(ReaderType *reader);
 
+  /** State shared by the threads reading the slices. The slices are
+   * assigned in the order of the files. */
+  struct ReadSlicesThreadStruct {
+    Self *Filter;
+
+    /** Slices to read, with whether they are inside the requested region
+     * or only their meta data dictionary is needed. */
+    std::vector< int >   Slices;
+    std::vector< bool >  InsideRequestedRegion;
+    ImageRegionType      SliceRegionToRequest;
+    SizeType             ValidSize;
+    bool                 ReadMetaDataDictionaries;
+
+    /** ImageIO of every thread, when one is set on the filter. */
+    std::vector< ImageIOBase::Pointer > ImageIOs;
+
+    /** Dictionaries of the slices, stored by slice. */
+    DictionaryArrayType Dictionaries;
+
+    SimpleFastMutexLock Lock;
+    size_t              NextSlice;
+    SizeValueType       NumberOfSlicesRead;
+    SizeValueType       NumberOfSlicesToRead;
+
+    /** Slice being read by every thread, and the first slice whose
+     * reading failed with its exception. */
+    std::vector< size_t > CurrentSlice;
+    size_t                FailedSlice;
+    ExceptionObject       Exception;
+  };
+
+  /** Read the slice of file number i, or only its information when it is
+   * outside the requested region. Returns a copy of the meta data
+   * dictionary of the file when requested, NULL otherwise. The file is
+   * read with imageIO unless it is NULL. */
+  DictionaryRawPointer ReadSlice(ImageIOBase *imageIO,
+                                 int i,
+                                 bool insideRequestedRegion,
+                                 const ImageRegionType & sliceRegionToRequest,
+                                 const SizeType & validSize,
+                                 bool readMetaDataDictionary);
+
+  /** Read the slices of a ReadSlicesThreadStruct until none is left. */
+  void ReadSlices(ReadSlicesThreadStruct & str, ThreadIdType threadId);
+
+  /** Static function used as a "callback" by the MultiThreader to read
+   * slices. */
+  static ITK_THREAD_RETURN_TYPE ReadSlicesThreaderCallback(void *arg);
+
   /** Modified time of the MetaDataDictionaryArray */
   TimeStamp m_MetaDataDictionaryArrayMTime;
 
@@ -24,7 +24,6 @@
 #include "itkImageAlgorithm.h"
 #include "itkArray.h"
 #include "vnl/vnl_math.h"
-#include "itkProgressReporter.h"
 #include "itkMetaDataObject.h"
 
 namespace itk
@@ -54,6 +53,7 @@ void ImageSeriesReader< TOutputImage >
 
   os << indent << "ReverseOrder: " << m_ReverseOrder << std::endl;
   os << indent << "UseStreaming: " << m_UseStreaming << std::endl;
+  os << indent << "NumberOfReadingThreads: " << m_NumberOfReadingThreads << std::endl;
 
   if ( m_ImageIO )
     {
@@ -305,11 +305,6 @@ void ImageSeriesReader< TOutputImage >
   output->SetBufferedRegion(requestedRegion);
   output->Allocate();
 
-  // progress reported on a per slice basis
-  ProgressReporter progress(this, 0,
-                            requestedRegion.GetSize(TOutputImage::ImageDimension-1),
-                            100);
-
   // We utilize the modified time of the output information to
   // know when the meta array needs to be updated, when the output
   // information is updated so should the meta array.
@@ -319,9 +314,17 @@ void ImageSeriesReader< TOutputImage >
     this->m_OutputInformationMTime > this->m_MetaDataDictionaryArrayMTime
     && m_MetaDataDictionaryArrayUpdate;
 
-  typename  TOutputImage::InternalPixelType *outputBuffer = output->GetBufferPointer();
-  IndexType                           sliceStartIndex = requestedRegion.GetIndex();
-  const int                           numberOfFiles = static_cast< int >( m_FileNames.size() );
+  IndexType sliceStartIndex = requestedRegion.GetIndex();
+  const int numberOfFiles = static_cast< int >( m_FileNames.size() );
+
+  ReadSlicesThreadStruct str;
+  str.Filter = this;
+  str.SliceRegionToRequest = sliceRegionToRequest;
+  str.ValidSize = validSize;
+  str.ReadMetaDataDictionaries = needToUpdateMetaDataDictionaryArray;
+  str.NextSlice = 0;
+  str.NumberOfSlicesRead = 0;
+  str.NumberOfSlicesToRead = 0;
 
   for ( int i = 0; i != numberOfFiles; ++i )
     {
@@ -331,135 +334,320 @@ void ImageSeriesReader< TOutputImage >
       }
 
     const bool insideRequestedRegion = requestedRegion.IsInside(sliceStartIndex);
-    const int  iFileName = ( m_ReverseOrder ? numberOfFiles - i - 1 : i );
 
     // check if we need this slice
     if ( !insideRequestedRegion && !needToUpdateMetaDataDictionaryArray )
       {
       continue;
       }
+    str.Slices.push_back(i);
+    str.InsideRequestedRegion.push_back(insideRequestedRegion);
+    if ( insideRequestedRegion )
+      {
+      ++str.NumberOfSlicesToRead;
+      }
+    }
+  str.Dictionaries.resize(str.Slices.size(), 0);
+  str.FailedSlice = str.Slices.size();
 
-    // configure reader
-    typename ReaderType::Pointer reader = ReaderType::New();
-    reader->SetFileName( m_FileNames[iFileName].c_str() );
-
-    TOutputImage * readerOutput = reader->GetOutput();
+  ThreadIdType numberOfThreads = m_NumberOfReadingThreads;
+  if ( str.Slices.size() < numberOfThreads )
+    {
+    numberOfThreads = static_cast< ThreadIdType >( str.Slices.size() );
+    }
 
-    if ( m_ImageIO )
+  // An ImageIO cannot be used by several threads at once, the other
+  // threads read with clones of the one set.
+  if ( m_ImageIO )
+    {
+    str.ImageIOs.push_back(m_ImageIO);
+    for ( ThreadIdType t = 1; t < numberOfThreads; ++t )
       {
-      reader->SetImageIO(m_ImageIO);
+      str.ImageIOs.push_back( m_ImageIO->Clone() );
       }
-    reader->SetUseStreaming(m_UseStreaming);
-    readerOutput->SetRequestedRegion(sliceRegionToRequest);
+    }
 
-    // update the data or info
-    if ( !insideRequestedRegion )
+  str.CurrentSlice.resize(numberOfThreads, 0);
+
+  // The number of threads of the reader is only changed for the reading
+  // of the slices, not for the later updates.
+  MultiThreader *    threader = this->GetMultiThreader();
+  const ThreadIdType previousNumberOfThreads = threader->GetNumberOfThreads();
+  try
+    {
+    if ( numberOfThreads > 1 )
       {
-      reader->UpdateOutputInformation();
+      threader->SetNumberOfThreads(numberOfThreads);
+      threader->SetSingleMethod(this->ReadSlicesThreaderCallback, &str);
+      threader->SingleMethodExecute();
+      threader->SetNumberOfThreads(previousNumberOfThreads);
       }
     else
       {
-      // read the meta data information
-      readerOutput->UpdateOutputInformation();
+      this->ReadSlices(str, 0);
+      }
+    }
+  catch ( ... )
+    {
+    threader->SetNumberOfThreads(previousNumberOfThreads);
+    for ( size_t k = 0; k < str.Dictionaries.size(); ++k )
+      {
+      delete str.Dictionaries[k];
+      }
+    throw;
+    }
 
-      // propagate the requested region to determin what the region
-      // will actually be read
-      readerOutput->PropagateRequestedRegion();
+  // Keep the dictionaries in the order of the files, whatever the order
+  // in which they were read.
+  if ( str.FailedSlice != str.Slices.size() || this->GetAbortGenerateData() )
+    {
+    for ( size_t k = 0; k < str.Dictionaries.size(); ++k )
+      {
+      delete str.Dictionaries[k];
+      }
+    if ( str.FailedSlice != str.Slices.size() )
+      {
+      throw str.Exception;
+      }
+    std::string    msg;
+    ProcessAborted e(__FILE__, __LINE__);
+    msg += "Object " + std::string( this->GetNameOfClass() ) + ": AbortGenerateDataOn";
+    e.SetDescription(msg);
+    throw e;
+    }
+  for ( size_t k = 0; k < str.Dictionaries.size(); ++k )
+    {
+    if ( str.Dictionaries[k] )
+      {
+      m_MetaDataDictionaryArray.push_back(str.Dictionaries[k]);
+      }
+    }
+
+  // update the time if we modified the meta array
+  if ( needToUpdateMetaDataDictionaryArray )
+    {
+    m_MetaDataDictionaryArrayMTime.Modified();
+    }
+}
+
+template< class TOutputImage >
+ITK_THREAD_RETURN_TYPE
+ImageSeriesReader< TOutputImage >
+::ReadSlicesThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  ReadSlicesThreadStruct *         str = static_cast< ReadSlicesThreadStruct * >( info->UserData );
 
-      // check that the size of each slice is the same
-      if ( readerOutput->GetLargestPossibleRegion().GetSize() != validSize )
+  // The exception of the first slice that failed is thrown again once
+  // all the threads have stopped.
+  try
+    {
+    str->Filter->ReadSlices(*str, info->ThreadID);
+    }
+  catch ( ExceptionObject & e )
+    {
+    str->Lock.Lock();
+    if ( str->CurrentSlice[info->ThreadID] < str->FailedSlice )
+      {
+      str->FailedSlice = str->CurrentSlice[info->ThreadID];
+      str->Exception = e;
+      }
+    str->Lock.Unlock();
+    }
+  catch ( std::exception & e )
+    {
+    str->Lock.Lock();
+    if ( str->CurrentSlice[info->ThreadID] < str->FailedSlice )
+      {
+      str->FailedSlice = str->CurrentSlice[info->ThreadID];
+      str->Exception = ExceptionObject(__FILE__, __LINE__, e.what(), ITK_LOCATION);
+      }
+    str->Lock.Unlock();
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< class TOutputImage >
+void
+ImageSeriesReader< TOutputImage >
+::ReadSlices(ReadSlicesThreadStruct & str, ThreadIdType threadId)
+{
+  for (;; )
+    {
+    // Take the next slice, unless a slice failed or the filter was
+    // aborted.
+    str.Lock.Lock();
+    const size_t k = str.NextSlice;
+    const bool   stop = k >= str.Slices.size()
+                        || str.FailedSlice != str.Slices.size()
+                        || this->GetAbortGenerateData();
+    if ( !stop )
+      {
+      ++str.NextSlice;
+      }
+    str.Lock.Unlock();
+    if ( stop )
+      {
+      return;
+      }
+
+    str.CurrentSlice[threadId] = k;
+    str.Dictionaries[k] = this->ReadSlice(str.ImageIOs.empty() ? 0 : str.ImageIOs[threadId].GetPointer(),
+                                          str.Slices[k],
+                                          str.InsideRequestedRegion[k],
+                                          str.SliceRegionToRequest,
+                                          str.ValidSize,
+                                          str.ReadMetaDataDictionaries);
+
+    // progress reported on a per slice basis, by the first thread
+    if ( str.InsideRequestedRegion[k] )
+      {
+      str.Lock.Lock();
+      const SizeValueType numberOfSlicesRead = ++str.NumberOfSlicesRead;
+      str.Lock.Unlock();
+      if ( threadId == 0 )
         {
-        itkExceptionMacro( << "Size mismatch! The size of  "
-                           << m_FileNames[iFileName].c_str()
-                           << " is "
-                           << readerOutput->GetLargestPossibleRegion().GetSize()
-                           << " and does not match the required size "
-                           << validSize
-                           << " from file "
-                           << m_FileNames[m_ReverseOrder ? m_FileNames.size() - 1 : 0].c_str() );
+        this->UpdateProgress( static_cast< float >( numberOfSlicesRead )
+                              / static_cast< float >( str.NumberOfSlicesToRead ) );
         }
+      }
+    }
+}
 
-      // get the size of the region to be read
-      SizeType readSize = readerOutput->GetRequestedRegion().GetSize();
+template< class TOutputImage >
+typename ImageSeriesReader< TOutputImage >::DictionaryRawPointer
+ImageSeriesReader< TOutputImage >
+::ReadSlice(ImageIOBase *imageIO,
+            int i,
+            bool insideRequestedRegion,
+            const ImageRegionType & sliceRegionToRequest,
+            const SizeType & validSize,
+            bool readMetaDataDictionary)
+{
+  TOutputImage *output = this->GetOutput();
 
-      if( readSize == sliceRegionToRequest.GetSize() )
-        {
-        // if the buffer of the ImageReader is going to match that of
-        // ourselves, then set the ImageReader's buffer to a section
-        // of ours
+  const ImageRegionType requestedRegion = output->GetRequestedRegion();
 
-        const size_t  numberOfPixelsInSlice = sliceRegionToRequest.GetNumberOfPixels();
+  typename  TOutputImage::InternalPixelType *outputBuffer = output->GetBufferPointer();
+  const int                           numberOfFiles = static_cast< int >( m_FileNames.size() );
+  const int                           iFileName = ( m_ReverseOrder ? numberOfFiles - i - 1 : i );
 
-        typedef typename TOutputImage::AccessorFunctorType AccessorFunctorType;
-        const size_t      numberOfInternalComponentsPerPixel =  AccessorFunctorType::GetVectorLength( output );
+  IndexType sliceStartIndex = requestedRegion.GetIndex();
+  if ( TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage )
+    {
+    sliceStartIndex[this->m_NumberOfDimensionsInImage] = i;
+    }
 
+  // configure reader
+  typename ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( m_FileNames[iFileName].c_str() );
 
-        const ptrdiff_t   sliceOffset = ( TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage ) ?
-          ( i - requestedRegion.GetIndex(this->m_NumberOfDimensionsInImage)) : 0;
+  TOutputImage * readerOutput = reader->GetOutput();
 
-        const ptrdiff_t  numberOfPixelComponentsUpToSlice =  numberOfPixelsInSlice * numberOfInternalComponentsPerPixel * sliceOffset;
-        const bool       bufferDelete = false;
+  if ( imageIO )
+    {
+    reader->SetImageIO(imageIO);
+    }
+  reader->SetUseStreaming(m_UseStreaming);
+  readerOutput->SetRequestedRegion(sliceRegionToRequest);
 
-        typename  TOutputImage::InternalPixelType * outputSliceBuffer = outputBuffer + numberOfPixelComponentsUpToSlice;
+  // update the data or info
+  if ( !insideRequestedRegion )
+    {
+    reader->UpdateOutputInformation();
+    }
+  else
+    {
+    // read the meta data information
+    readerOutput->UpdateOutputInformation();
 
-        if ( strcmp(output->GetNameOfClass(), "VectorImage") == 0 )
-          {
-          // if the input image type is a vector image then the number
-          // of components needs to be set for the size
-          readerOutput->GetPixelContainer()->SetImportPointer( outputSliceBuffer,
-                                                               numberOfPixelsInSlice*numberOfInternalComponentsPerPixel,
-                                                               bufferDelete );
-          }
-        else
-          {
-          // otherwise the actual number of pixels needs to be passed
-          readerOutput->GetPixelContainer()->SetImportPointer( outputSliceBuffer,
-                                                               numberOfPixelsInSlice,
-                                                               bufferDelete );
-          }
-        readerOutput->UpdateOutputData();
-        }
-      else
-        {
-        // the read region isn't going to match exactly what we need
-        // to update to buffer created by the reader, then copy
+    // propagate the requested region to determin what the region
+    // will actually be read
+    readerOutput->PropagateRequestedRegion();
+
+    // check that the size of each slice is the same
+    if ( readerOutput->GetLargestPossibleRegion().GetSize() != validSize )
+      {
+      itkExceptionMacro( << "Size mismatch! The size of  "
+                         << m_FileNames[iFileName].c_str()
+                         << " is "
+                         << readerOutput->GetLargestPossibleRegion().GetSize()
+                         << " and does not match the required size "
+                         << validSize
+                         << " from file "
+                         << m_FileNames[m_ReverseOrder ? m_FileNames.size() - 1 : 0].c_str() );
+      }
 
-        reader->Update();
+    // get the size of the region to be read
+    SizeType readSize = readerOutput->GetRequestedRegion().GetSize();
 
-        // output of buffer copy
-        ImageRegionType outRegion = requestedRegion;
-        outRegion.SetIndex( sliceStartIndex );
+    if( readSize == sliceRegionToRequest.GetSize() )
+      {
+      // if the buffer of the ImageReader is going to match that of
+      // ourselves, then set the ImageReader's buffer to a section
+      // of ours
 
-        // set the moving dimension to a size of 1
-        if ( TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage )
-          {
-          outRegion.SetSize(this->m_NumberOfDimensionsInImage, 1);
-          }
+      const size_t  numberOfPixelsInSlice = sliceRegionToRequest.GetNumberOfPixels();
 
-        ImageAlgorithm::Copy( readerOutput, output, sliceRegionToRequest, outRegion );
+      typedef typename TOutputImage::AccessorFunctorType AccessorFunctorType;
+      const size_t      numberOfInternalComponentsPerPixel =  AccessorFunctorType::GetVectorLength( output );
 
-        }
 
-      // report progress for read slices
-      progress.CompletedPixel();
+      const ptrdiff_t   sliceOffset = ( TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage ) ?
+        ( i - requestedRegion.GetIndex(this->m_NumberOfDimensionsInImage)) : 0;
 
-     } // end !insidedRequestedRegion
+      const ptrdiff_t  numberOfPixelComponentsUpToSlice =  numberOfPixelsInSlice * numberOfInternalComponentsPerPixel * sliceOffset;
+      const bool       bufferDelete = false;
 
-    // Deep copy the MetaDataDictionary into the array
-    if ( reader->GetImageIO() &&  needToUpdateMetaDataDictionaryArray )
-      {
-      DictionaryRawPointer newDictionary = new DictionaryType;
-      *newDictionary = reader->GetImageIO()->GetMetaDataDictionary();
-      m_MetaDataDictionaryArray.push_back(newDictionary);
+      typename  TOutputImage::InternalPixelType * outputSliceBuffer = outputBuffer + numberOfPixelComponentsUpToSlice;
+
+      if ( strcmp(output->GetNameOfClass(), "VectorImage") == 0 )
+        {
+        // if the input image type is a vector image then the number
+        // of components needs to be set for the size
+        readerOutput->GetPixelContainer()->SetImportPointer( outputSliceBuffer,
+                                                             numberOfPixelsInSlice*numberOfInternalComponentsPerPixel,
+                                                             bufferDelete );
+        }
+      else
+        {
+        // otherwise the actual number of pixels needs to be passed
+        readerOutput->GetPixelContainer()->SetImportPointer( outputSliceBuffer,
+                                                             numberOfPixelsInSlice,
+                                                             bufferDelete );
+        }
+      readerOutput->UpdateOutputData();
       }
+    else
+      {
+      // the read region isn't going to match exactly what we need
+      // to update to buffer created by the reader, then copy
 
-    } // end per slice loop
+      reader->Update();
 
-  // update the time if we modified the meta array
-  if ( needToUpdateMetaDataDictionaryArray )
+      // output of buffer copy
+      ImageRegionType outRegion = requestedRegion;
+      outRegion.SetIndex( sliceStartIndex );
+
+      // set the moving dimension to a size of 1
+      if ( TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage )
+        {
+        outRegion.SetSize(this->m_NumberOfDimensionsInImage, 1);
+        }
+
+      ImageAlgorithm::Copy( readerOutput, output, sliceRegionToRequest, outRegion );
+      }
+    } // end !insidedRequestedRegion
+
+  // Deep copy the MetaDataDictionary
+  if ( reader->GetImageIO() && readMetaDataDictionary )
     {
-    m_MetaDataDictionaryArrayMTime.Modified();
+    DictionaryRawPointer newDictionary = new DictionaryType;
+    *newDictionary = reader->GetImageIO()->GetMetaDataDictionary();
+    return newDictionary;
     }
+  return 0;
 }
 
 template< class TOutputImage >
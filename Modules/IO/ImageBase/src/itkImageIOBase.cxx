@@ -916,6 +916,38 @@ ImageIOBase
   return axis;
 }
 
+LightObject::Pointer ImageIOBase::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+  Self::Pointer        rval = dynamic_cast< Self * >( loPtr.GetPointer() );
+  if ( rval.IsNull() )
+    {
+    itkExceptionMacro(<< "downcast to type "
+                      << this->GetNameOfClass()
+                      << " failed.");
+    }
+
+  rval->SetUseCompression(m_UseCompression);
+  rval->SetUseStreamedReading(m_UseStreamedReading);
+  rval->SetUseStreamedWriting(m_UseStreamedWriting);
+
+  // The image description may have been set by the user for a format
+  // without header, reading the file overrides it otherwise.
+  rval->m_PixelType = m_PixelType;
+  rval->m_ComponentType = m_ComponentType;
+  rval->m_ByteOrder = m_ByteOrder;
+  rval->m_FileType = m_FileType;
+  rval->m_NumberOfComponents = m_NumberOfComponents;
+  rval->m_NumberOfDimensions = m_NumberOfDimensions;
+  rval->m_Dimensions = m_Dimensions;
+  rval->m_Spacing = m_Spacing;
+  rval->m_Origin = m_Origin;
+  rval->m_Direction = m_Direction;
+  rval->m_Strides = m_Strides;
+
+  return loPtr;
+}
+
 void ImageIOBase::PrintSelf(std::ostream & os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
@@ -17,10 +17,41 @@
  *=========================================================================*/
 
 #include "itkImageIOFactory.h"
+#include "itkSimpleFastMutexLock.h"
+#include "itksys/SystemTools.hxx"
+
+#include <map>
 
 
 namespace itk
 {
+namespace
+{
+// For each directory and extension, the class of the ImageIO that last
+// read a file. The cache is only valid for the list of ImageIO classes
+// it was built from, so registering or unregistering a factory clears it.
+typedef std::map< std::string, std::string > ReadImageIOCacheType;
+
+SimpleFastMutexLock         ReadImageIOCacheLock;
+ReadImageIOCacheType        ReadImageIOCache;
+std::vector< std::string >  ReadImageIOCacheClasses;
+
+bool HasSupportedReadExtension(const ImageIOBase *io, const std::string & fileName)
+{
+  const ImageIOBase::ArrayOfExtensionsType & extensions = io->GetSupportedReadExtensions();
+  for ( ImageIOBase::ArrayOfExtensionsType::const_iterator it = extensions.begin();
+        it != extensions.end(); ++it )
+    {
+    if ( fileName.size() >= it->size()
+         && fileName.compare(fileName.size() - it->size(), it->size(), *it) == 0 )
+      {
+      return true;
+      }
+    }
+  return false;
+}
+} // end anonymous namespace
+
 ImageIOBase::Pointer
 ImageIOFactory::CreateImageIO(const char *path, FileModeType mode)
 {
@@ -42,6 +73,94 @@ ImageIOFactory::CreateImageIO(const char *path, FileModeType mode)
                 << std::endl;
       }
     }
+
+  if ( mode == ReadMode && path )
+    {
+    // Probing a file may open and parse it, so the ImageIOs most likely
+    // to read it are probed first.
+    std::vector< std::string > classes;
+    for ( std::list< ImageIOBase::Pointer >::iterator k = possibleImageIO.begin();
+          k != possibleImageIO.end(); ++k )
+      {
+      classes.push_back( ( *k )->GetNameOfClass() );
+      }
+
+    const std::string fileName(path);
+    const std::string key = itksys::SystemTools::GetFilenamePath(fileName) + "/"
+                            + itksys::SystemTools::GetFilenameLastExtension(fileName);
+    std::string cachedClass;
+    ReadImageIOCacheLock.Lock();
+    if ( classes != ReadImageIOCacheClasses )
+      {
+      ReadImageIOCache.clear();
+      ReadImageIOCacheClasses = classes;
+      }
+    else
+      {
+      ReadImageIOCacheType::const_iterator cached = ReadImageIOCache.find(key);
+      if ( cached != ReadImageIOCache.end() )
+        {
+        cachedClass = cached->second;
+        }
+      }
+    ReadImageIOCacheLock.Unlock();
+
+    // The ImageIOs that declare no extension keep their rank, so that
+    // they are still probed before the ImageIOs registered after them.
+    // The cached ImageIO and the ones supporting the extension of the
+    // file are moved ahead of the others, but not ahead of an ImageIO
+    // without extensions registered before them.
+    std::list< ImageIOBase::Pointer >           candidates;
+    std::list< ImageIOBase::Pointer >           others;
+    std::list< ImageIOBase::Pointer >::iterator afterUndeclared = candidates.end();
+    bool                                        anyUndeclared = false;
+    for ( std::list< ImageIOBase::Pointer >::iterator k = possibleImageIO.begin();
+          k != possibleImageIO.end(); ++k )
+      {
+      if ( ( *k )->GetSupportedReadExtensions().empty() )
+        {
+        candidates.push_back(*k);
+        afterUndeclared = --candidates.end();
+        anyUndeclared = true;
+        }
+      else if ( cachedClass == ( *k )->GetNameOfClass() )
+        {
+        std::list< ImageIOBase::Pointer >::iterator position = candidates.begin();
+        if ( anyUndeclared )
+          {
+          position = afterUndeclared;
+          ++position;
+          }
+        candidates.insert(position, *k);
+        }
+      else if ( HasSupportedReadExtension(*k, fileName) )
+        {
+        candidates.push_back(*k);
+        }
+      else
+        {
+        others.push_back(*k);
+        }
+      }
+    candidates.splice(candidates.end(), others);
+
+    for ( std::list< ImageIOBase::Pointer >::iterator k = candidates.begin();
+          k != candidates.end(); ++k )
+      {
+      if ( ( *k )->CanReadFile(path) )
+        {
+        ReadImageIOCacheLock.Lock();
+        if ( classes == ReadImageIOCacheClasses )
+          {
+          ReadImageIOCache[key] = ( *k )->GetNameOfClass();
+          }
+        ReadImageIOCacheLock.Unlock();
+        return *k;
+        }
+      }
+    return 0;
+    }
+
   for ( std::list< ImageIOBase::Pointer >::iterator k = possibleImageIO.begin();
         k != possibleImageIO.end(); ++k )
     {
@@ -0,0 +1,200 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImageIOPrefetcher.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace itk
+{
+ImageIOPrefetcher::ImageIOPrefetcher():
+  m_ThreadID(0),
+  m_Running(false),
+  m_ImageInformationRead(false),
+  m_ComponentType(ImageIOBase::UNKNOWNCOMPONENTTYPE),
+  m_NumberOfComponents(0),
+  m_Succeeded(false)
+{}
+
+ImageIOPrefetcher::~ImageIOPrefetcher()
+{
+  this->Wait();
+}
+
+bool
+ImageIOPrefetcher::ComputeNextRegion(const ImageIOBase *imageIO,
+                                     const ImageIORegion & region,
+                                     ImageIORegion & next)
+{
+  next = region;
+  for ( unsigned int i = region.GetImageDimension(); i > 0; --i )
+    {
+    const unsigned int  d = i - 1;
+    const SizeValueType extent = d < imageIO->GetNumberOfDimensions() ? imageIO->GetDimensions(d) : 1;
+    if ( region.GetSize(d) >= extent )
+      {
+      continue;
+      }
+    const SizeValueType start = static_cast< SizeValueType >( region.GetIndex(d) ) + region.GetSize(d);
+    if ( region.GetSize(d) == 0 || start >= extent )
+      {
+      return false;
+      }
+    next.SetIndex( d, static_cast< ImageIORegion::IndexValueType >( start ) );
+    next.SetSize( d, std::min(region.GetSize(d), extent - start) );
+    return true;
+    }
+  return false;
+}
+
+void
+ImageIOPrefetcher::Start(ImageIOBase *imageIO)
+{
+  ImageIORegion next;
+  if ( !ComputeNextRegion(imageIO, imageIO->GetIORegion(), next) )
+    {
+    return;
+    }
+  this->Discard();
+
+  if ( m_ImageIO.IsNull()
+       || m_FileName != imageIO->GetFileName()
+       || strcmp( m_ImageIO->GetNameOfClass(), imageIO->GetNameOfClass() ) != 0 )
+    {
+    LightObject::Pointer another = imageIO->CreateAnother();
+    m_ImageIO = dynamic_cast< ImageIOBase * >( another.GetPointer() );
+    if ( m_ImageIO.IsNull() )
+      {
+      return;
+      }
+    m_FileName = imageIO->GetFileName();
+    m_ImageIO->SetFileName(m_FileName);
+    m_ImageInformationRead = false;
+    }
+  m_ImageIO->SetUseStreamedReading( imageIO->GetUseStreamedReading() );
+
+  m_ComponentType = imageIO->GetComponentType();
+  m_NumberOfComponents = imageIO->GetNumberOfComponents();
+  m_Dimensions.resize( imageIO->GetNumberOfDimensions() );
+  for ( unsigned int i = 0; i < m_Dimensions.size(); ++i )
+    {
+    m_Dimensions[i] = imageIO->GetDimensions(i);
+    }
+
+  m_Region = next;
+  m_Buffer.resize( next.GetNumberOfPixels() * imageIO->GetComponentSize() * m_NumberOfComponents );
+
+  if ( m_Threader.IsNull() )
+    {
+    m_Threader = MultiThreader::New();
+    }
+  m_ThreadID = m_Threader->SpawnThread(ReadThreaderCallback, this);
+  m_Running = true;
+}
+
+bool
+ImageIOPrefetcher::Read(ImageIOBase *imageIO, void *buffer)
+{
+  this->Wait();
+
+  const bool prefetched = m_Succeeded
+                          && m_FileName == imageIO->GetFileName()
+                          && m_Region == imageIO->GetIORegion()
+                          && m_Buffer.size() == m_Region.GetNumberOfPixels()
+                          * imageIO->GetComponentSize() * imageIO->GetNumberOfComponents();
+  if ( prefetched && !m_Buffer.empty() )
+    {
+    std::memcpy(buffer, &m_Buffer[0], m_Buffer.size());
+    }
+  m_Succeeded = false;
+  return prefetched;
+}
+
+void
+ImageIOPrefetcher::Discard()
+{
+  this->Wait();
+  m_Succeeded = false;
+  std::vector< char >().swap(m_Buffer);
+}
+
+void
+ImageIOPrefetcher::Wait()
+{
+  if ( m_Running )
+    {
+    m_Threader->TerminateThread(m_ThreadID);
+    m_Running = false;
+    }
+}
+
+ITK_THREAD_RETURN_TYPE
+ImageIOPrefetcher::ReadThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  Self *                           self = static_cast< Self * >( info->UserData );
+
+  self->m_Succeeded = false;
+  try
+    {
+    ImageIOBase *imageIO = self->m_ImageIO;
+    if ( !self->m_ImageInformationRead )
+      {
+      imageIO->ReadImageInformation();
+      self->m_ImageInformationRead = true;
+      }
+
+    // The copy of the ImageIO must return the pixels as the reader expects them
+    if ( imageIO->GetComponentType() != self->m_ComponentType
+         || imageIO->GetNumberOfComponents() != self->m_NumberOfComponents
+         || imageIO->GetNumberOfDimensions() != self->m_Dimensions.size() )
+      {
+      return ITK_THREAD_RETURN_VALUE;
+      }
+    for ( unsigned int i = 0; i < self->m_Dimensions.size(); ++i )
+      {
+      if ( imageIO->GetDimensions(i) != self->m_Dimensions[i] )
+        {
+        return ITK_THREAD_RETURN_VALUE;
+        }
+      }
+
+    imageIO->SetIORegion(self->m_Region);
+    if ( !self->m_Buffer.empty() )
+      {
+      imageIO->Read(&self->m_Buffer[0]);
+      }
+    self->m_Succeeded = true;
+    }
+  catch ( ... )
+    {
+    // The region is read again by the reader, which reports the error
+    self->m_Succeeded = false;
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+void
+ImageIOPrefetcher::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "FileName: " << m_FileName << std::endl;
+  os << indent << "Region: " << m_Region << std::endl;
+  os << indent << "Running: " << m_Running << std::endl;
+}
+} // end namespace itk
@@ -0,0 +1,148 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkMultiThreader.h"
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+/* Convert buffers large enough to be split between threads, and check
+ * that the result is that of the conversion on one thread. */
+
+namespace
+{
+template< class TInput, class TOutput >
+bool ConvertBufferTest3Compare(const char *name, int inputNumberOfComponents, bool vectorImage)
+{
+  typedef itk::ConvertPixelBuffer< TInput, TOutput,
+                                   itk::DefaultConvertPixelTraits< TOutput > > ConverterType;
+
+  const size_t numberOfPixels = 5 * ConverterType::MinimumNumberOfPixelsPerThread + 17;
+  const size_t numberOfOutputs = vectorImage ? numberOfPixels * inputNumberOfComponents : numberOfPixels;
+  std::vector< TInput > input(numberOfPixels * inputNumberOfComponents);
+  for ( size_t i = 0; i < input.size(); ++i )
+    {
+    input[i] = static_cast< TInput >( ( i * 37 ) % 251 );
+    }
+
+  std::vector< TOutput > serial(numberOfOutputs);
+  std::vector< TOutput > threaded(numberOfOutputs);
+
+  itk::MultiThreader::SetGlobalDefaultNumberOfThreads(1);
+  if ( vectorImage )
+    {
+    ConverterType::ConvertVectorImage(&input[0], inputNumberOfComponents, &serial[0], numberOfPixels);
+    }
+  else
+    {
+    ConverterType::Convert(&input[0], inputNumberOfComponents, &serial[0], numberOfPixels);
+    }
+
+  itk::MultiThreader::SetGlobalDefaultNumberOfThreads(4);
+  if ( vectorImage )
+    {
+    ConverterType::ConvertVectorImage(&input[0], inputNumberOfComponents, &threaded[0], numberOfPixels);
+    }
+  else
+    {
+    ConverterType::Convert(&input[0], inputNumberOfComponents, &threaded[0], numberOfPixels);
+    }
+
+  for ( size_t i = 0; i < numberOfOutputs; ++i )
+    {
+    if ( !( serial[i] == threaded[i] ) )
+      {
+      std::cerr << name << ": the threaded conversion differs at " << i << std::endl;
+      return false;
+      }
+    }
+
+  // On the threads of a caller's threader, which keeps its settings
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  threader->SetNumberOfThreads(3);
+  std::fill(threaded.begin(), threaded.end(), TOutput());
+  if ( vectorImage )
+    {
+    ConverterType::ConvertVectorImage(&input[0], inputNumberOfComponents, &threaded[0], numberOfPixels, threader);
+    }
+  else
+    {
+    ConverterType::Convert(&input[0], inputNumberOfComponents, &threaded[0], numberOfPixels, threader);
+    }
+  if ( threader->GetNumberOfThreads() != 3 )
+    {
+    std::cerr << name << ": the threader has " << threader->GetNumberOfThreads()
+              << " threads after the conversion instead of 3" << std::endl;
+    return false;
+    }
+
+  for ( size_t i = 0; i < numberOfOutputs; ++i )
+    {
+    if ( !( serial[i] == threaded[i] ) )
+      {
+      std::cerr << name << ": the conversion on the caller's threader differs at " << i << std::endl;
+      return false;
+      }
+    }
+  std::cout << name << ": OK" << std::endl;
+  return true;
+}
+}
+
+int itkConvertBufferTest3(int, char* [])
+{
+  bool pass = true;
+  pass &= ConvertBufferTest3Compare< unsigned short, float >("gray to gray", 1, false);
+  pass &= ConvertBufferTest3Compare< unsigned char, float >("RGB to gray", 3, false);
+  pass &= ConvertBufferTest3Compare< unsigned char, unsigned char >("RGBA to gray", 4, false);
+  pass &= ConvertBufferTest3Compare< short, itk::RGBPixel< float > >("gray to RGB", 1, false);
+  pass &= ConvertBufferTest3Compare< float, itk::RGBAPixel< double > >("RGBA to RGBA", 4, false);
+  pass &= ConvertBufferTest3Compare< int, double >("vector image", 3, true);
+
+  // An unsupported conversion throws on the calling thread
+  typedef itk::ConvertPixelBuffer< float, itk::SymmetricSecondRankTensor< float, 3 >,
+                                   itk::DefaultConvertPixelTraits< itk::SymmetricSecondRankTensor< float, 3 > > >
+  TensorConverterType;
+  const size_t numberOfPixels = 4 * TensorConverterType::MinimumNumberOfPixelsPerThread;
+  std::vector< float > input(numberOfPixels, 1.0f);
+  std::vector< itk::SymmetricSecondRankTensor< float, 3 > > output(numberOfPixels);
+  bool caught = false;
+  try
+    {
+    TensorConverterType::Convert(&input[0], 1, &output[0], numberOfPixels);
+    }
+  catch ( itk::ExceptionObject & excp )
+    {
+    std::cout << "Expected exception: " << excp.GetDescription() << std::endl;
+    caught = true;
+    }
+  if ( !caught )
+    {
+    std::cerr << "Converting 1 component to a tensor should throw" << std::endl;
+    pass = false;
+    }
+
+  if ( !pass )
+    {
+    std::cerr << "Test FAILED" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test PASSED" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,239 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMemoryMappedImageContainer.h"
+#include "itkVectorImage.h"
+
+/* Read images with memory mapping enabled and check that the pixels are
+ * those written, that the file is mapped when it is uncompressed and
+ * needs no conversion, and that modifying the mapped buffer leaves the
+ * file untouched. */
+
+namespace
+{
+typedef itk::Image< float, 3 >       ImageType;
+typedef itk::Image< short, 3 >       ShortImageType;
+typedef itk::VectorImage< float, 3 > VectorImageType;
+
+float ImageFileReaderMemoryMappingTestValue(const ImageType::IndexType & index, unsigned int component = 0)
+{
+  return 0.5f * index[0] + 10.0f * index[1] + 100.0f * index[2] + 1000.0f * component;
+}
+
+template< class TImage >
+bool ImageFileReaderMemoryMappingTestIsMapped(TImage *image)
+{
+  typedef typename TImage::PixelContainer PixelContainerType;
+  typedef itk::MemoryMappedImageContainer< typename PixelContainerType::ElementIdentifier,
+                                           typename PixelContainerType::Element >
+  MappedContainerType;
+  const MappedContainerType *container =
+    dynamic_cast< const MappedContainerType * >( image->GetPixelContainer() );
+  return container != 0 && container->IsMapped();
+}
+
+bool ImageFileReaderMemoryMappingTestCheck(const ImageType *image, const std::string & fileName)
+{
+  itk::ImageRegionConstIteratorWithIndex< ImageType > it( image, image->GetLargestPossibleRegion() );
+  for (; !it.IsAtEnd(); ++it )
+    {
+    if ( it.Get() != ImageFileReaderMemoryMappingTestValue( it.GetIndex() ) )
+      {
+      std::cerr << "Wrong pixel " << it.Get() << " at " << it.GetIndex()
+                << " in " << fileName << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+bool ImageFileReaderMemoryMappingTestFile(const ImageType *image, const std::string & fileName,
+                                          bool compress, bool mustBeMapped)
+{
+  typedef itk::ImageFileWriter< ImageType > WriterType;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+  writer->SetUseCompression(compress);
+  writer->Update();
+
+  typedef itk::ImageFileReader< ImageType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(fileName);
+  reader->UseMemoryMappingOn();
+  reader->Update();
+
+  ImageType::Pointer output = reader->GetOutput();
+  const bool mapped = ImageFileReaderMemoryMappingTestIsMapped( output.GetPointer() );
+  std::cout << fileName << ( mapped ? " is mapped" : " is read" ) << std::endl;
+  if ( compress && mapped )
+    {
+    std::cerr << "Compressed file " << fileName << " should not be mapped" << std::endl;
+    return false;
+    }
+  if ( mustBeMapped && !mapped )
+    {
+    std::cerr << "File " << fileName << " should be mapped" << std::endl;
+    return false;
+    }
+  if ( !ImageFileReaderMemoryMappingTestCheck(output, fileName) )
+    {
+    return false;
+    }
+
+  // The mapping is copy-on-write: the file must not change.
+  output->FillBuffer(-1.0f);
+
+  ReaderType::Pointer check = ReaderType::New();
+  check->SetFileName(fileName);
+  check->Update();
+  if ( !ImageFileReaderMemoryMappingTestCheck(check->GetOutput(), fileName) )
+    {
+    std::cerr << "File " << fileName << " modified through the mapping" << std::endl;
+    return false;
+    }
+
+  // Growing the container copies the mapped elements to memory it owns.
+  ImageType::PixelContainer *container = output->GetPixelContainer();
+  const ImageType::SizeValueType numberOfPixels = container->Size();
+  container->Reserve(2 * numberOfPixels);
+  if ( ImageFileReaderMemoryMappingTestIsMapped( output.GetPointer() )
+       || !container->GetContainerManageMemory()
+       || ( *container )[numberOfPixels - 1] != -1.0f )
+    {
+    std::cerr << "Wrong container after Reserve() for " << fileName << std::endl;
+    return false;
+    }
+
+  return true;
+}
+}
+
+int itkImageFileReaderMemoryMappingTest(int argc, char *argv[])
+{
+  if ( argc < 2 )
+    {
+    std::cerr << "Usage: " << argv[0] << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+    }
+  const std::string prefix = std::string(argv[1]) + "/itkImageFileReaderMemoryMappingTest";
+
+  ImageType::SizeType size;
+  size[0] = 37;
+  size[1] = 21;
+  size[2] = 9;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, image->GetLargestPossibleRegion() );
+  for (; !it.IsAtEnd(); ++it )
+    {
+    it.Set( ImageFileReaderMemoryMappingTestValue( it.GetIndex() ) );
+    }
+
+  bool success = true;
+
+  // The data of a .mhd file is at the start of the .raw file, and the
+  // voxels of a .nii file at a 16 bytes aligned offset; the data of a
+  // .mha file follows a header of any length, so it is mapped only if
+  // it happens to be aligned.
+  success &= ImageFileReaderMemoryMappingTestFile(image, prefix + ".mhd", false, true);
+  success &= ImageFileReaderMemoryMappingTestFile(image, prefix + ".nii", false, true);
+  success &= ImageFileReaderMemoryMappingTestFile(image, prefix + ".mha", false, false);
+  success &= ImageFileReaderMemoryMappingTestFile(image, prefix + "Compressed.mha", true, false);
+  success &= ImageFileReaderMemoryMappingTestFile(image, prefix + "Compressed.nii.gz", true, false);
+
+  // A pixel type conversion prevents the mapping.
+  typedef itk::ImageFileReader< ShortImageType > ShortReaderType;
+  ShortReaderType::Pointer shortReader = ShortReaderType::New();
+  shortReader->SetFileName(prefix + ".mhd");
+  shortReader->UseMemoryMappingOn();
+  shortReader->Update();
+  if ( ImageFileReaderMemoryMappingTestIsMapped( shortReader->GetOutput() ) )
+    {
+    std::cerr << "Converted image should not be mapped" << std::endl;
+    success = false;
+    }
+  itk::ImageRegionConstIteratorWithIndex< ShortImageType >
+    sit( shortReader->GetOutput(), shortReader->GetOutput()->GetLargestPossibleRegion() );
+  for (; !sit.IsAtEnd(); ++sit )
+    {
+    if ( sit.Get() != static_cast< short >( ImageFileReaderMemoryMappingTestValue( sit.GetIndex() ) ) )
+      {
+      std::cerr << "Wrong converted pixel " << sit.Get() << " at " << sit.GetIndex() << std::endl;
+      success = false;
+      break;
+      }
+    }
+
+  // Vector images are mapped as well.
+  VectorImageType::Pointer vectorImage = VectorImageType::New();
+  vectorImage->SetRegions(size);
+  vectorImage->SetVectorLength(3);
+  vectorImage->Allocate();
+  itk::ImageRegionIteratorWithIndex< VectorImageType > vit( vectorImage, vectorImage->GetLargestPossibleRegion() );
+  for (; !vit.IsAtEnd(); ++vit )
+    {
+    VectorImageType::PixelType value(3);
+    for ( unsigned int c = 0; c < 3; ++c )
+      {
+      value[c] = ImageFileReaderMemoryMappingTestValue(vit.GetIndex(), c);
+      }
+    vit.Set(value);
+    }
+  typedef itk::ImageFileWriter< VectorImageType > VectorWriterType;
+  VectorWriterType::Pointer vectorWriter = VectorWriterType::New();
+  vectorWriter->SetInput(vectorImage);
+  vectorWriter->SetFileName(prefix + "Vector.mhd");
+  vectorWriter->Update();
+
+  typedef itk::ImageFileReader< VectorImageType > VectorReaderType;
+  VectorReaderType::Pointer vectorReader = VectorReaderType::New();
+  vectorReader->SetFileName(prefix + "Vector.mhd");
+  vectorReader->UseMemoryMappingOn();
+  vectorReader->Update();
+  if ( !ImageFileReaderMemoryMappingTestIsMapped( vectorReader->GetOutput() ) )
+    {
+    std::cerr << "Vector image should be mapped" << std::endl;
+    success = false;
+    }
+  itk::ImageRegionConstIteratorWithIndex< VectorImageType >
+    vcheck( vectorReader->GetOutput(), vectorReader->GetOutput()->GetLargestPossibleRegion() );
+  for (; !vcheck.IsAtEnd(); ++vcheck )
+    {
+    const VectorImageType::PixelType value = vcheck.Get();
+    for ( unsigned int c = 0; c < 3; ++c )
+      {
+      if ( value[c] != ImageFileReaderMemoryMappingTestValue(vcheck.GetIndex(), c) )
+        {
+        std::cerr << "Wrong vector pixel " << value << " at " << vcheck.GetIndex() << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  if ( !success )
+    {
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
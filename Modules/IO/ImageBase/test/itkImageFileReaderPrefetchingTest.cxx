@@ -0,0 +1,185 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageIOFactory.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkStreamingImageFilter.h"
+
+/* Stream a pipeline from a reader with prefetching on, and check that
+ * the prefetched regions are those that are read next, and that a
+ * region that was not prefetched is still read correctly. */
+
+namespace
+{
+typedef itk::Image< short, 3 > ImageType;
+
+short ImageFileReaderPrefetchingTestValue(const ImageType::IndexType & index)
+{
+  return static_cast< short >( index[0] + 50 * index[1] + 1000 * index[2] );
+}
+
+bool ImageFileReaderPrefetchingTestCheck(const ImageType *image, const ImageType::RegionType & region)
+{
+  itk::ImageRegionConstIteratorWithIndex< ImageType > it(image, region);
+  for (; !it.IsAtEnd(); ++it )
+    {
+    if ( it.Get() != ImageFileReaderPrefetchingTestValue( it.GetIndex() ) )
+      {
+      std::cerr << "Wrong pixel " << it.Get() << " at " << it.GetIndex() << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int itkImageFileReaderPrefetchingTest(int argc, char *argv[])
+{
+  if ( argc < 2 )
+    {
+    std::cerr << "Usage: " << argv[0] << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+    }
+  const std::string fileName = std::string(argv[1]) + "/itkImageFileReaderPrefetchingTest.mha";
+
+  ImageType::SizeType size;
+  size[0] = 31;
+  size[1] = 17;
+  size[2] = 11;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, image->GetLargestPossibleRegion() );
+  for (; !it.IsAtEnd(); ++it )
+    {
+    it.Set( ImageFileReaderPrefetchingTestValue( it.GetIndex() ) );
+    }
+
+  bool success = true;
+  try
+    {
+    typedef itk::ImageFileWriter< ImageType > WriterType;
+    WriterType::Pointer writer = WriterType::New();
+    writer->SetInput(image);
+    writer->SetFileName(fileName);
+    writer->Update();
+
+    // The regions that follow each other along the slowest dimension
+    itk::ImageIOBase::Pointer io =
+      itk::ImageIOFactory::CreateImageIO(fileName.c_str(), itk::ImageIOFactory::ReadMode);
+    io->SetFileName(fileName);
+    io->ReadImageInformation();
+    itk::ImageIORegion region(3);
+    region.SetSize(0, 31);
+    region.SetSize(1, 17);
+    region.SetSize(2, 4);
+    region.SetIndex(2, 4);
+    itk::ImageIORegion next(3);
+    if ( !itk::ImageIOPrefetcher::ComputeNextRegion(io, region, next)
+         || next.GetIndex(2) != 8 || next.GetSize(2) != 3 || next.GetSize(1) != 17 )
+      {
+      std::cerr << "Wrong region after " << region << ": " << next << std::endl;
+      success = false;
+      }
+    region.SetIndex(2, 8);
+    region.SetSize(2, 3);
+    if ( itk::ImageIOPrefetcher::ComputeNextRegion(io, region, next) )
+      {
+      std::cerr << "No region should follow " << region << std::endl;
+      success = false;
+      }
+
+    // The prefetched region is returned only when it is the one read
+    itk::ImageIOPrefetcher::Pointer prefetcher = itk::ImageIOPrefetcher::New();
+    region.SetIndex(2, 0);
+    region.SetSize(2, 5);
+    io->SetIORegion(region);
+    prefetcher->Start(io);
+    ImageType::RegionType slab;
+    slab.SetIndex(2, 5);
+    slab.SetSize(0, 31);
+    slab.SetSize(1, 17);
+    slab.SetSize(2, 5);
+    ImageType::Pointer slabImage = ImageType::New();
+    slabImage->SetRegions(slab);
+    slabImage->Allocate();
+    region.SetIndex(2, 5);
+    io->SetIORegion(region);
+    if ( !prefetcher->Read( io, slabImage->GetBufferPointer() )
+         || !ImageFileReaderPrefetchingTestCheck(slabImage, slab) )
+      {
+      std::cerr << "The region following the first one was not prefetched" << std::endl;
+      success = false;
+      }
+    prefetcher->Start(io);
+    region.SetIndex(2, 0);
+    io->SetIORegion(region);
+    if ( prefetcher->Read( io, slabImage->GetBufferPointer() ) )
+      {
+      std::cerr << "A region that was not prefetched was returned" << std::endl;
+      success = false;
+      }
+
+    // A streamed pipeline
+    typedef itk::ImageFileReader< ImageType > ReaderType;
+    ReaderType::Pointer reader = ReaderType::New();
+    reader->SetFileName(fileName);
+    reader->UsePrefetchingOn();
+
+    typedef itk::StreamingImageFilter< ImageType, ImageType > StreamerType;
+    StreamerType::Pointer streamer = StreamerType::New();
+    streamer->SetInput( reader->GetOutput() );
+    streamer->SetNumberOfStreamDivisions(4);
+    streamer->Update();
+    if ( !ImageFileReaderPrefetchingTestCheck( streamer->GetOutput(),
+                                               streamer->GetOutput()->GetLargestPossibleRegion() ) )
+      {
+      std::cerr << "Wrong streamed image" << std::endl;
+      success = false;
+      }
+
+    // Then a region the reader did not prefetch
+    ImageType::RegionType requested;
+    requested.SetIndex(2, 2);
+    requested.SetSize(0, 31);
+    requested.SetSize(1, 17);
+    requested.SetSize(2, 6);
+    reader->GetOutput()->SetRequestedRegion(requested);
+    reader->Update();
+    if ( !ImageFileReaderPrefetchingTestCheck(reader->GetOutput(), requested) )
+      {
+      std::cerr << "Wrong region read after streaming" << std::endl;
+      success = false;
+      }
+    }
+  catch ( itk::ExceptionObject & excp )
+    {
+    std::cerr << excp << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if ( !success )
+    {
+    std::cerr << "Test FAILED" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test PASSED" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,171 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileWriter.h"
+#include "itkImageIOFactory.h"
+#include "itkVersion.h"
+#include "itksys/SystemTools.hxx"
+
+/* Check that CreateImageIO returns the ImageIO able to read a file,
+ * including when the ImageIO that read the previous file with the same
+ * extension from the same directory cannot read it, and that an ImageIO
+ * declaring no extension keeps its precedence. */
+
+namespace
+{
+// An ImageIO that declares no extension, and claims the MetaImage file
+// of the test
+class ImageIOFactoryTestImageIO:public itk::ImageIOBase
+{
+public:
+  typedef ImageIOFactoryTestImageIO Self;
+  typedef itk::ImageIOBase          Superclass;
+  typedef itk::SmartPointer< Self > Pointer;
+
+  itkNewMacro(Self);
+  itkTypeMacro(ImageIOFactoryTestImageIO, ImageIOBase);
+
+  virtual bool CanReadFile(const char *fileName)
+  {
+    return itksys::SystemTools::GetFilenameName(fileName) == "itkImageIOFactoryTest.mha";
+  }
+  virtual void ReadImageInformation() {}
+  virtual void Read(void *) {}
+  virtual bool CanWriteFile(const char *) { return false; }
+  virtual void WriteImageInformation() {}
+  virtual void Write(const void *) {}
+};
+
+class ImageIOFactoryTestFactory:public itk::ObjectFactoryBase
+{
+public:
+  typedef ImageIOFactoryTestFactory Self;
+  typedef itk::ObjectFactoryBase    Superclass;
+  typedef itk::SmartPointer< Self > Pointer;
+
+  itkFactorylessNewMacro(Self);
+  itkTypeMacro(ImageIOFactoryTestFactory, ObjectFactoryBase);
+
+  virtual const char * GetITKSourceVersion() const { return ITK_SOURCE_VERSION; }
+  virtual const char * GetDescription() const { return "ImageIO without extensions"; }
+
+protected:
+  ImageIOFactoryTestFactory()
+  {
+    this->RegisterOverride( "itkImageIOBase", "ImageIOFactoryTestImageIO",
+                            "ImageIO without extensions", 1,
+                            itk::CreateObjectFunction< ImageIOFactoryTestImageIO >::New() );
+  }
+};
+
+bool ImageIOFactoryTestCheck(const std::string & fileName,
+                             itk::ImageIOFactory::FileModeType mode,
+                             const char *expectedClass)
+{
+  itk::ImageIOBase::Pointer io = itk::ImageIOFactory::CreateImageIO(fileName.c_str(), mode);
+  const std::string found = io.IsNull() ? "(none)" : io->GetNameOfClass();
+  const std::string expected = expectedClass ? expectedClass : "(none)";
+  if ( found != expected )
+    {
+    std::cerr << "CreateImageIO(" << fileName << ") returned " << found
+              << " instead of " << expected << std::endl;
+    return false;
+    }
+  return true;
+}
+}
+
+int itkImageIOFactoryTest(int argc, char *argv[])
+{
+  if ( argc < 2 )
+    {
+    std::cerr << "Usage: " << argv[0] << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+    }
+  const std::string directory = argv[1];
+  const std::string pngFile = directory + "/itkImageIOFactoryTest.png";
+  const std::string metaFile = directory + "/itkImageIOFactoryTest.mha";
+  const std::string pngAsMetaFile = directory + "/itkImageIOFactoryTestPNG.mha";
+
+  typedef itk::Image< unsigned char, 2 > ImageType;
+  ImageType::RegionType region;
+  region.SetSize(0, 8);
+  region.SetSize(1, 8);
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+  image->FillBuffer(7);
+
+  typedef itk::ImageFileWriter< ImageType > WriterType;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput(image);
+  try
+    {
+    writer->SetFileName(pngFile);
+    writer->Update();
+    writer->SetFileName(metaFile);
+    writer->Update();
+    }
+  catch ( itk::ExceptionObject & excp )
+    {
+    std::cerr << excp << std::endl;
+    return EXIT_FAILURE;
+    }
+  // A PNG file with the extension of MetaImage
+  if ( !itksys::SystemTools::CopyFileAlways( pngFile.c_str(), pngAsMetaFile.c_str() ) )
+    {
+    std::cerr << "Cannot copy " << pngFile << " to " << pngAsMetaFile << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  const itk::ImageIOFactory::FileModeType read = itk::ImageIOFactory::ReadMode;
+  const itk::ImageIOFactory::FileModeType write = itk::ImageIOFactory::WriteMode;
+
+  bool pass = true;
+  // Twice, the second time through the cache
+  for ( unsigned int i = 0; i < 2; ++i )
+    {
+    pass &= ImageIOFactoryTestCheck(pngFile, read, "PNGImageIO");
+    pass &= ImageIOFactoryTestCheck(metaFile, read, "MetaImageIO");
+    pass &= ImageIOFactoryTestCheck(pngAsMetaFile, read, "PNGImageIO");
+    }
+  pass &= ImageIOFactoryTestCheck(directory + "/itkImageIOFactoryTestMissing.mha", read, 0);
+
+  // An ImageIO without extensions registered first is probed before the
+  // ImageIO supporting the extension of the file
+  ImageIOFactoryTestFactory::Pointer factory = ImageIOFactoryTestFactory::New();
+  itk::ObjectFactoryBase::RegisterFactory(factory, itk::ObjectFactoryBase::INSERT_AT_FRONT);
+  for ( unsigned int i = 0; i < 2; ++i )
+    {
+    pass &= ImageIOFactoryTestCheck(metaFile, read, "ImageIOFactoryTestImageIO");
+    pass &= ImageIOFactoryTestCheck(pngAsMetaFile, read, "PNGImageIO");
+    pass &= ImageIOFactoryTestCheck(pngFile, read, "PNGImageIO");
+    }
+  itk::ObjectFactoryBase::UnRegisterFactory(factory);
+  pass &= ImageIOFactoryTestCheck(metaFile, read, "MetaImageIO");
+  pass &= ImageIOFactoryTestCheck(pngFile, write, "PNGImageIO");
+  pass &= ImageIOFactoryTestCheck(metaFile, write, "MetaImageIO");
+
+  if ( !pass )
+    {
+    std::cerr << "Test FAILED" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test PASSED" << std::endl;
+  return EXIT_SUCCESS;
+}
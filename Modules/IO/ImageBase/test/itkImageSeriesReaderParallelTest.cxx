@@ -0,0 +1,191 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include <sstream>
+
+#include "itkImageSeriesReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMetaDataObject.h"
+
+/* Read a series of slices with several threads and compare the image and
+ * the meta data dictionaries with those of a serial reading. */
+
+namespace
+{
+typedef itk::Image< unsigned short, 2 >     SliceType;
+typedef itk::Image< unsigned short, 3 >     VolumeType;
+typedef itk::ImageSeriesReader< VolumeType > ReaderType;
+
+unsigned short ImageSeriesReaderParallelTestValue(const VolumeType::IndexType & index)
+{
+  return static_cast< unsigned short >( 1000 * index[2] + 10 * index[1] + index[0] );
+}
+
+bool ImageSeriesReaderParallelTestCheck(ReaderType *reader, bool reverseOrder)
+{
+  const unsigned int numberOfSlices =
+    static_cast< unsigned int >( reader->GetFileNames().size() );
+
+  VolumeType *output = reader->GetOutput();
+  itk::ImageRegionConstIteratorWithIndex< VolumeType > it( output, output->GetLargestPossibleRegion() );
+  for (; !it.IsAtEnd(); ++it )
+    {
+    VolumeType::IndexType index = it.GetIndex();
+    if ( reverseOrder )
+      {
+      index[2] = numberOfSlices - 1 - index[2];
+      }
+    if ( it.Get() != ImageSeriesReaderParallelTestValue(index) )
+      {
+      std::cerr << "Wrong pixel " << it.Get() << " at " << it.GetIndex()
+                << " with " << reader->GetNumberOfReadingThreads() << " threads" << std::endl;
+      return false;
+      }
+    }
+
+  // The dictionaries are in the order of the slices of the output.
+  const ReaderType::DictionaryArrayType *dictionaries = reader->GetMetaDataDictionaryArray();
+  if ( dictionaries->size() != numberOfSlices )
+    {
+    std::cerr << "Expected " << numberOfSlices << " dictionaries, got "
+              << dictionaries->size() << std::endl;
+    return false;
+    }
+  for ( unsigned int i = 0; i < numberOfSlices; ++i )
+    {
+    std::string sliceNumber;
+    itk::ExposeMetaData< std::string >( *( *dictionaries )[i], "SliceNumber", sliceNumber );
+    std::ostringstream expected;
+    expected << ( reverseOrder ? numberOfSlices - 1 - i : i );
+    if ( sliceNumber != expected.str() )
+      {
+      std::cerr << "Dictionary " << i << " is the one of slice " << sliceNumber
+                << " instead of " << expected.str() << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int itkImageSeriesReaderParallelTest(int argc, char *argv[])
+{
+  if ( argc < 3 )
+    {
+    std::cerr << "Usage: " << argv[0] << " outputDirectory extension" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  const unsigned int numberOfSlices = 23;
+
+  // Write the slices, each with its number in its meta data dictionary.
+  ReaderType::FileNamesContainer fileNames;
+  for ( unsigned int i = 0; i < numberOfSlices; ++i )
+    {
+    SliceType::SizeType size;
+    size[0] = 9;
+    size[1] = 7;
+    SliceType::Pointer slice = SliceType::New();
+    slice->SetRegions(size);
+    slice->Allocate();
+    itk::ImageRegionIteratorWithIndex< SliceType > it( slice, slice->GetLargestPossibleRegion() );
+    for (; !it.IsAtEnd(); ++it )
+      {
+      VolumeType::IndexType index;
+      index[0] = it.GetIndex()[0];
+      index[1] = it.GetIndex()[1];
+      index[2] = i;
+      it.Set( ImageSeriesReaderParallelTestValue(index) );
+      }
+
+    std::ostringstream sliceNumber;
+    sliceNumber << i;
+    itk::EncapsulateMetaData< std::string >( slice->GetMetaDataDictionary(), "SliceNumber",
+                                             sliceNumber.str() );
+
+    std::ostringstream fileName;
+    fileName << argv[1] << "/itkImageSeriesReaderParallelTest" << i << "." << argv[2];
+    fileNames.push_back( fileName.str() );
+
+    typedef itk::ImageFileWriter< SliceType > WriterType;
+    WriterType::Pointer writer = WriterType::New();
+    writer->SetInput(slice);
+    writer->SetFileName( fileName.str() );
+    writer->Update();
+    }
+
+  const itk::ThreadIdType numbersOfThreads[] = { 1, 2, 4, 64 };
+  for ( unsigned int t = 0; t < 4; ++t )
+    {
+    for ( unsigned int reverse = 0; reverse < 2; ++reverse )
+      {
+      ReaderType::Pointer reader = ReaderType::New();
+      reader->SetFileNames(fileNames);
+      reader->SetReverseOrder(reverse != 0);
+      reader->SetNumberOfReadingThreads(numbersOfThreads[t]);
+      const itk::ThreadIdType threaderThreads = reader->GetMultiThreader()->GetNumberOfThreads();
+      try
+        {
+        reader->Update();
+        }
+      catch ( itk::ExceptionObject & e )
+        {
+        std::cerr << e << std::endl;
+        return EXIT_FAILURE;
+        }
+      if ( !ImageSeriesReaderParallelTestCheck(reader, reverse != 0) )
+        {
+        return EXIT_FAILURE;
+        }
+      // The reading threads do not leak into the later updates.
+      if ( reader->GetMultiThreader()->GetNumberOfThreads() != threaderThreads )
+        {
+        std::cerr << "The threader has " << reader->GetMultiThreader()->GetNumberOfThreads()
+                  << " threads after the reading instead of " << threaderThreads << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  // A missing file fails the parallel reading as it fails the serial one.
+  fileNames[numberOfSlices / 2] = std::string( argv[1] ) + "/itkImageSeriesReaderParallelTestMissing." + argv[2];
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileNames(fileNames);
+  reader->SetNumberOfReadingThreads(4);
+  reader->Print(std::cout);
+  const itk::ThreadIdType threaderThreads = reader->GetMultiThreader()->GetNumberOfThreads();
+  try
+    {
+    reader->Update();
+    std::cerr << "The reading of a missing file did not fail." << std::endl;
+    return EXIT_FAILURE;
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cout << "Expected exception: " << e << std::endl;
+    }
+  if ( reader->GetMultiThreader()->GetNumberOfThreads() != threaderThreads )
+    {
+    std::cerr << "The failed reading did not restore the number of threads." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -118,28 +118,25 @@ public:
                            const ImageIORegion & largestPossibleRegion);
 
   /** Determine if the ImageIO can stream reading from this
-   *  file. Only time cannot stream read/write is if compression is used.
+   *  file. Compressed data is streamed by inflating it from the start
+   *  of the data, so the pieces are best read in file order. Only data
+   *  split over several files cannot be streamed when compressed.
    *  CanRead must be called prior to this function. */
-  virtual bool CanStreamRead()
-  {
-    if ( m_MetaImage.CompressedData() )
-      {
-      return false;
-      }
-    return true;
-  }
+  virtual bool CanStreamRead();
+
+  /** The pixel data can be memory mapped when it is stored in binary
+   *  form, uncompressed and in the byte order of the host, either after
+   *  the header or in a single separate data file. */
+  virtual bool CanMemoryMapRead(std::string & dataFileName, SizeType & offset);
 
   /** Determine if the ImageIO can stream writing to this
-   *  file. Only time cannot stream read/write is if compression is used.
+   *  file. Compressed files can be written as a stream of pieces, but
+   *  the pieces must be written in order and cannot be pasted.
    *  Assumes file passes a CanRead call and its pixels are of the same
    *  type as the template of the writer. Can verify by first calling
    *  CanRead and then CanStreamRead prior to calling CanStreamWrite. */
   virtual bool CanStreamWrite()
   {
-    if ( this->GetUseCompression() )
-      {
-      return false;
-      }
     return true;
   }
 
@@ -156,8 +153,28 @@ protected:
 
 private:
 
+  /** Find the file holding the pixel data and the offset of its first
+   * byte. "dataSize" is the number of bytes stored, which is needed
+   * when the data is at the end of the file. */
+  bool GetPixelDataLocation(std::string & dataFileName, SizeType & offset,
+                            SizeType dataSize) const;
+
+  /** Compress the pixels of m_IORegion, which must follow the pieces
+   * written before. The header is written with the last piece. */
+  void WriteCompressed(const void *buffer);
+
+  /** Inflate the pixels of m_IORegion from compressed data. Returns
+   * false when the data cannot be read this way. */
+  bool ReadCompressedRegion(void *buffer);
+
+  class CompressedWriter;
+  class CompressedReader;
+
   MetaImage m_MetaImage;
 
+  CompressedWriter *m_CompressedWriter;
+  CompressedReader *m_CompressedReader;
+
   MetaImageIO(const Self &);    //purposely not implemented
   void operator=(const Self &); //purposely not implemented
 
@@ -20,14 +20,468 @@
 #include "itkSpatialOrientationAdapter.h"
 #include "itkMetaDataObject.h"
 #include "itkIOCommon.h"
+#include "itkMultiThreader.h"
 #include "itksys/SystemTools.hxx"
+#include "itk_zlib.h"
 
 namespace itk
 {
+namespace
+{
+// The pixel data is compressed in blocks of this size, on several
+// threads.
+const MetaImageIO::SizeType CompressionBlockSize = 256 * 1024;
+
+// Each block is primed with the data preceding it, up to the size of
+// the deflate window, so that the blocks compress almost as well as a
+// single stream.
+const MetaImageIO::SizeType CompressionWindowSize = 32 * 1024;
+
+struct CompressBlocksThreadStruct
+{
+  const unsigned char *Data;
+  MetaImageIO::SizeType Size;
+  // data preceding the first block
+  const unsigned char *Dictionary;
+  MetaImageIO::SizeType DictionarySize;
+  // end the deflate stream with the last block
+  bool Finish;
+  std::vector< std::vector< unsigned char > > Blocks;
+  std::vector< uLong > Adler;
+  bool Failed;
+};
+
+// Compress one block as raw deflate data ending on a byte boundary, so
+// that the blocks can be concatenated into a single stream.
+bool CompressBlock(CompressBlocksThreadStruct & str, size_t block)
+{
+  const MetaImageIO::SizeType begin = static_cast< MetaImageIO::SizeType >( block ) * CompressionBlockSize;
+  const MetaImageIO::SizeType size = std::min(CompressionBlockSize, str.Size - begin);
+  const bool                  finish = str.Finish && block + 1 == str.Blocks.size();
+
+  const unsigned char * dictionary = str.Dictionary;
+  MetaImageIO::SizeType dictionarySize = str.DictionarySize;
+  if ( block > 0 )
+    {
+    dictionarySize = std::min(CompressionWindowSize, begin);
+    dictionary = str.Data + begin - dictionarySize;
+    }
+
+  z_stream z;
+  z.zalloc = Z_NULL;
+  z.zfree = Z_NULL;
+  z.opaque = Z_NULL;
+  if ( deflateInit2(&z, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK )
+    {
+    return false;
+    }
+  if ( dictionarySize > 0
+       && deflateSetDictionary(&z, const_cast< Bytef * >( dictionary ),
+                               static_cast< uInt >( dictionarySize ) ) != Z_OK )
+    {
+    deflateEnd(&z);
+    return false;
+    }
+
+  std::vector< unsigned char > & output = str.Blocks[block];
+  output.resize( deflateBound( &z, static_cast< uLong >( size ) ) + 16 );
+
+  z.next_in = const_cast< Bytef * >( str.Data + begin );
+  z.avail_in = static_cast< uInt >( size );
+  z.next_out = &output[0];
+  z.avail_out = static_cast< uInt >( output.size() );
+
+  for (;; )
+    {
+    const int ret = deflate(&z, finish ? Z_FINISH : Z_SYNC_FLUSH);
+    if ( ret == Z_STREAM_ERROR )
+      {
+      deflateEnd(&z);
+      return false;
+      }
+    if ( finish ? ret == Z_STREAM_END : z.avail_out != 0 )
+      {
+      break;
+      }
+    if ( z.avail_out == 0 )
+      {
+      const size_t used = output.size();
+      output.resize(2 * used);
+      z.next_out = &output[used];
+      z.avail_out = static_cast< uInt >( output.size() - used );
+      }
+    }
+  output.resize(z.total_out);
+  deflateEnd(&z);
+
+  str.Adler[block] = adler32(adler32(0, Z_NULL, 0), str.Data + begin,
+                             static_cast< uInt >( size ) );
+  return true;
+}
+
+ITK_THREAD_RETURN_TYPE CompressBlocksThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  CompressBlocksThreadStruct *     str = static_cast< CompressBlocksThreadStruct * >( info->UserData );
+
+  for ( size_t block = info->ThreadID; block < str->Blocks.size(); block += info->NumberOfThreads )
+    {
+    if ( !CompressBlock(*str, block) )
+      {
+      str->Failed = true;
+      }
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+} // end anonymous namespace
+
+/** \\class MetaImageIO::CompressedWriter
+ * Writes a zlib stream made of independently compressed blocks. The
+ * pieces of the image are appended in order, and the stream ends with
+ * the last one. */
+class MetaImageIO::CompressedWriter
+{
+public:
+  /** The compressed data is written to "dataFileName", or kept in
+   * memory when it is empty. "headerDataFileName" is the name stored
+   * in the header. */
+  CompressedWriter(const std::string & dataFileName,
+                   const std::string & headerDataFileName):
+    m_DataFileName(dataFileName),
+    m_HeaderDataFileName(headerDataFileName),
+    m_Adler( adler32(0, Z_NULL, 0) ),
+    m_UncompressedSize(0),
+    m_CompressedSize(0)
+  {}
+
+  bool Start()
+  {
+    if ( !m_DataFileName.empty() )
+      {
+      m_Stream.open(m_DataFileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+      if ( !m_Stream.is_open() )
+        {
+        return false;
+        }
+      }
+    // zlib header: deflate with a 32K window and the default level
+    const unsigned char header[2] = { 0x78, 0x9c };
+    return this->Output(header, 2);
+  }
+
+  bool Append(const unsigned char *data, SizeType size, bool last)
+  {
+    CompressBlocksThreadStruct str;
+    str.Data = data;
+    str.Size = size;
+    str.Dictionary = m_Window.empty() ? 0 : &m_Window[0];
+    str.DictionarySize = static_cast< SizeType >( m_Window.size() );
+    str.Finish = last;
+    str.Failed = false;
+
+    size_t numberOfBlocks = static_cast< size_t >( ( size + CompressionBlockSize - 1 ) / CompressionBlockSize );
+    if ( numberOfBlocks == 0 && last )
+      {
+      numberOfBlocks = 1;
+      }
+    str.Blocks.resize(numberOfBlocks);
+    str.Adler.resize(numberOfBlocks);
+
+    ThreadIdType numberOfThreads = MultiThreader::GetGlobalDefaultNumberOfThreads();
+    if ( numberOfBlocks < numberOfThreads )
+      {
+      numberOfThreads = static_cast< ThreadIdType >( numberOfBlocks );
+      }
+    if ( numberOfThreads > 1 )
+      {
+      MultiThreader::Pointer threader = MultiThreader::New();
+      threader->SetNumberOfThreads(numberOfThreads);
+      threader->SetSingleMethod(CompressBlocksThreaderCallback, &str);
+      threader->SingleMethodExecute();
+      }
+    else
+      {
+      for ( size_t block = 0; block < numberOfBlocks; ++block )
+        {
+        str.Failed = str.Failed || !CompressBlock(str, block);
+        }
+      }
+    if ( str.Failed )
+      {
+      return false;
+      }
+
+    for ( size_t block = 0; block < numberOfBlocks; ++block )
+      {
+      if ( !str.Blocks[block].empty()
+           && !this->Output( &str.Blocks[block][0], str.Blocks[block].size() ) )
+        {
+        return false;
+        }
+      const SizeType blockSize =
+        std::min( CompressionBlockSize, size - static_cast< SizeType >( block ) * CompressionBlockSize );
+      m_Adler = adler32_combine( m_Adler, str.Adler[block], static_cast< z_off_t >( blockSize ) );
+      }
+    m_UncompressedSize += size;
+
+    // keep the end of the data to prime the next piece
+    const size_t windowSize = static_cast< size_t >( CompressionWindowSize );
+    if ( static_cast< size_t >( size ) >= windowSize )
+      {
+      m_Window.assign(data + size - windowSize, data + size);
+      }
+    else
+      {
+      m_Window.insert(m_Window.end(), data, data + size);
+      if ( m_Window.size() > windowSize )
+        {
+        m_Window.erase( m_Window.begin(), m_Window.end() - windowSize );
+        }
+      }
+
+    if ( last )
+      {
+      const unsigned char trailer[4] = {
+        static_cast< unsigned char >( ( m_Adler >> 24 ) & 0xff ),
+        static_cast< unsigned char >( ( m_Adler >> 16 ) & 0xff ),
+        static_cast< unsigned char >( ( m_Adler >> 8 ) & 0xff ),
+        static_cast< unsigned char >( m_Adler & 0xff )
+      };
+      if ( !this->Output(trailer, 4) )
+        {
+        return false;
+        }
+      if ( m_Stream.is_open() )
+        {
+        m_Stream.close();
+        return !m_Stream.fail();
+        }
+      }
+    return true;
+  }
+
+  bool IsInMemory() const
+  {
+    return m_DataFileName.empty();
+  }
+
+  const std::vector< unsigned char > & GetCompressedData() const
+  {
+    return m_Buffer;
+  }
+
+  const std::string & GetHeaderDataFileName() const
+  {
+    return m_HeaderDataFileName;
+  }
+
+  SizeType GetUncompressedSize() const
+  {
+    return m_UncompressedSize;
+  }
+
+  SizeType GetCompressedSize() const
+  {
+    return m_CompressedSize;
+  }
+
+private:
+  bool Output(const unsigned char *data, size_t size)
+  {
+    if ( m_Stream.is_open() )
+      {
+      m_Stream.write(reinterpret_cast< const char * >( data ), size);
+      if ( m_Stream.fail() )
+        {
+        return false;
+        }
+      }
+    else
+      {
+      m_Buffer.insert(m_Buffer.end(), data, data + size);
+      }
+    m_CompressedSize += static_cast< SizeType >( size );
+    return true;
+  }
+
+  std::string                  m_DataFileName;
+  std::string                  m_HeaderDataFileName;
+  std::ofstream                m_Stream;
+  std::vector< unsigned char > m_Buffer;
+  std::vector< unsigned char > m_Window;
+  uLong                        m_Adler;
+  SizeType                     m_UncompressedSize;
+  SizeType                     m_CompressedSize;
+};
+
+/** \\class MetaImageIO::CompressedReader
+ * Inflates compressed pixel data sequentially. The state is kept
+ * between the reads, so that pieces read in file order only inflate
+ * the data once. */
+class MetaImageIO::CompressedReader
+{
+public:
+  CompressedReader():
+    m_ModifiedTime(0),
+    m_Offset(0),
+    m_CompressedSize(0),
+    m_Initialized(false),
+    m_Position(0),
+    m_Remaining(0)
+  {}
+
+  ~CompressedReader()
+  {
+    this->Close();
+  }
+
+  /** Whether the data at "position" can be read without starting again
+   * from the beginning of the data. */
+  bool CanReadFrom(const std::string & fileName, SizeType offset,
+                   SizeType compressedSize, SizeType position) const
+  {
+    return m_Initialized
+           && fileName == m_FileName
+           && offset == m_Offset
+           && compressedSize == m_CompressedSize
+           && position >= m_Position
+           && itksys::SystemTools::ModifiedTime( fileName.c_str() ) == m_ModifiedTime;
+  }
+
+  bool Open(const std::string & fileName, SizeType offset, SizeType compressedSize)
+  {
+    this->Close();
+
+    m_Stream.open(fileName.c_str(), std::ios::in | std::ios::binary);
+    if ( !m_Stream.is_open() )
+      {
+      return false;
+      }
+    m_Stream.seekg(offset, std::ios::beg);
+    if ( m_Stream.fail() )
+      {
+      this->Close();
+      return false;
+      }
+
+    m_ZStream.zalloc = Z_NULL;
+    m_ZStream.zfree = Z_NULL;
+    m_ZStream.opaque = Z_NULL;
+    m_ZStream.next_in = Z_NULL;
+    m_ZStream.avail_in = 0;
+    // accept both zlib and gzip streams, as MetaIO does
+    if ( inflateInit2(&m_ZStream, 47) != Z_OK )
+      {
+      this->Close();
+      return false;
+      }
+
+    m_Initialized = true;
+    m_FileName = fileName;
+    m_ModifiedTime = itksys::SystemTools::ModifiedTime( fileName.c_str() );
+    m_Offset = offset;
+    m_CompressedSize = compressedSize;
+    m_Position = 0;
+    m_Remaining = compressedSize;
+    m_Input.resize(64 * 1024);
+    return true;
+  }
+
+  void Close()
+  {
+    if ( m_Initialized )
+      {
+      inflateEnd(&m_ZStream);
+      m_Initialized = false;
+      }
+    if ( m_Stream.is_open() )
+      {
+      m_Stream.close();
+      }
+    m_Stream.clear();
+    m_FileName.clear();
+  }
+
+  /** Inflate the next "size" bytes into "data", or skip them when
+   * "data" is null. */
+  bool Read(unsigned char *data, SizeType size)
+  {
+    while ( size > 0 )
+      {
+      if ( m_ZStream.avail_in == 0 && m_Remaining > 0 )
+        {
+        const std::streamsize count = static_cast< std::streamsize >(
+          std::min( m_Remaining, static_cast< SizeType >( m_Input.size() ) ) );
+        m_Stream.read(reinterpret_cast< char * >( &m_Input[0] ), count);
+        if ( m_Stream.gcount() != count )
+          {
+          this->Close();
+          return false;
+          }
+        m_ZStream.next_in = &m_Input[0];
+        m_ZStream.avail_in = static_cast< uInt >( count );
+        m_Remaining -= count;
+        }
+
+      SizeType chunk;
+      if ( data )
+        {
+        chunk = std::min( size, static_cast< SizeType >( 1 << 30 ) );
+        m_ZStream.next_out = data;
+        }
+      else
+        {
+        m_Scratch.resize(64 * 1024);
+        chunk = std::min( size, static_cast< SizeType >( m_Scratch.size() ) );
+        m_ZStream.next_out = &m_Scratch[0];
+        }
+      m_ZStream.avail_out = static_cast< uInt >( chunk );
+
+      const int      ret = inflate(&m_ZStream, Z_NO_FLUSH);
+      const SizeType produced = chunk - static_cast< SizeType >( m_ZStream.avail_out );
+      if ( data )
+        {
+        data += produced;
+        }
+      size -= produced;
+      m_Position += produced;
+
+      if ( ( ret != Z_OK && ret != Z_BUF_ERROR && ret != Z_STREAM_END )
+           || ( ret == Z_STREAM_END && size > 0 )
+           || ( produced == 0 && m_ZStream.avail_in == 0 && m_Remaining == 0 ) )
+        {
+        this->Close();
+        return false;
+        }
+      }
+    return true;
+  }
+
+  SizeType GetPosition() const
+  {
+    return m_Position;
+  }
+
+private:
+  std::string                  m_FileName;
+  long                         m_ModifiedTime;
+  SizeType                     m_Offset;
+  SizeType                     m_CompressedSize;
+  std::ifstream                m_Stream;
+  z_stream                     m_ZStream;
+  bool                         m_Initialized;
+  SizeType                     m_Position;
+  SizeType                     m_Remaining;
+  std::vector< unsigned char > m_Input;
+  std::vector< unsigned char > m_Scratch;
+};
+
 MetaImageIO::MetaImageIO()
 {
   m_FileType = Binary;
   m_SubSamplingFactor = 1;
+  m_CompressedWriter = 0;
+  m_CompressedReader = 0;
   if ( MET_SystemByteOrderMSB() )
     {
     m_ByteOrder = BigEndian;
@@ -45,7 +499,10 @@ MetaImageIO::MetaImageIO()
 }
 
 MetaImageIO::~MetaImageIO()
-{}
+{
+  delete m_CompressedWriter;
+  delete m_CompressedReader;
+}
 
 void MetaImageIO::PrintSelf(std::ostream & os, Indent indent) const
 {
@@ -436,39 +893,46 @@ void MetaImageIO::Read(void *buffer)
 
   if ( largestRegion != m_IORegion )
     {
-    int *indexMin = new int[nDims];
-    int *indexMax = new int[nDims];
-    for ( unsigned int i = 0; i < nDims; i++ )
+    // Compressed data is inflated once for all the pieces read in order,
+    // instead of from the beginning of the data for every piece.
+    if ( !m_MetaImage.CompressedData()
+         || m_SubSamplingFactor != 1
+         || !this->ReadCompressedRegion(buffer) )
       {
-      if ( i < m_IORegion.GetImageDimension() )
+      int *indexMin = new int[nDims];
+      int *indexMax = new int[nDims];
+      for ( unsigned int i = 0; i < nDims; i++ )
         {
-        indexMin[i] = m_IORegion.GetIndex()[i];
-        indexMax[i] = indexMin[i] + m_IORegion.GetSize()[i] - 1;
+        if ( i < m_IORegion.GetImageDimension() )
+          {
+          indexMin[i] = m_IORegion.GetIndex()[i];
+          indexMax[i] = indexMin[i] + m_IORegion.GetSize()[i] - 1;
+          }
+        else
+          {
+          indexMin[i] = 0;
+          // this is zero since this is a (size - 1)
+          indexMax[i] = 0;
+          }
         }
-      else
+
+      if ( !m_MetaImage.ReadROI(indexMin, indexMax,
+                                m_FileName.c_str(), true, buffer,
+                                m_SubSamplingFactor) )
         {
-        indexMin[i] = 0;
-        // this is zero since this is a (size - 1)
-        indexMax[i] = 0;
+        delete[] indexMin;
+        delete[] indexMax;
+        itkExceptionMacro( "File cannot be read: "
+                           << this->GetFileName() << " for reading."
+                           << std::endl
+                           << "Reason: "
+                           << itksys::SystemTools::GetLastSystemError() );
         }
-      }
 
-    if ( !m_MetaImage.ReadROI(indexMin, indexMax,
-                              m_FileName.c_str(), true, buffer,
-                              m_SubSamplingFactor) )
-      {
       delete[] indexMin;
       delete[] indexMax;
-      itkExceptionMacro( "File cannot be read: "
-                         << this->GetFileName() << " for reading."
-                         << std::endl
-                         << "Reason: "
-                         << itksys::SystemTools::GetLastSystemError() );
       }
 
-    delete[] indexMin;
-    delete[] indexMax;
-
     m_MetaImage.ElementByteOrderFix( m_IORegion.GetNumberOfPixels() );
     }
   else
@@ -487,6 +951,205 @@ void MetaImageIO::Read(void *buffer)
     }
 }
 
+bool MetaImageIO::CanMemoryMapRead(std::string & dataFileName, SizeType & offset)
+{
+  if ( !m_MetaImage.BinaryData()
+       || m_MetaImage.CompressedData()
+       || ( this->GetComponentSize() > 1
+            && m_MetaImage.BinaryDataByteOrderMSB() != MET_SystemByteOrderMSB() ) )
+    {
+    return false;
+    }
+
+  return this->GetPixelDataLocation( dataFileName, offset,
+                                     static_cast< SizeType >( this->GetImageSizeInBytes() ) );
+}
+
+bool MetaImageIO::CanStreamRead()
+{
+  if ( m_MetaImage.CompressedData() )
+    {
+    std::string dataFileName;
+    SizeType    offset;
+    return this->GetPixelDataLocation( dataFileName, offset,
+                                       static_cast< SizeType >( m_MetaImage.CompressedDataSize() ) );
+    }
+  return true;
+}
+
+bool MetaImageIO::GetPixelDataLocation(std::string & dataFileName, SizeType & offset,
+                                       SizeType dataSize) const
+{
+  const std::string elementDataFileName = m_MetaImage.ElementDataFileName();
+  if ( elementDataFileName == "LOCAL"
+       || elementDataFileName == "Local"
+       || elementDataFileName == "local" )
+    {
+    dataFileName = m_FileName;
+    }
+  else if ( elementDataFileName.empty()
+            || elementDataFileName.compare(0, 4, "LIST") == 0
+            || elementDataFileName.find('%') != std::string::npos )
+    {
+    // the data is split over several files
+    return false;
+    }
+  else if ( itksys::SystemTools::FileIsFullPath( elementDataFileName.c_str() ) )
+    {
+    dataFileName = elementDataFileName;
+    }
+  else
+    {
+    dataFileName = itksys::SystemTools::GetFilenamePath(m_FileName);
+    if ( !dataFileName.empty() )
+      {
+      dataFileName += "/";
+      }
+    dataFileName += elementDataFileName;
+    }
+
+  // Locate the data the same way MetaImage::M_ReadElements does.
+  if ( m_MetaImage.HeaderSize() > 0 )
+    {
+    offset = m_MetaImage.HeaderSize();
+    }
+  else if ( m_MetaImage.HeaderSize() == -1 )
+    {
+    const SizeType fileSize =
+      static_cast< SizeType >( itksys::SystemTools::FileLength( dataFileName.c_str() ) );
+    if ( dataSize <= 0 || fileSize < dataSize )
+      {
+      return false;
+      }
+    offset = fileSize - dataSize;
+    }
+  else if ( dataFileName == m_FileName )
+    {
+    // the data starts right after the header, which is parsed again to
+    // find where it ends
+    std::ifstream stream( m_FileName.c_str(), std::ios::in | std::ios::binary );
+    MetaImage     header;
+    if ( !stream.is_open() || !header.ReadStream(0, &stream, false) )
+      {
+      return false;
+      }
+    offset = static_cast< SizeType >( stream.tellg() );
+    if ( offset < 0 )
+      {
+      return false;
+      }
+    }
+  else
+    {
+    offset = 0;
+    }
+
+  return true;
+}
+
+bool MetaImageIO::ReadCompressedRegion(void *buffer)
+{
+  std::string dataFileName;
+  SizeType    offset;
+  SizeType    compressedSize = static_cast< SizeType >( m_MetaImage.CompressedDataSize() );
+  if ( !m_MetaImage.BinaryData()
+       || !this->GetPixelDataLocation(dataFileName, offset, compressedSize) )
+    {
+    return false;
+    }
+  if ( compressedSize <= 0 )
+    {
+    // the data goes to the end of the file
+    compressedSize =
+      static_cast< SizeType >( itksys::SystemTools::FileLength( dataFileName.c_str() ) ) - offset;
+    if ( compressedSize <= 0 )
+      {
+      return false;
+      }
+    }
+
+  const unsigned int      nDims = this->GetNumberOfDimensions();
+  const SizeType          pixelSize = this->GetComponentSize() * this->GetNumberOfComponents();
+  std::vector< SizeType > index(nDims, 0);
+  std::vector< SizeType > size(nDims, 1);
+  std::vector< SizeType > stride(nDims, pixelSize);
+  for ( unsigned int i = 0; i < nDims; i++ )
+    {
+    if ( i < m_IORegion.GetImageDimension() )
+      {
+      index[i] = m_IORegion.GetIndex()[i];
+      size[i] = m_IORegion.GetSize()[i];
+      }
+    if ( i > 0 )
+      {
+      stride[i] = stride[i - 1] * this->GetDimensions(i - 1);
+      }
+    }
+
+  // The rows of the region are merged into longer runs of contiguous
+  // bytes when they span whole lines, slices, etc.
+  unsigned int runDimension = 1;
+  SizeType     runSize = size[0] * pixelSize;
+  while ( runDimension < nDims
+          && index[runDimension - 1] == 0
+          && size[runDimension - 1] == static_cast< SizeType >( this->GetDimensions(runDimension - 1) ) )
+    {
+    runSize *= size[runDimension];
+    ++runDimension;
+    }
+
+  SizeType numberOfRuns = 1;
+  SizeType position = 0;
+  for ( unsigned int i = 0; i < nDims; i++ )
+    {
+    if ( i >= runDimension )
+      {
+      numberOfRuns *= size[i];
+      }
+    position += index[i] * stride[i];
+    }
+
+  if ( !m_CompressedReader )
+    {
+    m_CompressedReader = new CompressedReader;
+    }
+  if ( !m_CompressedReader->CanReadFrom(dataFileName, offset, compressedSize, position)
+       && !m_CompressedReader->Open(dataFileName, offset, compressedSize) )
+    {
+    return false;
+    }
+
+  unsigned char *         out = static_cast< unsigned char * >( buffer );
+  std::vector< SizeType > current(index);
+  for ( SizeType run = 0; run < numberOfRuns; ++run )
+    {
+    position = 0;
+    for ( unsigned int i = 0; i < nDims; i++ )
+      {
+      position += current[i] * stride[i];
+      }
+    if ( !m_CompressedReader->Read( 0, position - m_CompressedReader->GetPosition() )
+         || !m_CompressedReader->Read(out, runSize) )
+      {
+      return false;
+      }
+    out += runSize;
+
+    for ( unsigned int i = runDimension; i < nDims; i++ )
+      {
+      if ( ++current[i] < index[i] + size[i] )
+        {
+        break;
+        }
+      current[i] = index[i];
+      }
+    }
+
+  // the byte order is fixed on the element data of the MetaImage
+  m_MetaImage.ElementData(buffer, false);
+  return true;
+}
+
 MetaImage * MetaImageIO::GetMetaImagePointer(void)
 {
   return &m_MetaImage;
@@ -1048,7 +1711,14 @@ MetaImageIO
     largestRegion.SetSize( i, this->GetDimensions(i) );
     }
 
-  if ( m_UseCompression && ( largestRegion != m_IORegion ) )
+  const std::string elementDataFileName = m_MetaImage.ElementDataFileName();
+  if ( m_UseCompression && binaryData
+       && elementDataFileName.compare(0, 4, "LIST") != 0
+       && elementDataFileName.find('%') == std::string::npos )
+    {
+    this->WriteCompressed(buffer);
+    }
+  else if ( m_UseCompression && ( largestRegion != m_IORegion ) )
     {
     std::cout << "Compression in use: cannot stream the file writing" << std::endl;
     }
@@ -1097,6 +1767,139 @@ MetaImageIO
   delete[] eOrigin;
 }
 
+void MetaImageIO::WriteCompressed(const void *buffer)
+{
+  const unsigned int nDims = this->GetNumberOfDimensions();
+  const SizeType     pixelSize = this->GetComponentSize() * this->GetNumberOfComponents();
+
+  // The piece must cover a contiguous range of the data: whole lines,
+  // slices, etc. up to its first partial dimension, and a single index
+  // in the dimensions above.
+  SizeType start = 0;
+  SizeType stride = pixelSize;
+  bool     partial = false;
+  for ( unsigned int i = 0; i < nDims; i++ )
+    {
+    const SizeType index = m_IORegion.GetIndex()[i];
+    const SizeType size = m_IORegion.GetSize()[i];
+    if ( partial && size != 1 )
+      {
+      itkExceptionMacro( "Compressed data can only be streamed by contiguous pieces: "
+                         << this->GetFileName() );
+      }
+    if ( index != 0 || size != static_cast< SizeType >( this->GetDimensions(i) ) )
+      {
+      partial = true;
+      }
+    start += index * stride;
+    stride *= this->GetDimensions(i);
+    }
+  const SizeType pieceSize = static_cast< SizeType >( m_IORegion.GetNumberOfPixels() ) * pixelSize;
+  const bool     last = ( start + pieceSize == stride );
+
+  if ( start == 0 )
+    {
+    delete m_CompressedWriter;
+    m_CompressedWriter = 0;
+
+    std::string headerDataFileName = m_MetaImage.ElementDataFileName();
+    if ( headerDataFileName.empty() )
+      {
+      if ( itksys::SystemTools::GetFilenameLastExtension(m_FileName) == ".mha" )
+        {
+        headerDataFileName = "LOCAL";
+        }
+      else
+        {
+        headerDataFileName =
+          itksys::SystemTools::GetFilenameWithoutLastExtension(m_FileName) + ".zraw";
+        }
+      }
+
+    std::string dataFileName;
+    if ( headerDataFileName == "LOCAL"
+         || headerDataFileName == "Local"
+         || headerDataFileName == "local" )
+      {
+      // the data follows the header, whose size is only known at the end
+      }
+    else if ( itksys::SystemTools::FileIsFullPath( headerDataFileName.c_str() ) )
+      {
+      dataFileName = headerDataFileName;
+      }
+    else
+      {
+      dataFileName = itksys::SystemTools::GetFilenamePath(m_FileName);
+      if ( !dataFileName.empty() )
+        {
+        dataFileName += "/";
+        }
+      dataFileName += headerDataFileName;
+      }
+
+    m_CompressedWriter = new CompressedWriter(dataFileName, headerDataFileName);
+    if ( !m_CompressedWriter->Start() )
+      {
+      delete m_CompressedWriter;
+      m_CompressedWriter = 0;
+      itkExceptionMacro( "File cannot be written: " << dataFileName
+                         << std::endl
+                         << "Reason: "
+                         << itksys::SystemTools::GetLastSystemError() );
+      }
+    }
+  else if ( !m_CompressedWriter || m_CompressedWriter->GetUncompressedSize() != start )
+    {
+    itkExceptionMacro( "Compressed data must be written piece after piece in file order: "
+                       << this->GetFileName() );
+    }
+
+  if ( !m_CompressedWriter->Append(static_cast< const unsigned char * >( buffer ), pieceSize, last) )
+    {
+    delete m_CompressedWriter;
+    m_CompressedWriter = 0;
+    itkExceptionMacro( "Compressed data cannot be written: "
+                       << this->GetFileName()
+                       << std::endl
+                       << "Reason: "
+                       << itksys::SystemTools::GetLastSystemError() );
+    }
+
+  if ( !last )
+    {
+    return;
+    }
+
+  // The header is written once the size of the compressed data is known.
+  const std::string elementDataFileName = m_MetaImage.ElementDataFileName();
+  m_MetaImage.ElementDataFileName( m_CompressedWriter->GetHeaderDataFileName().c_str() );
+  m_MetaImage.CompressedDataSize( m_CompressedWriter->GetCompressedSize() );
+  bool written = m_MetaImage.MetaObject::Write( m_FileName.c_str() );
+  m_MetaImage.ElementDataFileName( elementDataFileName.c_str() );
+  m_MetaImage.CompressedDataSize(0);
+
+  if ( written && m_CompressedWriter->IsInMemory() )
+    {
+    const std::vector< unsigned char > & data = m_CompressedWriter->GetCompressedData();
+    std::ofstream stream( m_FileName.c_str(), std::ios::out | std::ios::binary | std::ios::app );
+    stream.write( reinterpret_cast< const char * >( &data[0] ), data.size() );
+    stream.close();
+    written = !stream.fail();
+    }
+
+  delete m_CompressedWriter;
+  m_CompressedWriter = 0;
+
+  if ( !written )
+    {
+    itkExceptionMacro( "File cannot be written: "
+                       << this->GetFileName()
+                       << std::endl
+                       << "Reason: "
+                       << itksys::SystemTools::GetLastSystemError() );
+    }
+}
+
 /** Given a requested region, determine what could be the region that we can
  * read from the file. This is called the streamable region, which will be
  * smaller than the LargestPossibleRegion and greater or equal to the
@@ -1134,17 +1937,12 @@ MetaImageIO::GetActualNumberOfSplitsForWriting(unsigned int numberOfRequestedSpl
 {
   if ( this->GetUseCompression() )
     {
-    // we can not stream or paste with compression
+    // we can stream but not paste with compression
     if ( pasteRegion != largestPossibleRegion )
       {
       itkExceptionMacro( "Pasting and compression is not supported! Can't write:" << this->GetFileName() );
       }
-    else if ( numberOfRequestedSplits != 1 )
-      {
-      itkDebugMacro("Requested streaming and compression");
-      itkDebugMacro("Meta IO is not streaming now!");
-      }
-    return 1;
+    return GetActualNumberOfSplitsForWritingCanStreamWrite(numberOfRequestedSplits, pasteRegion);
     }
 
   if ( !itksys::SystemTools::FileExists( m_FileName.c_str() ) )
@@ -0,0 +1,200 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+#include "itkStreamingImageFilter.h"
+#include "itkMetaImageIO.h"
+
+namespace
+{
+typedef short                       PixelType;
+typedef itk::Image< PixelType, 3 >  ImageType;
+
+bool SameImages(const ImageType *expected, const ImageType *actual)
+{
+  if ( expected->GetLargestPossibleRegion() != actual->GetLargestPossibleRegion() )
+    {
+    std::cerr << "The size of the image read is "
+              << actual->GetLargestPossibleRegion().GetSize() << std::endl;
+    return false;
+    }
+  itk::ImageRegionConstIterator< ImageType > eit( expected, expected->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator< ImageType > ait( actual, expected->GetLargestPossibleRegion() );
+  for (; !eit.IsAtEnd(); ++eit, ++ait )
+    {
+    if ( eit.Get() != ait.Get() )
+      {
+      std::cerr << "Pixel " << eit.GetIndex() << " is " << ait.Get()
+                << " instead of " << eit.Get() << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+int WriteAndRead(const ImageType *image, const std::string & fileName,
+                 unsigned int numberOfWritePieces, unsigned int numberOfReadPieces)
+{
+  std::cout << fileName << ": written in " << numberOfWritePieces
+            << " pieces, read in " << numberOfReadPieces << " pieces" << std::endl;
+
+  typedef itk::ImageFileWriter< ImageType > WriterType;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+  writer->SetUseCompression(true);
+  writer->SetNumberOfStreamDivisions(numberOfWritePieces);
+  writer->Update();
+
+  // the whole image is read by MetaIO in a single inflate call
+  typedef itk::ImageFileReader< ImageType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(fileName);
+  reader->Update();
+  if ( !SameImages( image, reader->GetOutput() ) )
+    {
+    std::cerr << "Reading the whole image failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  itk::MetaImageIO *io = dynamic_cast< itk::MetaImageIO * >( reader->GetImageIO() );
+  if ( !io || !io->GetMetaImagePointer()->CompressedData() )
+    {
+    std::cerr << "The image was not written compressed" << std::endl;
+    return EXIT_FAILURE;
+    }
+  if ( !io->CanStreamRead() )
+    {
+    std::cerr << "The compressed image cannot be streamed" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  ReaderType::Pointer streamedReader = ReaderType::New();
+  streamedReader->SetFileName(fileName);
+  streamedReader->SetUseStreaming(true);
+
+  typedef itk::StreamingImageFilter< ImageType, ImageType > StreamerType;
+  StreamerType::Pointer streamer = StreamerType::New();
+  streamer->SetInput( streamedReader->GetOutput() );
+  streamer->SetNumberOfStreamDivisions(numberOfReadPieces);
+  streamer->Update();
+  if ( !SameImages( image, streamer->GetOutput() ) )
+    {
+    std::cerr << "Reading the image in pieces failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // a region inside the image, read from the inflate state of the
+  // previous pieces or from the beginning of the data
+  ImageType::RegionType region = image->GetLargestPossibleRegion();
+  region.ShrinkByRadius(3);
+  ReaderType::Pointer regionReader = ReaderType::New();
+  regionReader->SetFileName(fileName);
+  regionReader->SetUseStreaming(true);
+  regionReader->GetOutput()->SetRequestedRegion(region);
+  regionReader->Update();
+  itk::ImageRegionConstIterator< ImageType > eit(image, region);
+  itk::ImageRegionConstIterator< ImageType > ait(regionReader->GetOutput(), region);
+  for (; !eit.IsAtEnd(); ++eit, ++ait )
+    {
+    if ( eit.Get() != ait.Get() )
+      {
+      std::cerr << "Reading a region failed at " << eit.GetIndex() << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
+}
+
+int itkMetaImageStreamingCompressionTest(int argc, char *argv[])
+{
+  if ( argc < 2 )
+    {
+    std::cerr << "Usage: " << argv[0] << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+    }
+  const std::string directory = argv[1];
+
+  // large enough to be compressed in several blocks
+  ImageType::SizeType size;
+  size[0] = 96;
+  size[1] = 80;
+  size[2] = 41;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  unsigned int                          seed = 1;
+  itk::ImageRegionIterator< ImageType > it( image, image->GetLargestPossibleRegion() );
+  for (; !it.IsAtEnd(); ++it )
+    {
+    seed = seed * 1103515245 + 12345;
+    const ImageType::IndexType index = it.GetIndex();
+    it.Set( static_cast< PixelType >( index[0] * index[1] - 7 * index[2] + ( ( seed >> 16 ) % 5 ) ) );
+    }
+
+  const char *extensions[] = { ".mha", ".mhd" };
+  for ( unsigned int e = 0; e < 2; ++e )
+    {
+    const std::string fileName = directory + "/itkMetaImageStreamingCompressionTest" + extensions[e];
+    if ( WriteAndRead(image, fileName, 1, 4) != EXIT_SUCCESS
+         || WriteAndRead(image, fileName, 7, 1) != EXIT_SUCCESS
+         || WriteAndRead(image, fileName, 41, 9) != EXIT_SUCCESS )
+      {
+      return EXIT_FAILURE;
+      }
+    }
+
+  // the pieces of compressed data cannot be written out of order
+  itk::MetaImageIO::Pointer io = itk::MetaImageIO::New();
+  io->SetNumberOfDimensions(3);
+  for ( unsigned int i = 0; i < 3; ++i )
+    {
+    io->SetDimensions( i, size[i] );
+    }
+  io->SetComponentType(itk::ImageIOBase::SHORT);
+  io->SetPixelType(itk::ImageIOBase::SCALAR);
+  io->SetUseCompression(true);
+  io->SetFileName( directory + "/itkMetaImageStreamingCompressionTestOrder.mha" );
+  itk::ImageIORegion ioRegion(3);
+  for ( unsigned int i = 0; i < 3; ++i )
+    {
+    ioRegion.SetIndex(i, 0);
+    ioRegion.SetSize( i, size[i] );
+    }
+  ioRegion.SetIndex(2, 10);
+  ioRegion.SetSize(2, 1);
+  io->SetIORegion(ioRegion);
+  try
+    {
+    io->Write( image->GetBufferPointer() + 10 * size[0] * size[1] );
+    std::cerr << "Writing a piece out of order did not fail" << std::endl;
+    return EXIT_FAILURE;
+    }
+  catch ( itk::ExceptionObject & err )
+    {
+    std::cout << "Expected exception: " << err.GetDescription() << std::endl;
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
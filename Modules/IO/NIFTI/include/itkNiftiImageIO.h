@@ -71,6 +71,12 @@ public:
   /** Reads the data from disk into the memory buffer provided. */
   virtual void Read(void *buffer);
 
+  /** The voxels can be memory mapped when the file is not compressed,
+   * is stored in the byte order of the host, does not need rescaling and
+   * has no vector voxels other than RGB, RGBA or complex ones, which
+   * NIfTI stores in a different order than ITK. */
+  virtual bool CanMemoryMapRead(std::string & dataFileName, SizeType & offset);
+
   /*-------- This part of the interfaces deals with writing data. ----- */
 
   /** Determine if the file can be written with this ImageIO implementation.
@@ -88,6 +94,11 @@ public:
    * that the IORegions has been set properly. */
   virtual void Write(const void *buffer);
 
+  /** Any region can be read. Only its voxels are read and allocated,
+   *  seeking past the others in uncompressed files and decompressing and
+   *  discarding them in gzip files. */
+  virtual bool CanStreamRead();
+
   /** Calculate the region of the image that can be efficiently read
    *  in response to a given requested region. */
   virtual ImageIORegion
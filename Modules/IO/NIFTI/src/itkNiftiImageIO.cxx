@@ -340,10 +340,144 @@ int SymMatDim(int count)
   return dim;
 }
 
+// seeks to an offset of the voxels, which may not fit in the long offset
+// of znzseek (32 bits on Windows): it is then reached by relative seeks
+// of at most the largest long.
+static bool
+SeekNiftiFile(znzFile fp, uint64_t offset)
+{
+  const uint64_t maximumStep = static_cast< uint64_t >( NumericTraits< long >::max() );
+  uint64_t       step = std::min(offset, maximumStep);
+
+  if ( znzseek(fp, static_cast< long >( step ), SEEK_SET) < 0 )
+    {
+    return false;
+    }
+  for ( offset -= step; offset > 0; offset -= step )
+    {
+    step = std::min(offset, maximumStep);
+    if ( znzseek(fp, static_cast< long >( step ), SEEK_CUR) < 0 )
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+// reads the voxels of the region of nim starting at origin and of the
+// given size into data, in the order of the file. The file is read in
+// increasing offsets, the longest runs of contiguous voxels at a time,
+// so that gzip files are only decompressed once, the voxels outside the
+// region being decompressed and discarded. Returns false on failure.
+static bool
+ReadNiftiRegion(nifti_image *nim, const int origin[7], const int size[7], void *data)
+{
+  // the offsets in the file are computed in 64 bits, whatever the size of
+  // size_t and long, only the runs read must fit in memory
+  uint64_t dims[7];
+  uint64_t strides[7];
+  uint64_t stride = nim->nbyper;
+  for ( int i = 0; i < 7; i++ )
+    {
+    dims[i] = i < nim->ndim ? static_cast< uint64_t >( nim->dim[i + 1] ) : 1;
+    strides[i] = stride;
+    stride *= dims[i];
+    }
+
+  // the dimensions read whole are read along with the first one which is
+  // not, and the run length is the same for all the runs of the region
+  int contiguous = 0;
+  while ( contiguous < 7
+          && origin[contiguous] == 0
+          && static_cast< uint64_t >( size[contiguous] ) == dims[contiguous] )
+    {
+    contiguous++;
+    }
+  const size_t runLength =
+    static_cast< size_t >( contiguous < 7 ? strides[contiguous] * size[contiguous] : stride );
+  const int      firstOuterDim = contiguous < 7 ? contiguous + 1 : 7;
+  const uint64_t runOffset = contiguous < 7 ? strides[contiguous] * origin[contiguous] : 0;
+
+  char *const fname = nifti_findimgname(nim->iname, nim->nifti_type);
+  if ( fname == NULL )
+    {
+    return false;
+    }
+  znzFile fp = znzopen( fname, "rb", nifti_is_gzfile(fname) );
+  free(fname);
+  if ( znz_isnull(fp) )
+    {
+    return false;
+    }
+
+  // as in nifti_image_load, a negative offset means that the voxels are
+  // at the end of the file
+  uint64_t dataOffset = static_cast< uint64_t >( nim->iname_offset );
+  bool     ok = true;
+  if ( nim->iname_offset < 0 )
+    {
+    const int fileSize = nifti_get_filesize(nim->iname);
+    ok = !nifti_is_gzfile(nim->iname) && fileSize > 0;
+    dataOffset = static_cast< uint64_t >( fileSize ) > stride ? fileSize - stride : 0;
+    }
+
+  // the file is read from its start, there is no current run
+  bool     positioned = false;
+  uint64_t position = 0;
+  int      index[7] = { 0, 0, 0, 0, 0, 0, 0 };
+  char *   out = static_cast< char * >( data );
+  while ( ok )
+    {
+    uint64_t offset = dataOffset + runOffset;
+    for ( int i = firstOuterDim; i < 7; i++ )
+      {
+      offset += strides[i] * ( origin[i] + index[i] );
+      }
+    if ( !positioned || offset != position )
+      {
+      ok = SeekNiftiFile(fp, offset);
+      }
+    ok = ok && nifti_read_buffer(fp, out, runLength, nim) == runLength;
+    positioned = true;
+    position = offset + runLength;
+    out += runLength;
+
+    // next run
+    int i = firstOuterDim;
+    while ( i < 7 && ++index[i] == size[i] )
+      {
+      index[i++] = 0;
+      }
+    if ( i == 7 )
+      {
+      break;
+      }
+    }
+  znzclose(fp);
+  return ok;
+}
+
+bool
+NiftiImageIO
+::CanStreamRead()
+{
+  return true;
+}
+
 ImageIORegion
 NiftiImageIO
 ::GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requestedRegion) const
 {
+  if ( !m_UseStreamedReading )
+    {
+    ImageIORegion largestRegion(this->m_NumberOfDimensions);
+    for ( unsigned int i = 0; i < this->m_NumberOfDimensions; i++ )
+      {
+      largestRegion.SetSize(i, this->m_Dimensions[i]);
+      largestRegion.SetIndex(i, 0);
+      }
+    return largestRegion;
+    }
   return requestedRegion;
 }
 
@@ -437,7 +571,7 @@ void NiftiImageIO::Read(void *buffer)
   ImageIORegion::SizeType  size = regionToRead.GetSize();
   ImageIORegion::IndexType start = regionToRead.GetIndex();
 
-  int          numElts = 1;
+  size_t       numElts = 1;
   int          _origin[7];
   int          _size[7];
   unsigned int i;
@@ -463,8 +597,11 @@ void NiftiImageIO::Read(void *buffer)
     // other dims out of the way
     _size[6] = _size[5];
     _size[5] = _size[4];
+    _origin[6] = _origin[5];
+    _origin[5] = _origin[4];
     // sizes = x y z t vecsize
     _size[4] = numComponents;
+    _origin[4] = 0;
     }
   // Free memory if any was occupied already (incase of re-using the IO filter).
   if ( this->m_NiftiImage != NULL )
@@ -503,13 +640,17 @@ void NiftiImageIO::Read(void *buffer)
     }
   else
     {
-    // read in a subregion
-    if ( nifti_read_subregion_image(this->m_NiftiImage,
-                                    _origin,
-                                    _size,
-                                    &data) == -1 || this->m_NiftiImage == NULL )
+    // read in a subregion, only allocating memory for its voxels
+    size_t regionSize = this->m_NiftiImage->nbyper;
+    for ( i = 0; i < 7; i++ )
       {
-      itkExceptionMacro( << "nifti_read_subregion_image failed for file: "
+      regionSize *= _size[i];
+      }
+    data = malloc(regionSize);
+    if ( data == NULL || !ReadNiftiRegion(this->m_NiftiImage, _origin, _size, data) )
+      {
+      free(data);
+      itkExceptionMacro( << "Reading a region failed for file: "
                          << this->GetFileName() );
       }
     }
@@ -529,7 +670,7 @@ void NiftiImageIO::Read(void *buffer)
 
     // Deal with correct management of 64bits platforms
     const size_t imageSizeInComponents =
-      static_cast< size_t >( this->GetImageSizeInComponents() );
+      static_cast< size_t >( numElts ) * numComponents;
 
     //
     // allocate new buffer for floats. Malloc instead of new to
@@ -601,13 +742,13 @@ void NiftiImageIO::Read(void *buffer)
   else
     {
     // otherwise nifti is x y z t vec l m 0, itk is
-    // vec x y z t l m o
+    // vec x y z t l m o, both with the size of the region read.
     const char *       niftibuf = (const char *)data;
     char *             itkbuf = (char *)buffer;
-    const size_t rowdist = this->m_NiftiImage->dim[1];
-    const size_t slicedist = rowdist * this->m_NiftiImage->dim[2];
-    const size_t volumedist = slicedist * this->m_NiftiImage->dim[3];
-    const size_t seriesdist = volumedist * this->m_NiftiImage->dim[4];
+    const size_t rowdist = _size[0];
+    const size_t slicedist = rowdist * _size[1];
+    const size_t volumedist = slicedist * _size[2];
+    const size_t seriesdist = volumedist * _size[3];
     //
     // as per ITK bug 0007485
     // NIfTI is lower triangular, ITK is upper triangular.
@@ -626,13 +767,13 @@ void NiftiImageIO::Read(void *buffer)
         vecOrder[i] = i;
         }
       }
-    for ( int t = 0; t < this->m_NiftiImage->dim[4]; t++ )
+    for ( int t = 0; t < _size[3]; t++ )
       {
-      for ( int z = 0; z < this->m_NiftiImage->dim[3]; z++ )
+      for ( int z = 0; z < _size[2]; z++ )
         {
-        for ( int y = 0; y < this->m_NiftiImage->dim[2]; y++ )
+        for ( int y = 0; y < _size[1]; y++ )
           {
-          for ( int x = 0; x < this->m_NiftiImage->dim[1]; x++ )
+          for ( int x = 0; x < _size[0]; x++ )
             {
             for ( unsigned int c = 0; c < numComponents; c++ )
               {
@@ -729,6 +870,37 @@ void NiftiImageIO::Read(void *buffer)
     }
 }
 
+bool NiftiImageIO::CanMemoryMapRead(std::string & dataFileName, SizeType & offset)
+{
+  if ( this->MustRescale()
+       || ( this->GetNumberOfComponents() > 1
+            && this->GetPixelType() != COMPLEX
+            && this->GetPixelType() != RGB
+            && this->GetPixelType() != RGBA ) )
+    {
+    return false;
+    }
+
+  nifti_image *header = nifti_image_read(this->GetFileName(), false);
+  if ( header == NULL )
+    {
+    return false;
+    }
+
+  const bool canMap = header->iname != NULL
+                      && !nifti_is_gzfile(header->iname)
+                      && header->iname_offset >= 0
+                      && ( header->swapsize < 2 || header->byteorder == nifti_short_order() );
+  if ( canMap )
+    {
+    dataFileName = header->iname;
+    offset = header->iname_offset;
+    }
+  nifti_image_free(header);
+
+  return canMap;
+}
+
 // This method will only test if the header looks like an
 // Nifti Header.  Some code is redundant with ReadImageInformation
 // a StateMachine could provide a better implementation
@@ -0,0 +1,158 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkNiftiImageIOTest.h"
+
+// Reads regions of 4D scalar and 3D vector images, uncompressed and
+// gzip compressed, and checks that only the requested region is read
+// and that it holds the voxels written.
+
+static short
+StreamedReadScalar(const itk::Image< short, 4 >::IndexType & idx)
+{
+  return static_cast< short >( idx[0] + 11 * ( idx[1] + 9 * ( idx[2] + 7 * idx[3] ) ) );
+}
+
+static float
+StreamedReadComponent(const itk::VectorImage< float, 3 >::IndexType & idx, unsigned int c)
+{
+  return static_cast< float >( c * 1000 + idx[0] + 10 * idx[1] + 100 * idx[2] );
+}
+
+template< class TImage >
+static bool
+CheckStreamedRead(const std::string & filename,
+                  const typename TImage::RegionType & region,
+                  const TImage *original)
+{
+  typedef itk::ImageFileReader< TImage > ReaderType;
+  typename ReaderType::Pointer reader = ReaderType::New();
+  reader->SetImageIO( itk::NiftiImageIO::New() );
+  reader->SetFileName( filename );
+  reader->GetOutput()->SetRequestedRegion(region);
+  reader->GetOutput()->Update();
+
+  const TImage *image = reader->GetOutput();
+  if ( image->GetBufferedRegion() != region )
+    {
+    std::cerr << filename << ": read " << image->GetBufferedRegion()
+              << " instead of " << region << std::endl;
+    return false;
+    }
+  itk::ImageRegionConstIterator< TImage > it(image, region);
+  itk::ImageRegionConstIterator< TImage > ot(original, region);
+  for (; !it.IsAtEnd(); ++it, ++ot )
+    {
+    if ( it.Get() != ot.Get() )
+      {
+      std::cerr << filename << ": wrong value " << it.Get() << " instead of "
+                << ot.Get() << " at " << it.GetIndex() << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+int itkNiftiImageIOTest13(int ac, char* av[])
+{
+  //
+  // first argument is passing in the writable directory to do all testing
+  if(ac > 1) {
+    char *testdir = *++av;
+    --ac;
+    itksys::SystemTools::ChangeDirectory(testdir);
+  }
+
+  typedef itk::Image< short, 4 >        ScalarImageType;
+  typedef itk::VectorImage< float, 3 >  VectorImageType;
+
+  ScalarImageType::RegionType scalarRegion;
+  ScalarImageType::SizeType   scalarSize = {{ 11, 9, 7, 5 }};
+  scalarRegion.SetSize(scalarSize);
+  ScalarImageType::Pointer scalarImage = ScalarImageType::New();
+  scalarImage->SetRegions(scalarRegion);
+  scalarImage->Allocate();
+  for ( itk::ImageRegionIterator< ScalarImageType > it(scalarImage, scalarRegion); !it.IsAtEnd(); ++it )
+    {
+    it.Set( StreamedReadScalar( it.GetIndex() ) );
+    }
+
+  VectorImageType::RegionType vectorRegion;
+  VectorImageType::SizeType   vectorSize = {{ 6, 5, 4 }};
+  vectorRegion.SetSize(vectorSize);
+  VectorImageType::Pointer vectorImage = VectorImageType::New();
+  vectorImage->SetRegions(vectorRegion);
+  vectorImage->SetNumberOfComponentsPerPixel(3);
+  vectorImage->Allocate();
+  for ( itk::ImageRegionIterator< VectorImageType > it(vectorImage, vectorRegion); !it.IsAtEnd(); ++it )
+    {
+    VectorImageType::PixelType value(3);
+    for ( unsigned int c = 0; c < 3; c++ )
+      {
+      value[c] = StreamedReadComponent( it.GetIndex(), c );
+      }
+    it.Set(value);
+    }
+
+  // a time slab, an inner block and a single row
+  std::vector< ScalarImageType::RegionType > scalarRegions;
+  ScalarImageType::IndexType index = {{ 0, 0, 0, 2 }};
+  ScalarImageType::SizeType  size = {{ 11, 9, 7, 2 }};
+  scalarRegions.push_back( ScalarImageType::RegionType(index, size) );
+  ScalarImageType::IndexType index2 = {{ 3, 2, 1, 1 }};
+  ScalarImageType::SizeType  size2 = {{ 5, 4, 3, 3 }};
+  scalarRegions.push_back( ScalarImageType::RegionType(index2, size2) );
+  ScalarImageType::IndexType index3 = {{ 0, 8, 6, 4 }};
+  ScalarImageType::SizeType  size3 = {{ 11, 1, 1, 1 }};
+  scalarRegions.push_back( ScalarImageType::RegionType(index3, size3) );
+
+  VectorImageType::IndexType vectorIndex = {{ 1, 2, 1 }};
+  VectorImageType::SizeType  vectorRegionSize = {{ 4, 2, 3 }};
+  const VectorImageType::RegionType vectorSubRegion(vectorIndex, vectorRegionSize);
+
+  const char *extensions[] = { ".nii", ".nii.gz" };
+  int         status = EXIT_SUCCESS;
+  try
+    {
+    for ( unsigned int e = 0; e < 2; e++ )
+      {
+      const std::string scalarFileName = std::string("StreamedReadScalar") + extensions[e];
+      itk::IOTestHelper::WriteImage< ScalarImageType, itk::NiftiImageIO >(scalarImage, scalarFileName);
+      for ( size_t r = 0; r < scalarRegions.size(); r++ )
+        {
+        if ( !CheckStreamedRead< ScalarImageType >(scalarFileName, scalarRegions[r], scalarImage) )
+          {
+          status = EXIT_FAILURE;
+          }
+        }
+
+      const std::string vectorFileName = std::string("StreamedReadVector") + extensions[e];
+      itk::IOTestHelper::WriteImage< VectorImageType, itk::NiftiImageIO >(vectorImage, vectorFileName);
+      if ( !CheckStreamedRead< VectorImageType >(vectorFileName, vectorSubRegion, vectorImage) )
+        {
+        status = EXIT_FAILURE;
+        }
+      }
+    }
+  catch ( itk::ExceptionObject & err )
+    {
+    std::cerr << err << std::endl;
+    return EXIT_FAILURE;
+    }
+  return status;
+}
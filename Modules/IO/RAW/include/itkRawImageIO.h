@@ -106,6 +106,10 @@ public:
   /** Reads the data from disk into the memory buffer provided. */
   virtual void Read(void *buffer);
 
+  /** The data can be memory mapped when it is binary and stored in the
+   * byte order of the host. */
+  virtual bool CanMemoryMapRead(std::string & dataFileName, SizeType & offset);
+
   /** Set/Get the Data mask. */
   itkGetConstReferenceMacro(ImageMask, unsigned short);
   void SetImageMask(unsigned long val)
@@ -136,6 +140,10 @@ protected:
   ~RawImageIO();
   void PrintSelf(std::ostream & os, Indent indent) const;
 
+  /** Returns a RawImageIO with the same image description, header size,
+   * file dimensionality and mask, which can read the same files. */
+  virtual LightObject::Pointer InternalClone() const;
+
   //void ComputeInternalFileName(unsigned long slice);
   void OpenFileForReading(std::ifstream & is);
 
@@ -60,6 +60,26 @@ void RawImageIO< TPixel, VImageDimension >::PrintSelf(std::ostream & os, Indent
   os << indent << "FileDimensionality: " << m_FileDimensionality << std::endl;
 }
 
+template< class TPixel, unsigned int VImageDimension >
+LightObject::Pointer RawImageIO< TPixel, VImageDimension >::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+  Pointer              rval = dynamic_cast< Self * >( loPtr.GetPointer() );
+  if ( rval.IsNull() )
+    {
+    itkExceptionMacro(<< "downcast to type "
+                      << this->GetNameOfClass()
+                      << " failed.");
+    }
+
+  rval->m_FileDimensionality = m_FileDimensionality;
+  rval->m_ManualHeaderSize = m_ManualHeaderSize;
+  rval->m_HeaderSize = m_HeaderSize;
+  rval->m_ImageMask = m_ImageMask;
+
+  return loPtr;
+}
+
 template< class TPixel, unsigned int VImageDimension >
 SizeValueType RawImageIO< TPixel, VImageDimension >::GetHeaderSize()
 {
@@ -232,6 +252,27 @@ void RawImageIO< TPixel, VImageDimension >
   else if itkReadRawBytesAfterSwappingMacro(double, DOUBLE)
 }
 
+template< class TPixel, unsigned int VImageDimension >
+bool RawImageIO< TPixel, VImageDimension >
+::CanMemoryMapRead(std::string & dataFileName, SizeType & offset)
+{
+  const ByteOrder systemByteOrder =
+    ByteSwapper< int >::SystemIsBigEndian() ? BigEndian : LittleEndian;
+
+  if ( m_FileType != Binary
+       || ( this->GetComponentSize() > 1
+            && m_ByteOrder != OrderNotApplicable
+            && m_ByteOrder != systemByteOrder ) )
+    {
+    return false;
+    }
+
+  this->ComputeStrides();
+  dataFileName = m_FileName;
+  offset = static_cast< SizeType >( this->GetHeaderSize() );
+  return true;
+}
+
 template< class TPixel, unsigned int VImageDimension >
 bool RawImageIO< TPixel, VImageDimension >
 ::CanWriteFile(const char *fname)
@@ -0,0 +1,135 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include <fstream>
+#include "itkRawImageIO.h"
+#include "itkImageSeriesReader.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itksys/SystemTools.hxx"
+
+// The slices of a series of raw files are read on several threads with
+// clones of the RawImageIO set, which must describe the files as well.
+namespace
+{
+unsigned short RawImageIOSeriesReaderTestPixel(unsigned int x, unsigned int y, unsigned int z)
+{
+  return static_cast< unsigned short >( x + 10 * y + 1000 * z );
+}
+}
+
+int itkRawImageIOSeriesReaderTest(int argc, char *argv[])
+{
+  if ( argc < 2 )
+    {
+    std::cerr << "Usage: " << argv[0] << " OutputDirectory" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  typedef itk::Image< unsigned short, 3 >                ImageType;
+  typedef itk::RawImageIO< unsigned short, 2 >           RawImageIOType;
+  typedef itk::ImageSeriesReader< ImageType >            ReaderType;
+
+  const unsigned int sizeX = 8;
+  const unsigned int sizeY = 6;
+  const unsigned int numberOfSlices = 7;
+  const unsigned int headerSize = 12;
+
+  // little endian slices after a header of 12 bytes
+  ReaderType::FileNamesContainer fileNames;
+  for ( unsigned int z = 0; z < numberOfSlices; ++z )
+    {
+    std::ostringstream fileName;
+    fileName << argv[1] << "/RawImageIOSeriesReaderTest" << z << ".raw";
+    fileNames.push_back( fileName.str() );
+
+    std::ofstream file( fileName.str().c_str(), std::ios::out | std::ios::binary );
+    for ( unsigned int i = 0; i < headerSize; ++i )
+      {
+      file.put( static_cast< char >( 0xff ) );
+      }
+    for ( unsigned int y = 0; y < sizeY; ++y )
+      {
+      for ( unsigned int x = 0; x < sizeX; ++x )
+        {
+        const unsigned short value = RawImageIOSeriesReaderTestPixel(x, y, z);
+        file.put( static_cast< char >( value & 0xff ) );
+        file.put( static_cast< char >( value >> 8 ) );
+        }
+      }
+    }
+
+  RawImageIOType::Pointer io = RawImageIOType::New();
+  io->SetHeaderSize( headerSize );
+  io->SetByteOrderToLittleEndian();
+  io->SetDimensions( 0, sizeX );
+  io->SetDimensions( 1, sizeY );
+  io->SetSpacing( 0, 0.5 );
+  io->SetSpacing( 1, 2.0 );
+  io->SetOrigin( 0, -3.0 );
+  io->SetOrigin( 1, 4.0 );
+
+  int result = EXIT_SUCCESS;
+  try
+    {
+    ReaderType::Pointer reader = ReaderType::New();
+    reader->SetImageIO( io );
+    reader->SetFileNames( fileNames );
+    reader->SetNumberOfReadingThreads( 4 );
+    reader->Update();
+
+    ImageType::ConstPointer image = reader->GetOutput();
+    const ImageType::SizeType size = image->GetLargestPossibleRegion().GetSize();
+    if ( size[0] != sizeX || size[1] != sizeY || size[2] != numberOfSlices
+         || image->GetSpacing()[0] != 0.5 || image->GetSpacing()[1] != 2.0
+         || image->GetOrigin()[0] != -3.0 || image->GetOrigin()[1] != 4.0 )
+      {
+      std::cerr << "The series was read with the size " << size
+                << ", spacing " << image->GetSpacing()
+                << " and origin " << image->GetOrigin() << std::endl;
+      result = EXIT_FAILURE;
+      }
+    else
+      {
+      itk::ImageRegionConstIteratorWithIndex< ImageType > it( image, image->GetLargestPossibleRegion() );
+      for ( ; !it.IsAtEnd(); ++it )
+        {
+        const ImageType::IndexType index = it.GetIndex();
+        const unsigned short       expected = RawImageIOSeriesReaderTestPixel(index[0], index[1], index[2]);
+        if ( it.Get() != expected )
+          {
+          std::cerr << "Pixel " << index << " is " << it.Get()
+                    << " instead of " << expected << std::endl;
+          result = EXIT_FAILURE;
+          break;
+          }
+        }
+      }
+    }
+  catch ( itk::ExceptionObject & err )
+    {
+    std::cerr << "Exception caught: " << err << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  for ( unsigned int z = 0; z < numberOfSlices; ++z )
+    {
+    itksys::SystemTools::RemoveFile( fileNames[z].c_str() );
+    }
+
+  return result;
+}
@@ -73,6 +73,19 @@ public:
   /** Reads 3D data from tiled tiff. */
   virtual void ReadTiles(void *buffer);
 
+  /** Single page grayscale and RGB images whose samples can be copied
+   * as they are decoded support streamed reading. Their strips or
+   * tiles are decoded on several threads, and only the ones
+   * intersecting the IORegion are read. */
+  virtual bool CanStreamRead()
+  {
+    return m_CanReadEncodedData;
+  }
+
+  /** Returns the requested region when the file can be streamed. */
+  virtual ImageIORegion
+  GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requested) const;
+
   /*-------- This part of the interfaces deals with writing data. ----- */
 
   /** Determine the file type. Returns true if this ImageIO can read the
@@ -146,6 +159,13 @@ protected:
 
   int EvaluateImageAt(void *out, void *in);
 
+  /** Returns true when the strips or tiles of the image hold the pixels
+   * exactly as they are returned by Read. */
+  bool CanReadEncodedData();
+
+  /** Decodes the strips or tiles intersecting the IORegion. */
+  void ReadEncodedRegion(void *buffer);
+
   unsigned int  GetFormat();
 
   void GetColor(int index, unsigned short *red,
@@ -175,6 +195,7 @@ private:
   unsigned short *m_ColorBlue;
   int             m_TotalColors;
   unsigned int    m_ImageFormat;
+  bool            m_CanReadEncodedData;
 };
 } // end namespace itk
 
@@ -17,9 +17,13 @@
  *=========================================================================*/
 
 #include "itkTIFFImageIO.h"
+#include "itkMultiThreader.h"
 #include "itksys/SystemTools.hxx"
 
 #include <sys/stat.h>
+#include <algorithm>
+#include <cstring>
+#include <vector>
 
 namespace itk
 {
@@ -1079,6 +1083,211 @@ unsigned int TIFFImageIO::GetFormat()
   return m_ImageFormat;
 }
 
+namespace
+{
+/** Shared state of the threads decoding the strips or tiles of an
+ * image. A strip is handled as a tile as wide as the image. */
+struct EncodedReadThreadStruct
+{
+  std::string             FileName;
+  TIFF *                  Image;
+  bool                    Tiled;
+  uint32                  ChunkWidth;
+  uint32                  ChunkHeight;
+  uint32                  ChunksAcross;
+  std::vector< uint32 >   Chunks;
+  size_t                  PixelSize;
+  uint32                  RegionStart[2];
+  uint32                  RegionSize[2];
+  unsigned char *         Buffer;
+  bool                    Failed;
+};
+
+/** Decodes the chunks first, first + step, ... with the given handle
+ * and copies the part intersecting the region to the buffer. */
+bool ReadEncodedChunks(const EncodedReadThreadStruct & str, TIFF *image,
+                       size_t first, size_t step)
+{
+  const tsize_t chunkSize = str.Tiled ? TIFFTileSize(image) : TIFFStripSize(image);
+  if ( chunkSize <= 0 )
+    {
+    return false;
+    }
+  std::vector< unsigned char > chunk( static_cast< size_t >( chunkSize ) );
+
+  const uint32 regionEnd[2] = { str.RegionStart[0] + str.RegionSize[0],
+                                str.RegionStart[1] + str.RegionSize[1] };
+  const size_t chunkRowSize = str.ChunkWidth * str.PixelSize;
+  const size_t regionRowSize = str.RegionSize[0] * str.PixelSize;
+
+  for ( size_t c = first; c < str.Chunks.size(); c += step )
+    {
+    const uint32 index = str.Chunks[c];
+    const tsize_t decoded = str.Tiled
+                            ? TIFFReadEncodedTile(image, index, &chunk[0], chunkSize)
+                            : TIFFReadEncodedStrip(image, index, &chunk[0], chunkSize);
+    if ( decoded < 0 )
+      {
+      return false;
+      }
+
+    const uint32 x0 = ( index % str.ChunksAcross ) * str.ChunkWidth;
+    const uint32 y0 = ( index / str.ChunksAcross ) * str.ChunkHeight;
+    const uint32 xBegin = std::max(x0, str.RegionStart[0]);
+    const uint32 xEnd = std::min(x0 + str.ChunkWidth, regionEnd[0]);
+    const uint32 yBegin = std::max(y0, str.RegionStart[1]);
+    const uint32 yEnd = std::min(y0 + str.ChunkHeight, regionEnd[1]);
+    for ( uint32 y = yBegin; y < yEnd; ++y )
+      {
+      std::memcpy(str.Buffer + ( y - str.RegionStart[1] ) * regionRowSize
+                  + ( xBegin - str.RegionStart[0] ) * str.PixelSize,
+                  &chunk[0] + ( y - y0 ) * chunkRowSize + ( xBegin - x0 ) * str.PixelSize,
+                  ( xEnd - xBegin ) * str.PixelSize);
+      }
+    }
+  return true;
+}
+
+ITK_THREAD_RETURN_TYPE ReadEncodedChunksThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  EncodedReadThreadStruct *        str = static_cast< EncodedReadThreadStruct * >( info->UserData );
+
+  // A libtiff handle cannot be shared between threads, so all the
+  // threads but the first one open the file again.
+  TIFF *image = str->Image;
+  if ( info->ThreadID > 0 )
+    {
+    image = TIFFOpen(str->FileName.c_str(), "r");
+    }
+  if ( !image )
+    {
+    str->Failed = true;
+    return ITK_THREAD_RETURN_VALUE;
+    }
+  if ( !ReadEncodedChunks(*str, image, info->ThreadID, info->NumberOfThreads) )
+    {
+    str->Failed = true;
+    }
+  if ( image != str->Image )
+    {
+    TIFFClose(image);
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+} // end anonymous namespace
+
+bool TIFFImageIO::CanReadEncodedData()
+{
+  if ( !m_InternalImage->CanRead()
+       || this->GetNumberOfDimensions() != 2
+       || m_InternalImage->m_Orientation != ORIENTATION_TOPLEFT
+       || m_InternalImage->m_BitsPerSample != 8 * this->GetComponentSize() )
+    {
+    return false;
+    }
+
+  // Only the formats that EvaluateImageAt copies without any conversion
+  switch ( this->GetFormat() )
+    {
+    case TIFFImageIO::GRAYSCALE:
+      return m_InternalImage->m_Photometrics == PHOTOMETRIC_MINISBLACK
+             && m_InternalImage->m_SamplesPerPixel == 1
+             && ( m_ComponentType == UCHAR || m_ComponentType == CHAR
+                  || m_ComponentType == USHORT || m_ComponentType == SHORT
+                  || m_ComponentType == FLOAT );
+    case TIFFImageIO::RGB_:
+      return m_InternalImage->m_Photometrics == PHOTOMETRIC_RGB
+             && m_InternalImage->m_SamplesPerPixel == 3
+             && ( m_ComponentType == UCHAR || m_ComponentType == CHAR
+                  || m_ComponentType == USHORT );
+    default:
+      return false;
+    }
+}
+
+void TIFFImageIO::ReadEncodedRegion(void *buffer)
+{
+  EncodedReadThreadStruct str;
+  str.FileName = m_FileName;
+  str.Image = m_InternalImage->m_Image;
+  str.Tiled = TIFFIsTiled(str.Image) != 0;
+  str.PixelSize = this->GetComponentSize() * this->GetNumberOfComponents();
+  str.Buffer = static_cast< unsigned char * >( buffer );
+  str.Failed = false;
+
+  if ( str.Tiled )
+    {
+    if ( !TIFFGetField(str.Image, TIFFTAG_TILEWIDTH, &str.ChunkWidth)
+         || !TIFFGetField(str.Image, TIFFTAG_TILELENGTH, &str.ChunkHeight)
+         || str.ChunkWidth == 0 || str.ChunkHeight == 0 )
+      {
+      itkExceptionMacro(<< "Cannot read tile width and tile length from file " << m_FileName);
+      }
+    }
+  else
+    {
+    uint32 rowsPerStrip = m_InternalImage->m_Height;
+    TIFFGetFieldDefaulted(str.Image, TIFFTAG_ROWSPERSTRIP, &rowsPerStrip);
+    str.ChunkWidth = m_InternalImage->m_Width;
+    str.ChunkHeight = std::max< uint32 >( 1, std::min(rowsPerStrip, m_InternalImage->m_Height) );
+    }
+  str.ChunksAcross = ( m_InternalImage->m_Width + str.ChunkWidth - 1 ) / str.ChunkWidth;
+
+  for ( unsigned int i = 0; i < 2; ++i )
+    {
+    str.RegionStart[i] = static_cast< uint32 >( m_IORegion.GetIndex(i) );
+    str.RegionSize[i] = static_cast< uint32 >( m_IORegion.GetSize(i) );
+    }
+  if ( str.RegionSize[0] == 0 || str.RegionSize[1] == 0 )
+    {
+    return;
+    }
+
+  // Only the chunks intersecting the region are decoded
+  for ( uint32 row = str.RegionStart[1] / str.ChunkHeight;
+        row <= ( str.RegionStart[1] + str.RegionSize[1] - 1 ) / str.ChunkHeight; ++row )
+    {
+    for ( uint32 col = str.RegionStart[0] / str.ChunkWidth;
+          col <= ( str.RegionStart[0] + str.RegionSize[0] - 1 ) / str.ChunkWidth; ++col )
+      {
+      str.Chunks.push_back(row * str.ChunksAcross + col);
+      }
+    }
+
+  ThreadIdType numberOfThreads = MultiThreader::GetGlobalDefaultNumberOfThreads();
+  if ( str.Chunks.size() < numberOfThreads )
+    {
+    numberOfThreads = static_cast< ThreadIdType >( str.Chunks.size() );
+    }
+  if ( numberOfThreads > 1 )
+    {
+    MultiThreader::Pointer threader = MultiThreader::New();
+    threader->SetNumberOfThreads(numberOfThreads);
+    threader->SetSingleMethod(ReadEncodedChunksThreaderCallback, &str);
+    threader->SingleMethodExecute();
+    }
+  else
+    {
+    str.Failed = !ReadEncodedChunks(str, str.Image, 0, 1);
+    }
+
+  if ( str.Failed )
+    {
+    itkExceptionMacro(<< "Problem decoding the strips or tiles of " << m_FileName);
+    }
+}
+
+ImageIORegion
+TIFFImageIO::GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requested) const
+{
+  if ( !m_UseStreamedReading || !m_CanReadEncodedData || requested.GetImageDimension() != 2 )
+    {
+    return Superclass::GenerateStreamableReadRegionFromRequestedRegion(requested);
+    }
+  return requested;
+}
+
 /** Read a tiled tiff */
 void TIFFImageIO::ReadTiles(void *buffer)
 {
@@ -1458,6 +1667,13 @@ void TIFFImageIO::Read(void *buffer)
     return;
     }
 
+  if ( this->GetIORegion().GetImageDimension() == 2 && this->CanReadEncodedData() )
+    {
+    this->ReadEncodedRegion(buffer);
+    m_InternalImage->Clean();
+    return;
+    }
+
   unsigned int format = this->GetFormat();
 
   switch ( format )
@@ -1490,6 +1706,7 @@ TIFFImageIO::TIFFImageIO()
   m_Origin[1] = 0.0;
 
   m_Compression = TIFFImageIO::PackBits;
+  m_CanReadEncodedData = false;
 
   this->AddSupportedWriteExtension(".tif");
   this->AddSupportedWriteExtension(".TIF");
@@ -1658,6 +1875,8 @@ void TIFFImageIO::ReadImageInformation()
     m_Origin[2] = 0.0;
     }
 
+  m_CanReadEncodedData = this->CanReadEncodedData();
+
   return;
 }
 
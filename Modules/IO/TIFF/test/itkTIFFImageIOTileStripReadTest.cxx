@@ -0,0 +1,218 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkMultiThreader.h"
+#include "itkRGBPixel.h"
+#include "itkTIFFImageIO.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+const uint32 TestWidth = 157;
+const uint32 TestHeight = 129;
+
+template< class TComponent >
+TComponent TestValue(uint32 x, uint32 y, unsigned int c)
+{
+  return static_cast< TComponent >( x * 7 + y * 131 + c * 1009 );
+}
+
+// Writes the test image with libtiff, in tiles of 32x16 pixels or in
+// strips of 5 rows.
+template< class TComponent >
+bool WriteTestFile(const std::string & fileName, unsigned int samplesPerPixel, bool tiled)
+{
+  TIFF *tif = TIFFOpen(fileName.c_str(), "w");
+  if ( !tif )
+    {
+    return false;
+    }
+  TIFFSetField(tif, TIFFTAG_IMAGEWIDTH, TestWidth);
+  TIFFSetField(tif, TIFFTAG_IMAGELENGTH, TestHeight);
+  TIFFSetField(tif, TIFFTAG_SAMPLESPERPIXEL, samplesPerPixel);
+  TIFFSetField(tif, TIFFTAG_BITSPERSAMPLE, 8 * sizeof( TComponent ));
+  TIFFSetField(tif, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
+  TIFFSetField(tif, TIFFTAG_PHOTOMETRIC,
+               samplesPerPixel == 3 ? PHOTOMETRIC_RGB : PHOTOMETRIC_MINISBLACK);
+  TIFFSetField(tif, TIFFTAG_COMPRESSION, COMPRESSION_LZW);
+
+  const uint32 chunkWidth = tiled ? 32 : TestWidth;
+  const uint32 chunkHeight = tiled ? 16 : 5;
+  if ( tiled )
+    {
+    TIFFSetField(tif, TIFFTAG_TILEWIDTH, chunkWidth);
+    TIFFSetField(tif, TIFFTAG_TILELENGTH, chunkHeight);
+    }
+  else
+    {
+    TIFFSetField(tif, TIFFTAG_ROWSPERSTRIP, chunkHeight);
+    }
+
+  std::vector< TComponent > chunk(chunkWidth * chunkHeight * samplesPerPixel);
+  for ( uint32 y0 = 0; y0 < TestHeight; y0 += chunkHeight )
+    {
+    for ( uint32 x0 = 0; x0 < TestWidth; x0 += chunkWidth )
+      {
+      const uint32 rows = tiled ? chunkHeight : std::min(chunkHeight, TestHeight - y0);
+      for ( uint32 y = 0; y < rows; ++y )
+        {
+        for ( uint32 x = 0; x < chunkWidth; ++x )
+          {
+          for ( unsigned int c = 0; c < samplesPerPixel; ++c )
+            {
+            chunk[( y * chunkWidth + x ) * samplesPerPixel + c] =
+              TestValue< TComponent >(x0 + x, y0 + y, c);
+            }
+          }
+        }
+      const tsize_t size = rows * chunkWidth * samplesPerPixel * sizeof( TComponent );
+      const tsize_t written = tiled
+                              ? TIFFWriteEncodedTile(tif, TIFFComputeTile(tif, x0, y0, 0, 0), &chunk[0], size)
+                              : TIFFWriteEncodedStrip(tif, TIFFComputeStrip(tif, y0, 0), &chunk[0], size);
+      if ( written < 0 )
+        {
+        TIFFClose(tif);
+        return false;
+        }
+      }
+    }
+  TIFFClose(tif);
+  return true;
+}
+
+template< class TPixel >
+typename itk::NumericTraits< TPixel >::ValueType Component(const TPixel & pixel, unsigned int)
+{
+  return pixel;
+}
+
+template< class TComponent >
+TComponent Component(const itk::RGBPixel< TComponent > & pixel, unsigned int c)
+{
+  return pixel[c];
+}
+
+// Reads the requested region of the file and checks that only that
+// region was read, and that it holds the expected values.
+template< class TImage >
+bool ReadAndCheck(const std::string & fileName, const typename TImage::RegionType & requested,
+                  unsigned int samplesPerPixel)
+{
+  typedef itk::ImageFileReader< TImage > ReaderType;
+  typename ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(fileName);
+  reader->SetImageIO( itk::TIFFImageIO::New() );
+  reader->UpdateOutputInformation();
+  reader->GetOutput()->SetRequestedRegion(requested);
+  reader->Update();
+
+  const TImage *image = reader->GetOutput();
+  if ( image->GetBufferedRegion() != requested )
+    {
+    std::cerr << fileName << ": buffered region " << image->GetBufferedRegion()
+              << " differs from the requested region " << requested << std::endl;
+    return false;
+    }
+
+  typedef typename itk::NumericTraits< typename TImage::PixelType >::ValueType ComponentType;
+  itk::ImageRegionConstIteratorWithIndex< TImage > it(image, requested);
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const typename TImage::IndexType index = it.GetIndex();
+    for ( unsigned int c = 0; c < samplesPerPixel; ++c )
+      {
+      const ComponentType expected = TestValue< ComponentType >(index[0], index[1], c);
+      if ( Component(it.Get(), c) != expected )
+        {
+        std::cerr << fileName << ": wrong value at " << index << " component " << c
+                  << ", expected " << static_cast< double >( expected )
+                  << " but found " << static_cast< double >( Component(it.Get(), c) ) << std::endl;
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+template< class TImage >
+bool TestFile(const std::string & fileName, unsigned int samplesPerPixel, bool tiled)
+{
+  typedef typename itk::NumericTraits< typename TImage::PixelType >::ValueType ComponentType;
+  if ( !WriteTestFile< ComponentType >(fileName, samplesPerPixel, tiled) )
+    {
+    std::cerr << "Cannot write " << fileName << std::endl;
+    return false;
+    }
+
+  typename TImage::RegionType full;
+  full.SetSize(0, TestWidth);
+  full.SetSize(1, TestHeight);
+
+  // A region that cuts through strips and tiles on every side
+  typename TImage::RegionType region;
+  region.SetIndex(0, 45);
+  region.SetIndex(1, 17);
+  region.SetSize(0, 70);
+  region.SetSize(1, 101);
+
+  return ReadAndCheck< TImage >(fileName, full, samplesPerPixel)
+         && ReadAndCheck< TImage >(fileName, region, samplesPerPixel);
+}
+} // end anonymous namespace
+
+int itkTIFFImageIOTileStripReadTest( int argc, char* argv[] )
+{
+  if( argc < 2 )
+    {
+    std::cerr << "Usage: " << argv[0] << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+    }
+  const std::string directory = argv[1];
+
+  // Decode the strips and tiles on several threads
+  itk::MultiThreader::SetGlobalDefaultNumberOfThreads(4);
+
+  typedef itk::Image< unsigned char, 2 >                    GrayImageType;
+  typedef itk::Image< itk::RGBPixel< unsigned short >, 2 > RGBImageType;
+
+  bool pass = true;
+  try
+    {
+    pass &= TestFile< GrayImageType >(directory + "/TileStripReadGrayTiled.tif", 1, true);
+    pass &= TestFile< GrayImageType >(directory + "/TileStripReadGrayStrips.tif", 1, false);
+    pass &= TestFile< RGBImageType >(directory + "/TileStripReadRGBTiled.tif", 3, true);
+    pass &= TestFile< RGBImageType >(directory + "/TileStripReadRGBStrips.tif", 3, false);
+    }
+  catch( itk::ExceptionObject & excp )
+    {
+    std::cerr << excp << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if( !pass )
+    {
+    std::cerr << "Test FAILED !" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test PASSED !" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,639 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// Runs a curated set of representative workloads on synthetic images and
+// reports their timings and memory usage as JSON.
+//
+//   itkBenchmarkDriver [--sizes 32,64,128] [--threads 1,4] [--iterations 3]
+//                      [--filter name] [--output file.json]
+//                      [--temporary-directory dir]
+//
+// The sizes are the number of voxels along each axis of the 3D images.  By
+// default the workloads are run with one thread, and with the default number
+// of threads of the platform.  The progress and a readable summary of the
+// probes are written to the standard error.
+
+#include "itkTimeProbesCollectorBase.h"
+#include "itkMemoryProbesCollectorBase.h"
+#include "itkMultiThreader.h"
+#include "itkVersion.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkResampleImageFilter.h"
+#include "itkAffineTransform.h"
+#include "itkBSplineTransform.h"
+#include "itkLinearInterpolateImageFunction.h"
+#include "itkDiscreteGaussianImageFilter.h"
+#include "itkMedianImageFilter.h"
+#include "itkBinaryThresholdImageFilter.h"
+#include "itkConnectedComponentImageFilter.h"
+#include "itkSignedMaurerDistanceMapImageFilter.h"
+#include "itkMattesMutualInformationImageToImageMetricv4.h"
+#include "itkTranslationTransform.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkMetaImageIOFactory.h"
+#include "itkNrrdImageIOFactory.h"
+#include "itkNiftiImageIOFactory.h"
+#include "itksys/SystemInformation.hxx"
+#include "itksys/SystemTools.hxx"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+const unsigned int Dimension = 3;
+
+typedef itk::Image< float, Dimension >         FloatImageType;
+typedef itk::Image< short, Dimension >         ShortImageType;
+typedef itk::Image< unsigned char, Dimension > MaskImageType;
+typedef itk::Image< unsigned int, Dimension >  LabelImageType;
+
+/** Collects the timings and memory usage of the workloads. */
+class BenchmarkRunner
+{
+public:
+  BenchmarkRunner():
+    m_Iterations(3)
+  {}
+
+  std::vector< unsigned int >      m_Sizes;
+  std::vector< itk::ThreadIdType > m_Threads;
+  unsigned int                     m_Iterations;
+  std::string                      m_Filter;
+  std::string                      m_Output;
+  std::string                      m_TemporaryDirectory;
+
+  itk::TimeProbesCollectorBase   m_TimeProbes;
+  itk::MemoryProbesCollectorBase m_MemoryProbes;
+
+  /** Whether the workload was selected on the command line. */
+  bool IsSelected(const std::string & workload) const
+  {
+    return m_Filter.empty() || workload.find(m_Filter) != std::string::npos;
+  }
+
+  /** Name of the probes of a workload run on images of the given size,
+   * with the given number of threads. */
+  static std::string ProbeName(const std::string & workload, unsigned int size,
+                               itk::ThreadIdType threads)
+  {
+    std::ostringstream name;
+    name << workload << "/size=" << size << "/threads=" << threads;
+    return name.str();
+  }
+
+  void Start(const std::string & name)
+  {
+    m_MemoryProbes.Start( name.c_str() );
+    m_TimeProbes.Start( name.c_str() );
+  }
+
+  void Stop(const std::string & name)
+  {
+    m_TimeProbes.Stop( name.c_str() );
+    m_MemoryProbes.Stop( name.c_str() );
+  }
+
+  /** Time the update of a filter that has been fully set up. */
+  template< class TFilter >
+  void UpdateFilter(const std::string & name, TFilter *filter)
+  {
+    this->Start(name);
+    filter->Update();
+    this->Stop(name);
+  }
+};
+
+/** Smooth blobs plus uniform noise.  The content only depends on the size
+ * and on the shift of the blobs, so that all the runs process the same
+ * data. */
+FloatImageType::Pointer
+MakeSyntheticImage(unsigned int size, double shift = 0.0)
+{
+  FloatImageType::Pointer image = FloatImageType::New();
+  FloatImageType::SizeType imageSize;
+  imageSize.Fill(size);
+  FloatImageType::RegionType region;
+  region.SetSize(imageSize);
+  image->SetRegions(region);
+  image->Allocate();
+
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize(121212);
+
+  const unsigned int numberOfBlobs = 4;
+  const double       centers[numberOfBlobs][Dimension] =
+    { { 0.30, 0.30, 0.50 }, { 0.70, 0.35, 0.40 }, { 0.45, 0.70, 0.60 }, { 0.60, 0.60, 0.25 } };
+  const double sigma = size / 8.0;
+
+  itk::ImageRegionIteratorWithIndex< FloatImageType > it(image, region);
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const FloatImageType::IndexType & index = it.GetIndex();
+    double value = 0.0;
+    for ( unsigned int b = 0; b < numberOfBlobs; ++b )
+      {
+      double distance2 = 0.0;
+      for ( unsigned int d = 0; d < Dimension; ++d )
+        {
+        const double delta = index[d] - ( centers[b][d] * size + shift );
+        distance2 += delta * delta;
+        }
+      value += 100.0 * vcl_exp( -distance2 / ( 2.0 * sigma * sigma ) );
+      }
+    value += generator->GetUniformVariate(-5.0, 5.0);
+    it.Set( static_cast< float >( value ) );
+    }
+  return image;
+}
+
+ShortImageType::Pointer
+MakeShortImage(const FloatImageType *input)
+{
+  ShortImageType::Pointer image = ShortImageType::New();
+  image->SetRegions( input->GetLargestPossibleRegion() );
+  image->Allocate();
+
+  itk::ImageRegionConstIterator< FloatImageType > it( input, input->GetLargestPossibleRegion() );
+  itk::ImageRegionIterator< ShortImageType >      ot( image, image->GetLargestPossibleRegion() );
+  for (; !it.IsAtEnd(); ++it, ++ot )
+    {
+    ot.Set( static_cast< short >( it.Get() ) );
+    }
+  return image;
+}
+
+MaskImageType::Pointer
+MakeMaskImage(const FloatImageType *input)
+{
+  typedef itk::BinaryThresholdImageFilter< FloatImageType, MaskImageType > ThresholdType;
+  ThresholdType::Pointer threshold = ThresholdType::New();
+  threshold->SetInput(input);
+  threshold->SetLowerThreshold(50.0f);
+  threshold->SetInsideValue(1);
+  threshold->SetOutsideValue(0);
+  threshold->Update();
+
+  MaskImageType::Pointer mask = threshold->GetOutput();
+  mask->DisconnectPipeline();
+  return mask;
+}
+
+void
+BenchmarkResampleAffine(BenchmarkRunner & runner, const FloatImageType *input,
+                        unsigned int size, itk::ThreadIdType threads)
+{
+  const std::string name = runner.ProbeName("ResampleAffine", size, threads);
+
+  typedef itk::AffineTransform< double, Dimension > TransformType;
+  TransformType::Pointer transform = TransformType::New();
+  TransformType::OutputVectorType axis;
+  axis[0] = 0.2;
+  axis[1] = 0.3;
+  axis[2] = 1.0;
+  transform->Rotate3D(axis, 0.2);
+  TransformType::OutputVectorType translation;
+  translation.Fill(0.1 * size);
+  transform->Translate(translation);
+
+  for ( unsigned int i = 0; i < runner.m_Iterations; ++i )
+    {
+    typedef itk::ResampleImageFilter< FloatImageType, FloatImageType > FilterType;
+    FilterType::Pointer filter = FilterType::New();
+    filter->SetInput(input);
+    filter->SetTransform(transform);
+    filter->SetOutputParametersFromImage(input);
+    filter->SetNumberOfThreads(threads);
+    runner.UpdateFilter(name, filter.GetPointer());
+    }
+}
+
+void
+BenchmarkResampleBSpline(BenchmarkRunner & runner, const FloatImageType *input,
+                         unsigned int size, itk::ThreadIdType threads)
+{
+  const std::string name = runner.ProbeName("ResampleBSpline", size, threads);
+
+  typedef itk::BSplineTransform< double, Dimension, 3 > TransformType;
+  TransformType::Pointer transform = TransformType::New();
+
+  TransformType::PhysicalDimensionsType dimensions;
+  TransformType::MeshSizeType           meshSize;
+  for ( unsigned int d = 0; d < Dimension; ++d )
+    {
+    dimensions[d] = input->GetSpacing()[d] * ( size - 1 );
+    }
+  meshSize.Fill(4);
+  transform->SetTransformDomainOrigin( input->GetOrigin() );
+  transform->SetTransformDomainDirection( input->GetDirection() );
+  transform->SetTransformDomainPhysicalDimensions(dimensions);
+  transform->SetTransformDomainMeshSize(meshSize);
+
+  // Reproducible smooth deformation of a few voxels.
+  TransformType::ParametersType parameters( transform->GetNumberOfParameters() );
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize(343434);
+  for ( unsigned int p = 0; p < parameters.Size(); ++p )
+    {
+    parameters[p] = generator->GetUniformVariate(-2.0, 2.0);
+    }
+  transform->SetParameters(parameters);
+
+  for ( unsigned int i = 0; i < runner.m_Iterations; ++i )
+    {
+    typedef itk::ResampleImageFilter< FloatImageType, FloatImageType > FilterType;
+    FilterType::Pointer filter = FilterType::New();
+    filter->SetInput(input);
+    filter->SetTransform(transform);
+    filter->SetOutputParametersFromImage(input);
+    filter->SetNumberOfThreads(threads);
+    runner.UpdateFilter(name, filter.GetPointer());
+    }
+}
+
+void
+BenchmarkDiscreteGaussian(BenchmarkRunner & runner, const FloatImageType *input,
+                          unsigned int size, itk::ThreadIdType threads)
+{
+  const std::string name = runner.ProbeName("DiscreteGaussian", size, threads);
+
+  for ( unsigned int i = 0; i < runner.m_Iterations; ++i )
+    {
+    typedef itk::DiscreteGaussianImageFilter< FloatImageType, FloatImageType > FilterType;
+    FilterType::Pointer filter = FilterType::New();
+    filter->SetInput(input);
+    filter->SetVariance(4.0);
+    filter->SetMaximumKernelWidth(64);
+    filter->SetNumberOfThreads(threads);
+    runner.UpdateFilter(name, filter.GetPointer());
+    }
+}
+
+void
+BenchmarkMedian(BenchmarkRunner & runner, const ShortImageType *input,
+                unsigned int size, itk::ThreadIdType threads)
+{
+  const std::string name = runner.ProbeName("Median", size, threads);
+
+  for ( unsigned int i = 0; i < runner.m_Iterations; ++i )
+    {
+    typedef itk::MedianImageFilter< ShortImageType, ShortImageType > FilterType;
+    FilterType::Pointer filter = FilterType::New();
+    FilterType::InputSizeType radius;
+    radius.Fill(2);
+    filter->SetInput(input);
+    filter->SetRadius(radius);
+    filter->SetNumberOfThreads(threads);
+    runner.UpdateFilter(name, filter.GetPointer());
+    }
+}
+
+void
+BenchmarkConnectedComponent(BenchmarkRunner & runner, const MaskImageType *input,
+                            unsigned int size, itk::ThreadIdType threads)
+{
+  const std::string name = runner.ProbeName("ConnectedComponent", size, threads);
+
+  for ( unsigned int i = 0; i < runner.m_Iterations; ++i )
+    {
+    typedef itk::ConnectedComponentImageFilter< MaskImageType, LabelImageType > FilterType;
+    FilterType::Pointer filter = FilterType::New();
+    filter->SetInput(input);
+    filter->SetNumberOfThreads(threads);
+    runner.UpdateFilter(name, filter.GetPointer());
+    }
+}
+
+void
+BenchmarkSignedMaurerDistanceMap(BenchmarkRunner & runner, const MaskImageType *input,
+                                 unsigned int size, itk::ThreadIdType threads)
+{
+  const std::string name = runner.ProbeName("SignedMaurerDistanceMap", size, threads);
+
+  for ( unsigned int i = 0; i < runner.m_Iterations; ++i )
+    {
+    typedef itk::SignedMaurerDistanceMapImageFilter< MaskImageType, FloatImageType > FilterType;
+    FilterType::Pointer filter = FilterType::New();
+    filter->SetInput(input);
+    filter->SetUseImageSpacing(true);
+    filter->SetSquaredDistance(false);
+    filter->SetNumberOfThreads(threads);
+    runner.UpdateFilter(name, filter.GetPointer());
+    }
+}
+
+void
+BenchmarkMattesMutualInformation(BenchmarkRunner & runner, const FloatImageType *fixed,
+                                 const FloatImageType *moving, unsigned int size,
+                                 itk::ThreadIdType threads)
+{
+  const std::string name = runner.ProbeName("MattesMutualInformationv4", size, threads);
+
+  typedef itk::MattesMutualInformationImageToImageMetricv4< FloatImageType, FloatImageType > MetricType;
+  typedef itk::TranslationTransform< double, Dimension >                                 TransformType;
+
+  for ( unsigned int i = 0; i < runner.m_Iterations; ++i )
+    {
+    TransformType::Pointer transform = TransformType::New();
+    transform->SetIdentity();
+
+    MetricType::Pointer metric = MetricType::New();
+    metric->SetFixedImage(fixed);
+    metric->SetMovingImage(moving);
+    metric->SetMovingTransform(transform);
+    metric->SetNumberOfHistogramBins(32);
+    metric->SetMaximumNumberOfThreads(threads);
+
+    MetricType::MeasureType    value;
+    MetricType::DerivativeType derivative;
+
+    // The initialization computes the image gradients, and is part of the
+    // cost of a registration.
+    runner.Start(name);
+    metric->Initialize();
+    metric->GetValueAndDerivative(value, derivative);
+    runner.Stop(name);
+    }
+}
+
+void
+BenchmarkIO(BenchmarkRunner & runner, const FloatImageType *input,
+            unsigned int size, const char *format, const char *extension)
+{
+  const std::string writeName = runner.ProbeName(std::string("ImageFileWriter") + format, size, 1);
+  const std::string readName = runner.ProbeName(std::string("ImageFileReader") + format, size, 1);
+
+  std::ostringstream fileName;
+  fileName << runner.m_TemporaryDirectory << "/itkBenchmark" << size << extension;
+
+  typedef itk::ImageFileWriter< FloatImageType > WriterType;
+  if ( runner.IsSelected(writeName) )
+    {
+    for ( unsigned int i = 0; i < runner.m_Iterations; ++i )
+      {
+      WriterType::Pointer writer = WriterType::New();
+      writer->SetInput(input);
+      writer->SetFileName( fileName.str() );
+      runner.UpdateFilter(writeName, writer.GetPointer());
+      }
+    }
+  else if ( runner.IsSelected(readName) )
+    {
+    // The file to read is written without timing the writer.
+    WriterType::Pointer writer = WriterType::New();
+    writer->SetInput(input);
+    writer->SetFileName( fileName.str() );
+    writer->Update();
+    }
+  if ( runner.IsSelected(readName) )
+    {
+    for ( unsigned int i = 0; i < runner.m_Iterations; ++i )
+      {
+      typedef itk::ImageFileReader< FloatImageType > ReaderType;
+      ReaderType::Pointer reader = ReaderType::New();
+      reader->SetFileName( fileName.str() );
+      runner.UpdateFilter(readName, reader.GetPointer());
+      }
+    }
+  itksys::SystemTools::RemoveFile( fileName.str().c_str() );
+}
+
+void
+RunBenchmarks(BenchmarkRunner & runner)
+{
+  for ( size_t s = 0; s < runner.m_Sizes.size(); ++s )
+    {
+    const unsigned int size = runner.m_Sizes[s];
+    std::cerr << "Generating the synthetic images of size " << size << std::endl;
+
+    FloatImageType::Pointer image = MakeSyntheticImage(size);
+    FloatImageType::Pointer moving = MakeSyntheticImage(size, 2.0);
+    ShortImageType::Pointer shortImage = MakeShortImage(image);
+    MaskImageType::Pointer  mask = MakeMaskImage(image);
+
+    for ( size_t t = 0; t < runner.m_Threads.size(); ++t )
+      {
+      const itk::ThreadIdType threads = runner.m_Threads[t];
+      std::cerr << "  " << threads << " thread(s)" << std::endl;
+
+      if ( runner.IsSelected("ResampleAffine") )
+        {
+        BenchmarkResampleAffine(runner, image, size, threads);
+        }
+      if ( runner.IsSelected("ResampleBSpline") )
+        {
+        BenchmarkResampleBSpline(runner, image, size, threads);
+        }
+      if ( runner.IsSelected("DiscreteGaussian") )
+        {
+        BenchmarkDiscreteGaussian(runner, image, size, threads);
+        }
+      if ( runner.IsSelected("Median") )
+        {
+        BenchmarkMedian(runner, shortImage, size, threads);
+        }
+      if ( runner.IsSelected("ConnectedComponent") )
+        {
+        BenchmarkConnectedComponent(runner, mask, size, threads);
+        }
+      if ( runner.IsSelected("SignedMaurerDistanceMap") )
+        {
+        BenchmarkSignedMaurerDistanceMap(runner, mask, size, threads);
+        }
+      if ( runner.IsSelected("MattesMutualInformationv4") )
+        {
+        BenchmarkMattesMutualInformation(runner, image, moving, size, threads);
+        }
+      }
+
+    BenchmarkIO(runner, image, size, "Meta", ".mha");
+    BenchmarkIO(runner, image, size, "NRRD", ".nrrd");
+    BenchmarkIO(runner, image, size, "NIFTI", ".nii.gz");
+    }
+}
+
+void
+WriteJSONReport(const BenchmarkRunner & runner, std::ostream & os)
+{
+  itksys::SystemInformation info;
+  info.RunCPUCheck();
+  info.RunOSCheck();
+  info.RunMemoryCheck();
+
+  os << "{" << std::endl;
+  os << "\"SystemInformation\": {" << std::endl;
+  os << "  \"ITKVersion\": ";
+  itk::TimeProbesCollectorBase::JSONWriteString( os, itk::Version::GetITKVersion() );
+  os << "," << std::endl << "  \"Hostname\": ";
+  itk::TimeProbesCollectorBase::JSONWriteString( os, info.GetHostname() );
+  os << "," << std::endl << "  \"OperatingSystem\": ";
+  itk::TimeProbesCollectorBase::JSONWriteString( os, std::string( info.GetOSName() ) + " " + info.GetOSRelease() );
+  os << "," << std::endl << "  \"Processor\": ";
+  itk::TimeProbesCollectorBase::JSONWriteString( os, info.GetExtendedProcessorName() );
+  os << "," << std::endl;
+  os << "  \"NumberOfPhysicalCPU\": " << info.GetNumberOfPhysicalCPU() << "," << std::endl;
+  os << "  \"NumberOfLogicalCPU\": " << info.GetNumberOfLogicalCPU() << "," << std::endl;
+  os << "  \"TotalPhysicalMemory\": " << info.GetTotalPhysicalMemory() << "," << std::endl;
+  os << "  \"GlobalDefaultNumberOfThreads\": "
+     << itk::MultiThreader::GetGlobalDefaultNumberOfThreads() << std::endl;
+  os << "}," << std::endl;
+
+  os << "\"Iterations\": " << runner.m_Iterations << "," << std::endl;
+  os << "\"Time\": ";
+  runner.m_TimeProbes.JSONReport(os);
+  os << "," << std::endl;
+  os << "\"Memory\": ";
+  runner.m_MemoryProbes.JSONReport(os);
+  os << "}" << std::endl;
+}
+
+template< class T >
+bool
+ParseList(const char *arg, std::vector< T > & values)
+{
+  values.clear();
+  std::stringstream stream(arg);
+  std::string       item;
+  while ( std::getline(stream, item, ',') )
+    {
+    const long value = atol( item.c_str() );
+    if ( value <= 0 )
+      {
+      return false;
+      }
+    values.push_back( static_cast< T >( value ) );
+    }
+  return !values.empty();
+}
+
+void
+Usage(const char *program)
+{
+  std::cerr << "Usage: " << program << std::endl
+            << "  [--sizes 32,64,128]       Size of the 3D synthetic images" << std::endl
+            << "  [--threads 1,N]           Numbers of threads" << std::endl
+            << "  [--iterations 3]          Number of runs of every workload" << std::endl
+            << "  [--filter name]           Only run the workloads whose name contains name" << std::endl
+            << "  [--output file.json]      JSON report, written to the standard output by default" << std::endl
+            << "  [--temporary-directory .] Directory of the files written by the IO workloads" << std::endl;
+}
+} // end anonymous namespace
+
+int main(int argc, char *argv[])
+{
+  BenchmarkRunner runner;
+  runner.m_Sizes.push_back(32);
+  runner.m_Sizes.push_back(64);
+  runner.m_Sizes.push_back(128);
+  runner.m_Threads.push_back(1);
+  if ( itk::MultiThreader::GetGlobalDefaultNumberOfThreads() > 1 )
+    {
+    runner.m_Threads.push_back( itk::MultiThreader::GetGlobalDefaultNumberOfThreads() );
+    }
+  runner.m_TemporaryDirectory = ".";
+
+  for ( int i = 1; i < argc; ++i )
+    {
+    const std::string arg = argv[i];
+    if ( i + 1 >= argc )
+      {
+      Usage(argv[0]);
+      return EXIT_FAILURE;
+      }
+    const char *value = argv[++i];
+    bool        valid = true;
+    if ( arg == "--sizes" )
+      {
+      valid = ParseList(value, runner.m_Sizes);
+      }
+    else if ( arg == "--threads" )
+      {
+      valid = ParseList(value, runner.m_Threads);
+      }
+    else if ( arg == "--iterations" )
+      {
+      runner.m_Iterations = static_cast< unsigned int >( atoi(value) );
+      valid = runner.m_Iterations > 0;
+      }
+    else if ( arg == "--filter" )
+      {
+      runner.m_Filter = value;
+      }
+    else if ( arg == "--output" )
+      {
+      runner.m_Output = value;
+      }
+    else if ( arg == "--temporary-directory" )
+      {
+      runner.m_TemporaryDirectory = value;
+      }
+    else
+      {
+      valid = false;
+      }
+    if ( !valid )
+      {
+      Usage(argv[0]);
+      return EXIT_FAILURE;
+      }
+    }
+
+  itk::MetaImageIOFactory::RegisterOneFactory();
+  itk::NrrdImageIOFactory::RegisterOneFactory();
+  itk::NiftiImageIOFactory::RegisterOneFactory();
+
+  try
+    {
+    RunBenchmarks(runner);
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cerr << "Benchmark failed: " << e << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // The JSON report may be written to the standard output: the progress
+  // and the readable summary go to the standard error.
+  runner.m_TimeProbes.Report(std::cerr);
+  runner.m_MemoryProbes.Report(std::cerr);
+
+  if ( runner.m_Output.empty() )
+    {
+    WriteJSONReport(runner, std::cout);
+    }
+  else
+    {
+    std::ofstream output( runner.m_Output.c_str() );
+    if ( !output )
+      {
+      std::cerr << "Cannot write " << runner.m_Output << std::endl;
+      return EXIT_FAILURE;
+      }
+    WriteJSONReport(runner, output);
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,28 @@
+set(DOCUMENTATION "This module contains a driver running a curated set of
+representative workloads of the toolkit (resampling, smoothing, connected
+components, distance maps, image metrics and image IO) on synthetic images of
+several sizes and with several numbers of threads.  The timings and memory
+usage are collected with TimeProbesCollectorBase and MemoryProbesCollectorBase
+and written as JSON, so that builds can be compared with each other.")
+
+itk_module(ITKBenchmarks
+  DEPENDS
+    ITKCommon
+    ITKConnectedComponents
+    ITKDistanceMap
+    ITKImageFunction
+    ITKImageGrid
+    ITKIOImageBase
+    ITKIOMeta
+    ITKIONIFTI
+    ITKIONRRD
+    ITKMetricsv4
+    ITKSmoothing
+    ITKThresholding
+    ITKTransform
+  TEST_DEPENDS
+    ITKTestKernel
+  EXCLUDE_FROM_ALL
+  DESCRIPTION
+    "${DOCUMENTATION}"
+)
@@ -20,7 +20,9 @@
 
 #include "itkBoxMeanImageFilter.h"
 #include "itkProgressAccumulator.h"
-#include "itkBoxUtilities.h"
+#include "itkImageScanlineIterator.h"
+#include "itkProgressReporter.h"
+#include "itkSummedAreaTable.h"
 
 
 /*
@@ -45,37 +47,39 @@ void
 BoxMeanImageFilter< TInputImage, TOutputImage >
 ::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread, ThreadIdType threadId)
 {
-  // Accumulate type is too small
-  typedef typename NumericTraits< PixelType >::RealType    AccPixType;
-  typedef Image< AccPixType, TInputImage::ImageDimension > AccumImageType;
-
-  typename TInputImage::SizeType internalRadius;
-  for ( unsigned int i = 0; i < TInputImage::ImageDimension; i++ )
-    {
-    internalRadius[i] = this->GetRadius()[i] + 1;
-    }
+  typedef SummedAreaTable< InputImageType >  TableType;
+  typedef typename TableType::RegionListType RegionListType;
 
   const InputImageType *inputImage = this->GetInput();
   OutputImageType *     outputImage = this->GetOutput();
-  RegionType            accumRegion = outputRegionForThread;
-  accumRegion.PadByRadius(internalRadius);
-  accumRegion.Crop( inputImage->GetRequestedRegion() );
 
-  ProgressReporter progress( this, threadId, 2 * accumRegion.GetNumberOfPixels() );
+  ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
 
-  typename AccumImageType::Pointer accImage = AccumImageType::New();
-  accImage->SetRegions(accumRegion);
-  accImage->Allocate();
+  // The pixels outside the image are left out of the boxes, and the
+  // tables count the pixels summed over each box
+  TableType table;
+  table.SetReplicateBorder(false);
+  table.SetSubtractReferenceValue(true);
+  const RegionListType slabs = TableType::SplitRegion( outputRegionForThread, this->GetRadius() );
+  for ( typename RegionListType::const_iterator sit = slabs.begin(); sit != slabs.end(); ++sit )
+    {
+    table.Compute( inputImage, *sit, this->GetRadius() );
+    const double reference = table.GetReferenceValue();
 
-  BoxAccumulateFunction< TInputImage, AccumImageType >(inputImage, accImage,
-                                                       accumRegion,
-                                                       accumRegion,
-                                                       progress);
-  BoxMeanCalculatorFunction< AccumImageType, TOutputImage >(accImage.GetPointer(), outputImage,
-                                                            accumRegion,
-                                                            outputRegionForThread,
-                                                            this->GetRadius(),
-                                                            progress);
+    ImageScanlineIterator< OutputImageType > oIt(outputImage, *sit);
+    while ( !oIt.IsAtEnd() )
+      {
+      typename TableType::OffsetValueType position = table.ComputeOffset( oIt.GetIndex() );
+      while ( !oIt.IsAtEndOfLine() )
+        {
+        oIt.Set( static_cast< OutputPixelType >( reference + table.GetSum(position) / table.GetCount(position) ) );
+        ++position;
+        ++oIt;
+        progress.CompletedPixel();
+        }
+      oIt.NextLine();
+      }
+    }
 }
 } // end namespace itk
 #endif
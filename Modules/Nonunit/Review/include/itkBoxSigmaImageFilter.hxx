@@ -21,7 +21,9 @@
 #include "itkBoxSigmaImageFilter.h"
 #include "itkProgressAccumulator.h"
 #include "itkNumericTraits.h"
-#include "itkBoxUtilities.h"
+#include "itkImageScanlineIterator.h"
+#include "itkProgressReporter.h"
+#include "itkSummedAreaTable.h"
 
 
 /*
@@ -46,38 +48,42 @@ void
 BoxSigmaImageFilter< TInputImage, TOutputImage >
 ::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread, ThreadIdType threadId)
 {
-  // Accumulate type is too small
-  typedef typename itk::NumericTraits< PixelType >::RealType             AccValueType;
-  typedef typename itk::Vector< AccValueType, 2 >                        AccPixType;
-  typedef typename itk::Image< AccPixType, TInputImage::ImageDimension > AccumImageType;
-
-  typename TInputImage::SizeType internalRadius;
-  for ( unsigned int i = 0; i < TInputImage::ImageDimension; i++ )
-    {
-    internalRadius[i] = this->GetRadius()[i] + 1;
-    }
+  typedef SummedAreaTable< InputImageType >  TableType;
+  typedef typename TableType::RegionListType RegionListType;
 
   const InputImageType *inputImage = this->GetInput();
   OutputImageType *     outputImage = this->GetOutput();
-  RegionType            accumRegion = outputRegionForThread;
-  accumRegion.PadByRadius(internalRadius);
-  accumRegion.Crop( inputImage->GetRequestedRegion() );
 
-  ProgressReporter progress( this, threadId, 2 * accumRegion.GetNumberOfPixels() );
+  ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
 
-  typename AccumImageType::Pointer accImage = AccumImageType::New();
-  accImage->SetRegions(accumRegion);
-  accImage->Allocate();
+  // The pixels outside the image are left out of the boxes, and the
+  // tables count the pixels summed over each box
+  TableType table;
+  table.SetReplicateBorder(false);
+  table.SetComputeSumOfSquares(true);
+  table.SetSubtractReferenceValue(true);
+  const RegionListType slabs = TableType::SplitRegion( outputRegionForThread, this->GetRadius() );
+  for ( typename RegionListType::const_iterator sit = slabs.begin(); sit != slabs.end(); ++sit )
+    {
+    table.Compute( inputImage, *sit, this->GetRadius() );
 
-  BoxSquareAccumulateFunction< TInputImage, AccumImageType >(inputImage, accImage,
-                                                             accumRegion,
-                                                             accumRegion,
-                                                             progress);
-  BoxSigmaCalculatorFunction< AccumImageType, TOutputImage >(accImage, outputImage,
-                                                             accumRegion,
-                                                             outputRegionForThread,
-                                                             this->GetRadius(),
-                                                             progress);
+    ImageScanlineIterator< OutputImageType > oIt(outputImage, *sit);
+    while ( !oIt.IsAtEnd() )
+      {
+      typename TableType::OffsetValueType position = table.ComputeOffset( oIt.GetIndex() );
+      while ( !oIt.IsAtEndOfLine() )
+        {
+        const double sum = table.GetSum(position);
+        const double pixelscount = table.GetCount(position);
+        const double var = ( table.GetSumOfSquares(position) - sum * sum / pixelscount ) / ( pixelscount - 1 );
+        oIt.Set( static_cast< OutputPixelType >( var > 0.0 ? vcl_sqrt(var) : 0.0 ) );
+        ++position;
+        ++oIt;
+        progress.CompletedPixel();
+        }
+      oIt.NextLine();
+      }
+    }
 }
 } // end namespace itk
 #endif
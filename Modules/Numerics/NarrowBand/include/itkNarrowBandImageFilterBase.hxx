@@ -62,6 +62,7 @@ NarrowBandImageFilterBase< TInputImage, TOutputImage >
 
     //Set the number of threads before any other initialization happens
     this->GetMultiThreader()->SetNumberOfThreads( NumberOfThreads );
+    this->GetMultiThreader()->ExactNumberOfThreadsOn();
 
     // Copy the input image to the output image.  Algorithms will operate
     // directly on the output image and the update buffer.
@@ -119,6 +119,7 @@ ImageToHistogramFilter< TImage >
   m_Minimums.resize(nbOfThreads);
   m_Maximums.resize(nbOfThreads);
   m_Barrier = Barrier::New();
+  this->GetMultiThreader()->ExactNumberOfThreadsOn();
   m_Barrier->Initialize(nbOfThreads);
 }
 
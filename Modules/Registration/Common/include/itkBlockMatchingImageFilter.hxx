@@ -95,7 +95,10 @@ BlockMatchingImageFilter< TFixedImage, TMovingImage, TFeatures, TDisplacements,
   ThreadStruct str;
   str.Filter = this;
 
+  // The feature points are split over GetNumberOfThreads() threads: all
+  // of them must run.
   this->GetMultiThreader()->SetNumberOfThreads( this->GetNumberOfThreads() );
+  this->GetMultiThreader()->ExactNumberOfThreadsOn();
   this->GetMultiThreader()->SetSingleMethod(this->ThreaderCallback, &str);
 
   // multithread the execution
@@ -90,6 +90,9 @@ ImageToImageMetric< TFixedImage, TMovingImage >
 {
   this->m_ThreaderParameter.metric = this;
   this->m_NumberOfThreads = this->m_Threader->GetNumberOfThreads();
+  // The fixed image samples are split, and the per-thread results
+  // reduced, over m_NumberOfThreads threads: all of them must run.
+  this->m_Threader->ExactNumberOfThreadsOn();
 
   /* if 100% backward compatible, we should include this...but...
   typename BSplineTransformType::Pointer transformer =
@@ -0,0 +1,129 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMeanSquaresImageToImageMetric.h"
+#include "itkTranslationTransform.h"
+#include "itkLinearInterpolateImageFunction.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkThreadArena.h"
+
+// ImageToImageMetric splits the fixed image samples between its threads
+// and reduces the results of every thread: a global arena granting fewer
+// threads than requested must not change the value nor the derivative.
+namespace
+{
+typedef itk::Image< float, 2 > ImageToImageMetricThreadArenaTestImageType;
+
+ImageToImageMetricThreadArenaTestImageType::Pointer
+ImageToImageMetricThreadArenaTestImage(double centerX)
+{
+  typedef ImageToImageMetricThreadArenaTestImageType ImageType;
+  ImageType::Pointer  image = ImageType::New();
+  ImageType::SizeType size;
+  size.Fill( 64 );
+  image->SetRegions( size );
+  image->Allocate();
+  for( itk::ImageRegionIteratorWithIndex< ImageType > it( image, image->GetBufferedRegion() ); !it.IsAtEnd(); ++it )
+    {
+    const double dx = it.GetIndex()[0] - centerX;
+    const double dy = it.GetIndex()[1] - 30.0;
+    it.Set( static_cast< float >( 100.0 * vcl_exp( -( dx * dx + dy * dy ) / 200.0 ) ) );
+    }
+  return image;
+}
+}
+
+int itkImageToImageMetricThreadArenaTest(int itkNotUsed(argc), char*[] itkNotUsed(argv))
+{
+  typedef ImageToImageMetricThreadArenaTestImageType ImageType;
+  typedef itk::MeanSquaresImageToImageMetric< ImageType, ImageType > MetricType;
+  typedef itk::TranslationTransform< double, 2 >                     TransformType;
+  typedef itk::LinearInterpolateImageFunction< ImageType, double >   InterpolatorType;
+
+  ImageType::Pointer fixed = ImageToImageMetricThreadArenaTestImage( 30.0 );
+  ImageType::Pointer moving = ImageToImageMetricThreadArenaTestImage( 33.0 );
+
+  MetricType::TransformParametersType parameters( 2 );
+  parameters.Fill( 0.0 );
+  parameters[0] = 1.0;
+
+  MetricType::MeasureType    referenceValue = 0.0;
+  MetricType::DerivativeType referenceDerivative;
+  MetricType::MeasureType    referenceGetValue = 0.0;
+
+  const bool useThreadPool = itk::MultiThreader::GetGlobalDefaultUseThreadPool();
+
+  int result = EXIT_SUCCESS;
+  for( int run = 0; run < 3; ++run )
+    {
+    // The first run, without arena, is the reference; the others run in
+    // an arena of 2 threads, with and without the thread pool.
+    if( run == 1 )
+      {
+      itk::ThreadArena::Pointer arena = itk::ThreadArena::New();
+      arena->SetMaximumNumberOfThreads( 2 );
+      itk::MultiThreader::SetGlobalDefaultThreadArena( arena );
+      }
+    itk::MultiThreader::SetGlobalDefaultUseThreadPool( run == 2 );
+
+    MetricType::Pointer metric = MetricType::New();
+    metric->SetFixedImage( fixed );
+    metric->SetMovingImage( moving );
+    metric->SetTransform( TransformType::New() );
+    metric->SetInterpolator( InterpolatorType::New() );
+    metric->SetFixedImageRegion( fixed->GetBufferedRegion() );
+    metric->SetNumberOfThreads( 4 );
+    metric->UseAllPixelsOn();
+    metric->Initialize();
+
+    MetricType::MeasureType    value = 0.0;
+    MetricType::DerivativeType derivative;
+    metric->GetValueAndDerivative( parameters, value, derivative );
+    const MetricType::MeasureType getValue = metric->GetValue( parameters );
+
+    std::cout << "Run " << run << ": value " << value << " derivative " << derivative
+              << " GetValue " << getValue << std::endl;
+    if( run == 0 )
+      {
+      referenceValue = value;
+      referenceDerivative = derivative;
+      referenceGetValue = getValue;
+      continue;
+      }
+    if( vcl_abs( value - referenceValue ) > 1e-9 * vcl_abs( referenceValue )
+        || vcl_abs( getValue - referenceGetValue ) > 1e-9 * vcl_abs( referenceGetValue ) )
+      {
+      std::cerr << "Run " << run << ": the value differs from " << referenceValue << std::endl;
+      result = EXIT_FAILURE;
+      }
+    for( unsigned int i = 0; i < derivative.Size(); ++i )
+      {
+      if( vcl_abs( derivative[i] - referenceDerivative[i] ) > 1e-9 * vcl_abs( referenceDerivative[i] ) )
+        {
+        std::cerr << "Run " << run << ": the derivative differs from " << referenceDerivative << std::endl;
+        result = EXIT_FAILURE;
+        break;
+        }
+      }
+    }
+
+  itk::MultiThreader::SetGlobalDefaultThreadArena( 0 );
+  itk::MultiThreader::SetGlobalDefaultUseThreadPool( useThreadPool );
+
+  return result;
+}
@@ -102,6 +102,7 @@ ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
   m_NumberOfLabels.clear();
   m_NumberOfLabels.resize(nbOfThreads, 0);
   m_Barrier = Barrier::New();
+  this->GetMultiThreader()->ExactNumberOfThreadsOn();
   m_Barrier->Initialize(nbOfThreads);
   const SizeValueType pixelcount = output->GetRequestedRegion().GetNumberOfPixels();
   const SizeValueType xsize = output->GetRequestedRegion().GetSize()[0];
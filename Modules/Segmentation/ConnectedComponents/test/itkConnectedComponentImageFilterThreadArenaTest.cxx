@@ -0,0 +1,85 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkConnectedComponentImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkThreadArena.h"
+
+// The threads of ConnectedComponentImageFilter wait for each other at a
+// barrier: a global arena granting fewer threads than requested must not
+// make the filter hang, nor change its output.
+int itkConnectedComponentImageFilterThreadArenaTest(int itkNotUsed(argc), char*[] itkNotUsed(argv))
+{
+  typedef unsigned char                      PixelType;
+  typedef itk::Image< PixelType, 2 >         ImageType;
+  typedef itk::Image< unsigned short, 2 >    LabelImageType;
+
+  ImageType::Pointer  img = ImageType::New();
+  ImageType::SizeType size;
+  size.Fill( 128 );
+  img->SetRegions( size );
+  img->Allocate();
+  for( itk::ImageRegionIteratorWithIndex< ImageType > it( img, img->GetBufferedRegion() ); !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType & idx = it.GetIndex();
+    it.Set( ( idx[0] / 5 + idx[1] / 7 ) % 3 != 0 ? 255 : 0 );
+    }
+
+  typedef itk::ConnectedComponentImageFilter< ImageType, LabelImageType > FilterType;
+
+  FilterType::Pointer reference = FilterType::New();
+  reference->SetInput( img );
+  reference->SetNumberOfThreads( 1 );
+  reference->Update();
+
+  itk::ThreadArena::Pointer arena = itk::ThreadArena::New();
+  arena->SetMaximumNumberOfThreads( 2 );
+  itk::MultiThreader::SetGlobalDefaultThreadArena( arena );
+
+  int result = EXIT_SUCCESS;
+  for( int useThreadPool = 0; useThreadPool < 2; ++useThreadPool )
+    {
+    FilterType::Pointer filter = FilterType::New();
+    filter->SetInput( img );
+    filter->SetNumberOfThreads( 8 );
+    filter->GetMultiThreader()->SetUseThreadPool( useThreadPool != 0 );
+    filter->Update();
+
+    if( filter->GetObjectCount() != reference->GetObjectCount() )
+      {
+      std::cerr << "Thread pool " << useThreadPool << ": " << filter->GetObjectCount()
+                << " objects instead of " << reference->GetObjectCount() << std::endl;
+      result = EXIT_FAILURE;
+      }
+    itk::ImageRegionConstIterator< LabelImageType > it( filter->GetOutput(), img->GetBufferedRegion() );
+    itk::ImageRegionConstIterator< LabelImageType > rit( reference->GetOutput(), img->GetBufferedRegion() );
+    for( ; !it.IsAtEnd(); ++it, ++rit )
+      {
+      if( it.Get() != rit.Get() )
+        {
+        std::cerr << "Thread pool " << useThreadPool << ": the labels differ" << std::endl;
+        result = EXIT_FAILURE;
+        break;
+        }
+      }
+    }
+
+  itk::MultiThreader::SetGlobalDefaultThreadArena( 0 );
+
+  return result;
+}
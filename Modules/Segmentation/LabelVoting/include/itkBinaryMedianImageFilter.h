@@ -32,7 +32,8 @@ namespace itk
  * This filter computes an image where a given pixel is the median value
  * of the pixels in a neighborhood about the corresponding input pixel.
  * For the case of binary images the median can be obtained by simply counting
- * the neighbors that are foreground.
+ * the neighbors that are foreground. They are counted from a
+ * SummedAreaTable, in constant time whatever the radius.
  *
  * A median filter is one of the family of nonlinear filters.  It is
  * used to smooth an image without being biased by outliers or shot noise.
@@ -142,6 +143,23 @@ private:
   BinaryMedianImageFilter(const Self &); //purposely not implemented
   void operator=(const Self &);          //purposely not implemented
 
+  /** Function object counting the foreground pixels in the summed area
+   * tables. */
+  class ForegroundCounter
+  {
+public:
+    ForegroundCounter():m_ForegroundValue() {}
+    ForegroundCounter(const InputPixelType & foregroundValue):m_ForegroundValue(foregroundValue) {}
+
+    inline SizeValueType operator()(const InputPixelType & value) const
+    {
+      return ( value == m_ForegroundValue ) ? 1 : 0;
+    }
+
+private:
+    InputPixelType m_ForegroundValue;
+  };
+
   InputSizeType m_Radius;
 
   InputPixelType m_ForegroundValue;
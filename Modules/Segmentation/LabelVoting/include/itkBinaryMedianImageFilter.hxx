@@ -19,15 +19,9 @@
 #define __itkBinaryMedianImageFilter_hxx
 #include "itkBinaryMedianImageFilter.h"
 
-#include "itkConstNeighborhoodIterator.h"
-#include "itkNeighborhoodInnerProduct.h"
-#include "itkImageRegionIterator.h"
-#include "itkNeighborhoodAlgorithm.h"
-#include "itkOffset.h"
+#include "itkImageScanlineIterator.h"
 #include "itkProgressReporter.h"
-
-#include <vector>
-#include <algorithm>
+#include "itkSummedAreaTable.h"
 
 namespace itk
 {
@@ -96,65 +90,53 @@ BinaryMedianImageFilter< TInputImage, TOutputImage >
 ::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
                        ThreadIdType threadId)
 {
-  ZeroFluxNeumannBoundaryCondition< InputImageType > nbc;
-
-  ConstNeighborhoodIterator< InputImageType > bit;
-  ImageRegionIterator< OutputImageType >      it;
+  typedef SummedAreaTable< InputImageType, SizeValueType, ForegroundCounter > TableType;
+  typedef typename TableType::RegionListType                                  RegionListType;
 
-  // Allocate output
   typename OutputImageType::Pointer output = this->GetOutput();
   typename InputImageType::ConstPointer input  = this->GetInput();
 
-  // Find the data-set boundary "faces"
-  typename NeighborhoodAlgorithm::ImageBoundaryFacesCalculator< InputImageType >::FaceListType faceList;
-  NeighborhoodAlgorithm::ImageBoundaryFacesCalculator< InputImageType > bC;
-  faceList = bC(input, outputRegionForThread, m_Radius);
+  SizeValueType neighborhoodSize = 1;
+  for ( unsigned int d = 0; d < InputImageDimension; ++d )
+    {
+    neighborhoodSize *= 2 * m_Radius[d] + 1;
+    }
 
-  typename NeighborhoodAlgorithm::ImageBoundaryFacesCalculator< InputImageType >::FaceListType::iterator fit;
+  // All of our neighborhoods have an odd number of pixels, so there is
+  // always a median index (if there where an even number of pixels
+  // in the neighborhood we have to average the middle two values).
+  const SizeValueType medianPosition = neighborhoodSize / 2;
 
   ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
 
-  // Process each of the boundary faces.  These are N-d regions which border
-  // the edge of the buffer.
-  for ( fit = faceList.begin(); fit != faceList.end(); ++fit )
+  // The foreground pixels of the neighborhoods are counted from
+  // tables built slab after slab, to bound the memory they use
+  TableType table;
+  table.SetFunctor( ForegroundCounter(m_ForegroundValue) );
+  const RegionListType slabs = TableType::SplitRegion(outputRegionForThread, m_Radius);
+  for ( typename RegionListType::const_iterator sit = slabs.begin(); sit != slabs.end(); ++sit )
     {
-    bit = ConstNeighborhoodIterator< InputImageType >(m_Radius, input, *fit);
-    it  = ImageRegionIterator< OutputImageType >(output, *fit);
-    bit.OverrideBoundaryCondition(&nbc);
-    bit.GoToBegin();
+    table.Compute(input, *sit, m_Radius);
 
-    unsigned int neighborhoodSize = bit.Size();
-
-    // All of our neighborhoods have an odd number of pixels, so there is
-    // always a median index (if there where an even number of pixels
-    // in the neighborhood we have to average the middle two values).
-    unsigned int medianPosition = neighborhoodSize / 2;
-
-    while ( !bit.IsAtEnd() )
+    ImageScanlineIterator< OutputImageType > it(output, *sit);
+    while ( !it.IsAtEnd() )
       {
-      // count the pixels in the neighborhood
-      unsigned int count = 0;
-      for ( unsigned int i = 0; i < neighborhoodSize; ++i )
+      typename TableType::OffsetValueType position = table.ComputeOffset( it.GetIndex() );
+      while ( !it.IsAtEndOfLine() )
         {
-        InputPixelType value = bit.GetPixel(i);
-        if ( value == m_ForegroundValue )
+        if ( table.GetSum(position) > medianPosition )
           {
-          count++;
+          it.Set( static_cast< OutputPixelType >( m_ForegroundValue ) );
           }
+        else
+          {
+          it.Set( static_cast< OutputPixelType >( m_BackgroundValue ) );
+          }
+        ++position;
+        ++it;
+        progress.CompletedPixel();
         }
-
-      if ( count > medianPosition )
-        {
-        it.Set( static_cast< OutputPixelType >( m_ForegroundValue ) );
-        }
-      else
-        {
-        it.Set( static_cast< OutputPixelType >( m_BackgroundValue ) );
-        }
-
-      ++bit;
-      ++it;
-      progress.CompletedPixel();
+      it.NextLine();
       }
     }
 }
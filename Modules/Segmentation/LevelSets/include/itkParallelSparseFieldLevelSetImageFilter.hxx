@@ -1139,6 +1139,7 @@ ParallelSparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
   str.TimeStep = NumericTraits< TimeStepType >::Zero;
 
   this->GetMultiThreader()->SetNumberOfThreads (m_NumOfThreads);
+  this->GetMultiThreader()->ExactNumberOfThreadsOn();
 
   // Initialize the list of time step values that will be generated by the
   // various threads.  There is one distinct slot for each possible thread,
@@ -1024,6 +1024,16 @@ bool MetaObject::CompressedData(void) const
   return m_CompressedData;
   }
 
+void MetaObject::CompressedDataSize(METAIO_STL::streamoff _compressedDataSize)
+  {
+  m_CompressedDataSize = _compressedDataSize;
+  }
+
+METAIO_STL::streamoff MetaObject::CompressedDataSize(void) const
+  {
+  return m_CompressedDataSize;
+  }
+
 void  MetaObject::BinaryData(bool _binaryData)
   {
   m_BinaryData = _binaryData;
@@ -266,6 +266,9 @@ class METAIO_EXPORT MetaObject
       void  CompressedData(bool _compressedData);
       bool  CompressedData(void) const;
 
+      void  CompressedDataSize(METAIO_STL::streamoff _compressedDataSize);
+      METAIO_STL::streamoff CompressedDataSize(void) const;
+
 
       virtual void Clear(void);
 